@@ -0,0 +1,359 @@
+/***********************************************************************
+ *
+ * Cycle count benchmarks for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/* Definitions -------------------------------------------------------*/
+#ifndef F_CPU
+#define F_CPU 16000000
+#endif
+
+/* Includes ----------------------------------------------------------*/
+#include <avr/io.h>         // AVR device-specific IO definitions
+#include <avr/interrupt.h>  // Interrupts standard C library for AVR-GCC
+#include <util/delay.h>     // Busy wait while the UART drains
+#include <stdlib.h>         // itoa() as the baseline
+#include <string.h>         // memcpy
+#include "bench.h"
+#include "fmt.h"            // Formatted output library for AVR-GCC
+#include "lcdfb.h"          // LCD framebuffer library for AVR-GCC
+#include "uart.h"           // UART library for AVR-GCC
+#include "chime.h"          // Sampled chime library
+#include "evlog.h"          // Event log library
+#include "event.h"          // EV_ENTRY
+#include "pin.h"            // PIN accumulator library
+#include "siphash.h"        // SipHash library
+#include "sha1.h"           // SHA-1 library
+#include "totp.h"           // One-time code library
+#include "users.h"          // User table library
+#include "rtc.h"            // Wall clock library
+#include "schedule.h"       // Access schedule library
+#include "eeq.h"            // EEPROM write queue library
+#include "eemap.h"          // EEPROM layout
+
+/* Global Variables --------------------------------------------------*/
+static uint16_t benchOverhead = 0;     // Cycles of an empty measurement
+
+/* Function definitions ----------------------------------------------*/
+void bench_start(void)
+{
+	TCCR1B = 0;
+	TCCR1A = 0;
+	TCNT1 = 0;
+	TIFR1 = (1 << TOV1);
+	TCCR1B = (1 << CS10);
+}
+
+/*--------------------------------------------------------------------*/
+uint16_t bench_stop(void)
+{
+	uint16_t cycles;
+
+	TCCR1B = 0;
+	cycles = TCNT1;
+	if (TIFR1 & (1 << TOV1))
+		return 0xFFFF;
+	return (cycles > benchOverhead) ? cycles - benchOverhead : 0;
+}
+
+#ifdef BENCH
+/*--------------------------------------------------------------------*/
+// Lets the UART send what is in the transmit buffer
+static void bench_drain(void)
+{
+	sei();
+	_delay_ms(150);
+	cli();
+}
+
+/*--------------------------------------------------------------------*/
+static void bench_report(const char *name, uint16_t cycles)
+{
+	sei();
+	fmt_uart_P("bench %-20S %5u cycles\r\n", FMT_P(name), cycles);
+	bench_drain();
+}
+
+/*--------------------------------------------------------------------*/
+// Counter output of correctPin() and wrongPin()
+static void bench_fmt(void)
+{
+	volatile uint8_t correct = 12;
+	volatile uint8_t wrong = 103;
+	char string2[4];
+
+	bench_start();
+	uart_puts("Correct: ");
+	uart_puts(itoa(correct, string2, 10));
+	uart_puts("\r\n");
+	uart_puts("Wrong: ");
+	uart_puts(itoa(wrong, string2, 10));
+	uart_puts("\r\n");
+	bench_report(PSTR("uart itoa+puts"), bench_stop());
+
+	bench_start();
+	fmt_uart_P("Correct: %u\r\nWrong: %u\r\n", correct, wrong);
+	bench_report(PSTR("uart fmt"), bench_stop());
+
+	// Remaining time line of the Timer/Counter1 handler
+	bench_start();
+	lcdfb_gotoxy(2, 0);
+	lcdfb_puts("Remaining time: ");
+	lcdfb_puts(itoa(correct, string2, 10));
+	bench_report(PSTR("lcdfb itoa+puts"), bench_stop());
+
+	bench_start();
+	fmt_lcd_P(2, 0, 18, "Remaining time: %u", correct);
+	bench_report(PSTR("lcdfb fmt"), bench_stop());
+}
+
+/*--------------------------------------------------------------------*/
+// Decoding of one chime sample, the slowest of the 16 codes, from a
+// large step so the sums saturate
+static void bench_chime(void)
+{
+	volatile int16_t sink;
+	uint16_t worst = 0;
+
+	for (uint8_t code = 0; code < 16; code++)
+	{
+		adpcm_t s = {30000, 80};
+		uint16_t cycles;
+
+		bench_start();
+		sink = adpcm_decode(&s, code);
+		cycles = bench_stop();
+		if (cycles > worst)
+			worst = cycles;
+	}
+	(void)sink;
+	bench_report(PSTR("adpcm_decode max"), worst);
+}
+
+/*--------------------------------------------------------------------*/
+// Encoding of one log record, the longest: escaped argument and a time
+// varint of five bytes
+static void bench_evlog(void)
+{
+	uint8_t rec[EVLOG_REC_MAX];
+	volatile uint32_t dt = 0xFFFFFFFF;
+	volatile uint8_t sink;
+	uint16_t cycles;
+
+	bench_start();
+	sink = evlog_encode(rec, EV_ENTRY, 0xFF, dt);
+	cycles = bench_stop();
+	(void)sink;
+	bench_report(PSTR("evlog_encode max"), cycles);
+}
+
+/*--------------------------------------------------------------------*/
+// SipHash-2-4 test vectors of the reference implementation: the key
+// 00 01 .. 0F, the message 00 01 .. len-1
+static void bench_siphash(void)
+{
+	static const struct {
+		uint8_t len;
+		uint64_t hash;
+	} vectors[] PROGMEM = {
+		{0, 0x726FDB47DD0E0E31ULL}, {1, 0x74F839C593DC67FDULL},
+		{7, 0xAB0200F58B01D137ULL}, {8, 0x93F5F5799A932462ULL},
+		{15, 0xA129CA6149BE45E5ULL}, {16, 0x3F2ACC7F57C29BDBULL},
+		{63, 0x958A324CEB064572ULL},
+	};
+	uint8_t key[SIPHASH_KEY_LEN];
+	uint8_t msg[64];
+	uint64_t hash;
+	uint8_t len;
+	uint8_t failed = 0;
+	siphash_t st;
+	uint16_t cycles;
+
+	for (uint8_t i = 0; i < sizeof(msg); i++)
+		msg[i] = i;
+	memcpy(key, msg, sizeof(key));
+
+	for (uint8_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++)
+	{
+		len = pgm_read_byte(&vectors[i].len);
+		memcpy_P(&hash, &vectors[i].hash, sizeof(hash));
+		if (siphash24(key, msg, len) != hash)
+			failed++;
+	}
+	sei();
+	fmt_uart_P("bench siphash vectors        %u of %u wrong\r\n", failed,
+		   (uint8_t)(sizeof(vectors) / sizeof(vectors[0])));
+	bench_drain();
+
+	siphash_init(&st, key);
+	bench_start();
+	siphash_rounds(&st, SIPHASH_C_ROUNDS);
+	bench_report(PSTR("siphash_rounds 2"), bench_stop());
+
+	bench_start();
+	siphash_rounds_c(&st, SIPHASH_C_ROUNDS);
+	bench_report(PSTR("siphash_rounds_c 2"), bench_stop());
+
+	bench_start();
+	hash = siphash24(key, msg, 8);
+	cycles = bench_stop();
+	(void)hash;
+	bench_report(PSTR("siphash24 8 bytes"), cycles);
+}
+
+/*--------------------------------------------------------------------*/
+// One key press of a pin entry, and the check of a wrong 10 digit pin
+// turned away by the filter, of one the filter let past and against
+// every record
+static void bench_pin(void)
+{
+	static const char digits[PIN_MAX] = "0123456789";
+	pin_t pin;
+	volatile int16_t sink;
+	uint16_t cycles;
+	uint32_t half[2] = {0x9E3779B9UL, 0};
+	uint64_t cred;
+	uint16_t tries = 0;
+
+	pin_start(&pin);
+	for (uint8_t i = 0; i < PIN_MAX - 1; i++)
+		pin_digit(&pin, digits[i]);
+	bench_start();
+	pin_digit(&pin, digits[PIN_MAX - 1]);
+	cycles = bench_stop();
+	bench_report(PSTR("pin_digit"), cycles);
+
+	bench_start();
+	sink = users_match(pin_finish(&pin));
+	cycles = bench_stop();
+	bench_report(PSTR("pin verify"), cycles);
+
+	// A wrong credential past the filter, the lookup the filter saves
+	// the others
+	do
+	{
+		half[1] += 0x7F4A7C15UL;
+		memcpy(&cred, half, sizeof(cred));
+	} while (!users_maybe(cred) && ++tries < 60000);
+	bench_start();
+	sink = users_match(cred);
+	cycles = bench_stop();
+	bench_report(PSTR("pin past filter"), cycles);
+
+	bench_start();
+	sink = users_find(digits, PIN_MAX);
+	cycles = bench_stop();
+	(void)sink;
+	bench_report(PSTR("users_find"), cycles);
+}
+
+/*--------------------------------------------------------------------*/
+// The HOTP vectors of RFC 4226 for the counters 0 to 2, one SHA-1 block
+// (a HOTP is four and a division) and a miss of the code cache, which
+// takes as long as a hit
+static void bench_totp(void)
+{
+	static const uint32_t vectors[] PROGMEM = {755224, 287082, 359152};
+	static const char key[] PROGMEM = "12345678901234567890";
+	uint8_t secret[20];
+	uint8_t block[SHA1_BLOCK_LEN];
+	uint8_t failed = 0;
+	volatile int16_t sink;
+	sha1_t s;
+	uint16_t cycles;
+
+	memcpy_P(secret, key, sizeof(secret));
+	for (uint8_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++)
+		if (hotp(secret, sizeof(secret), i) != pgm_read_dword(&vectors[i]))
+			failed++;
+	sei();
+	fmt_uart_P("bench hotp vectors           %u of %u wrong\r\n", failed,
+		   (uint8_t)(sizeof(vectors) / sizeof(vectors[0])));
+	bench_drain();
+
+	memset(block, 0x5A, sizeof(block));
+	sha1_init(&s);
+	bench_start();
+	sha1_update(&s, block, sizeof(block));
+	bench_report(PSTR("sha1 block"), bench_stop());
+
+	bench_start();
+	sink = totp_match(0x0123456789ABCDEFULL);
+	cycles = bench_stop();
+	(void)sink;
+	bench_report(PSTR("totp_match"), cycles);
+}
+
+/*--------------------------------------------------------------------*/
+// Costs of the clock on the second tick and of the schedule on an entry
+static void bench_schedule(void)
+{
+	uint32_t saved = rtc_now();
+	volatile uint8_t sink;
+	uint16_t cycles;
+
+	// Sunday 23:59:59 UTC, the tick turns the hour and the week
+	rtc_set(1609718399UL);
+	bench_start();
+	rtc_tick();
+	bench_report(PSTR("rtc_tick week turn"), bench_stop());
+
+	bench_start();
+	sink = schedule_allowed(1);
+	cycles = bench_stop();
+	(void)sink;
+	bench_report(PSTR("schedule_allowed"), cycles);
+
+	rtc_set(saved);
+}
+
+/*--------------------------------------------------------------------*/
+// A write of a full job, which the main loop used to wait 3.4 ms per
+// byte for, and the read through the queue. The bytes are the ones the
+// EEPROM holds, so nothing is programmed
+static void bench_eeq(void)
+{
+	uint8_t rec[EEQ_JOB_LEN];
+	uint16_t written;
+	uint16_t cycles;
+
+	eeq_read(rec, EE_USERS, sizeof(rec));
+	bench_start();
+	eeq_write(EE_USERS, rec, sizeof(rec));
+	written = bench_stop();
+
+	// Still queued, the interrupts are off
+	bench_start();
+	eeq_read(rec, EE_USERS, sizeof(rec));
+	cycles = bench_stop();
+	eeq_flush();
+	bench_report(PSTR("eeq_write 16 bytes"), written);
+	bench_report(PSTR("eeq_read 16 queued"), cycles);
+}
+
+/*--------------------------------------------------------------------*/
+void bench_run(void)
+{
+	cli();
+
+	// Calibrate the cost of bench_start() and bench_stop() themselves
+	bench_start();
+	benchOverhead = bench_stop();
+
+	bench_fmt();
+	bench_chime();
+	bench_evlog();
+	bench_siphash();
+	bench_pin();
+	bench_totp();
+	bench_schedule();
+	bench_eeq();
+
+	sei();
+}
+#endif /* BENCH */
@@ -0,0 +1,64 @@
+#ifndef BENCH_H_
+#define BENCH_H_
+
+/***********************************************************************
+ *
+ * Cycle count benchmarks for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/**
+ * @file  bench.h
+ * @defgroup dumbledoor_bench Benchmark Library <bench.h>
+ * @code #include <bench.h> @endcode
+ *
+ * @brief On target cycle count benchmarks.
+ *
+ * @details
+ * Timer/Counter1 is borrowed at prescaler 1 before the application
+ * timers are started, so one timer tick is one CPU cycle. Measured code
+ * runs with interrupts disabled and must finish within 65535 cycles
+ * (4 ms at 16 MHz), longer runs are reported as 65535.
+ *
+ * The benchmarks are only built when BENCH is defined, for example by
+ * adding BENCH to the symbols of the Debug configuration. The results
+ * are printed to the UART at boot.
+ *
+ * @author
+ * Demirkan Korbey Baglamac and Rasit Demiroren
+ *
+ * @copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * Programmed for the Digital Electronics 2 project.
+ * This work is licensed under the terms of the MIT license.
+ */
+
+/* Includes ----------------------------------------------------------*/
+#include <avr/io.h>         // AVR device-specific IO definitions
+
+/* Function prototypes -----------------------------------------------*/
+/**
+ * @brief    Clears Timer/Counter1 and starts it at prescaler 1.
+ * @return   none
+ */
+void bench_start(void);
+
+/**
+ * @brief    Stops Timer/Counter1.
+ * @return   Cycles since bench_start() minus the measuring overhead,
+ *           65535 if the counter overflowed
+ */
+uint16_t bench_stop(void);
+
+/**
+ * @brief    Runs all benchmarks and prints the results to the UART.
+ *           Call after uart_init() and before the application timers
+ *           are configured. Returns with interrupts enabled.
+ * @return   none
+ */
+void bench_run(void);
+
+#endif /* BENCH_H_ */
@@ -0,0 +1,473 @@
+/***********************************************************************
+ *
+ * RS-485 door bus library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/* Includes ----------------------------------------------------------*/
+#include <util/atomic.h>    // ATOMIC_BLOCK
+#include "bus.h"
+#include "eemap.h"          // EEPROM layout
+#include "eeq.h"            // Link mode and address
+#include "event.h"          // Event clock
+#include "uart.h"           // UART library for AVR-GCC
+#include "users.h"          // User table sync
+#include "stack.h"          // Stack report
+#include "trace.h"          // Flight recorder
+#include "sound.h"          // Melodies
+#include "evlog.h"          // Event log
+#include "config.h"         // Settings
+#include "rtc.h"            // Clock
+#include "schedule.h"       // Access schedules
+#include "totp.h"           // One-time code secrets
+
+/* Definitions -------------------------------------------------------*/
+#define BUS_EVENTS_MASK (BUS_EVENTS_MAX - 1)
+
+#if (BUS_EVENTS_MAX & BUS_EVENTS_MASK)
+# error BUS_EVENTS_MAX is not a power of 2
+#endif
+
+// Security events are sent at once, not after the batch window
+#define BUS_URGENT(type) \
+	((type) == EV_ENTRY || (type) == EV_DENIED || (type) == EV_BOOT || (type) == EV_STACK)
+
+/* Global Variables --------------------------------------------------*/
+typedef struct {
+	uint8_t seq;
+	uint8_t type;
+	uint8_t arg;
+	uint16_t time;
+	uint16_t tick;                  // event_ticks() when posted
+} bus_event_t;
+
+static uint8_t busMode = BUS_MODE_CONSOLE;
+static uint8_t busAddr = FRAME_ADDR_BCAST;
+static frame_rx_t busRx;
+
+// Events not yet acknowledged by the master, oldest at busTail
+static bus_event_t busEvents[BUS_EVENTS_MAX];
+static volatile uint8_t busTail = 0;
+static volatile uint8_t busCount = 0;
+static volatile uint8_t busNextSeq = 0;
+static volatile uint8_t busLost = 0;
+static uint8_t busEpoch = 0;        // EE_BOOT_EPOCH of this reset
+static uint8_t busEpochSet = 0;
+
+// Stream mode: what was sent last and when
+static uint8_t busPushed = 0;       // busNextSeq at the last push
+static uint16_t busPushTime = 0;
+static uint8_t busPushNow = 0;      // Acknowledged, send the rest
+
+// Stream mode batches
+static uint8_t busBatchWindow = BUS_BATCH_WINDOW;
+static uint8_t busBatchEvents = BUS_BATCH_EVENTS;
+static volatile uint8_t busUrgent = 0;      // A security event is new
+static volatile uint16_t busBatchStart = 0; // event_ticks() of the oldest new event
+static uint8_t busFirstSent = 0;            // Sequence number after the last batched event
+static uint16_t busHistSize[BUS_HIST_SIZES];
+static uint16_t busHistLatency[BUS_HIST_LATENCIES];
+
+/* Function definitions ----------------------------------------------*/
+void bus_init(void)
+{
+	eeq_read(&busMode, EE_LINK_MODE, 1);
+	eeq_read(&busAddr, EE_NODE_ADDR, 1);
+
+	// One epoch per reset, a change of the link keeps the events
+	if (!busEpochSet)
+	{
+		eeq_read(&busEpoch, EE_BOOT_EPOCH, 1);
+		busEpoch++;
+		eeq_write(EE_BOOT_EPOCH, &busEpoch, 1);
+		busEpochSet = 1;
+	}
+
+	// Without a valid address the door stays a console
+	if ((busMode != BUS_MODE_POLLED && busMode != BUS_MODE_STREAM) ||
+		busAddr == FRAME_ADDR_MASTER || busAddr > FRAME_ADDR_MAX)
+		busMode = BUS_MODE_CONSOLE;
+
+	frame_rx_reset(&busRx);
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t bus_mode(void)
+{
+	return busMode;
+}
+
+/*--------------------------------------------------------------------*/
+// Drops the oldest queued key press to make room, the events after it
+// move up and keep their sequence numbers. Interrupts off.
+static void bus_drop_key(void)
+{
+	for (uint8_t i = 0; i < busCount; i++)
+	{
+		if (busEvents[(busTail + i) & BUS_EVENTS_MASK].type != EV_KEY)
+			continue;
+		for (; i < busCount - 1; i++)
+			busEvents[(busTail + i) & BUS_EVENTS_MASK] = busEvents[(busTail + i + 1) & BUS_EVENTS_MASK];
+		busCount--;
+		if (busLost != 0xFF)
+			busLost++;
+		trace(TR_EV_LOST, EV_KEY);
+		return;
+	}
+}
+
+/*--------------------------------------------------------------------*/
+void bus_post(uint8_t type, uint8_t arg, uint16_t time)
+{
+	if (busMode == BUS_MODE_CONSOLE)
+		return;
+	// Key presses only fill batches, alone they would take the room of
+	// the security events
+	if (type == EV_KEY && (busMode != BUS_MODE_STREAM || !busBatchEvents))
+		return;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		if (busCount == BUS_EVENTS_MAX && type != EV_KEY)
+			bus_drop_key();
+		if (busCount == BUS_EVENTS_MAX)
+		{
+			// Keep the unacknowledged events, count the new one as lost
+			if (busLost != 0xFF)
+				busLost++;
+			trace(TR_EV_LOST, type);
+		}
+		else
+		{
+			bus_event_t *ev = &busEvents[(busTail + busCount) & BUS_EVENTS_MASK];
+			if (busNextSeq == busPushed)
+				busBatchStart = event_ticks();
+			if (BUS_URGENT(type))
+				busUrgent = 1;
+			ev->seq = busNextSeq++;
+			ev->type = type;
+			ev->arg = arg;
+			ev->time = time;
+			ev->tick = event_ticks();
+			busCount++;
+		}
+	}
+}
+
+/*--------------------------------------------------------------------*/
+void bus_batch(uint8_t window, uint8_t events)
+{
+	busBatchWindow = window;
+	busBatchEvents = events;
+}
+
+/*--------------------------------------------------------------------*/
+static void bus_put(void *ctx, uint8_t b)
+{
+	(void)ctx;
+	uart_putc(b);
+}
+
+/*--------------------------------------------------------------------*/
+// Drops the events up to and including the acknowledged sequence
+// number. An ack of another epoch, or of an event not posted yet, was
+// meant for the door before a reset.
+static void bus_ack(const frame_rx_t *rx)
+{
+	uint8_t ack;
+
+	if (rx->len < 2 || rx->payload[0] != busEpoch)
+		return;
+	ack = rx->payload[1];
+
+	// Only an ack from the oldest queued event to the last posted counts
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		while (busCount && (uint8_t)(ack - busEvents[busTail].seq) <
+			(uint8_t)(busNextSeq - busEvents[busTail].seq))
+		{
+			busTail = (busTail + 1) & BUS_EVENTS_MASK;
+			busCount--;
+		}
+	}
+}
+
+/*--------------------------------------------------------------------*/
+// Sends the oldest pending events, returns busNextSeq at that moment
+static uint8_t bus_reply_events(uint8_t seq)
+{
+	uint8_t payload[2 + BUS_EVENTS_PER_FRAME * BUS_EVENT_LEN];
+	uint8_t len = 2;
+	uint8_t n;
+	uint8_t next;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		next = busNextSeq;
+		payload[0] = busEpoch;
+		payload[1] = busLost;
+		busLost = 0;
+		n = (busCount < BUS_EVENTS_PER_FRAME) ? busCount : BUS_EVENTS_PER_FRAME;
+		for (uint8_t i = 0; i < n; i++)
+		{
+			bus_event_t *ev = &busEvents[(busTail + i) & BUS_EVENTS_MASK];
+			payload[len++] = ev->seq;
+			payload[len++] = ev->type;
+			payload[len++] = ev->arg;
+			payload[len++] = ev->time & 0xFF;
+			payload[len++] = ev->time >> 8;
+		}
+	}
+
+	frame_write(bus_put, 0, busAddr, FT_EVENTS, seq, payload, len);
+	return next;
+}
+
+/*--------------------------------------------------------------------*/
+static uint8_t bus_varint(uint8_t *p, uint16_t v)
+{
+	uint8_t n = 0;
+
+	while (v >= 0x80)
+	{
+		p[n++] = (v & 0x7F) | 0x80;
+		v >>= 7;
+	}
+	p[n++] = v;
+	return n;
+}
+
+/*--------------------------------------------------------------------*/
+// Counts v in the bucket of its bit length, the last one takes the rest
+static void bus_hist(uint16_t *hist, uint8_t buckets, uint16_t v)
+{
+	uint8_t i = 0;
+
+	while (v && i < buckets - 1)
+	{
+		v >>= 1;
+		i++;
+	}
+	if (hist[i] != 0xFFFF)
+		hist[i]++;
+}
+
+/*--------------------------------------------------------------------*/
+// Sends the oldest pending events in an FT_BATCH frame, returns
+// busNextSeq at that moment
+static uint8_t bus_send_batch(void)
+{
+	uint8_t payload[FRAME_PAYLOAD_MAX];
+	uint8_t len = BUS_BATCH_HEADER;
+	uint8_t fresh = 0;
+	uint8_t next;
+	uint16_t time;
+	uint16_t tick = event_ticks();
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		const bus_event_t *ev = &busEvents[busTail];
+
+		next = busNextSeq;
+		busUrgent = 0;
+		payload[0] = busEpoch;
+		payload[1] = busLost;
+		busLost = 0;
+		payload[2] = ev->seq;
+		payload[3] = ev->time & 0xFF;
+		payload[4] = ev->time >> 8;
+		time = ev->time;
+
+		for (uint8_t i = 0; i < busCount && len + BUS_BATCH_EVENT_MAX <= FRAME_PAYLOAD_MAX; i++)
+		{
+			ev = &busEvents[(busTail + i) & BUS_EVENTS_MASK];
+			payload[len++] = ev->type;
+			len += bus_varint(&payload[len], ev->arg);
+			len += bus_varint(&payload[len], ev->time - time);
+			time = ev->time;
+
+			// First time in a batch
+			if ((int8_t)(ev->seq - busFirstSent) >= 0)
+			{
+				bus_hist(busHistLatency, BUS_HIST_LATENCIES, tick - ev->tick);
+				busFirstSent = ev->seq + 1;
+				fresh++;
+			}
+		}
+	}
+
+	if (fresh)
+		bus_hist(busHistSize, BUS_HIST_SIZES, fresh >> 1);
+	frame_write(bus_put, 0, busAddr, FT_BATCH, 0, payload, len);
+	return next;
+}
+
+/*--------------------------------------------------------------------*/
+// Stream mode: a batch when a security event is new, when enough new
+// events wait or when the oldest has waited the window, the
+// unacknowledged events again after 1-2 s. A batch starts with the
+// oldest unacknowledged event, so new events wait while one is on its
+// way and join the next.
+static void bus_stream(void)
+{
+	uint16_t now = event_time();
+	uint8_t fresh;
+	uint8_t sent;
+	uint8_t push;
+
+	// Counted in the queue, a dropped key press leaves a gap in the
+	// sequence numbers
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		sent = 0;
+		while (sent < busCount &&
+			(int8_t)(busPushed - busEvents[(busTail + sent) & BUS_EVENTS_MASK].seq) > 0)
+			sent++;
+		fresh = busCount - sent;
+	}
+
+	// Sent before and not acknowledged
+	push = sent && (busPushNow || (uint16_t)(now - busPushTime) >= 2);
+	if (fresh && !push && (!sent || !busBatchEvents))
+		push = !busBatchEvents || busUrgent || fresh >= busBatchEvents ||
+			(uint16_t)(event_ticks() - busBatchStart) >= busBatchWindow;
+	if (!push)
+		return;
+
+	// A whole frame or nothing, new events join the batch meanwhile
+	if (uart_tx_free(UART_HIGH) < FRAME_LEN_MAX)
+		return;
+
+	busPushed = busBatchEvents ? bus_send_batch() : bus_reply_events(0);
+	busPushTime = now;
+	busPushNow = 0;
+}
+
+/*--------------------------------------------------------------------*/
+static void bus_batch_stats(uint8_t clear, uint8_t *reply)
+{
+	for (uint8_t i = 0; i < BUS_HIST_SIZES; i++)
+	{
+		*reply++ = busHistSize[i] & 0xFF;
+		*reply++ = busHistSize[i] >> 8;
+		if (clear)
+			busHistSize[i] = 0;
+	}
+	for (uint8_t i = 0; i < BUS_HIST_LATENCIES; i++)
+	{
+		*reply++ = busHistLatency[i] & 0xFF;
+		*reply++ = busHistLatency[i] >> 8;
+		if (clear)
+			busHistLatency[i] = 0;
+	}
+}
+
+/*--------------------------------------------------------------------*/
+static void bus_tx_stats(uint8_t clear, uint8_t *reply)
+{
+	unsigned int dropped;
+
+	for (uint8_t lane = 0; lane < 2; lane++)
+	{
+		uart_tx_stats(lane ? UART_LOW : UART_HIGH, &dropped, &reply[2], clear);
+		reply[0] = dropped & 0xFF;
+		reply[1] = dropped >> 8;
+		reply += 3;
+	}
+}
+
+/*--------------------------------------------------------------------*/
+static void bus_handle(const frame_rx_t *rx)
+{
+	uint8_t reply[FRAME_PAYLOAD_MAX];
+	uint8_t len;
+
+	// Broadcasts are never answered, only one door may drive the bus
+	if (rx->addr != busAddr || (rx->type & FT_REPLY))
+		return;
+
+	switch (rx->type)
+	{
+	case FT_POLL:
+		bus_ack(rx);
+		bus_reply_events(rx->seq);
+		break;
+
+	case FT_EV_ACK:
+		bus_ack(rx);
+		busPushNow = 1;
+		break;
+
+	case FT_TX_STATS:
+		bus_tx_stats(rx->len >= 1 && rx->payload[0], reply);
+		frame_write(bus_put, 0, busAddr, FT_TX_STATS | FT_REPLY, rx->seq, reply, TX_STATS_LEN);
+		break;
+
+	case FT_BATCH_STATS:
+		bus_batch_stats(rx->len >= 1 && rx->payload[0], reply);
+		frame_write(bus_put, 0, busAddr, FT_BATCH_STATS | FT_REPLY, rx->seq, reply, BATCH_STATS_LEN);
+		break;
+
+	case FT_SET_ADDR:
+		if (rx->len < 2 || rx->payload[0] == FRAME_ADDR_MASTER || rx->payload[0] > FRAME_ADDR_MAX)
+			break;
+		frame_write(bus_put, 0, busAddr, FT_ACK, rx->seq, 0, 0);
+		eeq_write(EE_NODE_ADDR, &rx->payload[0], 1);
+		eeq_write(EE_LINK_MODE, &rx->payload[1], 1);
+		bus_init();
+		break;
+
+	default:
+		// User table sync, stack report, trace, melodies, event log,
+		// settings, clock, schedules and one-time code secrets
+		len = users_frame(rx->type, rx->payload, rx->len, reply);
+		if (len == FRAME_NO_REPLY)
+			len = stack_frame(rx->type, reply);
+		if (len == FRAME_NO_REPLY)
+			len = trace_frame(rx->type, rx->payload, rx->len, reply);
+		if (len == FRAME_NO_REPLY)
+			len = sound_frame(rx->type, rx->payload, rx->len, reply);
+		if (len == FRAME_NO_REPLY)
+			len = evlog_frame(rx->type, rx->payload, rx->len, reply);
+		if (len == FRAME_NO_REPLY)
+			len = config_frame(rx->type, rx->payload, rx->len, reply);
+		if (len == FRAME_NO_REPLY)
+			len = rtc_frame(rx->type, rx->payload, rx->len, reply);
+		if (len == FRAME_NO_REPLY)
+			len = schedule_frame(rx->type, rx->payload, rx->len, reply);
+		if (len == FRAME_NO_REPLY)
+			len = totp_frame(rx->type, rx->payload, rx->len, reply);
+		if (len != FRAME_NO_REPLY)
+			frame_write(bus_put, 0, busAddr, rx->type | FT_REPLY, rx->seq, reply, len);
+		break;
+	}
+}
+
+/*--------------------------------------------------------------------*/
+void bus_task(void)
+{
+	unsigned int c;
+
+	if (busMode == BUS_MODE_CONSOLE)
+		return;
+
+	if (busMode == BUS_MODE_STREAM && busCount)
+		bus_stream();
+
+	while (!((c = uart_getc()) & UART_NO_DATA))
+	{
+		// A damaged byte breaks the frame it belongs to
+		if (c & (UART_FRAME_ERROR | UART_OVERRUN_ERROR | UART_BUFFER_OVERFLOW))
+		{
+			trace(TR_UART_ERROR, c >> 8);
+			frame_rx_reset(&busRx);
+		}
+
+		if (frame_rx_byte(&busRx, c & 0xFF))
+			bus_handle(&busRx);
+	}
+}
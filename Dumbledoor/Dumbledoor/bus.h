@@ -0,0 +1,154 @@
+#ifndef BUS_H_
+#define BUS_H_
+
+/***********************************************************************
+ *
+ * RS-485 door bus library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/**
+ * @file  bus.h
+ * @defgroup dumbledoor_bus Door Bus Library <bus.h>
+ * @code #include <bus.h> @endcode
+ *
+ * @brief Addressed half-duplex multi-drop bus on top of the UART.
+ *
+ * @details
+ * Many doors share one RS-485 pair with a master. The transceiver
+ * driver enable is switched by the UART library (UART_DE_PORT and
+ * UART_DE_PIN in uart.h), the receiver is disabled while the door
+ * drives the bus.
+ *
+ * The master polls one door at a time with FT_POLL, so two doors never
+ * talk at once. A door only answers frames with its own address: it
+ * sends its pending events in one FT_EVENTS frame
+ *
+ *     epoch | lost | (seq, type, arg, time_lo, time_hi) * n
+ *
+ * where lost counts events dropped because the queue was full. Every
+ * event has an 8-bit sequence number, which starts over at 0 after a
+ * reset. The epoch counts the resets (EE_BOOT_EPOCH in eemap.h), so
+ * the master can tell a restarted door from events sent again. The
+ * master acknowledges with epoch | seq of the last event it got in the
+ * payload of its next poll, until then the door sends the same events
+ * again. An acknowledgement of another epoch, or of a sequence number
+ * the door has not posted, is ignored.
+ *
+ * In stream mode the door is alone on a point-to-point link and does
+ * not wait to be polled. bus_task() collects new events into one
+ * FT_BATCH frame with seq 0
+ *
+ *     epoch | lost | seq | time_lo | time_hi | (type, arg, dt) * n
+ *
+ * where seq and time belong to the first event, the next events have
+ * the sequence numbers after it and arg and dt, the seconds since the
+ * event before, are varints: 7 bits per byte, low bits first, the top
+ * bit set on all but the last byte. A burst of key presses takes three
+ * bytes per event instead of the five of FT_EVENTS plus a frame each.
+ * Key presses are queued for batches only, and a new security event
+ * takes the place of the oldest one when the queue is full.
+ * The batch is sent when an entry, a denial, a reset or a watchdog
+ * reset is among the new events, when BUS_BATCH_EVENTS new events are
+ * waiting or when the oldest has waited BUS_BATCH_WINDOW sound ticks,
+ * and only when the whole frame fits the transmit buffer; events that
+ * come in meanwhile join the batch. The unacknowledged events are sent
+ * again every second. The master acknowledges with FT_EV_ACK, which is
+ * not answered. Polls are still answered, so a master can use both.
+ * FT_BATCH_STATS reads histograms of the batch sizes and of the time
+ * from event_post() to the first batch of an event.
+ *
+ * Frames and the door events printed in console mode go to the high
+ * priority lane of the UART, status and debug text to the low priority
+ * lane. Nothing waits for a full lane, the bytes are dropped and
+ * counted; FT_TX_STATS reads the counters.
+ *
+ * The link mode and the address are read from EEPROM (see eemap.h).
+ * Erased EEPROM means console mode: no frames, the application prints
+ * human readable text as before.
+ *
+ * @author
+ * Demirkan Korbey Baglamac and Rasit Demiroren
+ *
+ * @copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * Programmed for the Digital Electronics 2 project.
+ * This work is licensed under the terms of the MIT license.
+ */
+
+/* Includes ----------------------------------------------------------*/
+#include <stdint.h>         // Fixed width integer types
+#include "frame.h"          // Frame codec library
+
+/* Definitions -------------------------------------------------------*/
+// Link modes stored at EE_LINK_MODE
+#define BUS_MODE_CONSOLE        0xFF    // Text for a terminal
+#define BUS_MODE_POLLED         0x01    // Door on the bus, answers polls
+#define BUS_MODE_STREAM         0x02    // Door alone on a link, sends events
+
+#define BUS_EVENTS_MAX          16      // Event queue size, power of 2
+#define BUS_EVENT_LEN           5       // Bytes per event in FT_EVENTS
+#define BUS_EVENTS_PER_FRAME    ((FRAME_PAYLOAD_MAX - 2) / BUS_EVENT_LEN)
+
+// Transmit lanes of the UART, see uart_tx_stats()
+#define FT_TX_STATS             0x24    // [] or [clear] -> [high dropped lo, hi, high peak,
+                                        //                  low dropped lo, hi, low peak]
+#define TX_STATS_LEN            6
+
+// Stream mode batches, see bus_batch()
+#define BUS_BATCH_WINDOW        16      // Sound ticks the oldest new event may wait, 262 ms
+#define BUS_BATCH_EVENTS        8       // New events sent at once
+#define BUS_BATCH_HEADER        5       // epoch, lost, seq, time_lo, time_hi
+#define BUS_BATCH_EVENT_MAX     6       // type, arg varint, dt varint
+#define BUS_HIST_SIZES          4       // 1, 2-3, 4-7, 8+ new events
+#define BUS_HIST_LATENCIES      8       // 0, 1, 2-3, ... 64+ sound ticks
+#define FT_BATCH_STATS          0x25    // [] or [clear] -> [sizes, latencies], 16 bit counts
+#define BATCH_STATS_LEN         (2 * (BUS_HIST_SIZES + BUS_HIST_LATENCIES))
+
+/* Function prototypes -----------------------------------------------*/
+/**
+ * @brief    Reads the link mode and the address from EEPROM. Call
+ *           after uart_init().
+ * @return   none
+ */
+void bus_init(void);
+
+/**
+ * @brief    Current link mode.
+ * @return   BUS_MODE_CONSOLE, BUS_MODE_POLLED or BUS_MODE_STREAM
+ */
+uint8_t bus_mode(void);
+
+/**
+ * @brief    Queues an event for the master. Does nothing in console
+ *           mode, key presses only in stream mode with batches. When
+ *           the queue is full, another event takes the place of the
+ *           oldest key press; without one it is dropped and counted.
+ *           Safe to call from interrupt handlers.
+ * @param    type  Event type, see event.h
+ * @param    arg   Event argument
+ * @param    time  Time stamp in seconds
+ * @return   none
+ */
+void bus_post(uint8_t type, uint8_t arg, uint16_t time);
+
+/**
+ * @brief    Sets when stream mode sends a batch.
+ * @param    window  Sound ticks the oldest new event may wait
+ * @param    events  New events sent at once, 0: each event at once in
+ *                   an FT_EVENTS frame, without batches
+ * @return   none
+ */
+void bus_batch(uint8_t window, uint8_t events);
+
+/**
+ * @brief    Receives and answers frames, in stream mode also sends
+ *           the pending events. Call it from the main loop.
+ * @return   none
+ */
+void bus_task(void);
+
+#endif /* BUS_H_ */
@@ -0,0 +1,152 @@
+/***********************************************************************
+ *
+ * Sampled chime library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/* Includes ----------------------------------------------------------*/
+#include <avr/pgmspace.h>   // Sample and step sizes in program memory
+#include <util/atomic.h>    // ATOMIC_BLOCK
+#include "chime.h"
+#include "hal.h"            // Speaker PWM, Timer/Counter2 speed
+
+/* Definitions -------------------------------------------------------*/
+#define ADPCM_INDEX_MAX 88
+
+/* Global Variables --------------------------------------------------*/
+// IMA ADPCM step sizes
+static const uint16_t adpcmSteps[ADPCM_INDEX_MAX + 1] PROGMEM = {
+	7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37,
+	41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173,
+	190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658,
+	724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+	2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894,
+	6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289,
+	16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+// Step index change by the magnitude of a code
+static const int8_t adpcmIndex[8] PROGMEM = {
+	-1, -1, -1, -1, 2, 4, 6, 8
+};
+
+// Player, the handlers of Timer/Counter2 do not nest
+static volatile uint8_t chimePending = 0;  // Start at the next tick
+static volatile uint8_t chimeTicks = 0;    // Sound ticks left, 0: stopped
+static const uint8_t *chimeAt;             // Next byte of the sample
+static const uint8_t *chimeEnd;
+static uint8_t chimeByte;                  // High nibble still to play
+static uint8_t chimeOdd;
+static adpcm_t chimeAdpcm;
+
+/* Function definitions ----------------------------------------------*/
+// Single bit shifts, a constant shift by 3 may become a loop with -Os
+int16_t adpcm_decode(adpcm_t *s, uint8_t code)
+{
+	uint16_t step = pgm_read_word(&adpcmSteps[s->index]);
+	uint16_t half = step >> 1;
+	uint16_t quarter = half >> 1;
+	uint16_t diff = quarter >> 1;
+	int32_t pred = s->pred;
+	int8_t index = s->index + (int8_t)pgm_read_byte(&adpcmIndex[code & 7]);
+
+	if (code & 4)
+		diff += step;
+	if (code & 2)
+		diff += half;
+	if (code & 1)
+		diff += quarter;
+
+	if (code & 8)
+		pred -= diff;
+	else
+		pred += diff;
+	if (pred > INT16_MAX)
+		pred = INT16_MAX;
+	else if (pred < INT16_MIN)
+		pred = INT16_MIN;
+
+	if (index < 0)
+		index = 0;
+	else if (index > ADPCM_INDEX_MAX)
+		index = ADPCM_INDEX_MAX;
+
+	s->pred = (int16_t)pred;
+	s->index = (uint8_t)index;
+	return (int16_t)pred;
+}
+
+/*--------------------------------------------------------------------*/
+void chime_play(void)
+{
+	chimePending = 1;
+}
+
+/*--------------------------------------------------------------------*/
+void chime_stop(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		chimePending = 0;
+		if (chimeTicks)
+			chimeTicks = 1;
+	}
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t chime_busy(void)
+{
+	return chimePending || chimeTicks;
+}
+
+/*--------------------------------------------------------------------*/
+void chime_tick(void)
+{
+	if (chimePending)
+	{
+		chimePending = 0;
+		chimeAt = chimeData;
+		chimeEnd = chimeData + (chimeSamples + 1) / 2;
+		chimeOdd = 0;
+		chimeAdpcm.pred = 0;
+		chimeAdpcm.index = 0;
+		chimeTicks = (chimeSamples + HAL_CHIME_DIV - 1) / HAL_CHIME_DIV;
+		hal_chime(1);
+		return;
+	}
+	if (chimeTicks && --chimeTicks == 0)
+		hal_chime(0);
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t chime_div(void)
+{
+	return chimeTicks ? HAL_CHIME_DIV : HAL_SOUND_DIV;
+}
+
+/*--------------------------------------------------------------------*/
+// The end of the sample holds the last level until the tick stops it
+void chime_sample(void)
+{
+	uint8_t code;
+
+	if (chimeOdd)
+	{
+		code = chimeByte >> 4;
+	}
+	else
+	{
+		if (chimeAt == chimeEnd)
+			return;
+		chimeByte = pgm_read_byte(chimeAt++);
+		code = chimeByte & 0x0F;
+	}
+	chimeOdd ^= 1;
+
+	// Upper byte of the sample, offset to the middle of the PWM
+	hal_chime_write((uint8_t)((uint16_t)adpcm_decode(&chimeAdpcm, code) >> 8) ^ 0x80);
+}
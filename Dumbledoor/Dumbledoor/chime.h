@@ -0,0 +1,115 @@
+#ifndef CHIME_H_
+#define CHIME_H_
+
+/***********************************************************************
+ *
+ * Sampled chime library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/**
+ * @file  chime.h
+ * @defgroup dumbledoor_chime Sampled Chime Library <chime.h>
+ * @code #include <chime.h> @endcode
+ *
+ * @brief Door bell chime played from a 4 bit ADPCM sample in flash.
+ *
+ * @details
+ * The sample is IMA ADPCM, two 4 bit codes per byte, low nibble first,
+ * at CHIME_RATE samples per second. chime_data.c is written by
+ * Host/chime/doorchime, which encodes a WAV file with adpcm_decode() of
+ * this library so both ends agree.
+ *
+ * While the chime plays, Timer/Counter2 runs at prescaler 8: its fast
+ * PWM has a period of 256 cycles of 0.5 us, and OC2B (PD3, to the
+ * speaker through an RC filter) carries the sample. The TIMER2_COMPB
+ * handler decodes one sample per period with chime_sample(), which
+ * has no loops and is budgeted in Host/wcet/door.wcet. The overflow
+ * handler counts HAL_CHIME_DIV periods instead of HAL_SOUND_DIV, so
+ * the sound tick keeps its 16.384 ms and Timer/Counter0 and 1 are not
+ * touched. The relay PWM on OC2A keeps its duty at the higher rate.
+ *
+ * Timer/Counter2 only changes speed in chime_tick(), at a sound tick,
+ * so chime_play() and chime_stop() take effect at the next one. The
+ * door is not idle while the chime plays, the clock governor keeps the
+ * full clock.
+ *
+ * @author
+ * Demirkan Korbey Baglamac and Rasit Demiroren
+ *
+ * @copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * Programmed for the Digital Electronics 2 project.
+ * This work is licensed under the terms of the MIT license.
+ */
+
+/* Includes ----------------------------------------------------------*/
+#include <stdint.h>         // Fixed width integer types
+
+/* Definitions -------------------------------------------------------*/
+#define CHIME_RATE          7812    // Samples per second, 16 MHz / 8 / 256 = 7812.5
+#define CHIME_SAMPLES_MAX   12800   // 100 sound ticks, SOUND_TICKS_MAX
+
+/**
+ * @brief IMA ADPCM decoder state.
+ */
+typedef struct {
+	int16_t pred;                       // Last sample
+	uint8_t index;                      // Step size index, 0..88
+} adpcm_t;
+
+/* Global Variables --------------------------------------------------*/
+// The sample, in chime_data.c
+extern const uint8_t chimeData[];
+extern const uint16_t chimeSamples;
+
+/* Function prototypes -----------------------------------------------*/
+/**
+ * @brief    Decodes one 4 bit code.
+ * @param    s     Decoder state, zero at the start of a sample
+ * @param    code  ADPCM code, 0..15
+ * @return   Sample, -32768..32767
+ */
+int16_t adpcm_decode(adpcm_t *s, uint8_t code);
+
+/**
+ * @brief    Starts the chime from its beginning at the next sound tick.
+ * @return   none
+ */
+void chime_play(void);
+
+/**
+ * @brief    Stops the chime at the next sound tick.
+ * @return   none
+ */
+void chime_stop(void);
+
+/**
+ * @brief    Tells whether the chime plays or is about to.
+ * @return   1 while playing
+ */
+uint8_t chime_busy(void);
+
+/**
+ * @brief    Starts and stops the chime. Called by sound_tick().
+ * @return   none
+ */
+void chime_tick(void);
+
+/**
+ * @brief    Timer/Counter2 overflows until the next sound tick.
+ * @return   HAL_CHIME_DIV while the chime plays, otherwise HAL_SOUND_DIV
+ */
+uint8_t chime_div(void);
+
+/**
+ * @brief    Decodes the next sample and writes it to the speaker PWM.
+ *           Call it from the TIMER2_COMPB handler.
+ * @return   none
+ */
+void chime_sample(void);
+
+#endif /* CHIME_H_ */
@@ -0,0 +1,380 @@
+/***********************************************************************
+ *
+ * Door bell chime, IMA ADPCM at 7812 samples per second.
+ * Written by Host/chime/doorchime, do not edit.
+ *
+ **********************************************************************/
+
+/* Includes ----------------------------------------------------------*/
+#include <avr/pgmspace.h>   // Sample in program memory
+#include "chime.h"
+
+/* Definitions -------------------------------------------------------*/
+#define CHIME_SAMPLES   8593
+
+typedef char chime_samples_check[(CHIME_SAMPLES <= CHIME_SAMPLES_MAX) ? 1 : -1];
+
+/* Global Variables --------------------------------------------------*/
+const uint16_t chimeSamples = CHIME_SAMPLES;
+
+const uint8_t chimeData[(CHIME_SAMPLES + 1) / 2] PROGMEM = {
+	0x70, 0x77, 0x77, 0xf7, 0xff, 0x1b, 0x57, 0x91, 0x8b, 0xa1, 0xbb, 0x51,
+	0x32, 0xa3, 0x9d, 0x18, 0xcc, 0x40, 0x23, 0x90, 0xc9, 0x19, 0xcb, 0x58,
+	0x16, 0x99, 0x88, 0x99, 0x89, 0x39, 0x37, 0xa9, 0x1a, 0xc8, 0x0a, 0x41,
+	0x43, 0xc0, 0x1b, 0x98, 0x9d, 0x53, 0x11, 0x98, 0xaa, 0x08, 0x9e, 0x62,
+	0x02, 0x8a, 0xa8, 0x99, 0x99, 0x71, 0x05, 0x9a, 0x08, 0xba, 0x18, 0x62,
+	0x12, 0xd9, 0x18, 0xb9, 0x2b, 0x26, 0x01, 0xb9, 0x89, 0xb8, 0x0e, 0x27,
+	0x90, 0x88, 0xa9, 0xa0, 0x09, 0x55, 0xa2, 0x8a, 0x98, 0xab, 0x11, 0x55,
+	0x92, 0xab, 0x00, 0xbd, 0x31, 0x25, 0x00, 0xcb, 0x00, 0xda, 0x59, 0x04,
+	0x90, 0x98, 0x99, 0xb8, 0x59, 0x35, 0xa9, 0x09, 0xaa, 0x9a, 0x41, 0x46,
+	0xb8, 0x89, 0xa0, 0x8d, 0x32, 0x24, 0x98, 0x9c, 0xa1, 0xac, 0x72, 0x83,
+	0x88, 0x9a, 0x99, 0xc9, 0x71, 0x03, 0xa9, 0x80, 0xab, 0x89, 0x72, 0x14,
+	0xba, 0x08, 0xc9, 0x2a, 0x43, 0x14, 0xba, 0x0a, 0xe0, 0x1b, 0x35, 0x81,
+	0x98, 0x9b, 0xb8, 0x9b, 0x77, 0x91, 0x89, 0x88, 0x9a, 0x08, 0x44, 0x93,
+	0x9c, 0x91, 0xbb, 0x30, 0x35, 0x84, 0xac, 0x18, 0xea, 0x38, 0x24, 0x90,
+	0xb8, 0x0a, 0xd9, 0x39, 0x37, 0x99, 0x98, 0xa8, 0x8a, 0x29, 0x57, 0x98,
+	0x0a, 0xb0, 0x8a, 0x31, 0x35, 0xb1, 0x8d, 0x90, 0xcb, 0x53, 0x12, 0x90,
+	0xba, 0x08, 0xbd, 0x72, 0x03, 0x99, 0xa8, 0x99, 0x9a, 0x71, 0x15, 0x9a,
+	0x09, 0xb9, 0x1a, 0x52, 0x24, 0xc9, 0x1a, 0xc8, 0x0a, 0x44, 0x11, 0xb8,
+	0x9a, 0x98, 0x8e, 0x35, 0x92, 0x89, 0xb9, 0x99, 0x8b, 0x66, 0x82, 0x8b,
+	0x88, 0xbb, 0x10, 0x64, 0x93, 0xba, 0x00, 0xcc, 0x38, 0x34, 0x01, 0xda,
+	0x08, 0xc9, 0x3a, 0x27, 0x88, 0x89, 0x9a, 0xa8, 0x3a, 0x47, 0xa0, 0x09,
+	0xa9, 0x9a, 0x30, 0x65, 0xa0, 0x8a, 0x80, 0x9d, 0x31, 0x24, 0x90, 0xbb,
+	0x91, 0xad, 0x70, 0x03, 0x88, 0x9a, 0x99, 0xb9, 0x78, 0x15, 0x99, 0x88,
+	0xaa, 0x89, 0x51, 0x34, 0xba, 0x09, 0xc9, 0x0b, 0x44, 0x23, 0xb9, 0x8c,
+	0xb0, 0x8e, 0x44, 0x01, 0x98, 0xaa, 0x98, 0x9b, 0x75, 0x92, 0x89, 0x98,
+	0x9a, 0x89, 0x64, 0x02, 0xab, 0x80, 0xbb, 0x39, 0x26, 0x04, 0xab, 0x09,
+	0xe9, 0x3a, 0x25, 0x81, 0xa9, 0x0b, 0xc9, 0x2a, 0x47, 0x90, 0x89, 0x99,
+	0x9a, 0x18, 0x47, 0x90, 0x8a, 0xa0, 0xab, 0x31, 0x36, 0x91, 0x8d, 0x88,
+	0xbb, 0x71, 0x12, 0x90, 0xa9, 0x89, 0xda, 0x50, 0x14, 0xa8, 0x98, 0x99,
+	0x9a, 0x50, 0x17, 0x99, 0x09, 0xb8, 0x0a, 0x41, 0x25, 0xb8, 0x0b, 0xc0,
+	0x9b, 0x45, 0x11, 0xa0, 0x9b, 0x98, 0xad, 0x64, 0x82, 0x89, 0x99, 0x8a,
+	0x9a, 0x73, 0x04, 0x9a, 0x88, 0xba, 0x29, 0x72, 0x03, 0xba, 0x19, 0xea,
+	0x29, 0x43, 0x02, 0xc9, 0x89, 0xc8, 0x2b, 0x37, 0x80, 0x99, 0xa9, 0x99,
+	0x1b, 0x57, 0xa1, 0x89, 0x98, 0xaa, 0x20, 0x64, 0x91, 0x9a, 0x88, 0xac,
+	0x31, 0x25, 0x81, 0xcb, 0x80, 0xcb, 0x68, 0x14, 0x88, 0xa9, 0x99, 0xa9,
+	0x69, 0x25, 0x99, 0x89, 0xa9, 0x8a, 0x40, 0x36, 0xb8, 0x0a, 0xb8, 0x8d,
+	0x33, 0x34, 0xa8, 0x9d, 0xa1, 0x8d, 0x52, 0x03, 0x89, 0x9b, 0x99, 0xbb,
+	0x73, 0x07, 0x99, 0x88, 0x99, 0x98, 0x52, 0x04, 0xaa, 0x08, 0xba, 0x1a,
+	0x35, 0x14, 0xba, 0x0a, 0xd9, 0x2b, 0x36, 0x01, 0xa9, 0x9b, 0xb8, 0x1d,
+	0x46, 0x91, 0x89, 0xa9, 0x9a, 0x08, 0x56, 0x81, 0x9b, 0x90, 0xab, 0x30,
+	0x45, 0x82, 0xac, 0x80, 0xcb, 0x58, 0x23, 0x81, 0xba, 0x8a, 0xfa, 0x38,
+	0x17, 0x88, 0x89, 0x9a, 0x99, 0x20, 0x47, 0xa8, 0x89, 0xb0, 0x8a, 0x31,
+	0x27, 0xa0, 0x8b, 0xb0, 0x9c, 0x72, 0x02, 0x90, 0xaa, 0x88, 0xcb, 0x72,
+	0x03, 0x99, 0xa8, 0x99, 0xaa, 0x73, 0x05, 0xa9, 0x90, 0xa9, 0x1a, 0x52,
+	0x14, 0xb9, 0x1a, 0xe9, 0x09, 0x34, 0x02, 0xb8, 0x8b, 0xc9, 0x0c, 0x46,
+	0x81, 0x99, 0x99, 0x99, 0x0b, 0x56, 0x81, 0x8a, 0xa8, 0xaa, 0x28, 0x64,
+	0x82, 0xab, 0x80, 0xdb, 0x38, 0x25, 0x82, 0xca, 0x88, 0xca, 0x38, 0x27,
+	0x88, 0xa8, 0x99, 0xa9, 0x4a, 0x27, 0xa0, 0x09, 0xb9, 0x8a, 0x48, 0x45,
+	0xa0, 0x8a, 0xa8, 0x9c, 0x42, 0x43, 0xa0, 0xab, 0x90, 0xae, 0x52, 0x04,
+	0x88, 0x9a, 0x99, 0xaa, 0x70, 0x05, 0x98, 0x98, 0xa9, 0x89, 0x61, 0x23,
+	0xc9, 0x88, 0xb9, 0x1b, 0x44, 0x33, 0xd9, 0x89, 0xb8, 0x0d, 0x44, 0x01,
+	0x98, 0x9b, 0xa8, 0x8c, 0x65, 0x81, 0x89, 0x99, 0x9a, 0x88, 0x64, 0x82,
+	0xaa, 0x80, 0xac, 0x28, 0x44, 0x02, 0xbb, 0x88, 0xdb, 0x39, 0x27, 0x00,
+	0x9a, 0x8a, 0xc9, 0x39, 0x27, 0x90, 0x98, 0x9a, 0x9a, 0x29, 0x57, 0x90,
+	0x8a, 0xa0, 0x9b, 0x31, 0x36, 0xa1, 0x9c, 0x90, 0xac, 0x52, 0x13, 0x91,
+	0xbb, 0x89, 0xcc, 0x71, 0x03, 0x98, 0xa8, 0x9a, 0xa9, 0x70, 0x15, 0xa9,
+	0x88, 0xa9, 0x0a, 0x42, 0x25, 0xb8, 0x0b, 0xd8, 0x8a, 0x44, 0x12, 0xa8,
+	0x9b, 0xb8, 0x8d, 0x64, 0x82, 0x98, 0xa9, 0x99, 0x9a, 0x65, 0x82, 0x8a,
+	0x98, 0xab, 0x19, 0x64, 0x83, 0xaa, 0x09, 0xdb, 0x28, 0x34, 0x03, 0xda,
+	0x89, 0xc9, 0x29, 0x27, 0x80, 0xa8, 0x99, 0xa9, 0x1a, 0x57, 0x90, 0x89,
+	0xa8, 0x8a, 0x28, 0x55, 0xa1, 0x8a, 0x98, 0xac, 0x41, 0x33, 0x92, 0xbc,
+	0x88, 0xcc, 0x51, 0x23, 0x88, 0xba, 0x99, 0xbb, 0x78, 0x17, 0x98, 0x89,
+	0xa9, 0x98, 0x40, 0x25, 0xa8, 0x0a, 0xc9, 0x8a, 0x53, 0x23, 0xc0, 0x9a,
+	0xa8, 0x8d, 0x63, 0x02, 0x98, 0xaa, 0x98, 0x9c, 0x73, 0x84, 0x89, 0x99,
+	0xa9, 0x88, 0x72, 0x03, 0xaa, 0x88, 0xcb, 0x18, 0x44, 0x13, 0xcb, 0x88,
+	0xd9, 0x19, 0x35, 0x01, 0xb9, 0x9a, 0xc8, 0x2b, 0x47, 0x91, 0x89, 0x9a,
+	0x9a, 0x19, 0x47, 0x91, 0x9a, 0xa0, 0xab, 0x21, 0x46, 0x81, 0xab, 0x88,
+	0xbc, 0x50, 0x14, 0x81, 0xba, 0x89, 0xda, 0x58, 0x24, 0x98, 0xa8, 0x9a,
+	0xb9, 0x50, 0x27, 0xa8, 0x89, 0xb8, 0x8a, 0x41, 0x35, 0xa8, 0x8b, 0xb8,
+	0x8e, 0x52, 0x12, 0xa0, 0x9b, 0xa8, 0xac, 0x64, 0x12, 0x99, 0xa9, 0xa9,
+	0x9a, 0x73, 0x05, 0x99, 0x98, 0xb9, 0x09, 0x63, 0x14, 0xaa, 0x89, 0xc9,
+	0x1a, 0x35, 0x03, 0xb9, 0x0c, 0xc9, 0x0a, 0x37, 0x81, 0x99, 0x9a, 0x9a,
+	0x0b, 0x57, 0x81, 0x99, 0xa8, 0xaa, 0x28, 0x55, 0x92, 0xaa, 0x90, 0xac,
+	0x48, 0x43, 0x82, 0xbb, 0x89, 0xeb, 0x48, 0x34, 0x88, 0xa9, 0x9a, 0xca,
+	0x48, 0x27, 0x98, 0x89, 0xa9, 0x9a, 0x40, 0x36, 0xa8, 0x8a, 0xb8, 0x9c,
+	0x52, 0x33, 0xb1, 0x9c, 0xa8, 0xac, 0x73, 0x12, 0x90, 0xba, 0x98, 0xac,
+	0x72, 0x04, 0x89, 0x99, 0xa9, 0x89, 0x71, 0x13, 0xb9, 0x88, 0xca, 0x1a,
+	0x63, 0x13, 0xb9, 0x0b, 0xca, 0x0b, 0x37, 0x02, 0xb8, 0xaa, 0xb8, 0x0d,
+	0x46, 0x81, 0x99, 0x99, 0x9a, 0x1a, 0x65, 0x92, 0x99, 0x89, 0xbb, 0x20,
+	0x45, 0x83, 0xbb, 0x88, 0xcc, 0x38, 0x26, 0x81, 0xb9, 0x8a, 0xca, 0x49,
+	0x27, 0x88, 0x99, 0xa9, 0x99, 0x38, 0x47, 0x98, 0x89, 0xa9, 0x9a, 0x31,
+	0x37, 0xa0, 0x9b, 0xa0, 0x9d, 0x51, 0x23, 0x90, 0xbb, 0xa8, 0xbc, 0x72,
+	0x14, 0x98, 0x99, 0x9a, 0xaa, 0x72, 0x14, 0x99, 0x89, 0xba, 0x89, 0x63,
+	0x24, 0xb9, 0x0a, 0xd9, 0x0a, 0x34, 0x14, 0xb8, 0x8b, 0xb9, 0x0d, 0x64,
+	0x01, 0x89, 0x9a, 0xa9, 0x8a, 0x65, 0x82, 0x99, 0x99, 0xaa, 0x19, 0x45,
+	0x03, 0xab, 0x89, 0xcc, 0x28, 0x35, 0x02, 0xca, 0x89, 0xca, 0x39, 0x27,
+	0x81, 0xa9, 0x9a, 0xb9, 0x39, 0x57, 0x90, 0x89, 0xa9, 0x99, 0x28, 0x37,
+	0xa1, 0x9a, 0xa8, 0xac, 0x51, 0x33, 0xa2, 0xac, 0x98, 0xbc, 0x62, 0x23,
+	0x90, 0xba, 0x9a, 0xcb, 0x71, 0x15, 0x89, 0x99, 0xa9, 0x8a, 0x51, 0x25,
+	0xa9, 0x89, 0xc9, 0x0a, 0x52, 0x14, 0xa8, 0x9a, 0xb8, 0x8c, 0x54, 0x12,
+	0xa8, 0xaa, 0xa9, 0x8c, 0x55, 0x02, 0x99, 0xa9, 0xaa, 0x0a, 0x74, 0x03,
+	0xaa, 0x98, 0xbb, 0x29, 0x55, 0x03, 0xba, 0x89, 0xdb, 0x29, 0x26, 0x02,
+	0xaa, 0x9a, 0xba, 0x3b, 0x67, 0x80, 0x98, 0xa9, 0x99, 0x29, 0x46, 0x91,
+	0x8a, 0xa9, 0x9b, 0x30, 0x37, 0xa2, 0xab, 0xa0, 0xad, 0x41, 0x34, 0x80,
+	0xbb, 0x99, 0xbc, 0x70, 0x14, 0x90, 0x99, 0xaa, 0xa9, 0x60, 0x25, 0xa8,
+	0x89, 0xaa, 0x8b, 0x52, 0x35, 0xb8, 0x8a, 0xb9, 0x8d, 0x53, 0x23, 0xa8,
+	0x9c, 0xa8, 0x9c, 0x54, 0x03, 0x99, 0xa9, 0xaa, 0x9a, 0x74, 0x03, 0x99,
+	0x99, 0xbb, 0x09, 0x74, 0x03, 0xaa, 0x89, 0xca, 0x19, 0x35, 0x13, 0xba,
+	0x9b, 0xea, 0x2a, 0x36, 0x82, 0xa9, 0xaa, 0xba, 0x1a, 0x77, 0x91, 0x98,
+	0xa8, 0x99, 0x18, 0x45, 0x81, 0x9b, 0x98, 0xac, 0x40, 0x43, 0x82, 0xbb,
+	0x99, 0xbc, 0x78, 0x23, 0x91, 0xb9, 0xaa, 0xca, 0x68, 0x25, 0x98, 0x99,
+	0xa9, 0x9a, 0x50, 0x35, 0xa8, 0x8a, 0xc9, 0x9a, 0x62, 0x23, 0xa0, 0xab,
+	0xb8, 0x9d, 0x73, 0x12, 0x98, 0xaa, 0x99, 0xab, 0x74, 0x03, 0xa8, 0x99,
+	0xba, 0x99, 0x64, 0x04, 0x99, 0x89, 0xbb, 0x19, 0x54, 0x13, 0xb9, 0x8b,
+	0xda, 0x1a, 0x36, 0x12, 0xb9, 0x9b, 0xba, 0x1c, 0x47, 0x81, 0x98, 0xaa,
+	0xa9, 0x1a, 0x47, 0x92, 0x99, 0xa9, 0xba, 0x20, 0x46, 0x82, 0xba, 0x98,
+	0xbc, 0x40, 0x25, 0x01, 0xba, 0x9a, 0xda, 0x48, 0x16, 0x80, 0x99, 0x9a,
+	0x9a, 0x48, 0x27, 0xa0, 0x89, 0xb9, 0x9a, 0x41, 0x26, 0xa1, 0x8b, 0xa9,
+	0x9c, 0x52, 0x14, 0xa1, 0x9b, 0xa9, 0x9c, 0x72, 0x13, 0x98, 0xaa, 0x9a,
+	0xab, 0x73, 0x06, 0x98, 0x98, 0xaa, 0x09, 0x62, 0x23, 0xaa, 0x8a, 0xda,
+	0x1a, 0x44, 0x22, 0xb9, 0x9b, 0xc9, 0x1b, 0x46, 0x02, 0xa8, 0x9b, 0xaa,
+	0x0b, 0x57, 0x82, 0x99, 0xa9, 0xaa, 0x19, 0x46, 0x83, 0x9b, 0x99, 0xac,
+	0x38, 0x45, 0x82, 0xba, 0x99, 0xda, 0x38, 0x36, 0x80, 0xa9, 0x9b, 0xba,
+	0x59, 0x27, 0x80, 0x99, 0xaa, 0x9a, 0x48, 0x36, 0xa1, 0x9a, 0xb9, 0x9c,
+	0x51, 0x24, 0x91, 0xab, 0xa9, 0xac, 0x62, 0x14, 0x90, 0xaa, 0x99, 0xbb,
+	0x72, 0x15, 0x98, 0x99, 0x9a, 0x9a, 0x62, 0x15, 0x99, 0x89, 0xba, 0x0a,
+	0x63, 0x14, 0xa8, 0x9a, 0xb9, 0x0c, 0x54, 0x12, 0xa8, 0x9b, 0xb9, 0x8b,
+	0x47, 0x02, 0x99, 0xb9, 0xaa, 0x0a, 0x66, 0x82, 0x99, 0x99, 0xba, 0x18,
+	0x55, 0x02, 0xaa, 0x99, 0xcb, 0x28, 0x36, 0x82, 0xb9, 0x9a, 0xcb, 0x39,
+	0x47, 0x80, 0xa8, 0xa9, 0x9a, 0x39, 0x47, 0x80, 0x8a, 0xb9, 0x9a, 0x30,
+	0x37, 0x91, 0x9b, 0xa9, 0xac, 0x51, 0x34, 0x80, 0xbb, 0xa9, 0xbc, 0x72,
+	0x23, 0x90, 0xaa, 0xab, 0xba, 0x71, 0x17, 0x98, 0x89, 0xa9, 0x8a, 0x42,
+	0x25, 0xb8, 0x99, 0xb9, 0x8b, 0x45, 0x23, 0xb0, 0x9c, 0xa9, 0x8c, 0x54,
+	0x03, 0x98, 0xab, 0xaa, 0x8b, 0x66, 0x02, 0x99, 0xa9, 0xaa, 0x09, 0x74,
+	0x02, 0xa9, 0x89, 0xbb, 0x29, 0x36, 0x13, 0xca, 0x8a, 0xca, 0x3a, 0x36,
+	0x02, 0xaa, 0xab, 0xba, 0x4b, 0x47, 0x81, 0x99, 0xaa, 0xaa, 0x38, 0x47,
+	0x91, 0x9a, 0xa8, 0xab, 0x40, 0x35, 0x82, 0xac, 0xa8, 0xbb, 0x61, 0x24,
+	0x81, 0xab, 0xaa, 0xca, 0x60, 0x15, 0x90, 0x99, 0xaa, 0x9a, 0x51, 0x26,
+	0xa8, 0x89, 0xaa, 0x8b, 0x53, 0x34, 0xa8, 0x9b, 0xc9, 0x9b, 0x45, 0x23,
+	0xa8, 0xab, 0xba, 0x9c, 0x65, 0x12, 0x99, 0xa9, 0xaa, 0x8a, 0x74, 0x03,
+	0xa9, 0x99, 0xbb, 0x19, 0x55, 0x03, 0xb9, 0x99, 0xda, 0x19, 0x35, 0x03,
+	0xb9, 0xab, 0xca, 0x1a, 0x57, 0x81, 0xa8, 0xa9, 0xa9, 0x29, 0x46, 0x92,
+	0x99, 0xb9, 0xab, 0x30, 0x47, 0x81, 0xaa, 0x99, 0xbb, 0x50, 0x25, 0x81,
+	0xaa, 0x9a, 0xcb, 0x68, 0x24, 0x80, 0xaa, 0x9a, 0xab, 0x60, 0x25, 0x90,
+	0x8a, 0xba, 0x9b, 0x52, 0x26, 0xa0, 0x8a, 0xb9, 0x8c, 0x52, 0x33, 0xa0,
+	0x9c, 0xa9, 0x9c, 0x73, 0x12, 0x90, 0xba, 0xa9, 0x9b, 0x73, 0x06, 0x98,
+	0x99, 0xa9, 0x09, 0x62, 0x13, 0xa9, 0x8a, 0xcb, 0x1a, 0x45, 0x22, 0xb9,
+	0x9b, 0xca, 0x1a, 0x37, 0x02, 0xa9, 0xba, 0xb9, 0x1b, 0x67, 0x81, 0x98,
+	0xa9, 0x9a, 0x29, 0x55, 0x01, 0xaa, 0xa8, 0xbb, 0x30, 0x37, 0x82, 0xba,
+	0xa9, 0xdb, 0x48, 0x25, 0x81, 0xb9, 0x9a, 0xca, 0x58, 0x25, 0x90, 0x99,
+	0xaa, 0xaa, 0x50, 0x26, 0x90, 0x9a, 0xa9, 0x9b, 0x61, 0x24, 0xa1, 0x9b,
+	0xb9, 0x9c, 0x72, 0x13, 0x90, 0xba, 0xa9, 0xbb, 0x73, 0x16, 0x98, 0x99,
+	0x9a, 0x8a, 0x62, 0x14, 0x99, 0x99, 0xba, 0x0a, 0x54, 0x23, 0xb9, 0x9a,
+	0xda, 0x0a, 0x45, 0x12, 0xa8, 0xab, 0xb9, 0x0c, 0x46, 0x02, 0x99, 0xaa,
+	0xaa, 0x0a, 0x47, 0x02, 0x9a, 0xa9, 0xbb, 0x28, 0x56, 0x82, 0xa9, 0xa9,
+	0xca, 0x38, 0x45, 0x01, 0xaa, 0x9a, 0xbb, 0x59, 0x26, 0x81, 0xa9, 0xaa,
+	0xba, 0x48, 0x37, 0x91, 0x9a, 0x8a, 0x6c, 0x23, 0x00, 0x98, 0xef, 0x89,
+	0x9a, 0x64, 0x23, 0xb8, 0x9b, 0x91, 0xcc, 0x08, 0x25, 0x12, 0x82, 0xbc,
+	0x9a, 0x21, 0xda, 0x39, 0x26, 0x81, 0x99, 0xa8, 0x18, 0xd0, 0x9d, 0x30,
+	0x27, 0x88, 0x08, 0x99, 0xbb, 0x9a, 0x8a, 0x77, 0x02, 0xa8, 0x8a, 0x90,
+	0x9c, 0x10, 0x43, 0x22, 0x91, 0xbe, 0x18, 0x00, 0xca, 0x38, 0x16, 0x00,
+	0x98, 0x89, 0x19, 0xf8, 0x8c, 0x41, 0x23, 0x90, 0x80, 0xca, 0xaa, 0xab,
+	0x29, 0x77, 0x83, 0x9a, 0x89, 0xa8, 0x9b, 0x32, 0x42, 0x24, 0xb1, 0xaf,
+	0x20, 0xa0, 0xaa, 0x58, 0x14, 0x08, 0x90, 0x89, 0x88, 0xfb, 0x8c, 0x53,
+	0x22, 0x90, 0x98, 0xca, 0x99, 0xbb, 0x60, 0x46, 0x90, 0x8a, 0x98, 0x99,
+	0x8a, 0x32, 0x41, 0x15, 0xb8, 0x9d, 0x30, 0xc8, 0x8a, 0x31, 0x15, 0x00,
+	0xa0, 0x8a, 0xa0, 0xce, 0x0b, 0x46, 0x11, 0x80, 0x9a, 0xba, 0x99, 0xcb,
+	0x72, 0x25, 0xa0, 0x9a, 0x90, 0x9a, 0x88, 0x22, 0x52, 0x15, 0xca, 0x8a,
+	0x22, 0xda, 0x1b, 0x31, 0x33, 0x11, 0xb0, 0x8d, 0xb0, 0xcf, 0x19, 0x36,
+	0x01, 0x80, 0xab, 0x9a, 0x9b, 0x9b, 0x75, 0x05, 0x98, 0x99, 0x88, 0x8a,
+	0x80, 0x10, 0x44, 0x13, 0xdc, 0x08, 0x82, 0xca, 0x1a, 0x13, 0x43, 0x82,
+	0xb8, 0x8b, 0xd8, 0xaf, 0x38, 0x45, 0x81, 0x90, 0xba, 0x99, 0xaa, 0x09,
+	0x57, 0x03, 0xa9, 0x9a, 0x98, 0x8a, 0x82, 0x2a, 0x47, 0x82, 0xbc, 0x20,
+	0x91, 0xad, 0x19, 0x22, 0x44, 0x92, 0xaa, 0x99, 0xe8, 0xad, 0x42, 0x43,
+	0x81, 0xa8, 0xbb, 0x89, 0xba, 0x49, 0x47, 0x82, 0xa9, 0x99, 0x99, 0x88,
+	0x91, 0x3a, 0x67, 0x90, 0x9a, 0x20, 0xb0, 0xad, 0x00, 0x32, 0x35, 0xa2,
+	0x9c, 0x88, 0xdb, 0x9c, 0x63, 0x13, 0x81, 0xb9, 0xba, 0x89, 0xba, 0x78,
+	0x25, 0x82, 0x9b, 0xa9, 0x89, 0x80, 0xa9, 0x69, 0x27, 0xa8, 0x89, 0x11,
+	0xd9, 0x9b, 0x10, 0x52, 0x34, 0xa0, 0x9c, 0x90, 0xcc, 0x0a, 0x54, 0x13,
+	0x90, 0xc9, 0x99, 0x09, 0xb9, 0x61, 0x24, 0x80, 0xaa, 0x99, 0x09, 0x91,
+	0x9d, 0x60, 0x24, 0xb8, 0x19, 0x81, 0xeb, 0x9a, 0x10, 0x73, 0x23, 0xa9,
+	0x8c, 0x90, 0xbd, 0x28, 0x54, 0x02, 0x90, 0xba, 0x9a, 0x88, 0x9a, 0x71,
+	0x15, 0x90, 0xa9, 0x88, 0x88, 0xa0, 0x9d, 0x63, 0x13, 0xa9, 0x28, 0xc0,
+	0xcb, 0x9a, 0x20, 0x66, 0x02, 0xb9, 0x89, 0xa8, 0xbd, 0x31, 0x35, 0x03,
+	0xa8, 0xdb, 0x89, 0x90, 0x8a, 0x73, 0x13, 0x98, 0xa9, 0x0a, 0x80, 0xda,
+	0x8c, 0x55, 0x01, 0x98, 0x10, 0xc9, 0xab, 0x9a, 0x50, 0x46, 0x81, 0xaa,
+	0x09, 0xb9, 0x9d, 0x42, 0x33, 0x12, 0xc9, 0xcb, 0x08, 0xa0, 0x0a, 0x54,
+	0x13, 0x99, 0xa9, 0x1a, 0x91, 0xce, 0x1a, 0x55, 0x01, 0x09, 0x88, 0xc9,
+	0x9b, 0x9a, 0x71, 0x35, 0x90, 0xab, 0x80, 0xcb, 0x8a, 0x44, 0x22, 0x12,
+	0xda, 0x9b, 0x00, 0xb0, 0x1b, 0x46, 0x02, 0x99, 0x98, 0x09, 0xa0, 0xbf,
+	0x39, 0x45, 0x82, 0x08, 0x99, 0xcb, 0xab, 0x9a, 0x74, 0x16, 0x98, 0x8a,
+	0x88, 0xba, 0x19, 0x34, 0x23, 0x03, 0xec, 0x0a, 0x00, 0xb8, 0x19, 0x35,
+	0x02, 0x98, 0x99, 0x89, 0xd0, 0xaf, 0x30, 0x25, 0x82, 0x88, 0xb9, 0xbb,
+	0xbc, 0x09, 0x67, 0x13, 0xa9, 0x9a, 0x98, 0xac, 0x20, 0x33, 0x25, 0x92,
+	0xdc, 0x19, 0x81, 0xba, 0x29, 0x36, 0x00, 0x90, 0x99, 0x88, 0xf9, 0xac,
+	0x51, 0x33, 0x01, 0x99, 0xca, 0xaa, 0xbb, 0x4a, 0x67, 0x01, 0xa9, 0x98,
+	0x99, 0x99, 0x20, 0x33, 0x35, 0xb1, 0xcd, 0x28, 0xa1, 0xab, 0x38, 0x26,
+	0x01, 0x80, 0x9a, 0x98, 0xec, 0x9c, 0x53, 0x23, 0x01, 0xb9, 0xba, 0xac,
+	0xba, 0x78, 0x45, 0x81, 0xaa, 0x98, 0xa9, 0x89, 0x21, 0x42, 0x35, 0xc8,
+	0xab, 0x30, 0xc0, 0x9c, 0x21, 0x43, 0x12, 0x90, 0xab, 0xa8, 0xdf, 0x8a,
+	0x54, 0x12, 0x00, 0xaa, 0xaa, 0xba, 0xaa, 0x72, 0x27, 0x90, 0xa9, 0x88,
+	0x9a, 0x08, 0x10, 0x52, 0x24, 0xc9, 0x8b, 0x12, 0xd9, 0x9b, 0x32, 0x43,
+	0x23, 0xa8, 0x9c, 0xa9, 0xcf, 0x19, 0x54, 0x12, 0x88, 0xba, 0x9a, 0xb9,
+	0x0b, 0x74, 0x24, 0x98, 0xaa, 0x98, 0x9a, 0x10, 0x09, 0x55, 0x03, 0xca,
+	0x1a, 0x02, 0xcc, 0x8a, 0x32, 0x53, 0x13, 0xb9, 0xaa, 0xc9, 0xbf, 0x38,
+	0x36, 0x12, 0x99, 0xca, 0x8a, 0xa9, 0x1a, 0x46, 0x14, 0x99, 0x9a, 0x99,
+	0x89, 0x80, 0x09, 0x66, 0x81, 0xa9, 0x29, 0xa1, 0xbd, 0x09, 0x32, 0x35,
+	0x04, 0xba, 0x99, 0xda, 0xbc, 0x51, 0x34, 0x02, 0xa9, 0xbb, 0x8b, 0xba,
+	0x39, 0x77, 0x11, 0x99, 0x8a, 0x8a, 0x80, 0x98, 0x19, 0x47, 0x91, 0x9a,
+	0x11, 0xb8, 0xae, 0x08, 0x41, 0x34, 0x82, 0xcb, 0x88, 0xdb, 0x9b, 0x62,
+	0x24, 0x81, 0xa9, 0xab, 0x99, 0xa9, 0x48, 0x37, 0x82, 0xa9, 0xaa, 0x89,
+	0x00, 0xcb, 0x48, 0x37, 0x90, 0x0a, 0x00, 0xda, 0xbb, 0x18, 0x73, 0x24,
+	0x91, 0xbb, 0x88, 0xdc, 0x0a, 0x63, 0x13, 0x91, 0xb9, 0xab, 0x98, 0x99,
+	0x68, 0x35, 0x80, 0xa9, 0x9a, 0x88, 0x90, 0xbd, 0x61, 0x24, 0x90, 0x09,
+	0x91, 0xbd, 0xab, 0x18, 0x65, 0x14, 0xa8, 0x9a, 0x98, 0xbc, 0x29, 0x45,
+	0x13, 0x90, 0xca, 0x8b, 0x88, 0x99, 0x51, 0x35, 0x90, 0xa9, 0x9a, 0x00,
+	0xc9, 0xac, 0x72, 0x23, 0x90, 0x19, 0xb8, 0xae, 0xaa, 0x28, 0x47, 0x13,
+	0xb9, 0x9a, 0xa9, 0xbd, 0x40, 0x34, 0x22, 0xa8, 0xbc, 0x8a, 0x80, 0x9b,
+	0x63, 0x25, 0x88, 0xa9, 0x99, 0x81, 0xea, 0x8b, 0x73, 0x13, 0x88, 0x88,
+	0xc8, 0xac, 0xa9, 0x30, 0x57, 0x82, 0xa9, 0x89, 0xaa, 0x9c, 0x41, 0x24,
+	0x12, 0xb8, 0xbc, 0x08, 0xa0, 0x9a, 0x54, 0x23, 0x90, 0x9a, 0x8a, 0x80,
+	0xcf, 0x0a, 0x35, 0x04, 0x80, 0x98, 0xca, 0xab, 0xaa, 0x71, 0x36, 0x80,
+	0x9b, 0x89, 0xca, 0x89, 0x42, 0x33, 0x13, 0xd9, 0xac, 0x10, 0xa8, 0x8a,
+	0x44, 0x23, 0x98, 0x99, 0x89, 0xb8, 0xef, 0x29, 0x53, 0x02, 0x80, 0xa9,
+	0xbb, 0xcb, 0x8a, 0x73, 0x27, 0x98, 0x99, 0x89, 0xaa, 0x19, 0x42, 0x33,
+	0x03, 0xfa, 0x8b, 0x01, 0xa9, 0x0a, 0x35, 0x13, 0x80, 0x9a, 0x89, 0xea,
+	0xcd, 0x38, 0x35, 0x12, 0x98, 0xb9, 0xbc, 0xba, 0x1b, 0x67, 0x13, 0xb8,
+	0x99, 0xa9, 0xaa, 0x28, 0x43, 0x44, 0x82, 0xbc, 0x0b, 0x02, 0xbc, 0x19,
+	0x35, 0x13, 0x81, 0xaa, 0x99, 0xec, 0xad, 0x40, 0x25, 0x11, 0xa8, 0xaa,
+	0xab, 0xbb, 0x3a, 0x77, 0x03, 0xa9, 0x99, 0xa9, 0x99, 0x11, 0x42, 0x34,
+	0x91, 0xbd, 0x19, 0x92, 0xbd, 0x20, 0x43, 0x13, 0x81, 0xaa, 0xaa, 0xfd,
+	0xaa, 0x52, 0x34, 0x00, 0xa8, 0xbb, 0xba, 0xbb, 0x78, 0x36, 0x01, 0xaa,
+	0x9a, 0xa9, 0x89, 0x11, 0x52, 0x35, 0xb0, 0x9d, 0x10, 0xb0, 0xac, 0x20,
+	0x34, 0x33, 0xa1, 0xca, 0xa9, 0xde, 0x8a, 0x63, 0x33, 0x80, 0xb9, 0x9c,
+	0xaa, 0x9a, 0x71, 0x25, 0x91, 0xa9, 0x9a, 0x99, 0x08, 0x80, 0x72, 0x23,
+	0xb8, 0x8c, 0x11, 0xca, 0xac, 0x31, 0x53, 0x23, 0xa0, 0xab, 0xba, 0xdf,
+	0x09, 0x44, 0x23, 0x90, 0xba, 0xbb, 0xa9, 0x9b, 0x75, 0x23, 0x90, 0xaa,
+	0xaa, 0x89, 0x08, 0x88, 0x73, 0x16, 0xa9, 0x09, 0x81, 0xdb, 0x9a, 0x31,
+	0x44, 0x23, 0xb8, 0xab, 0xca, 0xbe, 0x39, 0x46, 0x12, 0x98, 0xba, 0xaa,
+	0xa9, 0x09, 0x65, 0x23, 0xa8, 0xaa, 0x9a, 0x09, 0x98, 0x0a, 0x57, 0x02,
+	0xb9, 0x00, 0xa1, 0xbe, 0x89, 0x31, 0x36, 0x13, 0xc9, 0x9a, 0xd9, 0xbb,
+	0x50, 0x35, 0x02, 0xa8, 0xbb, 0x9b, 0xa9, 0x19, 0x57, 0x12, 0xa8, 0x9a,
+	0x8a, 0x08, 0xb9, 0x2a, 0x57, 0x82, 0x99, 0x00, 0xc8, 0xbc, 0x09, 0x41,
+	0x36, 0x02, 0xbb, 0x99, 0xdb, 0x9c, 0x52, 0x24, 0x01, 0xa9, 0xbb, 0x99,
+	0x99, 0x28, 0x57, 0x01, 0x98, 0xaa, 0x09, 0x88, 0xca, 0x38, 0x37, 0x81,
+	0x89, 0x00, 0xeb, 0xab, 0x09, 0x72, 0x34, 0x90, 0xaa, 0x99, 0xeb, 0x0a,
+	0x53, 0x33, 0x81, 0xca, 0xab, 0x98, 0x98, 0x38, 0x47, 0x82, 0x99, 0xaa,
+	0x08, 0x98, 0xbd, 0x50, 0x34, 0x81, 0x09, 0x98, 0xcd, 0xaa, 0x19, 0x64,
+	0x24, 0x98, 0x9b, 0x99, 0xdb, 0x19, 0x44, 0x23, 0x80, 0xcb, 0x9b, 0x80,
+	0x99, 0x40, 0x35, 0x82, 0x9a, 0x9b, 0x08, 0xe9, 0x9c, 0x60, 0x23, 0x81,
+	0x08, 0xb9, 0xcd, 0x9a, 0x29, 0x56, 0x13, 0xa9, 0x9a, 0xaa, 0xac, 0x38,
+	0x45, 0x22, 0x90, 0xbc, 0x8a, 0x80, 0x9a, 0x51, 0x34, 0x81, 0x9a, 0x8a,
+	0x88, 0xec, 0x9b, 0x63, 0x14, 0x00, 0x88, 0xba, 0xbc, 0x9b, 0x48, 0x57,
+	0x01, 0xa9, 0x89, 0xaa, 0x9b, 0x41, 0x34, 0x23, 0xa8, 0xae, 0x09, 0x90,
+	0x9a, 0x61, 0x23, 0x80, 0x99, 0x89, 0x99, 0xed, 0x0a, 0x53, 0x23, 0x01,
+	0xa9, 0xbc, 0xcb, 0x9b, 0x71, 0x35, 0x81, 0xaa, 0x9a, 0xba, 0x0b, 0x52,
+	0x34, 0x13, 0xd8, 0xbb, 0x10, 0xa8, 0x8c, 0x52, 0x23, 0x81, 0x99, 0x89,
+	0xca, 0xce, 0x1a, 0x45, 0x22, 0x80, 0xb9, 0xcb, 0xba, 0x8b, 0x74, 0x24,
+	0xa1, 0x9a, 0xa9, 0xba, 0x19, 0x43, 0x44, 0x02, 0xc9, 0xab, 0x11, 0xc9,
+	0x0b, 0x53, 0x33, 0x00, 0x99, 0x9a, 0xeb, 0xbd, 0x29, 0x37, 0x13, 0x90,
+	0xba, 0xbc, 0xba, 0x0a, 0x57, 0x23, 0xa8, 0xaa, 0xa9, 0xab, 0x10, 0x43,
+	0x54, 0x82, 0xca, 0x8a, 0x01, 0xcb, 0x1a, 0x53, 0x23, 0x01, 0xa9, 0x9a,
+	0xfc, 0xbb, 0x40, 0x45, 0x02, 0x98, 0xba, 0xba, 0xba, 0x3a, 0x77, 0x02,
+	0xa8, 0x99, 0x99, 0x8a, 0x10, 0x31, 0x35, 0x82, 0xbd, 0x08, 0x91, 0xbc,
+	0x2a, 0x44, 0x23, 0x02, 0xba, 0xba, 0xed, 0xab, 0x61, 0x34, 0x01, 0x99,
+	0xbb, 0xab, 0xbb, 0x50, 0x37, 0x83, 0xa9, 0xaa, 0xaa, 0x89, 0x01, 0x51,
+	0x26, 0x91, 0x9c, 0x18, 0xb0, 0xad, 0x18, 0x34, 0x43, 0x81, 0xba, 0xaa,
+	0xce, 0x8b, 0x63, 0x24, 0x81, 0xa9, 0xab, 0x9b, 0x9b, 0x71, 0x25, 0x82,
+	0xaa, 0xaa, 0x99, 0x08, 0x88, 0x62, 0x25, 0xb0, 0x8a, 0x10, 0xda, 0x9c,
+	0x28, 0x53, 0x33, 0x91, 0xac, 0xb9, 0xcd, 0x0a, 0x54, 0x33, 0x80, 0xbb,
+	0xbb, 0xaa, 0x9a, 0x74, 0x24, 0x91, 0x9a, 0xaa, 0x89, 0x88, 0x89, 0x72,
+	0x15, 0xa8, 0x09, 0x81, 0xcc, 0x9a, 0x20, 0x54, 0x23, 0xa8, 0xab, 0xc9,
+	0xbd, 0x29, 0x46, 0x22, 0x98, 0xba, 0x9b, 0x9a, 0x89, 0x55, 0x14, 0x90,
+	0xa9, 0x9a, 0x09, 0xa8, 0x8a, 0x65, 0x13, 0x99, 0x19, 0xa8, 0xbe, 0x8b,
+	0x30, 0x47, 0x12, 0xb8, 0xaa, 0xc9, 0xac, 0x30, 0x37, 0x02, 0x98, 0xbb,
+	0x9b, 0x99, 0x19, 0x65, 0x13, 0x98, 0xaa, 0x9a, 0x80, 0xba, 0x1c, 0x37,
+	0x13, 0x99, 0x00, 0xda, 0xcc, 0x89, 0x31, 0x37, 0x83, 0xb9, 0xaa, 0xcb,
+	0x9c, 0x51, 0x34, 0x02, 0xa9, 0xac, 0x8a, 0x99, 0x10, 0x45, 0x23, 0xa9,
+	0xba, 0x89, 0x88, 0xcd, 0x29, 0x46, 0x01, 0x88, 0x80, 0xcb, 0xac, 0x8a,
+	0x72, 0x34, 0x91, 0xaa, 0x9a, 0xcb, 0x8b, 0x54, 0x33, 0x01, 0xc9, 0xbb,
+	0x89, 0x98, 0x28, 0x37, 0x03, 0xa8, 0xab, 0x88, 0xb8, 0xbf, 0x48, 0x35,
+	0x01, 0x80, 0xa8, 0xdc, 0xaa, 0x89, 0x64, 0x24, 0xa0, 0x9a, 0xa9, 0xbb,
+	0x1a, 0x55, 0x23, 0x81, 0xda, 0x9a, 0x08, 0x99, 0x38, 0x35, 0x03, 0xa9,
+	0x9a, 0x89, 0xea, 0xad, 0x41, 0x34, 0x02, 0x90, 0xc9, 0xbc, 0xab, 0x19,
+	0x57, 0x23, 0xb8, 0x9a, 0xba, 0xbb, 0x38, 0x46, 0x23, 0x91, 0xdb, 0x9a,
+	0x80, 0x99, 0x48, 0x44, 0x01, 0xa8, 0x89, 0xa8, 0xeb, 0x9c, 0x51, 0x24,
+	0x01, 0x90, 0xca, 0xbb, 0xbb, 0x58, 0x46, 0x03, 0xa9, 0xaa, 0xb9, 0x8c,
+	0x30, 0x44, 0x23, 0xa0, 0xbd, 0x09, 0x90, 0xaa, 0x41, 0x25, 0x02, 0xa8,
+	0x89, 0xb9, 0xce, 0x8b, 0x73, 0x23, 0x01, 0xa8, 0xdb, 0xba, 0xaa, 0x61,
+	0x45, 0x81, 0xa9, 0x99, 0xba, 0x89, 0x41, 0x43, 0x14, 0xb8, 0xbb, 0x19,
+	0xa8, 0x9d, 0x51, 0x33, 0x11, 0x98, 0x9a, 0xea, 0xcc, 0x0a, 0x54, 0x23,
+	0x81, 0xb9, 0xac, 0xbb, 0x9b, 0x74, 0x24, 0x91, 0xa9, 0xaa, 0xaa, 0x09,
+	0x42, 0x53, 0x13, 0xc9, 0x9b, 0x18, 0xc9, 0x9b, 0x53, 0x24, 0x02, 0xa0,
+	0xa9, 0xeb, 0xad, 0x19, 0x45, 0x23, 0x90, 0xba, 0xcb, 0xab, 0x0a, 0x75,
+	0x13, 0x90, 0xaa, 0xa9, 0xaa, 0x18, 0x32, 0x45, 0x13, 0xcb, 0x0b, 0x00,
+	0xeb, 0x0a, 0x42, 0x33, 0x13, 0xa9, 0xbb, 0xdd, 0xbc, 0x38, 0x37, 0x13,
+	0x98, 0xbb, 0xcb, 0xaa, 0x29, 0x47, 0x13, 0x98, 0xab, 0xaa, 0x8a, 0x18,
+	0x31, 0x47, 0x82, 0xba, 0x09, 0x90, 0xcd, 0x09, 0x42, 0x24, 0x12, 0xb9,
+	0xba, 0xdc, 0x9c, 0x40, 0x35, 0x02, 0xa8, 0xbb, 0xbb, 0xab, 0x40, 0x47,
+	0x12, 0xa9, 0xaa, 0x9a, 0x88, 0x08, 0x40, 0x36, 0x81, 0xab, 0x18, 0xd8,
+	0xbc, 0x19, 0x63, 0x33, 0x02, 0xba, 0xac, 0xdc, 0x9a, 0x62, 0x43, 0x01,
+	0xb9, 0xba, 0xaa, 0x9a, 0x51, 0x36, 0x82, 0xa9, 0xba, 0x8a, 0x88, 0x89,
+	0x61, 0x35, 0x90, 0x9a, 0x00, 0xea, 0x9c, 0x08, 0x63, 0x23, 0x81, 0xba,
+	0xbb, 0xcd, 0x8a, 0x64, 0x32, 0x80, 0xb9, 0xbb, 0x9a, 0x8a, 0x63, 0x25,
+	0x82, 0xaa, 0xba, 0x89, 0x90, 0xaa, 0x73, 0x25, 0x90, 0x89, 0x80, 0xdc,
+	0xaa, 0x10, 0x54, 0x14, 0x90, 0xaa, 0xaa, 0xcc, 0x29, 0x54, 0x13, 0x90,
+	0xba, 0xab, 0x9a, 0x09, 0x54, 0x34, 0x80, 0xba, 0xaa, 0x88, 0xb8, 0x9c,
+	0x74, 0x13, 0x88, 0x88, 0xa8, 0xcd, 0xaa, 0x30, 0x46, 0x13, 0xa8, 0xab,
+	0xca, 0xac, 0x38, 0x37, 0x12, 0x98, 0xbb, 0xab, 0x99, 0x18, 0x64, 0x23,
+	0x80, 0xbb, 0x9a, 0x88, 0xda, 0x0b, 0x65, 0x12, 0x80, 0x88, 0xc9, 0xbc,
+	0x9b, 0x51, 0x45, 0x02, 0xa9, 0xaa, 0xca, 0x9b, 0x51, 0x44, 0x11, 0xa8,
+	0xbb, 0x9a, 0x98, 0x08, 0x45, 0x14, 0x90, 0xaa, 0x89, 0x98, 0xcc, 0x1a,
+	0x46, 0x02, 0x00, 0x98, 0xcb, 0xbc, 0x8a, 0x71, 0x34, 0x82, 0xba, 0xaa,
+	0xcb, 0x0b, 0x72, 0x23, 0x02, 0xb9, 0xac, 0x89, 0x89, 0x19, 0x45, 0x13,
+	0xa0, 0x9a, 0x89, 0xc9, 0xae, 0x29, 0x36, 0x13, 0x80, 0xa9, 0xbd, 0xbc,
+	0x89, 0x64, 0x24, 0x91, 0xaa, 0xaa, 0xbb, 0x1a, 0x45, 0x24, 0x01, 0xca,
+	0xaa, 0x88, 0x98, 0x29, 0x45, 0x12, 0x98, 0x99, 0x89, 0xeb, 0xac, 0x30,
+	0x36, 0x13, 0x90, 0xca, 0xcb, 0xbb, 0x19, 0x57, 0x13, 0x98, 0xaa, 0xaa,
+	0xac, 0x10, 0x44, 0x23, 0x92, 0xdb, 0x9a, 0x80, 0xa9, 0x28, 0x36, 0x12,
+	0x90, 0x99, 0xa9, 0xdd, 0x9c, 0x40, 0x25, 0x12, 0x98, 0xca, 0xbb, 0xab,
+	0x49, 0x47, 0x12, 0xa8, 0xaa, 0xba, 0x9a, 0x30, 0x35, 0x25, 0x90, 0xcb,
+	0x89, 0x90, 0xba, 0x30, 0x36, 0x13, 0x88, 0xa9, 0xc9, 0xce, 0x9a, 0x52,
+	0x25, 0x01, 0x98, 0xbb, 0xac, 0x9b, 0x50, 0x36, 0x02, 0xb9, 0xaa, 0xba,
+	0x8a, 0x41, 0x53, 0x14, 0xa0, 0xac, 0x08, 0x98, 0x9c, 0x30, 0x44, 0x12,
+	0x91, 0xa9, 0xcb, 0xce, 0x89, 0x53, 0x34, 0x81, 0xb9, 0xbb, 0xac, 0x8b,
+	0x72, 0x25, 0x81, 0xa9, 0xaa, 0xaa, 0x88, 0x22, 0x44, 0x14, 0xb8, 0xab,
+	0x00, 0xd9, 0x9b, 0x50, 0x43, 0x22, 0x90, 0xaa, 0xcc, 0xbd, 0x19, 0x64,
+	0x23, 0x80, 0xba, 0xbb, 0xac, 0x09, 0x73, 0x15, 0x91, 0xa9, 0x9a, 0x9a,
+	0x80, 0x21, 0x44, 0x23, 0xca, 0x8a, 0x80, 0xdb, 0x9b, 0x42, 0x35, 0x22,
+	0x98, 0xbb, 0xdc, 0xac, 0x39, 0x46, 0x12, 0x90, 0xba, 0xbb, 0xab, 0x29,
+	0x47, 0x14, 0x98, 0xa9, 0xaa, 0x89, 0x08, 0x20, 0x55, 0x02, 0xaa, 0x09,
+	0xa0, 0xcd, 0x8a, 0x42, 0x34, 0x13, 0xa8, 0xbc, 0xdb, 0xac, 0x40, 0x35,
+	0x13, 0xb8, 0xbb, 0xac, 0x9a, 0x38, 0x47, 0x12, 0xa8, 0xaa, 0xaa, 0x88,
+	0x88, 0x48, 0x45, 0x82, 0xa9, 0x08, 0xc8, 0xbd, 0x89, 0x53, 0x34, 0x03,
+	0xba, 0xbb, 0xcd, 0x9b, 0x71, 0x43, 0x01, 0xa9, 0xba, 0xaa, 0x9a, 0x51,
+	0x44, 0x02, 0xa8, 0xab, 0x9a, 0x88, 0xa9, 0x60, 0x35, 0x81, 0x99, 0x80,
+	0xeb, 0xac, 0x08, 0x62, 0x24, 0x81, 0xb9, 0xba, 0xcc, 0x0a, 0x63, 0x24,
+	0x81, 0xb9, 0xab, 0xaa, 0x89, 0x52, 0x35, 0x01, 0xa9, 0xab, 0x8a, 0x98,
+	0x9c, 0x61, 0x34, 0x81, 0x88, 0xa8, 0xcd, 0x9c, 0x19, 0x54, 0x14, 0x91,
+	0xaa, 0xba, 0xbc, 0x19, 0x55, 0x23, 0x80, 0xca, 0xaa, 0x99, 0x88, 0x52,
+	0x24, 0x01, 0xaa, 0x9b, 0x98, 0xb9, 0x9d, 0x72, 0x33, 0x00, 0x88, 0xb9,
+	0xbf, 0xaa, 0x38, 0x46, 0x14, 0x98, 0xaa, 0xba, 0xac, 0x38, 0x55, 0x12,
+	0x90, 0xca, 0x9a, 0x88, 0x09, 0x42, 0x25, 0x80, 0xa9, 0x8a, 0x98, 0xdb,
+	0x8a, 0x73, 0x23, 0x01, 0x88, 0xdb, 0xbc, 0xaa, 0x41, 0x46, 0x12, 0xa9,
+	0xaa, 0xbb, 0x9c, 0x41, 0x44, 0x12, 0xa0, 0xac, 0x9a, 0x88, 0x09, 0x53,
+	0x24, 0x80, 0xaa, 0x89, 0xa9, 0xcd, 0x0a, 0x45, 0x23, 0x01, 0x99, 0xcc,
+	0xac, 0x9a, 0x52, 0x26, 0x82, 0xa9, 0xaa, 0xbb, 0x8b, 0x63, 0x34, 0x12,
+	0xb9, 0xbc, 0x89, 0x98, 0x09, 0x44, 0x24, 0x80, 0x9a, 0x89, 0xca, 0xbd,
+	0x2a, 0x46, 0x22, 0x81, 0xa9, 0xcc, 0xbb, 0x0a, 0x73, 0x25, 0x81, 0xaa,
+	0xaa, 0xab, 0x1a, 0x44, 0x24, 0x02, 0xc9, 0xab, 0x88, 0xa8, 0x09, 0x45,
+	0x23, 0x80, 0xa9, 0x99, 0xdc, 0xbc, 0x38, 0x46, 0x22, 0x90, 0xb9, 0xcc,
+	0xaa, 0x09, 0x65, 0x22, 0x90, 0xaa, 0xba, 0xaa, 0x29, 0x54, 0x23, 0x82,
+	0xda, 0x9a, 0x08, 0xaa, 0x19, 0x45, 0x22, 0x81, 0x99, 0xb9, 0xdd, 0x9c,
+	0x30, 0x45, 0x22, 0x98, 0xbb, 0xbc, 0xab, 0x39, 0x67, 0x02, 0xa0, 0xa9,
+	0xaa, 0x8a, 0x10, 0x34, 0x34, 0x91, 0xdb, 0x89, 0x90, 0xab, 0x29, 0x45,
+	0x23, 0x81, 0xa8, 0xcb, 0xdd, 0x9a, 0x41, 0x35, 0x03, 0xa8, 0xac, 0xac,
+	0x9a, 0x40, 0x36, 0x02, 0xa8, 0xbb, 0xba, 0x89, 0x30, 0x54, 0x33, 0xa1,
+	0xad, 0x09, 0xa8, 0xac, 0x28, 0x45, 0x23, 0x00, 0xb9, 0xdb, 0xcc, 0x8b,
+	0x63, 0x34, 0x01, 0xb9, 0xbb, 0xac, 0x9a, 0x62, 0x35, 0x81, 0xa9, 0xba,
+	0xaa, 0x88, 0x11, 0x54, 0x33, 0xa8, 0x9c, 0x88, 0xc9, 0xac, 0x30, 0x54,
+	0x32, 0x80, 0xba, 0xeb, 0xcb, 0x1a, 0x54, 0x33, 0x81, 0xca, 0xab, 0xbb,
+	0x09, 0x64, 0x24, 0x91, 0xa9, 0xab, 0x9a, 0x08, 0x10, 0x64, 0x13, 0xa8,
+	0x9a, 0x90, 0xfb, 0x9a, 0x20, 0x45, 0x13, 0x90, 0xba, 0xcc, 0xcb, 0x18,
+	0x36, 0x24, 0x90, 0xba, 0xbb, 0xab, 0x29, 0x65, 0x23, 0x90, 0xba, 0xab,
+	0x89, 0x98, 0x10, 0x56, 0x12, 0x99, 0x89, 0xa0, 0xbe, 0x8b, 0x41, 0x45,
+	0x12, 0x98, 0xbb, 0xbc, 0x9d, 0x38, 0x46, 0x12, 0x98, 0xbb, 0xba, 0x9a,
+	0x20, 0x46, 0x23, 0x98, 0xbb, 0x9b, 0x89, 0x99, 0x39, 0x57, 0x02, 0x98,
+	0x08, 0xc9, 0xbd, 0x0a, 0x51, 0x44, 0x02, 0xa9, 0xba, 0xdb, 0x9b, 0x61,
+	0x04,
+};
@@ -0,0 +1,301 @@
+/***********************************************************************
+ *
+ * Configuration library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/* Definitions -------------------------------------------------------*/
+#ifndef F_CPU
+#define F_CPU 16000000UL
+#endif
+
+/* Includes ----------------------------------------------------------*/
+#include <stddef.h>         // offsetof
+#include <string.h>         // memcpy
+#include <avr/pgmspace.h>   // Field table
+#include <util/atomic.h>    // ATOMIC_BLOCK
+#include "config.h"
+#include "bus.h"            // Stream mode batches
+#include "cpuclk.h"         // Quarter clock
+#include "eemap.h"          // EEPROM layout
+#include "eeq.h"            // EEPROM access
+#include "frame.h"          // frame_crc16
+#include "relay.h"          // Relay defaults
+#include "rtc.h"            // Local time
+#include "uart.h"           // UART_BAUD_SELECT
+
+#define CONFIG_MAGIC    0xC7
+
+// Bank header, the magic byte is written last
+#define HDR_MAGIC       0
+#define HDR_GEN         1
+#define HDR_SCHEMA      2
+#define HDR_LEN         3
+#define HDR_CRC         4
+
+typedef struct {
+	const char *name;                   // In program memory
+	uint8_t offset;                     // In config_t
+	uint8_t size;                       // 1 or 2
+	uint16_t min;
+	uint16_t max;
+	uint16_t def;
+} config_field_t;
+
+/* Global Variables --------------------------------------------------*/
+static const char nameEntry[] PROGMEM = "entry";
+static const char nameHold[] PROGMEM = "hold";
+static const char nameUnlock[] PROGMEM = "unlock";
+static const char namePullIn[] PROGMEM = "pullin";
+static const char nameHoldDuty[] PROGMEM = "duty";
+static const char nameBaud[] PROGMEM = "baud";
+static const char nameWindow[] PROGMEM = "window";
+static const char nameEvents[] PROGMEM = "batch";
+static const char nameTz[] PROGMEM = "tz";
+
+// CONFIG_... order
+static const config_field_t configFields[CONFIG_FIELDS] PROGMEM = {
+	{nameEntry, offsetof(config_t, entry), 1, 1, 60, CONFIG_ENTRY_S},
+	{nameHold, offsetof(config_t, hold), 1, 1, 60, CONFIG_HOLD_S},
+	{nameUnlock, offsetof(config_t, unlock), 1, 1, RELAY_UNLOCK_MAX_S, RELAY_UNLOCK_S},
+	{namePullIn, offsetof(config_t, pullIn), 1, 1, 63, RELAY_PULL_IN},
+	{nameHoldDuty, offsetof(config_t, holdDuty), 1, 0, 255, RELAY_HOLD_DUTY},
+	{nameBaud, offsetof(config_t, baud), 2, 1200, 19200, CONFIG_BAUD_BD},
+	{nameWindow, offsetof(config_t, batchWindow), 1, 1, 255, BUS_BATCH_WINDOW},
+	{nameEvents, offsetof(config_t, batchEvents), 1, 0, BUS_EVENTS_MAX, BUS_BATCH_EVENTS},
+	{nameTz, offsetof(config_t, tz), 1, 0, CONFIG_TZ_MAX, CONFIG_TZ_UTC},
+};
+
+// Defaults until config_init(), the same as in the table
+config_t config = {
+	CONFIG_BAUD_BD, CONFIG_ENTRY_S, CONFIG_HOLD_S, RELAY_UNLOCK_S, RELAY_PULL_IN,
+	RELAY_HOLD_DUTY, BUS_BATCH_WINDOW, BUS_BATCH_EVENTS, CONFIG_TZ_UTC
+};
+
+static uint8_t configBank = 0;
+static uint8_t configGen = 0;
+
+/* Function definitions ----------------------------------------------*/
+static uint16_t bank_addr(uint8_t bank)
+{
+	return EE_CONFIG + (bank ? CONFIG_BANK_LEN : 0);
+}
+
+/*--------------------------------------------------------------------*/
+static uint16_t bank_crc(const uint8_t *buf)
+{
+	uint16_t crc = 0xFFFF;
+
+	for (uint8_t i = 0; i < HDR_CRC; i++)
+		crc = frame_crc16(crc, buf[i]);
+	for (uint8_t i = 0; i < buf[HDR_LEN]; i++)
+		crc = frame_crc16(crc, buf[CONFIG_HEADER_LEN + i]);
+	return crc;
+}
+
+/*--------------------------------------------------------------------*/
+// Reads a bank, returns 1 when it is valid
+static uint8_t bank_read(uint8_t bank, uint8_t *buf)
+{
+	eeq_read(buf, bank_addr(bank), CONFIG_BANK_LEN);
+	return buf[HDR_MAGIC] == CONFIG_MAGIC && buf[HDR_LEN] <= CONFIG_DATA_MAX &&
+		bank_crc(buf) == (buf[HDR_CRC] | (buf[HDR_CRC + 1] << 8));
+}
+
+/*--------------------------------------------------------------------*/
+// Writes the struct to the other bank and makes it the newer one
+static void config_commit(void)
+{
+	uint8_t buf[CONFIG_HEADER_LEN + sizeof(config_t)];
+	uint8_t bank = configBank ^ 1;
+	uint8_t zero = 0;
+	uint16_t crc;
+
+	buf[HDR_MAGIC] = CONFIG_MAGIC;
+	buf[HDR_GEN] = configGen + 1;
+	buf[HDR_SCHEMA] = CONFIG_SCHEMA;
+	buf[HDR_LEN] = sizeof(config_t);
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		memcpy(&buf[CONFIG_HEADER_LEN], &config, sizeof(config_t));
+	}
+	crc = bank_crc(buf);
+	buf[HDR_CRC] = crc & 0xFF;
+	buf[HDR_CRC + 1] = crc >> 8;
+
+	eeq_write(bank_addr(bank), &zero, 1);
+	eeq_write(bank_addr(bank) + 1, buf + 1, sizeof(buf) - 1);
+	eeq_write(bank_addr(bank), buf, 1);
+	configBank = bank;
+	configGen++;
+}
+
+/*--------------------------------------------------------------------*/
+// Baud rates off by more than 2 % at full or quarter clock are refused
+static uint8_t baud_ok(uint16_t baud)
+{
+	uint16_t ubrr = UART_BAUD_SELECT((uint32_t)baud, F_CPU);
+	uint16_t slow = ((ubrr + 1) >> CPUCLK_SLOW_SHIFT) - 1;
+	uint32_t full = F_CPU / (16UL * (ubrr + 1));
+	uint32_t quarter = (F_CPU >> CPUCLK_SLOW_SHIFT) / (16UL * (slow + 1));
+
+	return (full > baud ? full - baud : baud - full) * 50 <= baud &&
+		(quarter > baud ? quarter - baud : baud - quarter) * 50 <= baud;
+}
+
+/*--------------------------------------------------------------------*/
+static uint8_t field_ok(uint8_t field, uint16_t value)
+{
+	const config_field_t *f = &configFields[field];
+
+	if (value < pgm_read_word(&f->min) || value > pgm_read_word(&f->max))
+		return 0;
+	return field != CONFIG_BAUD || baud_ok(value);
+}
+
+/*--------------------------------------------------------------------*/
+static void field_store(uint8_t field, uint16_t value)
+{
+	uint8_t *p = (uint8_t *)&config + pgm_read_byte(&configFields[field].offset);
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		if (pgm_read_byte(&configFields[field].size) == 2)
+			*(uint16_t *)p = value;
+		else
+			*p = value;
+	}
+}
+
+/*--------------------------------------------------------------------*/
+void config_init(void)
+{
+	uint8_t buf[CONFIG_BANK_LEN];
+	uint8_t ok0, ok1;
+	uint8_t gen0;
+
+	ok0 = bank_read(0, buf);
+	gen0 = buf[HDR_GEN];
+	ok1 = bank_read(1, buf);
+
+	if (!ok0 && !ok1)
+	{
+		// Defaults as generation 0 in bank 0
+		configBank = 1;
+		configGen = 0xFF;
+		config_commit();
+	}
+	else
+	{
+		// Both valid: the newer generation wins, counting wraps around
+		if (ok1 && (!ok0 || (int8_t)(buf[HDR_GEN] - gen0) > 0))
+		{
+			configBank = 1;
+		}
+		else
+		{
+			configBank = 0;
+			bank_read(0, buf);
+		}
+		configGen = buf[HDR_GEN];
+
+		// The fields the bank has, the others and those out of their
+		// range keep the default
+		for (uint8_t i = 0; i < CONFIG_FIELDS; i++)
+		{
+			uint8_t offset = pgm_read_byte(&configFields[i].offset);
+			uint8_t size = pgm_read_byte(&configFields[i].size);
+			uint16_t value = pgm_read_word(&configFields[i].def);
+
+			if (offset + size <= buf[HDR_LEN])
+			{
+				const uint8_t *p = &buf[CONFIG_HEADER_LEN + offset];
+				uint16_t stored = (size == 2) ? (p[0] | (p[1] << 8)) : p[0];
+
+				if (field_ok(i, stored))
+					value = stored;
+			}
+			field_store(i, value);
+		}
+	}
+	bus_batch(config.batchWindow, config.batchEvents);
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t config_set(uint8_t field, uint16_t value)
+{
+	if (field >= CONFIG_FIELDS)
+		return CONFIG_E_FIELD;
+	if (!field_ok(field, value))
+		return CONFIG_E_RANGE;
+	if (config_get(field) == value)
+		return CONFIG_OK;
+
+	field_store(field, value);
+	config_commit();
+	if (field == CONFIG_BATCH_WINDOW || field == CONFIG_BATCH_EVENTS)
+		bus_batch(config.batchWindow, config.batchEvents);
+	if (field == CONFIG_TZ)
+		rtc_zone();
+	return CONFIG_OK;
+}
+
+/*--------------------------------------------------------------------*/
+uint16_t config_get(uint8_t field)
+{
+	const uint8_t *p;
+
+	if (field >= CONFIG_FIELDS)
+		return 0;
+	p = (const uint8_t *)&config + pgm_read_byte(&configFields[field].offset);
+	return (pgm_read_byte(&configFields[field].size) == 2) ? *(const uint16_t *)p : *p;
+}
+
+/*--------------------------------------------------------------------*/
+const char *config_name(uint8_t field)
+{
+	return pgm_read_ptr(&configFields[field].name);
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t config_find(const char *name)
+{
+	uint8_t i;
+
+	for (i = 0; i < CONFIG_FIELDS; i++)
+	{
+		if (strcmp_P(name, config_name(i)) == 0)
+			break;
+	}
+	return i;
+}
+
+/*--------------------------------------------------------------------*/
+uint16_t config_ubrr(void)
+{
+	return UART_BAUD_SELECT((uint32_t)config.baud, F_CPU);
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t config_frame(uint8_t type, const uint8_t *payload, uint8_t len, uint8_t *reply)
+{
+	if (type != FT_CONFIG)
+		return FRAME_NO_REPLY;
+
+	reply[0] = (len >= 3) ? config_set(payload[0], payload[1] | (payload[2] << 8)) : CONFIG_OK;
+	reply[1] = configGen;
+	reply[2] = CONFIG_SCHEMA;
+	reply[3] = CONFIG_FIELDS;
+	for (uint8_t i = 0; i < CONFIG_FIELDS; i++)
+	{
+		uint16_t value = config_get(i);
+
+		reply[4 + 2 * i] = value & 0xFF;
+		reply[5 + 2 * i] = value >> 8;
+	}
+	return CONFIG_REPLY_LEN;
+}
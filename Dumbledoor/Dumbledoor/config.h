@@ -0,0 +1,170 @@
+#ifndef CONFIG_H_
+#define CONFIG_H_
+
+/***********************************************************************
+ *
+ * Configuration library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/**
+ * @file  config.h
+ * @defgroup dumbledoor_config Configuration Library <config.h>
+ * @code #include <config.h> @endcode
+ *
+ * @brief Settings of the door in EEPROM, changed without reflashing.
+ *
+ * @details
+ * The settings are the fields of config_t. A table in program memory
+ * gives each field its name, place, range and default, so the shell,
+ * the bus frame and the loader all go by the same table.
+ *
+ * The struct is kept twice in EEPROM at EE_CONFIG, in banks of
+ * CONFIG_BANK_LEN bytes with the header
+ *
+ *     magic | gen | schema | len | crc_lo | crc_hi
+ *
+ * and len bytes of the struct after it, the CRC covering both. A change
+ * writes the whole struct to the other bank with the next generation,
+ * the magic byte last, so a reset during the write leaves the old bank
+ * valid and the torn one fails its CRC. config_init() loads the newer
+ * valid bank into the SRAM struct in one pass, the ticks and the main
+ * loop read its fields directly.
+ *
+ * Fields are only ever added at the end of config_t, with the schema
+ * raised. A bank of an older schema is shorter, its missing fields get
+ * their defaults; a bank of a newer firmware is read as far as this
+ * one knows. A field out of its range gets its default too.
+ *
+ * tz is the offset of the local time of the access schedules (schedule.h)
+ * from UTC in quarter hours, plus CONFIG_TZ_UTC: 0 is UTC-12:00, 52 is
+ * UTC+01:00. The master changes it twice a year where the clocks go
+ * back and forth.
+ *
+ * The baud rate is used from the next reset. It has to be within 2 %
+ * at the quarter clock of cpuclk.h too, which leaves 1200 to 19200 Bd.
+ *
+ * @author
+ * Demirkan Korbey Baglamac and Rasit Demiroren
+ *
+ * @copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * Programmed for the Digital Electronics 2 project.
+ * This work is licensed under the terms of the MIT license.
+ */
+
+/* Includes ----------------------------------------------------------*/
+#include <stdint.h>         // Fixed width integer types
+
+/* Definitions -------------------------------------------------------*/
+#define CONFIG_SCHEMA       2       // 1: without tz
+#define CONFIG_BANK_LEN     48
+#define CONFIG_HEADER_LEN   6       // magic, gen, schema, len, crc
+#define CONFIG_DATA_MAX     (CONFIG_BANK_LEN - CONFIG_HEADER_LEN)
+
+// Field IDs, the order of the table in config.c
+#define CONFIG_ENTRY        0       // Seconds to type a pin
+#define CONFIG_HOLD         1       // Seconds the result is shown
+#define CONFIG_UNLOCK       2       // Unlock time of the door in seconds
+#define CONFIG_PULL_IN      3       // Relay pull-in in sound ticks
+#define CONFIG_HOLD_DUTY    4       // Relay hold duty of 255
+#define CONFIG_BAUD         5       // Baud rate of the serial link
+#define CONFIG_BATCH_WINDOW 6       // See bus_batch()
+#define CONFIG_BATCH_EVENTS 7
+#define CONFIG_TZ           8       // Local time, see rtc.h
+#define CONFIG_FIELDS       9
+
+// Defaults not given by the other libraries
+#define CONFIG_ENTRY_S      5
+#define CONFIG_HOLD_S       3
+#define CONFIG_BAUD_BD      9600
+#define CONFIG_TZ_UTC       48      // tz is UTC + (tz - 48) quarter hours
+#define CONFIG_TZ_MAX       104     // UTC+14:00
+
+// Configuration frame, the door answers with type | FT_REPLY
+#define FT_CONFIG           0x27    // [] or [field, value lo, value hi] ->
+                                    // [st, gen, schema, fields, value lo, value hi, ...]
+#define CONFIG_REPLY_LEN    (4 + 2 * CONFIG_FIELDS)
+
+// Status of a change
+#define CONFIG_OK           0
+#define CONFIG_E_FIELD      1       // No such field
+#define CONFIG_E_RANGE      2       // Value out of range
+
+/**
+ * @brief The settings, read directly by the application.
+ */
+typedef struct {
+	uint16_t baud;
+	uint8_t entry;
+	uint8_t hold;
+	uint8_t unlock;
+	uint8_t pullIn;
+	uint8_t holdDuty;
+	uint8_t batchWindow;
+	uint8_t batchEvents;
+	uint8_t tz;
+} config_t;
+
+typedef char config_len_check[(sizeof(config_t) <= CONFIG_DATA_MAX) ? 1 : -1];
+
+extern config_t config;
+
+/* Function prototypes -----------------------------------------------*/
+/**
+ * @brief    Loads the newer valid bank. With no valid bank the defaults
+ *           are written to EEPROM. Call it before uart_init().
+ * @return   none
+ */
+void config_init(void);
+
+/**
+ * @brief    Changes a field and writes the struct to the other bank.
+ *           Takes up to 150 ms, call it from the main loop.
+ * @param    field  CONFIG_...
+ * @param    value  New value
+ * @return   CONFIG_OK or CONFIG_E_...
+ */
+uint8_t config_set(uint8_t field, uint16_t value);
+
+/**
+ * @brief    Reads a field.
+ * @param    field  CONFIG_...
+ * @return   Value, 0 for no field
+ */
+uint16_t config_get(uint8_t field);
+
+/**
+ * @brief    Name of a field.
+ * @param    field  CONFIG_...
+ * @return   Name in program memory
+ */
+const char *config_name(uint8_t field);
+
+/**
+ * @brief    Looks up a field by its name.
+ * @param    name  Name
+ * @return   CONFIG_..., CONFIG_FIELDS when there is no such field
+ */
+uint8_t config_find(const char *name);
+
+/**
+ * @brief    Baud rate register value of the configured baud rate.
+ * @return   UBRR0 for uart_init() and cpuclk_init()
+ */
+uint16_t config_ubrr(void);
+
+/**
+ * @brief    Answers FT_CONFIG.
+ * @param    type     Frame type
+ * @param    payload  Request payload
+ * @param    len      Request payload length
+ * @param    reply    Reply payload, FRAME_PAYLOAD_MAX bytes
+ * @return   Reply payload length, FRAME_NO_REPLY for other frames
+ */
+uint8_t config_frame(uint8_t type, const uint8_t *payload, uint8_t len, uint8_t *reply);
+
+#endif /* CONFIG_H_ */
@@ -0,0 +1,184 @@
+/***********************************************************************
+ *
+ * CPU clock governor library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/* Includes ----------------------------------------------------------*/
+#include <util/atomic.h>    // ATOMIC_BLOCK
+#include "cpuclk.h"
+#include "event.h"          // Event clock
+#include "uart.h"           // Transmitter idle
+#ifdef __AVR__
+#include <avr/io.h>         // CLKPR, timers, UART, pin change
+#include <avr/interrupt.h>  // PCINT2_vect
+#include <avr/power.h>      // clock_prescale_set
+#include "stack.h"          // Interrupt nesting record
+#endif
+
+/* Definitions -------------------------------------------------------*/
+#define CPUCLK_HOLD     2           // Event clock seconds, one full tick at least
+
+#ifdef __AVR__
+#define CS_MASK         0x07        // Clock select bits of TCCRnB
+
+// Timer prescalers, full speed and slow
+#define CS0_FULL        0x04        // 256:  4.096 ms at 16 MHz
+#define CS0_SLOW        0x03        // 64:   4.096 ms at 4 MHz
+#define CS1_FULL        0x04        // 256:  1 s, OCR1A stays
+#define CS1_SLOW        0x03        // 64:   1 s
+#define CS2_FULL        0x05        // 128:  2.048 ms, the chime sets 8 while it plays
+#define CS2_SLOW        0x03        // 32:   2.048 ms
+
+#if CPUCLK_SLOW_SHIFT != 2
+# error The timer prescalers are for a clock divider of 4
+#endif
+#endif
+
+/* Global Variables --------------------------------------------------*/
+static volatile uint8_t cpuclkState = CPUCLK_FULL;
+static volatile uint16_t cpuclkBusy = 0;   // Event clock of the last activity
+static volatile uint8_t cpuclkWake = 0;    // Full speed asked for, not yet safe
+static volatile uint8_t cpuclkRx = 0;      // A byte is being received
+static uint16_t cpuclkRxAt = 0;            // Event clock of its start bit
+#ifdef __AVR__
+static uint16_t cpuclkUbrr[CPUCLK_STATES];
+#endif
+
+/* Function definitions ----------------------------------------------*/
+#ifdef __AVR__
+// Clock, timers and UART change together with interrupts disabled, and
+// only while no byte is sent or received: the UART counts its bits in
+// clock cycles. clock_prescale_set() has the divider in a register
+// before it sets CLKPCE, the change must follow within 4 cycles. The
+// door is not idle while the chime plays, so this never runs over its
+// Timer/Counter2 prescaler.
+static void cpuclk_set(uint8_t state)
+{
+	uint8_t slow = (state == CPUCLK_SLOW);
+
+	clock_prescale_set(slow ? (clock_div_t)CPUCLK_SLOW_SHIFT : clock_div_1);
+	TCCR0B = (TCCR0B & ~CS_MASK) | (slow ? CS0_SLOW : CS0_FULL);
+	TCCR1B = (TCCR1B & ~CS_MASK) | (slow ? CS1_SLOW : CS1_FULL);
+	TCCR2B = (TCCR2B & ~CS_MASK) | (slow ? CS2_SLOW : CS2_FULL);
+	UBRR0H = cpuclkUbrr[state] >> 8;
+	UBRR0L = cpuclkUbrr[state] & 0xFF;
+
+	// On a slow clock the first edge on RXD marks a byte coming in
+	cpuclkRx = 0;
+	PCIFR = _BV(PCIF2);
+	if (slow)
+		PCICR |= _BV(PCIE2);
+	else
+		PCICR &= ~_BV(PCIE2);
+	cpuclkState = state;
+}
+
+/*--------------------------------------------------------------------*/
+// The start bit of a byte on a slow clock. The byte is received at the
+// slow clock, the same baud rate; cpuclk_rx() changes the clock when it
+// is complete
+ISR(PCINT2_vect)
+{
+	stack_isr_enter(STACK_ISR_WAKE);
+	PCICR &= ~_BV(PCIE2);
+	cpuclkRx = 1;
+	cpuclkRxAt = event_time();
+	cpuclkBusy = cpuclkRxAt;
+	stack_isr_leave();
+}
+#else
+static void cpuclk_set(uint8_t state)
+{
+	cpuclkRx = 0;
+	cpuclkState = state;
+}
+#endif
+
+/*--------------------------------------------------------------------*/
+// Full speed now when the UART allows it, else at the next safe point.
+// Called with interrupts disabled
+static void cpuclk_wake(void)
+{
+	if (cpuclkState == CPUCLK_FULL)
+		return;
+	// A glitch on RXD is no byte, it has no receive complete
+	if (cpuclkRx && (uint16_t)(event_time() - cpuclkRxAt) >= CPUCLK_HOLD)
+		cpuclkRx = 0;
+	if (!cpuclkRx && uart_tx_idle())
+	{
+		cpuclk_set(CPUCLK_FULL);
+		cpuclkWake = 0;
+	}
+	else
+		cpuclkWake = 1;
+}
+
+/*--------------------------------------------------------------------*/
+void cpuclk_init(uint16_t ubrr)
+{
+#ifdef __AVR__
+	ubrr &= 0x0FFF;                 // Without the double speed flag
+	cpuclkUbrr[CPUCLK_FULL] = ubrr;
+	cpuclkUbrr[CPUCLK_SLOW] = ((ubrr + 1) >> CPUCLK_SLOW_SHIFT) - 1;
+	PCMSK2 |= _BV(PCINT16);         // RXD
+#else
+	(void)ubrr;
+#endif
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		cpuclkBusy = event_time();
+		cpuclk_set(CPUCLK_FULL);
+	}
+}
+
+/*--------------------------------------------------------------------*/
+void cpuclk_task(uint8_t idle)
+{
+	if (!idle || cpuclkWake)
+	{
+		cpuclk_full();
+		return;
+	}
+	if (cpuclkState == CPUCLK_SLOW)
+		return;
+
+	// The handlers which wake the clock and every byte sent or received
+	// set cpuclkBusy as well
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		if ((uint16_t)(event_time() - cpuclkBusy) >= CPUCLK_HOLD && uart_tx_idle())
+			cpuclk_set(CPUCLK_SLOW);
+	}
+}
+
+/*--------------------------------------------------------------------*/
+void cpuclk_full(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		cpuclkBusy = event_time();
+		cpuclk_wake();
+	}
+}
+
+/*--------------------------------------------------------------------*/
+void cpuclk_rx(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		cpuclkBusy = event_time();
+		cpuclkRx = 0;
+		cpuclk_wake();
+	}
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t cpuclk_state(void)
+{
+	return cpuclkState;
+}
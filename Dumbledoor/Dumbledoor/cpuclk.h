@@ -0,0 +1,105 @@
+#ifndef CPUCLK_H_
+#define CPUCLK_H_
+
+/***********************************************************************
+ *
+ * CPU clock governor library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/**
+ * @file  cpuclk.h
+ * @defgroup dumbledoor_cpuclk CPU Clock Library <cpuclk.h>
+ * @code #include <cpuclk.h> @endcode
+ *
+ * @brief Runs the CPU at a quarter of its clock while the door is idle.
+ *
+ * @details
+ * When the door has stood in standby for a full second tick, with no
+ * byte sent or received, the system clock prescaler (CLKPR) divides
+ * F_CPU by 4. The timer prescalers and the UART baud rate register are
+ * changed in the same step, so the ticks, the Timer/Counter1 count of
+ * the trace and the baud rate stay as they are. The first key press,
+ * seen by the key pad tick, a received byte and a byte to send bring
+ * the clock back to full speed.
+ *
+ * The UART counts its bits in clock cycles, so the clock only changes
+ * while it neither sends nor receives: both transmit lanes empty and
+ * the last stop bit out (TXC0), and no start bit seen since. A pin
+ * change interrupt on RXD marks the start bit on a slow clock; the
+ * byte is received at the slow clock and the receive complete interrupt,
+ * with the receiver waiting in the stop bit, changes it. A wake which
+ * comes while a byte is on the line waits for that point or for the
+ * main loop.
+ *
+ * 4 MHz is the lowest clock which keeps all of them: the 4 ms key pad
+ * tick needs a Timer/Counter0 prescaler of F_CPU / 4 / 62500 = 64 and
+ * 9600 Bd needs UBRR0 = 25 without an error. The _delay_us() loops of
+ * the display take 4 times longer when slow, the display is only written
+ * at full speed.
+ *
+ * On the host there is no clock, only the state is kept.
+ *
+ * @author
+ * Demirkan Korbey Baglamac and Rasit Demiroren
+ *
+ * @copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * Programmed for the Digital Electronics 2 project.
+ * This work is licensed under the terms of the MIT license.
+ */
+
+/* Includes ----------------------------------------------------------*/
+#include <stdint.h>         // Fixed width integer types
+
+/* Definitions -------------------------------------------------------*/
+#define CPUCLK_FULL     0       // F_CPU
+#define CPUCLK_SLOW     1       // F_CPU >> CPUCLK_SLOW_SHIFT
+#define CPUCLK_STATES   2
+
+#define CPUCLK_SLOW_SHIFT   2   // CLKPR divider 4
+
+/* Function prototypes -----------------------------------------------*/
+/**
+ * @brief    Starts at full speed. Call it after uart_init() and
+ *           hal_ticks_start().
+ * @param    ubrr  Baud rate register at full speed, as given to
+ *                 uart_init(), its value + 1 must divide by 4
+ * @return   none
+ */
+void cpuclk_init(uint16_t ubrr);
+
+/**
+ * @brief    Slows the clock down after a second tick in standby. Call it
+ *           from the main loop.
+ * @param    idle  The door is in standby, door_idle()
+ * @return   none
+ */
+void cpuclk_task(uint8_t idle);
+
+/**
+ * @brief    Back to full speed, at once when no byte is on the line,
+ *           else as soon as it is through. Stays there for at least
+ *           another second tick. Safe to call from interrupt handlers.
+ * @return   none
+ */
+void cpuclk_full(void);
+
+/**
+ * @brief    A byte was received, back to full speed. Called by the
+ *           receive complete interrupt, the receiver waits in the stop
+ *           bit until the next start bit.
+ * @return   none
+ */
+void cpuclk_rx(void);
+
+/**
+ * @brief    Current clock.
+ * @return   CPUCLK_FULL or CPUCLK_SLOW
+ */
+uint8_t cpuclk_state(void);
+
+#endif /* CPUCLK_H_ */
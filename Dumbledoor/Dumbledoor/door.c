@@ -0,0 +1,491 @@
+/***********************************************************************
+ * 
+ * Door lock application logic
+ * Accept 4 to 10 digit pin code, and if you don't know the pin you can ring 
+ * the door bell as well. Programmed for,
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac, Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ * 
+ **********************************************************************/
+
+/* Includes ----------------------------------------------------------*/
+#include <avr/pgmspace.h>		// Strings and tables in program memory
+#include <util/atomic.h>	// ATOMIC_BLOCK
+#include "door.h"
+#include "hal.h"			// Pins, key pad and display
+#include "lcdfb.h"			// LCD framebuffer library for AVR-GCC
+#include "fmt.h"			// Formatted output library for AVR-GCC
+#include "uart.h"			// UART library for AVR-GCC
+#include "event.h"			// Door event library
+#include "bus.h"			// RS-485 door bus library
+#include "users.h"			// User table library
+#include "trace.h"			// Flight recorder library
+#include "relay.h"			// Door lock relay library
+#include "sound.h"			// Melody library
+#include "config.h"			// Configuration library
+#include "pin.h"			// PIN accumulator library
+#include "totp.h"			// One-time code library
+#include "schedule.h"		// Access schedule library
+
+/* Function declarations ---------------------------------------------*/
+static void standby();			// Put system to the standby state
+static void ringDoorBell();		// Rings the door bell
+static void correctPin(uint16_t ID);	// Put system to the correct pin state
+static void wrongPin(uint8_t offHours);	// Put system to the wrong pin state
+static int16_t comparePins(uint64_t cred, uint8_t digits);	// Compares the typed pin with the correct pins,
+					// if correct returns the user ID if not returns -1,
+					// -2 for a user outside of the schedule
+static void traceState(uint8_t before);	// Records a change of the stages
+static void restart();			// Stops everything and puts system to the standby state
+static void keepCounters();		// Copies the attempt counters over a reset
+							
+/* Definitions -------------------------------------------------------*/
+#define DOOR_KEEP_MAGIC	0xD0C5		// doorKeep holds the counters
+
+#ifdef __AVR__
+# define DOOR_NOINIT	__attribute__((section(".noinit")))
+#else
+# define DOOR_NOINIT
+#endif
+
+/* Global Variables --------------------------------------------------*/
+static pin_t inPin;			// Input Pin (the hash of the digits user pressed)
+static int16_t inID = -1;		// Input ID (the ID of the typed Pin, if pin is wrong the Id value is -1)
+static uint8_t timerStage = 0;		// Sets the stage of the delay. 0: No Counter, 1: 5s Counter, 2: 3s Counter
+static uint8_t timerCnt = 0;		// Delay Counter
+static uint8_t correctAttempts = 0;	// Number of total correct entries
+static uint8_t wrongAttempts = 0;	// Number of total wrong entries
+static uint8_t pinDigitCnt = 0;		// Number of typed digits
+static uint8_t scanningStage = 0;	// Scanning Stage --> 0: None, 1: getPin, 2: Standby, 3: checkPin
+
+// Finished entry, looked up in the EEPROM by door_task() in the main loop
+static volatile uint8_t checkStage = 0;	// 0: None, 1: Asked, 2: Answered
+static uint64_t checkCred;		// Hash of the typed pin
+static uint8_t checkDigits;		// Number of typed digits
+static int16_t checkID;			// comparePins() of the entry
+static uint8_t checkUnlock;		// Unlock time of the user
+static uint8_t checkChime;		// Melody of the user + 1, 0: none
+static char checkName[USERS_NAME_LEN];	// Name of the user
+
+// Attempt counters, left as they were by a reset
+static struct {
+	uint16_t magic;
+	uint8_t correct;
+	uint8_t wrong;
+	uint8_t correctInv;		// ~correct
+	uint8_t wrongInv;		// ~wrong
+} doorKeep DOOR_NOINIT;
+
+// Scans the keypad, gets the typed pin and then compares the pin
+void door_tick_keypad(void)
+{
+	char pressedKey;				// Pressed Key
+	uint8_t before = (scanningStage << 4) | timerStage;
+	
+	// Scan the Keypad
+	pressedKey = hal_keypad_scan();
+	
+	// Key Press Buzzer
+	if(pressedKey != HAL_NO_KEY)
+	{
+		trace(TR_KEY, pressedKey);
+		sound_event(SOUND_KEY);
+		event_post(EV_KEY, 0);
+	}
+	
+	// If user pressed #, ring the door bell
+	if(pressedKey == '#' && scanningStage == 0)
+	{
+		ringDoorBell();
+		// Wait 3s and then standby
+		scanningStage = 2;
+		timerStage = 2;
+	}
+	// If user pressed *, configure the system to get typed pin
+	else if(pressedKey == '*' && scanningStage == 0)
+	{
+		scanningStage = 1;	// Enable getPin
+		timerStage = 1;		// Start 5 second timer
+		pinDigitCnt = 0;	// Set pin input index to 0
+		pin_start(&inPin);
+						
+		// Configure lcd
+		lcdfb_clear();
+		lcdfb_gotoxy(2,1);
+		lcdfb_puts_P("--Enter the pin--");
+	}
+		
+	// If scanningStage is 1 get the typed pin
+	if(scanningStage == 1)
+	{
+		// Scan the entered pin
+		if(pressedKey != '*' && pressedKey != '#' && pressedKey != HAL_NO_KEY)
+		{
+			// Fold the pressed key into inPin, the digit itself is not kept
+			pinDigitCnt = pin_digit(&inPin, pressedKey);
+				
+			// Configure lcd
+			lcdfb_putxy((pinDigitCnt + 7), 2, '*');
+		}
+		
+		// If 5s is up, the user pressed # or typed the longest pin enter
+		// here and hand the typed pin to door_task(), the correct pins
+		// are in EEPROM and too slow to read here
+		if(timerStage == 0 || pressedKey == '#' || pinDigitCnt >= PIN_MAX)
+		{	
+			ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+			{
+				checkCred = pin_finish(&inPin);
+				checkDigits = pinDigitCnt;
+				checkStage = 1;
+			}
+			
+			// If user typed pin before the timer finish stop the timer			
+			timerStage = 0;
+			timerCnt = 0;
+			scanningStage = 3;
+		}
+	}
+	
+	// If scanningStage is 3 wait for the answer of door_task()
+	if(scanningStage == 3 && checkStage == 2)
+	{
+		checkStage = 0;
+		inID = checkID;
+		
+		// Typed pin is incorrect, or not at this hour
+		if(inID < 0)
+		{
+			wrongPin(inID == -2);
+		}
+		// Typed pin is correct
+		else if(inID >= 0 && inID < USERS_MAX)
+		{
+			correctPin(inID);
+		}
+		
+		pinDigitCnt = 0;
+		// Wait 3s then, configure system for standby stage
+		scanningStage = 2;
+		timerStage = 2;
+	}
+	
+	// Changing the status to the standby
+	if(scanningStage == 2)
+	{
+		if(timerStage == 0)
+		{
+			scanningStage = 0;
+			standby();
+		}
+	}
+	
+	traceState(before);
+}
+
+// Creates the pin entry and the result timers, 5s and 3s by default
+void door_tick_second(void)
+{
+	uint8_t before = (scanningStage << 4) | timerStage;
+	
+	// Unlock time
+	relay_tick_second();
+	
+	// Standby status for the counter
+	if(timerStage == 0)
+		timerCnt = 0;	
+	// Pin entry count, config.entry seconds
+	else if(timerStage == 1)
+	{
+		timerCnt++;
+		if(timerCnt > config.entry)
+		{
+			timerCnt = 0;
+			timerStage = 0;
+		}
+		
+		// Configure LCD
+		fmt_lcd_P(2, 0, 18, "Remaining time: %u", config.entry + 1 - timerCnt);
+	}
+	// Result count, config.hold seconds
+	else if(timerStage == 2)
+	{
+		timerCnt++;
+		if(timerCnt > config.hold)
+		{
+			timerCnt = 0;
+			timerStage = 0;
+		}
+		
+		// Configure LCD
+		fmt_lcd_P(2, 0, 18, "Remaining time: %u", config.hold + 1 - timerCnt);
+	}
+	
+	traceState(before);
+}
+
+// Creates the signals for the buzzers
+void door_tick_sound(void)
+{
+	// Pull-in pulse of the relay
+	relay_tick_sound();
+	
+	// Melody of the buzzer and the door bell
+	sound_tick();
+}
+
+// Looks up the finished entry in the user table and the one-time codes,
+// with the unlock time, melody and name of the user
+void door_task(void)
+{
+	uint64_t cred;
+	int16_t id;
+	
+	if(checkStage != 1)
+		return;
+	
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		cred = checkCred;
+		checkCred = 0;
+	}
+	id = comparePins(cred, checkDigits);
+	cred = 0;
+	if(id >= 0)
+	{
+		checkUnlock = users_unlock(id);
+		checkChime = users_chime(id);
+		users_name(id, checkName);
+	}
+	
+	// The key pad tick takes it from here
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		checkID = id;
+		checkStage = 2;
+	}
+}
+
+/* Function definitions ----------------------------------------------*/
+void door_init(void)
+{
+	// No attempts yet
+	correctAttempts = 0;
+	wrongAttempts = 0;
+	keepCounters();
+	
+	restart();
+}
+
+uint8_t door_restore(void)
+{
+	// Random after a power-on, garbled by a crash
+	if(doorKeep.magic != DOOR_KEEP_MAGIC ||
+	   (uint8_t)(doorKeep.correct ^ doorKeep.correctInv) != 0xFF ||
+	   (uint8_t)(doorKeep.wrong ^ doorKeep.wrongInv) != 0xFF)
+	{
+		door_init();
+		return 0;
+	}
+	
+	correctAttempts = doorKeep.correct;
+	wrongAttempts = doorKeep.wrong;
+	
+	restart();
+	return 1;
+}
+
+uint8_t door_idle(void)
+{
+	return scanningStage == 0 && timerStage == 0 && !sound_busy();
+}
+
+void door_attempts(uint8_t *correct, uint8_t *wrong)
+{
+	*correct = correctAttempts;
+	*wrong = wrongAttempts;
+}
+
+static void restart()
+{
+	// Nothing typed, no timer and no sound running
+	pinDigitCnt = 0;
+	scanningStage = 0;
+	checkStage = 0;
+	timerStage = 0;
+	timerCnt = 0;
+	sound_stop();
+	
+	// Lock the door
+	relay_lock();
+	
+	standby();
+}
+
+static void standby()
+{
+	// Reset input ID
+	inID = -1;
+	
+	// Reset typed pin
+	pin_start(&inPin);
+	
+	// Reset Leds
+	hal_pin_write(HAL_LED_GREEN, 0);
+	hal_pin_write(HAL_LED_RED, 0);
+	
+	// Clear the lcd screen
+	lcdfb_clear();
+	// Print to lcd screen
+	lcdfb_gotoxy(2,0);
+	lcdfb_puts_P("Dumbledoor wishes");
+	lcdfb_gotoxy(4,1);
+	lcdfb_puts_P("Magical Days!");
+	lcdfb_gotoxy(1,2);
+	lcdfb_puts_P("* --> Enter the pin");
+	lcdfb_gotoxy(1,3);
+	lcdfb_puts_P("# --> Door Bell");
+}
+
+static void ringDoorBell()
+{	
+	// Door Bell Buzzer
+	sound_event(SOUND_DOORBELL);
+	
+	// Clear the lcd screen
+	lcdfb_clear();
+	// Print to lcd screen
+	lcdfb_gotoxy(2,2);
+	lcdfb_puts_P("Door bell is");
+	lcdfb_gotoxy(2,3);
+	lcdfb_puts_P("rang. ");
+	lcdfb_putc(HAL_GLYPH_BELL);
+	lcdfb_putc(HAL_GLYPH_BELL);
+	
+	// UART
+	event_post(EV_BELL, 0);
+	if(bus_mode() == BUS_MODE_CONSOLE)
+		uart_puts_P("Door bell is rang.\r\n");
+}
+
+static void correctPin(uint16_t ID)
+{	
+	const char *name = checkName;	// Name of the user from the user table
+	uint8_t chime;			// Melody of the user + 1, 0: none
+	
+	// Unlock the door for the time of the user
+	relay_unlock(checkUnlock);
+
+	// Light up the green led
+	hal_pin_write(HAL_LED_GREEN, 1);
+	
+	// Correct Pin Buzzer, or the melody of the user
+	chime = checkChime;
+	if(chime)
+		sound_play(chime - 1);
+	else
+		sound_event(SOUND_CORRECT);
+	
+	// Update Correct Attempts
+	correctAttempts++;
+	keepCounters();
+	trace(TR_CORRECT, correctAttempts);
+	
+	// Clear the lcd screen
+	lcdfb_clear();
+	// Print to lcd screen
+	lcdfb_gotoxy(2,1);
+	lcdfb_puts_P("Correct pin.");
+	lcdfb_gotoxy(2,2);
+	lcdfb_puts_P("Hello ");
+	lcdfb_putc(HAL_GLYPH_HEART);
+	lcdfb_putc(HAL_GLYPH_HEART);
+	lcdfb_gotoxy(2,3);
+	lcdfb_puts(name);
+	
+	// UART
+	event_post(EV_ENTRY, ID);
+	if(bus_mode() == BUS_MODE_CONSOLE)
+		fmt_uart_P("%s entered to the room!\r\n"
+			   "Total Attempts: \r\n"
+			   "Correct: %u\r\n"
+			   "Wrong: %u\r\n",
+			   name, correctAttempts, wrongAttempts);
+}
+
+static void wrongPin(uint8_t offHours)
+{	
+	// A wrong pin ends an unlock which is still running
+	relay_lock();
+	
+	// Light up the red led
+	hal_pin_write(HAL_LED_RED, 1);
+	
+	// Wrong Pin Buzzer
+	sound_event(SOUND_WRONG);
+	
+	// Update Wrong Attempts
+	wrongAttempts++;
+	keepCounters();
+	trace(TR_WRONG, wrongAttempts);
+	
+	// Clear the lcd screen
+	lcdfb_clear();
+	// Print to lcd screen
+	lcdfb_gotoxy(2,2);
+	if(offHours)
+		lcdfb_puts_P("Not at this hour.");
+	else
+		lcdfb_puts_P("Wrong pin.");
+	
+	// UART
+	event_post(EV_DENIED, 0);
+	if(bus_mode() == BUS_MODE_CONSOLE)
+	{
+		if(offHours)
+			fmt_uart_P("Entry outside of the schedule!\r\n");
+		else
+			fmt_uart_P("Wrong attempt to enter!\r\n");
+		fmt_uart_P("Total Attempts: \r\n"
+			   "Correct: %u\r\n"
+			   "Wrong: %u\r\n",
+			   correctAttempts, wrongAttempts);
+	}
+}
+
+static int16_t comparePins(uint64_t cred, uint8_t digits)
+{
+	// The registered pins are in the user table in EEPROM, indexed by
+	// their digests, the one-time codes are in the cache of totp.h.
+	// Returns the slot of the matching user, -1 or -2 when the
+	// schedule of the user does not allow this hour
+	int16_t id;
+	
+	if(digits < PIN_MIN)
+		return -1;
+	id = users_match(cred);
+	if(id == -1 && digits == TOTP_DIGITS)
+		id = totp_match(cred);
+	if(id >= 0 && !schedule_allowed(users_schedule(id)))
+		return -2;
+	return id;
+}
+
+static void traceState(uint8_t before)
+{
+	uint8_t now = (scanningStage << 4) | timerStage;
+	
+	if(now != before)
+		trace(TR_STATE, now);
+}
+
+static void keepCounters()
+{
+	doorKeep.magic = DOOR_KEEP_MAGIC;
+	doorKeep.correct = correctAttempts;
+	doorKeep.wrong = wrongAttempts;
+	doorKeep.correctInv = ~correctAttempts;
+	doorKeep.wrongInv = ~wrongAttempts;
+}
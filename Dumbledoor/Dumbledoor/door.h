@@ -0,0 +1,113 @@
+#ifndef DOOR_H_
+#define DOOR_H_
+
+/***********************************************************************
+ *
+ * Door lock application logic.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/**
+ * @file  door.h
+ * @defgroup dumbledoor_door Door Logic <door.h>
+ * @code #include <door.h> @endcode
+ *
+ * @brief Pin entry, door bell and buzzer sequences of the door lock.
+ *
+ * @details
+ * The states of the door are driven by three ticks. main.c calls the
+ * handlers from the timer interrupts, the host tools call them from a
+ * loop to run the door without the board. The logic only uses hal.h,
+ * the framebuffer, the event queue and the user table.
+ *
+ * `*` starts a pin entry of PIN_MIN to PIN_MAX digits, `#` ends it, so
+ * does the last digit or the entry timer. The digits go into a digest
+ * as they are typed (pin.h), a shorter entry is a wrong pin.
+ *
+ * The attempt counters are copied to .noinit RAM, which a reset does
+ * not clear, so door_restore() can take them over after a watchdog
+ * reset.
+ *
+ * @author
+ * Demirkan Korbey Baglamac and Rasit Demiroren
+ *
+ * @copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * Programmed for the Digital Electronics 2 project.
+ * This work is licensed under the terms of the MIT license.
+ */
+
+/* Includes ----------------------------------------------------------*/
+#include <stdint.h>         // Fixed width integer types
+
+/* Definitions -------------------------------------------------------*/
+#define DOOR_KEYPAD_MS  4       // Period of door_tick_keypad()
+#define DOOR_SOUND_MS   16      // Period of door_tick_sound()
+
+/* Function prototypes -----------------------------------------------*/
+/**
+ * @brief    Puts the door to the standby state: locked, leds off and
+ *           the welcome screen. Stops a pin entry, the timers and the
+ *           buzzers, so it can start the door again at any time.
+ * @return   none
+ */
+void door_init(void);
+
+/**
+ * @brief    Puts the door to the standby state like door_init(), but
+ *           keeps the correct and wrong attempt counters of the run
+ *           before the reset when they are intact. The door is always
+ *           locked afterwards, a pin entry of the run before is lost.
+ * @return   1 when the counters were kept, 0 when they start from 0
+ */
+uint8_t door_restore(void);
+
+/**
+ * @brief    Tells whether the door stands in standby: no pin entry, no
+ *           timer and no sound running.
+ * @return   1 in standby
+ */
+uint8_t door_idle(void);
+
+/**
+ * @brief    Correct and wrong attempts since the counters started.
+ * @param    correct  Correct pins
+ * @param    wrong    Wrong pins
+ * @return   none
+ */
+void door_attempts(uint8_t *correct, uint8_t *wrong);
+
+/**
+ * @brief    Scans the key pad and handles the pressed key.
+ *           Call it every DOOR_KEYPAD_MS.
+ * @return   none
+ */
+void door_tick_keypad(void);
+
+/**
+ * @brief    Looks up a finished pin entry in the user table and the
+ *           one-time codes, which door_tick_keypad() hands over. The
+ *           EEPROM reads may wait for a byte being programmed, so it is
+ *           called from the main loop and not from the key pad tick.
+ * @return   none
+ */
+void door_task(void);
+
+/**
+ * @brief    Counts down the pin entry and standby timers.
+ *           Call it every second.
+ * @return   none
+ */
+void door_tick_second(void);
+
+/**
+ * @brief    Plays the buzzer and door bell sequences.
+ *           Call it every DOOR_SOUND_MS.
+ * @return   none
+ */
+void door_tick_sound(void);
+
+#endif /* DOOR_H_ */
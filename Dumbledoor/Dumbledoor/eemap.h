@@ -0,0 +1,64 @@
+#ifndef EEMAP_H_
+#define EEMAP_H_
+
+/***********************************************************************
+ *
+ * EEPROM layout of the door lock.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/**
+ * @file  eemap.h
+ * @brief Fixed EEPROM addresses of the persistent settings.
+ *
+ * @details
+ * The addresses are fixed instead of EEMEM variables, so the settings
+ * of a door survive a firmware update which adds or reorders variables.
+ * They are read and written with eeq_read() and eeq_write().
+ * Erased EEPROM reads 0xFF, every user of the map treats that as "not
+ * set".
+ */
+
+/* Includes ----------------------------------------------------------*/
+#include <stdint.h>         // Fixed width integer types
+#include "users.h"          // User table size
+#include "evlog.h"          // Event log size
+#include "config.h"         // Configuration bank size
+#include "schedule.h"       // Schedule size
+#include "totp.h"           // One-time code secret size
+
+/* Definitions -------------------------------------------------------*/
+#define EE_LINK_MODE    0x000       // Serial link mode, see bus.h
+#define EE_NODE_ADDR    0x001       // Bus address of the door
+#define EE_SOUNDS       0x002       // Melody of each sound event, see sound.h
+#define EE_RTC_TRIM     0x006       // Drift of the second tick, see rtc.h (3 bytes)
+#define EE_BOOT_EPOCH   0x009       // Resets counted for the bus, see bus.h
+#define EE_SCHEDULE_SET 0x00A       // Schedules cleared, see schedule.h
+#define EE_USERS        0x010       // Two user table banks
+#define EE_USERS_END    (EE_USERS + 2 * USERS_BANK_LEN)
+#define EE_CONFIG       EE_USERS_END            // Two configuration banks
+#define EE_CONFIG_END   (EE_CONFIG + 2 * CONFIG_BANK_LEN)
+#define EE_LOG          (EE_USERS_END + 0x60)   // Event log
+#define EE_LOG_END      (EE_LOG + EVLOG_BLOCKS * EVLOG_BLOCK_LEN)
+#define EE_TOTP         EE_LOG_END              // One-time code secrets
+#define EE_TOTP_END     (EE_TOTP + TOTP_USERS * TOTP_ENTRY_LEN)
+#define EE_SCHEDULE     (EE_LOG + 7 * EVLOG_BLOCK_LEN)  // Access schedules, where 7 log blocks ended
+#define EE_SCHEDULE_END (EE_SCHEDULE + SCHEDULE_COUNT * SCHEDULE_LEN)
+
+#if EE_CONFIG_END > EE_LOG
+#error "The configuration banks run into the event log"
+#endif
+
+#if EE_TOTP_END > EE_SCHEDULE
+#error "The one-time code secrets run into the schedules"
+#endif
+
+#if defined(E2END) && EE_SCHEDULE_END > E2END + 1
+#error "The event log and the schedules do not fit into the EEPROM"
+#endif
+
+#endif /* EEMAP_H_ */
@@ -0,0 +1,200 @@
+/***********************************************************************
+ *
+ * EEPROM write queue library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/* Includes ----------------------------------------------------------*/
+#include <util/atomic.h>    // ATOMIC_BLOCK
+#include "eeq.h"
+#include "hal.h"            // EEPROM and its ready interrupt
+
+/* Definitions -------------------------------------------------------*/
+typedef struct {
+	uint16_t addr;
+	uint8_t len;                        // 0 for an eeq_done() job
+	void (*done)(void);
+	uint8_t data[EEQ_JOB_LEN];
+} eeq_job_t;
+
+/* Global Variables --------------------------------------------------*/
+// Ring of jobs, the bytes of the first one are programmed from eeqPos on
+static eeq_job_t eeqJobs[EEQ_JOBS];
+static uint8_t eeqHead = 0;
+static volatile uint8_t eeqCount = 0;
+static uint8_t eeqPos = 0;
+static volatile uint8_t eeqBytes = 0;   // Bytes of all jobs from eeqPos on
+
+/* Function definitions ----------------------------------------------*/
+/**
+ * @brief  Takes the first bytes of a write, with the interrupts off. The
+ *         last job takes them when they start in its bytes still queued
+ *         or right after it and cover it to its end, so no byte written
+ *         before moves behind them.
+ * @return Bytes taken, 0 when the queue is full
+ */
+static uint8_t eeq_put(uint16_t addr, const uint8_t *src, uint8_t len)
+{
+	eeq_job_t *job;
+	uint8_t from;
+	uint8_t n;
+
+	if (eeqCount)
+	{
+		job = &eeqJobs[(eeqHead + eeqCount - 1) % EEQ_JOBS];
+		from = (eeqCount == 1) ? eeqPos : 0;
+		if (job->len && addr >= job->addr + from && addr <= job->addr + job->len &&
+		    addr + len >= job->addr + job->len && addr - job->addr < EEQ_JOB_LEN)
+		{
+			from = addr - job->addr;
+			n = (len < EEQ_JOB_LEN - from) ? len : EEQ_JOB_LEN - from;
+			for (uint8_t i = 0; i < n; i++)
+				job->data[from + i] = src[i];
+			eeqBytes += from + n - job->len;
+			job->len = from + n;
+			return n;
+		}
+	}
+	if (eeqCount == EEQ_JOBS)
+		return 0;
+
+	job = &eeqJobs[(eeqHead + eeqCount) % EEQ_JOBS];
+	n = (len < EEQ_JOB_LEN) ? len : EEQ_JOB_LEN;
+	job->addr = addr;
+	job->len = n;
+	job->done = 0;
+	for (uint8_t i = 0; i < n; i++)
+		job->data[i] = src[i];
+	if (!eeqCount)
+		eeqPos = 0;
+	eeqCount++;
+	eeqBytes += n;
+	return n;
+}
+
+/*--------------------------------------------------------------------*/
+void eeq_write(uint16_t addr, const void *src, uint8_t len)
+{
+	const uint8_t *s = src;
+	uint8_t n;
+
+	while (len)
+	{
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			n = eeq_put(addr, s, len);
+		}
+		hal_ee_ready(1);
+		addr += n;
+		s += n;
+		len -= n;
+		// Full, the interrupt makes room
+		if (!n)
+			hal_ee_poll();
+	}
+}
+
+/*--------------------------------------------------------------------*/
+void eeq_done(void (*done)(void))
+{
+	uint8_t queued = 0;
+
+	while (!queued)
+	{
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			if (eeqCount < EEQ_JOBS)
+			{
+				eeq_job_t *job = &eeqJobs[(eeqHead + eeqCount) % EEQ_JOBS];
+
+				job->len = 0;
+				job->done = done;
+				if (!eeqCount)
+					eeqPos = 0;
+				eeqCount++;
+				queued = 1;
+			}
+		}
+		hal_ee_ready(1);
+		if (!queued)
+			hal_ee_poll();
+	}
+}
+
+/*--------------------------------------------------------------------*/
+void eeq_read(void *dst, uint16_t addr, uint8_t len)
+{
+	uint8_t *d = dst;
+	uint8_t running;
+
+	// No byte is started between the read and the overlay, so none can
+	// be missed by both
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		running = hal_ee_ready(0);
+	}
+	hal_ee_read(dst, addr, len);
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		// Later jobs over earlier ones, as they will be programmed
+		for (uint8_t j = 0; j < eeqCount; j++)
+		{
+			const eeq_job_t *job = &eeqJobs[(eeqHead + j) % EEQ_JOBS];
+
+			for (uint8_t i = 0; i < job->len; i++)
+			{
+				uint16_t at = job->addr + i - addr;
+
+				if (at < len)
+					d[at] = job->data[i];
+			}
+		}
+		if (running)
+			hal_ee_ready(1);
+	}
+}
+
+/*--------------------------------------------------------------------*/
+void eeq_flush(void)
+{
+	while (hal_ee_poll() || eeqCount)
+		;
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t eeq_pending(void)
+{
+	return eeqBytes;
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t eeq_step(void)
+{
+	eeq_job_t *job = &eeqJobs[eeqHead];
+	void (*done)(void);
+
+	if (!eeqCount)
+		return 0;
+
+	if (eeqPos < job->len)
+	{
+		hal_ee_update(job->addr + eeqPos, job->data[eeqPos]);
+		eeqPos++;
+		eeqBytes--;
+	}
+	if (eeqPos >= job->len)
+	{
+		// Off the queue first, the function may queue more
+		done = job->done;
+		eeqHead = (eeqHead + 1) % EEQ_JOBS;
+		eeqPos = 0;
+		eeqCount--;
+		if (done)
+			done();
+	}
+	return eeqCount != 0;
+}
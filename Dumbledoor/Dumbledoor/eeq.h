@@ -0,0 +1,111 @@
+#ifndef EEQ_H_
+#define EEQ_H_
+
+/***********************************************************************
+ *
+ * EEPROM write queue library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/**
+ * @file  eeq.h
+ * @defgroup dumbledoor_eeq EEPROM Write Queue Library <eeq.h>
+ * @code #include <eeq.h> @endcode
+ *
+ * @brief EEPROM writes in the background, one byte per EEPROM ready
+ *        interrupt.
+ *
+ * @details
+ * Programming an EEPROM byte takes 3.4 ms. eeq_write() only copies the
+ * bytes into a queue of EEQ_JOBS jobs of up to EEQ_JOB_LEN consecutive
+ * bytes and returns; the EE_READY interrupt programs them one by one
+ * with eeq_step(). A byte which already holds its value is skipped
+ * there, without a write cycle.
+ *
+ * The bytes are programmed in the order they were written, so a reset
+ * leaves the EEPROM as the blocking writes did: the table and setting
+ * banks write their header byte last and rely on it. A write is merged
+ * into the last job when it continues it, or when it starts in its
+ * bytes still queued and covers them to the end; a record written again
+ * before it was programmed then takes one write cycle per byte, and no
+ * byte written before moves behind the write. Other writes start a new
+ * job.
+ *
+ * eeq_read() sees the bytes still queued, every module reads and writes
+ * the EEPROM only through here. Only a full queue makes eeq_write()
+ * wait. eeq_flush() waits for everything written before, for records
+ * which must be in the EEPROM before the door answers; eeq_done() calls
+ * a function from the interrupt once they are. A reset drops what is
+ * still queued, as it dropped the writes a blocking caller had not come
+ * to yet.
+ *
+ * @author
+ * Demirkan Korbey Baglamac and Rasit Demiroren
+ *
+ * @copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * Programmed for the Digital Electronics 2 project.
+ * This work is licensed under the terms of the MIT license.
+ */
+
+/* Includes ----------------------------------------------------------*/
+#include <stdint.h>         // Fixed width integer types
+
+/* Definitions -------------------------------------------------------*/
+#define EEQ_JOBS            4       // Jobs in the queue
+#define EEQ_JOB_LEN         16      // Consecutive bytes of a job
+
+/* Function prototypes -----------------------------------------------*/
+/**
+ * @brief    Queues an EEPROM write. Call it from the main loop, it only
+ *           waits while the queue is full.
+ * @param    addr  EEPROM address, see eemap.h
+ * @param    src   Source
+ * @param    len   Number of bytes
+ * @return   none
+ */
+void eeq_write(uint16_t addr, const void *src, uint8_t len);
+
+/**
+ * @brief    Reads EEPROM with the queued bytes. Waits up to 3.4 ms for
+ *           the byte being programmed, call it from the main loop.
+ * @param    dst   Destination
+ * @param    addr  EEPROM address, see eemap.h
+ * @param    len   Number of bytes
+ * @return   none
+ */
+void eeq_read(void *dst, uint16_t addr, uint8_t len);
+
+/**
+ * @brief    Waits until everything queued so far is programmed.
+ * @return   none
+ */
+void eeq_flush(void);
+
+/**
+ * @brief    Calls a function once everything queued so far is
+ *           programmed. It runs in the EE_READY interrupt and may
+ *           queue writes, but must not wait for them.
+ * @param    done  Function to call
+ * @return   none
+ */
+void eeq_done(void (*done)(void));
+
+/**
+ * @brief    Number of bytes in the queue.
+ * @return   Bytes not yet programmed or skipped
+ */
+uint8_t eeq_pending(void);
+
+/**
+ * @brief    Programs or skips the next queued byte, or calls the next
+ *           eeq_done() function. Called by the EE_READY interrupt, with
+ *           the EEPROM ready and the interrupts off.
+ * @return   1 while the queue has more
+ */
+uint8_t eeq_step(void);
+
+#endif /* EEQ_H_ */
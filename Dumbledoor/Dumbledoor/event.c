@@ -0,0 +1,65 @@
+/***********************************************************************
+ *
+ * Door event library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/* Includes ----------------------------------------------------------*/
+#include <util/atomic.h>    // ATOMIC_BLOCK
+#include "event.h"
+#include "bus.h"            // RS-485 door bus library
+#include "evlog.h"          // Event log library
+
+/* Global Variables --------------------------------------------------*/
+static volatile uint16_t eventClock = 0;   // Seconds since reset
+static volatile uint16_t eventTicks = 0;   // Sound ticks since reset
+
+/* Function definitions ----------------------------------------------*/
+void event_tick(void)
+{
+	eventClock++;
+}
+
+/*--------------------------------------------------------------------*/
+void event_tick_sound(void)
+{
+	eventTicks++;
+}
+
+/*--------------------------------------------------------------------*/
+uint16_t event_ticks(void)
+{
+	uint16_t t;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		t = eventTicks;
+	}
+	return t;
+}
+
+/*--------------------------------------------------------------------*/
+uint16_t event_time(void)
+{
+	uint16_t t;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		t = eventClock;
+	}
+	return t;
+}
+
+/*--------------------------------------------------------------------*/
+void event_post(uint8_t type, uint8_t arg)
+{
+	uint16_t time = event_time();
+
+	bus_post(type, arg, time);
+	if (type != EV_KEY)
+		evlog_post(type, arg, time);
+}
@@ -0,0 +1,86 @@
+#ifndef EVENT_H_
+#define EVENT_H_
+
+/***********************************************************************
+ *
+ * Door event library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/**
+ * @file  event.h
+ * @defgroup dumbledoor_event Event Library <event.h>
+ * @code #include <event.h> @endcode
+ *
+ * @brief Time stamped door events for the serial link.
+ *
+ * @details
+ * The application reports what happens at the door with event_post().
+ * The library stamps the event with the seconds since reset and hands
+ * it to the serial link (see bus.h) and, key presses excepted, to the
+ * event log in EEPROM (see evlog.h). A second clock counts the sound
+ * ticks of 16.384 ms, the link times its batches with it.
+ *
+ * @author
+ * Demirkan Korbey Baglamac and Rasit Demiroren
+ *
+ * @copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * Programmed for the Digital Electronics 2 project.
+ * This work is licensed under the terms of the MIT license.
+ */
+
+/* Includes ----------------------------------------------------------*/
+#include <stdint.h>         // Fixed width integer types
+
+/* Definitions -------------------------------------------------------*/
+// Event types, the argument is given in brackets
+#define EV_BOOT         0x01    // Reset [MCUSR]
+#define EV_ENTRY        0x02    // Correct pin [user ID]
+#define EV_DENIED       0x03    // Wrong pin [0]
+#define EV_BELL         0x04    // Door bell [0]
+#define EV_STACK        0x05    // Watchdog reset [least free stack before, 255: more]
+#define EV_KEY          0x06    // Key pressed [0], never the key
+
+#define EVENT_TICK_US   16384   // Period of event_ticks()
+
+/* Function prototypes -----------------------------------------------*/
+/**
+ * @brief    Advances the event clock by one second. Call it from the
+ *           Timer/Counter1 overflow handler.
+ * @return   none
+ */
+void event_tick(void);
+
+/**
+ * @brief    Advances the tick clock. Call it with the sound tick from
+ *           the Timer/Counter2 overflow handler.
+ * @return   none
+ */
+void event_tick_sound(void);
+
+/**
+ * @brief    Sound ticks since reset, EVENT_TICK_US each, wraps after
+ *           about 18 minutes.
+ * @return   Tick clock
+ */
+uint16_t event_ticks(void);
+
+/**
+ * @brief    Seconds since reset, wraps after about 18 hours.
+ * @return   Event clock
+ */
+uint16_t event_time(void);
+
+/**
+ * @brief    Reports an event. Safe to call from interrupt handlers.
+ * @param    type  Event type EV_...
+ * @param    arg   Event argument
+ * @return   none
+ */
+void event_post(uint8_t type, uint8_t arg);
+
+#endif /* EVENT_H_ */
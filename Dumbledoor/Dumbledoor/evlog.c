@@ -0,0 +1,303 @@
+/***********************************************************************
+ *
+ * Event log library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/* Includes ----------------------------------------------------------*/
+#include <util/atomic.h>    // ATOMIC_BLOCK
+#include "evlog.h"
+#include "eemap.h"          // EE_LOG
+#include "event.h"          // EV_BOOT
+#include "frame.h"          // frame_crc16
+#include "eeq.h"            // EEPROM access
+#include "rtc.h"            // Wall clock
+
+/* Definitions -------------------------------------------------------*/
+#define EVLOG_SEQ           0       // Header offsets
+#define EVLOG_TIME          2
+#define EVLOG_CRC           6
+
+#define EVLOG_ADDR(block)   (EE_LOG + (uint16_t)(block) * EVLOG_BLOCK_LEN)
+
+typedef struct {
+	uint8_t type;
+	uint8_t arg;
+	uint16_t time;
+} evlog_event_t;
+
+/* Global Variables --------------------------------------------------*/
+static evlog_event_t evlogQueue[EVLOG_QUEUE];
+static volatile uint8_t evlogHead = 0;     // Next to write to EEPROM
+static volatile uint8_t evlogTail = 0;     // Next free slot
+
+static uint8_t evlogBlock;                 // Open block
+static uint16_t evlogSeq;                  // and its seq
+static uint8_t evlogFill;                  // Offset of its 0xFF
+static uint32_t evlogTime;                 // Time of the last record
+static uint16_t evlogHigh = 0;             // Wraps of the event clock
+static uint16_t evlogLast = 0;             // Event clock of the last record
+static uint32_t evlogUnix = 0;             // Unix time at the reset, 0 while unknown
+
+/* Function definitions ----------------------------------------------*/
+/**
+ * @brief  Writes a varint.
+ * @return Bytes written
+ */
+static uint8_t evlog_varint(uint8_t *out, uint32_t v)
+{
+	uint8_t n = 0;
+
+	while (v >= 0x80)
+	{
+		out[n++] = (uint8_t)v | 0x80;
+		v >>= 7;
+	}
+	out[n++] = (uint8_t)v;
+	return n;
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t evlog_encode(uint8_t *out, uint8_t type, uint8_t arg, uint32_t dt)
+{
+	uint16_t code = (dt < EVLOG_DT_ESC) ? (uint16_t)dt : EVLOG_DT_ESC;
+	uint8_t n = 2;
+
+	out[0] = (uint8_t)(type << 5) | code >> 8;
+	out[1] = (uint8_t)code;
+	if (arg < EVLOG_ARG_ESC)
+		out[0] |= arg << 1;
+	else
+	{
+		out[0] |= EVLOG_ARG_ESC << 1;
+		out[n++] = arg;
+	}
+	if (code == EVLOG_DT_ESC)
+		n += evlog_varint(&out[n], dt);
+	return n;
+}
+
+/*--------------------------------------------------------------------*/
+/**
+ * @brief  Reads a varint.
+ * @return Bytes read, 0 when it is cut off by the end of the block
+ */
+static uint8_t evlog_get(const uint8_t *in, uint8_t len, uint32_t *v)
+{
+	uint8_t n = 0;
+
+	*v = 0;
+	do
+	{
+		if (n >= len || n > 4)
+			return 0;
+		*v |= (uint32_t)(in[n] & 0x7F) << (7 * n);
+	} while (in[n++] & 0x80);
+	return n;
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t evlog_decode(const uint8_t *in, uint8_t len, evlog_rec_t *rec)
+{
+	uint8_t n = 2;
+	uint8_t m;
+	uint16_t code;
+	uint32_t v;
+
+	// Type 0 and 7 are no events, so 0x00 and 0xFF end the records
+	if (len < 2 || (uint8_t)(in[0] + 0x20) < 0x40)
+		return 0;
+	rec->type = in[0] >> 5;
+	rec->arg = (in[0] >> 1) & EVLOG_ARG_ESC;
+	code = (uint16_t)(in[0] & 0x01) << 8 | in[1];
+
+	if (rec->arg == EVLOG_ARG_ESC)
+	{
+		if (n >= len)
+			return 0;
+		rec->arg = in[n++];
+	}
+	if (code == EVLOG_DT_ESC)
+	{
+		m = evlog_get(&in[n], len - n, &v);
+		if (m == 0)
+			return 0;
+		n += m;
+	}
+	else
+		v = code;
+	rec->time = (rec->type == EV_BOOT) ? v : rec->time + v;
+	return n;
+}
+
+/*--------------------------------------------------------------------*/
+uint16_t evlog_crc(const uint8_t *block)
+{
+	uint16_t crc = 0xFFFF;
+
+	for (uint8_t i = 0; i < EVLOG_BLOCK_LEN; i++)
+	{
+		if (i != EVLOG_CRC && i != EVLOG_CRC + 1)
+			crc = frame_crc16(crc, block[i]);
+	}
+	return crc;
+}
+
+/*--------------------------------------------------------------------*/
+/**
+ * @brief  Writes the CRC of the open block and opens the next one, the
+ *         0xFF first and the seq last.
+ * @param  time  Time of the first record
+ */
+static void evlog_next(uint32_t time)
+{
+	uint8_t block[EVLOG_BLOCK_LEN];
+	uint16_t crc;
+	uint8_t end = EVLOG_END;
+
+	if (evlogSeq != EVLOG_SEQ_FREE)
+	{
+		eeq_read(block, EVLOG_ADDR(evlogBlock), EVLOG_BLOCK_LEN);
+		crc = evlog_crc(block);
+		eeq_write(EVLOG_ADDR(evlogBlock) + EVLOG_CRC, &crc, 2);
+	}
+
+	evlogBlock = (evlogBlock + 1) % EVLOG_BLOCKS;
+	evlogSeq++;
+	evlogFill = EVLOG_HEADER_LEN;
+	eeq_write(EVLOG_ADDR(evlogBlock) + EVLOG_HEADER_LEN, &end, 1);
+	eeq_write(EVLOG_ADDR(evlogBlock) + EVLOG_TIME, &time, 4);
+	eeq_write(EVLOG_ADDR(evlogBlock) + EVLOG_SEQ, &evlogSeq, 2);
+	evlogTime = time;
+}
+
+/*--------------------------------------------------------------------*/
+void evlog_init(void)
+{
+	uint8_t block[EVLOG_BLOCK_LEN];
+	evlog_rec_t rec;
+	uint16_t seq;
+	uint8_t n;
+
+	evlogSeq = EVLOG_SEQ_FREE;
+	evlogBlock = EVLOG_BLOCKS - 1;
+	evlogFill = EVLOG_BLOCK_LEN;
+	for (uint8_t i = 0; i < EVLOG_BLOCKS; i++)
+	{
+		eeq_read(&seq, EVLOG_ADDR(i) + EVLOG_SEQ, 2);
+		if (seq != EVLOG_SEQ_FREE && (evlogSeq == EVLOG_SEQ_FREE || seq > evlogSeq))
+		{
+			evlogSeq = seq;
+			evlogBlock = i;
+		}
+	}
+	evlogTime = 0;
+	if (evlogSeq == EVLOG_SEQ_FREE)
+		return;
+
+	// Find the end of the newest block
+	eeq_read(block, EVLOG_ADDR(evlogBlock), EVLOG_BLOCK_LEN);
+	rec.time = 0;
+	for (evlogFill = EVLOG_HEADER_LEN; evlogFill < EVLOG_BLOCK_LEN; evlogFill += n)
+	{
+		n = evlog_decode(&block[evlogFill], EVLOG_BLOCK_LEN - evlogFill, &rec);
+		if (n == 0)
+			break;
+	}
+	// Not the 0xFF of a record that never made it, start a fresh block
+	if (evlogFill < EVLOG_BLOCK_LEN && block[evlogFill] != EVLOG_END)
+		evlogFill = EVLOG_BLOCK_LEN;
+}
+
+/*--------------------------------------------------------------------*/
+void evlog_post(uint8_t type, uint8_t arg, uint16_t time)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		if ((uint8_t)(evlogTail - evlogHead) < EVLOG_QUEUE)
+		{
+			evlog_event_t *e = &evlogQueue[evlogTail % EVLOG_QUEUE];
+			e->type = type;
+			e->arg = arg;
+			e->time = time;
+			evlogTail++;
+		}
+	}
+}
+
+/*--------------------------------------------------------------------*/
+void evlog_task(void)
+{
+	evlog_event_t e;
+	uint8_t rec[EVLOG_REC_MAX + 1];
+	uint32_t time;
+	uint32_t dt;
+	uint8_t n;
+
+	if (evlogHead == evlogTail)
+		return;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		e = evlogQueue[evlogHead % EVLOG_QUEUE];
+	}
+
+	// Seconds since reset, past the wrap of the event clock after 18 h
+	if (e.type == EV_BOOT)
+	{
+		evlogHigh = 0;
+		evlogUnix = 0;
+	}
+	else if (e.time < evlogLast)
+		evlogHigh++;
+	evlogLast = e.time;
+	time = ((uint32_t)evlogHigh << 16) | e.time;
+
+	// Unix time once the clock is set, the jump to it is one escaped
+	// gap. A new block takes the clock again, as it was set or trimmed.
+	if (!evlogUnix && rtc_valid())
+		evlogUnix = rtc_now() - time;
+
+	dt = (e.type == EV_BOOT) ? time + evlogUnix : time + evlogUnix - evlogTime;
+	n = evlog_encode(rec, e.type, e.arg, dt);
+	if (evlogFill + n > EVLOG_BLOCK_LEN)
+	{
+		if (rtc_valid())
+			evlogUnix = rtc_now() - time;
+		evlog_next(time + evlogUnix);
+		dt = (e.type == EV_BOOT) ? time + evlogUnix : 0;
+		n = evlog_encode(rec, e.type, e.arg, dt);
+	}
+
+	// The rest of the record and the 0xFF after it, then its first byte
+	// over the old 0xFF, which adds it at once
+	rec[n] = EVLOG_END;
+	eeq_write(EVLOG_ADDR(evlogBlock) + evlogFill + 1, &rec[1],
+		  (evlogFill + n < EVLOG_BLOCK_LEN) ? n : n - 1);
+	eeq_write(EVLOG_ADDR(evlogBlock) + evlogFill, &rec[0], 1);
+	evlogFill += n;
+	evlogTime = (e.type == EV_BOOT) ? dt : evlogTime + dt;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		evlogHead++;
+	}
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t evlog_frame(uint8_t type, const uint8_t *payload, uint8_t len, uint8_t *reply)
+{
+	if (type != FT_LOG_READ)
+		return FRAME_NO_REPLY;
+
+	reply[0] = EVLOG_BLOCKS;
+	if (len < 2 || payload[0] >= EVLOG_BLOCKS || payload[1] >= 2)
+		return 1;
+	reply[1] = payload[0];
+	reply[2] = payload[1];
+	eeq_read(&reply[3], EVLOG_ADDR(payload[0]) + payload[1] * EVLOG_HALF, EVLOG_HALF);
+	return 3 + EVLOG_HALF;
+}
@@ -0,0 +1,160 @@
+#ifndef EVLOG_H_
+#define EVLOG_H_
+
+/***********************************************************************
+ *
+ * Event log library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/**
+ * @file  evlog.h
+ * @defgroup dumbledoor_evlog Event Log Library <evlog.h>
+ * @code #include <evlog.h> @endcode
+ *
+ * @brief Audit trail of the door events in EEPROM.
+ *
+ * @details
+ * The log is a ring of EVLOG_BLOCKS blocks of 64 bytes at EE_LOG. A
+ * block starts with a header
+ *
+ *     seq_lo | seq_hi | time (4 bytes, low first) | crc_lo | crc_hi
+ *
+ * where seq counts the blocks ever opened, so the newest block has the
+ * highest, and time is the time of its first record. The records follow,
+ * two bytes each
+ *
+ *     type (3 bits) | arg (4 bits) | dt (9 bits)
+ *
+ * where dt is the seconds since the record before, up to 510 (8.5
+ * minutes). A longer gap follows as a varint (7 bits per byte, low bits
+ * first, the top bit set on all but the last byte) with EVLOG_DT_ESC in
+ * the record, 2 bytes up to 4.5 hours and 3 up to 24 days. Every time
+ * is exact. EV_BOOT gives the seconds since the reset instead, the clock
+ * starts over. An argument of EVLOG_ARG_ESC or more follows in a byte,
+ * with EVLOG_ARG_ESC in the record; the entries of the first 15 users
+ * keep two bytes. An 8 byte record of its own would take four times
+ * the room.
+ *
+ * The times count the seconds since the reset until the wall clock
+ * (rtc.h) is set, then unix time: the record after the setting jumps to
+ * it with an escaped gap, and each new block takes the clock again in
+ * its header. EV_BOOT gives the unix time too when the clock is set.
+ * Times from EVLOG_UNIX on are unix time.
+ *
+ * Records are only appended. A record is written last byte first and
+ * the 0xFF after it before that, so until its first byte is written
+ * the block still ends where it did: a reset during the write loses
+ * the record and nothing else. A full block gets the CRC of the other
+ * 62 bytes, then the next one is opened and overwrites the oldest.
+ *
+ * Events are posted from the handlers into a short queue, evlog_task()
+ * encodes them from the main loop for the EEPROM write queue (eeq.h),
+ * which programs a record in the background. Key presses are not
+ * logged. The master reads the blocks with FT_LOG_READ, Host/log/doorlog
+ * decodes them.
+ *
+ * @author
+ * Demirkan Korbey Baglamac and Rasit Demiroren
+ *
+ * @copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * Programmed for the Digital Electronics 2 project.
+ * This work is licensed under the terms of the MIT license.
+ */
+
+/* Includes ----------------------------------------------------------*/
+#include <stdint.h>         // Fixed width integer types
+
+/* Definitions -------------------------------------------------------*/
+#define EVLOG_BLOCKS        5       // Blocks in the ring, the secrets of totp.h follow
+#define EVLOG_BLOCK_LEN     64
+#define EVLOG_HEADER_LEN    8       // seq, time, crc
+#define EVLOG_REC_MAX       8       // Record, argument byte, time varint
+#define EVLOG_ARG_ESC       0x0F    // The argument follows in a byte
+#define EVLOG_DT_ESC        0x1FF   // Longer gaps, the seconds follow as a varint
+#define EVLOG_SEQ_FREE      0xFFFF  // Never opened
+#define EVLOG_UNIX          1000000000UL // Unix time from here on, 2001-09-09
+#define EVLOG_END           0xFF    // After the last record of a block
+#define EVLOG_QUEUE         4       // Events waiting for the EEPROM, power of 2
+
+// Log frame, the door answers with type | FT_REPLY
+#define FT_LOG_READ         0x26    // [block, half] -> [blocks, block, half, 32 bytes]
+#define EVLOG_HALF          (EVLOG_BLOCK_LEN / 2)
+
+/**
+ * @brief A decoded record.
+ */
+typedef struct {
+	uint8_t type;           // EV_...
+	uint8_t arg;
+	uint32_t time;          // Seconds, unix time from EVLOG_UNIX on
+} evlog_rec_t;
+
+/* Function prototypes -----------------------------------------------*/
+/**
+ * @brief    Finds the newest block and its end. Call it before the
+ *           first event_post().
+ * @return   none
+ */
+void evlog_init(void);
+
+/**
+ * @brief    Queues an event for the log, drops it when the queue is
+ *           full. Safe to call from interrupt handlers.
+ * @param    type  EV_...
+ * @param    arg   Event argument
+ * @param    time  Event clock
+ * @return   none
+ */
+void evlog_post(uint8_t type, uint8_t arg, uint16_t time);
+
+/**
+ * @brief    Writes the oldest queued event to EEPROM. Call it from the
+ *           main loop.
+ * @return   none
+ */
+void evlog_task(void);
+
+/**
+ * @brief    Encodes a record.
+ * @param    out   EVLOG_REC_MAX bytes
+ * @param    type  EV_..., 1 to 6
+ * @param    arg   Event argument
+ * @param    dt    Seconds since the record before, since the reset for
+ *                 EV_BOOT
+ * @return   Length of the record
+ */
+uint8_t evlog_encode(uint8_t *out, uint8_t type, uint8_t arg, uint32_t dt);
+
+/**
+ * @brief    Decodes the next record of a block.
+ * @param    in    Record
+ * @param    len   Bytes left in the block
+ * @param    rec   Record, rec->time is the time of the record before
+ *                 (the block time for the first) and is advanced
+ * @return   Length of the record, 0 at the end of the records
+ */
+uint8_t evlog_decode(const uint8_t *in, uint8_t len, evlog_rec_t *rec);
+
+/**
+ * @brief    CRC of a block image, the CRC field left out.
+ * @param    block  EVLOG_BLOCK_LEN bytes
+ * @return   CRC to compare with the header
+ */
+uint16_t evlog_crc(const uint8_t *block);
+
+/**
+ * @brief    Answers FT_LOG_READ.
+ * @param    type     Frame type
+ * @param    payload  Request payload
+ * @param    len      Request payload length
+ * @param    reply    Reply payload, FRAME_PAYLOAD_MAX bytes
+ * @return   Reply payload length, FRAME_NO_REPLY for other frames
+ */
+uint8_t evlog_frame(uint8_t type, const uint8_t *payload, uint8_t len, uint8_t *reply);
+
+#endif /* EVLOG_H_ */
@@ -0,0 +1,318 @@
+/***********************************************************************
+ *
+ * Formatted output library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/* Includes ----------------------------------------------------------*/
+#include "fmt.h"
+#include "uart.h"           // UART library for AVR-GCC
+#include "lcdfb.h"          // LCD framebuffer library for AVR-GCC
+
+/* Definitions -------------------------------------------------------*/
+// Conversion flags
+#define FMT_LEFT    0x01    // '-' left align
+#define FMT_ZERO    0x02    // '0' zero padding
+#define FMT_LONG    0x04    // 'l' 32-bit argument
+#define FMT_NEG     0x08    // Negative number
+#define FMT_UPPER   0x10    // Upper case hex digits
+
+/* Global Variables --------------------------------------------------*/
+// Powers of ten used to convert numbers without a digit buffer
+static const uint32_t pow10_32[10] PROGMEM = {
+	1000000000UL, 100000000UL, 10000000UL, 1000000UL, 100000UL,
+	10000UL, 1000UL, 100UL, 10UL, 1UL
+};
+static const uint16_t pow10_16[5] PROGMEM = {
+	10000U, 1000U, 100U, 10U, 1U
+};
+
+/* Function definitions ----------------------------------------------*/
+static void fmt_put(fmt_sink_t *sink, char c)
+{
+	if (sink->left)
+	{
+		sink->left--;
+		sink->put(sink, c);
+	}
+}
+
+/*--------------------------------------------------------------------*/
+static void fmt_pad(fmt_sink_t *sink, char c, uint8_t n)
+{
+	while (n--)
+		fmt_put(sink, c);
+}
+
+/*--------------------------------------------------------------------*/
+// Emits a number with sign and padding, digits most significant first
+static void fmt_number(fmt_sink_t *sink, uint32_t v, uint8_t flags, uint8_t width, uint8_t hex)
+{
+	uint8_t digits = 1;
+	uint8_t len;
+
+	// Count the digits first, the padding goes in front of them
+	if (hex)
+	{
+		while (digits < 8 && (v >> (digits * 4)))
+			digits++;
+	}
+	else if (v <= 0xFFFF)
+	{
+		while (digits < 5 && (uint16_t)v >= pgm_read_word(&pow10_16[4 - digits]))
+			digits++;
+	}
+	else
+	{
+		digits = 5;
+		while (digits < 10 && v >= pgm_read_dword(&pow10_32[9 - digits]))
+			digits++;
+	}
+
+	len = digits + ((flags & FMT_NEG) ? 1 : 0);
+	if (!(flags & FMT_LEFT) && !(flags & FMT_ZERO) && width > len)
+		fmt_pad(sink, ' ', width - len);
+	if (flags & FMT_NEG)
+		fmt_put(sink, '-');
+	if (!(flags & FMT_LEFT) && (flags & FMT_ZERO) && width > len)
+		fmt_pad(sink, '0', width - len);
+
+	if (hex)
+	{
+		while (digits--)
+		{
+			uint8_t n = (v >> (digits * 4)) & 0x0F;
+			if (n < 10)
+				fmt_put(sink, '0' + n);
+			else
+				fmt_put(sink, ((flags & FMT_UPPER) ? 'A' : 'a') + n - 10);
+		}
+	}
+	else if (v <= 0xFFFF)
+	{
+		uint16_t v16 = v;
+		for (uint8_t i = 5 - digits; i < 5; i++)
+		{
+			uint16_t p = pgm_read_word(&pow10_16[i]);
+			char d = '0';
+			while (v16 >= p)
+			{
+				v16 -= p;
+				d++;
+			}
+			fmt_put(sink, d);
+		}
+	}
+	else
+	{
+		for (uint8_t i = 10 - digits; i < 10; i++)
+		{
+			uint32_t p = pgm_read_dword(&pow10_32[i]);
+			char d = '0';
+			while (v >= p)
+			{
+				v -= p;
+				d++;
+			}
+			fmt_put(sink, d);
+		}
+	}
+
+	if ((flags & FMT_LEFT) && width > len)
+		fmt_pad(sink, ' ', width - len);
+}
+
+/*--------------------------------------------------------------------*/
+// Emits a string from SRAM or program memory with padding
+static void fmt_string(fmt_sink_t *sink, const char *s, uint8_t progmem, uint8_t flags, uint8_t width)
+{
+	uint8_t len = 0;
+	char c;
+
+	if (s == NULL)
+		return;
+
+	// Only the characters the sink can still take are counted
+	if (width)
+	{
+		while (len < sink->left && (progmem ? pgm_read_byte(s + len) : s[len]))
+			len++;
+		if (!(flags & FMT_LEFT) && width > len)
+			fmt_pad(sink, ' ', width - len);
+	}
+
+	while (sink->left && (c = (progmem ? pgm_read_byte(s) : *s)))
+	{
+		fmt_put(sink, c);
+		s++;
+	}
+
+	if ((flags & FMT_LEFT) && width > len)
+		fmt_pad(sink, ' ', width - len);
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t fmt_vformat_p(fmt_sink_t *sink, const char *fmt, va_list ap)
+{
+	uint8_t start = sink->left;
+	char c;
+
+	while (sink->left && (c = pgm_read_byte(fmt++)))
+	{
+		uint8_t flags = 0;
+		uint8_t width = 0;
+		uint32_t v;
+
+		if (c != '%')
+		{
+			fmt_put(sink, c);
+			continue;
+		}
+
+		c = pgm_read_byte(fmt++);
+		if (c == '-')
+		{
+			flags |= FMT_LEFT;
+			c = pgm_read_byte(fmt++);
+		}
+		if (c == '0')
+		{
+			flags |= FMT_ZERO;
+			c = pgm_read_byte(fmt++);
+		}
+		while (c >= '0' && c <= '9')
+		{
+			width = width * 10 + (c - '0');
+			c = pgm_read_byte(fmt++);
+		}
+		if (width > FMT_WIDTH_MAX)
+			width = FMT_WIDTH_MAX;
+		if (c == 'l')
+		{
+			flags |= FMT_LONG;
+			c = pgm_read_byte(fmt++);
+		}
+
+		switch (c)
+		{
+		case 'd':
+			if (flags & FMT_LONG)
+			{
+				long sv = va_arg(ap, long);
+				if (sv < 0)
+					flags |= FMT_NEG;
+				v = (sv < 0) ? -(uint32_t)sv : (uint32_t)sv;
+			}
+			else
+			{
+				int sv = va_arg(ap, int);
+				if (sv < 0)
+					flags |= FMT_NEG;
+				v = (sv < 0) ? -(uint32_t)sv : (uint32_t)sv;
+			}
+			fmt_number(sink, v, flags, width, 0);
+			break;
+		case 'u':
+		case 'x':
+		case 'X':
+			if (flags & FMT_LONG)
+				v = va_arg(ap, unsigned long);
+			else
+				v = va_arg(ap, unsigned int);
+			if (c == 'X')
+				flags |= FMT_UPPER;
+			fmt_number(sink, v, flags, width, c != 'u');
+			break;
+		case 'c':
+			fmt_put(sink, (char)va_arg(ap, int));
+			break;
+		case 's':
+			fmt_string(sink, va_arg(ap, const char *), 0, flags, width);
+			break;
+		case 'S':
+			fmt_string(sink, (const char *)va_arg(ap, const wchar_t *), 1, flags, width);
+			break;
+		case '\0':
+			// Format string ends with a single '%'
+			return start - sink->left;
+		default:
+			fmt_put(sink, c);
+			break;
+		}
+	}
+
+	return start - sink->left;
+}
+
+/*--------------------------------------------------------------------*/
+static void fmt_put_uart(fmt_sink_t *sink, char c)
+{
+	(void)sink;
+	uart_putc(c);
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t fmt_uart_p(const char *fmt, ...)
+{
+	fmt_sink_t sink = { fmt_put_uart, 0, 0, FMT_UART_MAX };
+	uint8_t n;
+	va_list ap;
+
+	va_start(ap, fmt);
+	n = fmt_vformat_p(&sink, fmt, ap);
+	va_end(ap);
+	return n;
+}
+
+/*--------------------------------------------------------------------*/
+static void fmt_put_uart_low(fmt_sink_t *sink, char c)
+{
+	(void)sink;
+	uart_putc_low(c);
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t fmt_uart_low_p(const char *fmt, ...)
+{
+	fmt_sink_t sink = { fmt_put_uart_low, 0, 0, FMT_UART_MAX };
+	uint8_t n;
+	va_list ap;
+
+	va_start(ap, fmt);
+	n = fmt_vformat_p(&sink, fmt, ap);
+	va_end(ap);
+	return n;
+}
+
+/*--------------------------------------------------------------------*/
+static void fmt_put_lcd(fmt_sink_t *sink, char c)
+{
+	lcdfb_putxy(sink->x++, sink->y, c);
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t fmt_lcd_p(uint8_t x, uint8_t y, uint8_t width, const char *fmt, ...)
+{
+	fmt_sink_t sink = { fmt_put_lcd, x, y, 0 };
+	uint8_t n;
+	va_list ap;
+
+	// Clip the region to the display line
+	if (x >= LCD_DISP_LENGTH)
+		return 0;
+	if (width > LCD_DISP_LENGTH - x)
+		width = LCD_DISP_LENGTH - x;
+	sink.left = width;
+
+	va_start(ap, fmt);
+	n = fmt_vformat_p(&sink, fmt, ap);
+	va_end(ap);
+
+	// Blank the rest of the region
+	fmt_pad(&sink, ' ', sink.left);
+	return n;
+}
@@ -0,0 +1,159 @@
+#ifndef FMT_H_
+#define FMT_H_
+
+/***********************************************************************
+ *
+ * Formatted output library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/**
+ * @file  fmt.h
+ * @defgroup dumbledoor_fmt Formatted Output Library <fmt.h>
+ * @code #include <fmt.h> @endcode
+ *
+ * @brief Small printf style formatter writing straight into a sink.
+ *
+ * @details
+ * The format string is kept in program memory and is checked by the
+ * compiler like a printf() format, so a wrong conversion or argument
+ * type is a build warning. Characters go one by one into a sink: the
+ * UART transmit ring buffer or a region of the LCD framebuffer. There
+ * is no intermediate string buffer, numbers are converted most
+ * significant digit first by subtracting powers of ten.
+ *
+ * Supported conversions, with optional '-' (left align), '0' (zero
+ * padding) flags and a field width up to FMT_WIDTH_MAX:
+ *  - \%u \%d \%x \%X  16-bit unsigned, signed and hexadecimal numbers
+ *  - \%lu \%ld \%lx \%lX  32-bit variants, pass (unsigned long) / (long)
+ *  - \%c  one character
+ *  - \%s  string in SRAM
+ *  - \%S  string in program memory, pass it through FMT_P()
+ *  - \%\%  percent sign
+ *
+ * The output is bounded: one call emits at most FMT_UART_MAX characters
+ * to the UART and never more than the region width to the LCD.
+ *
+ * @author
+ * Demirkan Korbey Baglamac and Rasit Demiroren
+ *
+ * @copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * Programmed for the Digital Electronics 2 project.
+ * This work is licensed under the terms of the MIT license.
+ */
+
+/* Includes ----------------------------------------------------------*/
+#include <stdint.h>         // Fixed width integer types
+#include <stdarg.h>         // Variable argument lists
+#include <stddef.h>         // wchar_t for the %S compile time check
+#include <avr/pgmspace.h>   // Program memory strings
+
+/* Definitions -------------------------------------------------------*/
+/**
+ * @brief Largest field width, wider fields are clamped.
+ */
+#define FMT_WIDTH_MAX   20
+
+/**
+ * @brief Most characters one fmt_uart_P() call may put into the UART
+ *        transmit buffer.
+ */
+#ifndef FMT_UART_MAX
+# define FMT_UART_MAX   96
+#endif
+
+/**
+ * @brief Passes a program memory string to a \%S conversion. The cast
+ *        only satisfies the compile time format check.
+ */
+#define FMT_P(__s)      ((const wchar_t *)(__s))
+
+/**
+ * @brief Output sink of the formatter. put() is called once per
+ *        character while left is not zero.
+ */
+typedef struct fmt_sink {
+	void (*put)(struct fmt_sink *sink, char c);
+	uint8_t x;          // LCD sink: next column
+	uint8_t y;          // LCD sink: line
+	uint8_t left;       // Characters the sink still accepts
+} fmt_sink_t;
+
+/* Function prototypes -----------------------------------------------*/
+/**
+ * @brief    Formats into any sink.
+ * @param    sink  Output sink, left limits the output length
+ * @param    fmt   Format string in program memory
+ * @param    ap    Arguments
+ * @return   Number of characters given to the sink
+ */
+uint8_t fmt_vformat_p(fmt_sink_t *sink, const char *fmt, va_list ap);
+
+/**
+ * @brief    Formats into the UART transmit buffer.
+ * @param    fmt   Format string in program memory
+ * @return   Number of characters transmitted
+ * @see      fmt_uart_P
+ */
+uint8_t fmt_uart_p(const char *fmt, ...);
+
+/**
+ * @brief    Formats into the low priority UART transmit buffer, for
+ *           status and debug text. What does not fit is dropped.
+ * @param    fmt   Format string in program memory
+ * @return   Number of characters formatted
+ * @see      fmt_uart_low_P
+ */
+uint8_t fmt_uart_low_p(const char *fmt, ...);
+
+/**
+ * @brief    Formats into a region of one LCD framebuffer line. The
+ *           output is cut at the region width and the rest of the
+ *           region is filled with spaces, so no old characters remain.
+ * @param    x      First column of the region
+ * @param    y      Line of the region
+ * @param    width  Number of columns of the region
+ * @param    fmt    Format string in program memory
+ * @return   Number of formatted characters, padding excluded
+ * @see      fmt_lcd_P
+ */
+uint8_t fmt_lcd_p(uint8_t x, uint8_t y, uint8_t width, const char *fmt, ...);
+
+/**
+ * @brief    Never called, only lets the compiler check the format
+ *           string against the arguments.
+ */
+static inline void fmt_check(const char *fmt, ...)
+	__attribute__((format(printf, 1, 2)));
+static inline void fmt_check(const char *fmt, ...) { (void)fmt; }
+
+/**
+ * @brief    Macro to check the format string and put it into program
+ *           memory, then format into the UART transmit buffer.
+ */
+#define fmt_uart_P(__f, ...) \
+	(0 ? fmt_check(__f, ##__VA_ARGS__) : (void)0, \
+	 fmt_uart_p(PSTR(__f), ##__VA_ARGS__))
+
+/**
+ * @brief    Macro to check the format string and put it into program
+ *           memory, then format into the low priority UART transmit
+ *           buffer.
+ */
+#define fmt_uart_low_P(__f, ...) \
+	(0 ? fmt_check(__f, ##__VA_ARGS__) : (void)0, \
+	 fmt_uart_low_p(PSTR(__f), ##__VA_ARGS__))
+
+/**
+ * @brief    Macro to check the format string and put it into program
+ *           memory, then format into a region of the LCD framebuffer.
+ */
+#define fmt_lcd_P(__x, __y, __w, __f, ...) \
+	(0 ? fmt_check(__f, ##__VA_ARGS__) : (void)0, \
+	 fmt_lcd_p((__x), (__y), (__w), PSTR(__f), ##__VA_ARGS__))
+
+#endif /* FMT_H_ */
@@ -0,0 +1,189 @@
+/***********************************************************************
+ *
+ * Serial frame codec for AVR-GCC and the host tools.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/* Includes ----------------------------------------------------------*/
+#include "frame.h"
+#ifdef __AVR__
+#include <util/crc16.h>     // Optimized CRC routines of AVR libc
+#endif
+
+/* Definitions -------------------------------------------------------*/
+// Receiver states
+#define RX_SOF      0
+#define RX_ADDR     1
+#define RX_TYPE     2
+#define RX_SEQ      3
+#define RX_LEN      4
+#define RX_PAYLOAD  5
+#define RX_CRC_HI   6
+#define RX_CRC_LO   7
+
+/* Function definitions ----------------------------------------------*/
+uint16_t frame_crc16(uint16_t crc, uint8_t b)
+{
+#ifdef __AVR__
+	// XMODEM update is the same polynomial, only the start value differs
+	return _crc_xmodem_update(crc, b);
+#else
+	crc ^= (uint16_t)b << 8;
+	for (uint8_t i = 0; i < 8; i++)
+		crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+	return crc;
+#endif
+}
+
+/*--------------------------------------------------------------------*/
+void frame_rx_reset(frame_rx_t *rx)
+{
+	rx->state = RX_SOF;
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t frame_rx_byte(frame_rx_t *rx, uint8_t b)
+{
+	switch (rx->state)
+	{
+	case RX_SOF:
+		if (b == FRAME_SOF)
+		{
+			rx->crc = 0xFFFF;
+			rx->state = RX_ADDR;
+		}
+		break;
+	case RX_ADDR:
+		rx->addr = b;
+		rx->crc = frame_crc16(rx->crc, b);
+		rx->state = RX_TYPE;
+		break;
+	case RX_TYPE:
+		rx->type = b;
+		rx->crc = frame_crc16(rx->crc, b);
+		rx->state = RX_SEQ;
+		break;
+	case RX_SEQ:
+		rx->seq = b;
+		rx->crc = frame_crc16(rx->crc, b);
+		rx->state = RX_LEN;
+		break;
+	case RX_LEN:
+		if (b > FRAME_PAYLOAD_MAX)
+		{
+			// Not a header, maybe this byte starts the real frame
+			rx->state = RX_SOF;
+			return frame_rx_byte(rx, b);
+		}
+		rx->len = b;
+		rx->idx = 0;
+		rx->crc = frame_crc16(rx->crc, b);
+		rx->state = b ? RX_PAYLOAD : RX_CRC_HI;
+		break;
+	case RX_PAYLOAD:
+		rx->payload[rx->idx++] = b;
+		rx->crc = frame_crc16(rx->crc, b);
+		if (rx->idx == rx->len)
+			rx->state = RX_CRC_HI;
+		break;
+	case RX_CRC_HI:
+		if (b != (uint8_t)(rx->crc >> 8))
+		{
+			rx->state = RX_SOF;
+			return frame_rx_byte(rx, b);
+		}
+		rx->state = RX_CRC_LO;
+		break;
+	case RX_CRC_LO:
+		rx->state = RX_SOF;
+		if (b == (uint8_t)rx->crc)
+			return 1;
+		return frame_rx_byte(rx, b);
+	default:
+		rx->state = RX_SOF;
+		break;
+	}
+	return 0;
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t frame_write(frame_put_t put, void *ctx, uint8_t addr, uint8_t type,
+                    uint8_t seq, const uint8_t *payload, uint8_t len)
+{
+	uint16_t crc = 0xFFFF;
+
+	if (len > FRAME_PAYLOAD_MAX)
+		len = FRAME_PAYLOAD_MAX;
+
+	put(ctx, FRAME_SOF);
+	put(ctx, addr);
+	crc = frame_crc16(crc, addr);
+	put(ctx, type);
+	crc = frame_crc16(crc, type);
+	put(ctx, seq);
+	crc = frame_crc16(crc, seq);
+	put(ctx, len);
+	crc = frame_crc16(crc, len);
+	for (uint8_t i = 0; i < len; i++)
+	{
+		put(ctx, payload[i]);
+		crc = frame_crc16(crc, payload[i]);
+	}
+	put(ctx, crc >> 8);
+	put(ctx, crc & 0xFF);
+
+	return len + FRAME_OVERHEAD;
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t frame_find(const uint8_t *buf, size_t len, frame_view_t *frame, size_t *consumed)
+{
+	size_t i = 0;
+
+	while (i < len)
+	{
+		uint16_t crc = 0xFFFF;
+		uint8_t plen;
+
+		if (buf[i] != FRAME_SOF)
+		{
+			i++;
+			continue;
+		}
+		// Wait for the rest of a frame which may still be valid
+		if (len - i < FRAME_HEADER_LEN)
+			break;
+		plen = buf[i + 4];
+		if (plen > FRAME_PAYLOAD_MAX)
+		{
+			i++;
+			continue;
+		}
+		if (len - i < (size_t)plen + FRAME_OVERHEAD)
+			break;
+
+		for (uint8_t k = 1; k < FRAME_HEADER_LEN + plen; k++)
+			crc = frame_crc16(crc, buf[i + k]);
+		if (buf[i + FRAME_HEADER_LEN + plen] != (uint8_t)(crc >> 8) ||
+		    buf[i + FRAME_HEADER_LEN + plen + 1] != (uint8_t)crc)
+		{
+			i++;
+			continue;
+		}
+
+		frame->addr = buf[i + 1];
+		frame->type = buf[i + 2];
+		frame->seq = buf[i + 3];
+		frame->len = plen;
+		frame->payload = buf + i + FRAME_HEADER_LEN;
+		*consumed = i + plen + FRAME_OVERHEAD;
+		return 1;
+	}
+
+	*consumed = i;
+	return 0;
+}
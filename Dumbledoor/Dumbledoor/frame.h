@@ -0,0 +1,153 @@
+#ifndef FRAME_H_
+#define FRAME_H_
+
+/***********************************************************************
+ *
+ * Serial frame codec for AVR-GCC and the host tools.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/**
+ * @file  frame.h
+ * @defgroup dumbledoor_frame Frame Codec Library <frame.h>
+ * @code #include <frame.h> @endcode
+ *
+ * @brief Addressed, CRC protected frames for the door serial link.
+ *
+ * @details
+ * Every frame on the wire is
+ *
+ *     SOF | addr | type | seq | len | payload[len] | crc_hi | crc_lo
+ *
+ * addr is the address of the door the frame is sent to or comes from,
+ * type has FT_REPLY set when a door sends the frame, seq lets the master
+ * match a reply to its request and len is at most FRAME_PAYLOAD_MAX.
+ * The CRC is CRC-16/CCITT (polynomial 0x1021, initial value 0xFFFF)
+ * over addr..payload. A receiver that loses sync just waits for the
+ * next SOF whose header and CRC check out.
+ *
+ * The library has no AVR dependencies, the host tools are built from
+ * the same source.
+ *
+ * @author
+ * Demirkan Korbey Baglamac and Rasit Demiroren
+ *
+ * @copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * Programmed for the Digital Electronics 2 project.
+ * This work is licensed under the terms of the MIT license.
+ */
+
+/* Includes ----------------------------------------------------------*/
+#include <stdint.h>         // Fixed width integer types
+#include <stddef.h>         // size_t
+
+/* Definitions -------------------------------------------------------*/
+#define FRAME_SOF           0x7E    // Start of frame
+#define FRAME_HEADER_LEN    5       // SOF, addr, type, seq, len
+#define FRAME_OVERHEAD      7       // Header and CRC
+#define FRAME_PAYLOAD_MAX   48      // Longest payload
+#define FRAME_LEN_MAX       (FRAME_OVERHEAD + FRAME_PAYLOAD_MAX)
+
+#define FRAME_ADDR_MASTER   0x00    // Reserved, never a door
+#define FRAME_ADDR_MAX      247     // Highest door address
+#define FRAME_ADDR_BCAST    0xFF    // All doors, never answered
+
+#define FRAME_NO_REPLY      0xFF    // Module handler: not one of its frames
+
+// Frame types, doors answer with the request type | FT_REPLY
+#define FT_REPLY            0x80
+#define FT_POLL             0x01    // Master: [epoch, ack seq], door: FT_EVENTS
+#define FT_SET_ADDR         0x02    // Master: [new addr, link mode]
+#define FT_EV_ACK           0x03    // Master: [epoch, ack seq], not answered
+#define FT_EVENTS           (FT_POLL | FT_REPLY)
+#define FT_BATCH            (0x04 | FT_REPLY)   // Door in stream mode: events, see bus.h
+#define FT_ACK              (FT_SET_ADDR | FT_REPLY)
+
+/**
+ * @brief Byte wise receiver state, one per serial link.
+ */
+typedef struct {
+	uint8_t state;                      // Position inside the frame
+	uint8_t idx;                        // Payload bytes received
+	uint16_t crc;                       // Running CRC
+	uint8_t addr;
+	uint8_t type;
+	uint8_t seq;
+	uint8_t len;
+	uint8_t payload[FRAME_PAYLOAD_MAX];
+} frame_rx_t;
+
+/**
+ * @brief A frame found in a byte buffer, payload points into the
+ *        buffer (no copy).
+ */
+typedef struct {
+	uint8_t addr;
+	uint8_t type;
+	uint8_t seq;
+	uint8_t len;
+	const uint8_t *payload;
+} frame_view_t;
+
+/**
+ * @brief Byte output used by frame_write().
+ */
+typedef void (*frame_put_t)(void *ctx, uint8_t b);
+
+/* Function prototypes -----------------------------------------------*/
+/**
+ * @brief    Adds one byte to a CRC-16/CCITT.
+ * @param    crc  CRC so far, start with 0xFFFF
+ * @param    b    Next byte
+ * @return   Updated CRC
+ */
+uint16_t frame_crc16(uint16_t crc, uint8_t b);
+
+/**
+ * @brief    Resets a receiver, it waits for the next SOF.
+ * @param    rx  Receiver state
+ * @return   none
+ */
+void frame_rx_reset(frame_rx_t *rx);
+
+/**
+ * @brief    Feeds one received byte to a receiver.
+ * @param    rx  Receiver state
+ * @param    b   Received byte
+ * @return   1 when rx holds a complete frame with a valid CRC, the
+ *           frame stays valid until the next call, 0 otherwise
+ */
+uint8_t frame_rx_byte(frame_rx_t *rx, uint8_t b);
+
+/**
+ * @brief    Sends one frame byte by byte, the CRC is computed on the
+ *           fly so no frame buffer is needed.
+ * @param    put      Byte output
+ * @param    ctx      Passed to put
+ * @param    addr     Door address
+ * @param    type     Frame type
+ * @param    seq      Sequence number
+ * @param    payload  Payload bytes, may be NULL when len is 0
+ * @param    len      Payload length, clamped to FRAME_PAYLOAD_MAX
+ * @return   Number of bytes sent
+ */
+uint8_t frame_write(frame_put_t put, void *ctx, uint8_t addr, uint8_t type,
+                    uint8_t seq, const uint8_t *payload, uint8_t len);
+
+/**
+ * @brief    Looks for the first valid frame in a buffer without copying.
+ * @param    buf       Received bytes
+ * @param    len       Number of bytes in buf
+ * @param    frame     Filled in when a frame is found
+ * @param    consumed  Bytes the caller can drop: the frame and anything
+ *                     in front of it, or only the garbage in front of an
+ *                     incomplete frame
+ * @return   1 when a frame was found, 0 when more bytes are needed
+ */
+uint8_t frame_find(const uint8_t *buf, size_t len, frame_view_t *frame, size_t *consumed);
+
+#endif /* FRAME_H_ */
@@ -0,0 +1,188 @@
+#ifndef HAL_H_
+#define HAL_H_
+
+/***********************************************************************
+ *
+ * Hardware abstraction layer of the door lock.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/**
+ * @file  hal.h
+ * @defgroup dumbledoor_hal Hardware Abstraction Layer <hal.h>
+ * @code #include <hal.h> @endcode
+ *
+ * @brief Pins, key pad, display, ticks and EEPROM of the door.
+ *
+ * @details
+ * The door logic (door.c) and the libraries under it reach the hardware
+ * only through these functions, so they build for the host as well.
+ * hal_avr.c implements them for the ATmega328P, the host tools have a
+ * backend with in-memory fakes (Host/sim/hal_host.c).
+ *
+ * Serial is the uart.h interface, it is small enough to be implemented
+ * by the host backend directly. The ticks are the three timer interrupts
+ * started by hal_ticks_start(), their handlers call door_tick_keypad(),
+ * door_tick_second() and door_tick_sound(). Timer/Counter2 runs in fast
+ * PWM mode for the relay hold current and overflows every 2 ms, its
+ * handler calls door_tick_sound() every HAL_SOUND_DIV overflows. While
+ * the sampled chime plays it runs eight times faster and the handler
+ * counts HAL_CHIME_DIV overflows instead, see chime.h.
+ *
+ * The EEPROM functions are the bottom of the write queue of eeq.h, the
+ * modules use eeq_read() and eeq_write(). The backend owns the EEPROM
+ * ready interrupt, its handler calls eeq_step().
+ *
+ * @author
+ * Demirkan Korbey Baglamac and Rasit Demiroren
+ *
+ * @copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * Programmed for the Digital Electronics 2 project.
+ * This work is licensed under the terms of the MIT license.
+ */
+
+/* Includes ----------------------------------------------------------*/
+#include <stdint.h>         // Fixed width integer types
+
+/* Definitions -------------------------------------------------------*/
+// Outputs
+#define HAL_RELAY       0       // Door lock, high unlocks
+#define HAL_BELL        1       // Door bell
+#define HAL_BUZZER      2       // Key pad buzzer
+#define HAL_LED_RED     3       // Wrong pin
+#define HAL_LED_GREEN   4       // Correct pin
+#define HAL_PINS        5
+
+#define HAL_RELAY_FULL  255     // hal_relay() at full current
+
+#define HAL_SECOND_STEPS 62500U // Timer/Counter1 steps of 16 us per second tick
+#define HAL_SOUND_DIV   8       // Timer/Counter2 overflows per sound tick
+#define HAL_CHIME_DIV   128     // The same while the chime plays
+
+#define HAL_NO_KEY      ' '     // hal_keypad_scan() without a key
+
+#define HAL_GLYPH_HEART 0       // Custom characters of the display
+#define HAL_GLYPH_BELL  1
+
+/* Function prototypes -----------------------------------------------*/
+/**
+ * @brief    Initializes the display, the key pad and the outputs. All
+ *           outputs are low afterwards.
+ * @param    warm  The display kept its power over the reset, its
+ *                 power-on wait is skipped
+ * @return   none
+ */
+void hal_init(uint8_t warm);
+
+/**
+ * @brief    Starts the key pad (4 ms), second (1 s) and sound (16 ms)
+ *           ticks. Interrupts are enabled by the caller.
+ * @return   none
+ */
+void hal_ticks_start(void);
+
+/**
+ * @brief    Sets an output.
+ * @param    pin   HAL_...
+ * @param    high  0: low, otherwise high
+ * @return   none
+ */
+void hal_pin_write(uint8_t pin, uint8_t high);
+
+/**
+ * @brief    Drives the relay. Full current and off are port levels, the
+ *           values between are the duty of a 488 Hz PWM on the relay
+ *           pin. Use it instead of hal_pin_write() for HAL_RELAY.
+ * @param    duty  0: off, HAL_RELAY_FULL: on, otherwise duty of 255
+ * @return   none
+ */
+void hal_relay(uint8_t duty);
+
+/**
+ * @brief    Starts or stops the speaker PWM of the chime on OC2B (PD3).
+ *           Timer/Counter2 overflows every 128 us while it runs, every
+ *           2 ms otherwise. Call it at a sound tick.
+ * @param    on  0: stop, the speaker pin low, otherwise start at the
+ *               middle level
+ * @return   none
+ */
+void hal_chime(uint8_t on);
+
+/**
+ * @brief    Sets the speaker PWM for the next period.
+ * @param    level  Duty of 256
+ * @return   none
+ */
+void hal_chime_write(uint8_t level);
+
+/**
+ * @brief    Toggles an output.
+ * @param    pin  HAL_...
+ * @return   none
+ */
+void hal_pin_toggle(uint8_t pin);
+
+/**
+ * @brief    Scans the key pad once.
+ * @return   '0'..'9', '*', '#' or HAL_NO_KEY
+ */
+uint8_t hal_keypad_scan(void);
+
+/**
+ * @brief    Moves the display cursor.
+ * @param    x  Column
+ * @param    y  Line
+ * @return   none
+ */
+void hal_display_goto(uint8_t x, uint8_t y);
+
+/**
+ * @brief    Writes a character at the cursor, the cursor moves right.
+ * @param    c  Character or HAL_GLYPH_...
+ * @return   none
+ */
+void hal_display_putc(char c);
+
+/**
+ * @brief    Reads EEPROM, without the writes still queued. Waits up to
+ *           3.4 ms for the byte being programmed, call it from the main
+ *           loop.
+ * @param    dst   Destination
+ * @param    addr  EEPROM address, see eemap.h
+ * @param    len   Number of bytes
+ * @return   none
+ */
+void hal_ee_read(void *dst, uint16_t addr, uint8_t len);
+
+/**
+ * @brief    Programs one EEPROM byte unless it holds the value already.
+ *           Called by eeq_step() with the EEPROM ready and the
+ *           interrupts off, it does not wait for the write.
+ * @param    addr   EEPROM address, see eemap.h
+ * @param    value  New value
+ * @return   none
+ */
+void hal_ee_update(uint16_t addr, uint8_t value);
+
+/**
+ * @brief    Turns the EEPROM ready interrupt on or off. While it is on,
+ *           eeq_step() is called whenever the EEPROM is ready, until it
+ *           returns 0; then the interrupt turns itself off.
+ * @param    on  1: on, 0: off
+ * @return   1 when it was on
+ */
+uint8_t hal_ee_ready(uint8_t on);
+
+/**
+ * @brief    Waits a little for the EEPROM. With the interrupts off it
+ *           calls eeq_step() itself when the ready interrupt is on and
+ *           the EEPROM is ready, so a wait for the queue cannot hang.
+ * @return   1 while a byte is being programmed
+ */
+uint8_t hal_ee_poll(void);
+
+#endif /* HAL_H_ */
@@ -0,0 +1,221 @@
+/***********************************************************************
+ *
+ * Hardware abstraction layer of the door lock, AVR backend.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/* Includes ----------------------------------------------------------*/
+#include <avr/io.h>         // AVR device-specific IO definitions
+#include <avr/eeprom.h>     // EEPROM access
+#include <avr/interrupt.h>  // EEPROM ready interrupt
+#include <util/atomic.h>    // ATOMIC_BLOCK
+#include "hal.h"
+#include "eeq.h"            // EEPROM write queue library
+#include "stack.h"          // Stack usage library
+#include "timer.h"          // Timer library for AVR-GCC
+#include "lcd.h"            // LCD library for AVR-GCC
+#include "gpio.h"           // GPIO library for AVR-GCC
+#include "keypad.h"         // Key pad library for AVR-GCC
+
+/* Global Variables --------------------------------------------------*/
+// Port B bits of the outputs, in HAL_... order
+static const uint8_t halPinBit[HAL_PINS] = {
+	PB3,    // HAL_RELAY, OC2A
+	PB4,    // HAL_BELL
+	PB5,    // HAL_BUZZER
+	PB6,    // HAL_LED_RED
+	PB7     // HAL_LED_GREEN
+};
+
+// Custom characters for the lcd display
+static const uint8_t halGlyphs[16] = {
+	// addr 0: Heart
+	0b00000, 0b00000, 0b01010, 0b11111, 0b01110, 0b00100, 0b00000, 0b00000,
+	// addr 1: Bell
+	0b00000, 0b00100, 0b01110, 0b01110, 0b11111, 0b00100, 0b00000, 0b00000
+};
+
+/* Function definitions ----------------------------------------------*/
+void hal_init(uint8_t warm)
+{
+	// Initialize the LCD Display
+	if (warm)
+		lcd_init_warm(LCD_DISP_ON);
+	else
+		lcd_init(LCD_DISP_ON);
+
+	// Initialize the Key Pad
+	keypad_init();
+
+	// Store the custom characters to CGRAM line by line
+	lcd_command(1 << LCD_CGRAM);
+	for (uint8_t i = 0; i < sizeof(halGlyphs); i++)
+		lcd_data(halGlyphs[i]);
+	lcd_command(1 << LCD_DDRAM);
+
+	// Relay, door bell, buzzer and leds as outputs, set low
+	for (uint8_t pin = 0; pin < HAL_PINS; pin++)
+	{
+		GPIO_config_output(&DDRB, halPinBit[pin]);
+		GPIO_write_low(&PORTB, halPinBit[pin]);
+	}
+
+	// Speaker of the chime, OC2B, low until it plays
+	GPIO_config_output(&DDRD, PD3);
+	GPIO_write_low(&PORTD, PD3);
+}
+
+/*--------------------------------------------------------------------*/
+void hal_ticks_start(void)
+{
+	// Timer/Counter0 scans the key pad
+	TIM0_overflow_4ms();
+	TIM0_overflow_interrupt_enable();
+
+	// Timer/Counter1 counts the seconds, in CTC mode up to OCR1A: its
+	// overflow would come every 1.048576 s, too far off for the trim
+	OCR1A = HAL_SECOND_STEPS - 1;
+	TCCR1B |= (1 << WGM12);
+	TIM1_overflow_1s();
+	TIMSK1 |= (1 << OCIE1A);
+
+	// Timer/Counter2 drives the buzzers, in fast PWM mode for the hold
+	// current of the relay, the overflow period stays the same
+	TCCR2A |= (1 << WGM21) | (1 << WGM20);
+	TIM2_overflow_2ms();
+	TIM2_overflow_interrupt_enable();
+}
+
+/*--------------------------------------------------------------------*/
+void hal_pin_write(uint8_t pin, uint8_t high)
+{
+	if (high)
+		GPIO_write_high(&PORTB, halPinBit[pin]);
+	else
+		GPIO_write_low(&PORTB, halPinBit[pin]);
+}
+
+/*--------------------------------------------------------------------*/
+void hal_relay(uint8_t duty)
+{
+	if (duty == 0 || duty == HAL_RELAY_FULL)
+	{
+		// Port level, OC2A disconnected
+		TCCR2A &= ~((1 << COM2A1) | (1 << COM2A0));
+		hal_pin_write(HAL_RELAY, duty);
+	}
+	else
+	{
+		// Non-inverting fast PWM on OC2A, the relay pin
+		OCR2A = duty;
+		TCCR2A |= (1 << COM2A1);
+	}
+}
+
+/*--------------------------------------------------------------------*/
+// The overflow handler counts HAL_CHIME_DIV or HAL_SOUND_DIV periods
+// to the sound tick, the prescaler changes with it
+void hal_chime(uint8_t on)
+{
+	if (on)
+	{
+		OCR2B = 0x80;
+		TCCR2A |= (1 << COM2B1);
+		TIM2_overflow_128u();
+		TIFR2 = (1 << OCF2B);
+		TIMSK2 |= (1 << OCIE2B);
+	}
+	else
+	{
+		TIMSK2 &= ~(1 << OCIE2B);
+		TCCR2A &= ~((1 << COM2B1) | (1 << COM2B0));
+		GPIO_write_low(&PORTD, PD3);
+		TIM2_overflow_2ms();
+	}
+}
+
+/*--------------------------------------------------------------------*/
+void hal_chime_write(uint8_t level)
+{
+	OCR2B = level;
+}
+
+/*--------------------------------------------------------------------*/
+void hal_pin_toggle(uint8_t pin)
+{
+	GPIO_toggle(&PORTB, halPinBit[pin]);
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t hal_keypad_scan(void)
+{
+	return keypad_scan();
+}
+
+/*--------------------------------------------------------------------*/
+void hal_display_goto(uint8_t x, uint8_t y)
+{
+	lcd_gotoxy(x, y);
+}
+
+/*--------------------------------------------------------------------*/
+void hal_display_putc(char c)
+{
+	lcd_putc(c);
+}
+
+/*--------------------------------------------------------------------*/
+// Only the main loop reads EEPROM. The wait for a byte being programmed
+// keeps the interrupts on, the read keeps the address register to itself
+void hal_ee_read(void *dst, uint16_t addr, uint8_t len)
+{
+	eeprom_busy_wait();
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		eeprom_read_block(dst, (const void *)(uintptr_t)addr, len);
+	}
+}
+
+/*--------------------------------------------------------------------*/
+// The EEPROM is ready and the interrupts are off, eeprom_write_byte()
+// starts the write and returns
+void hal_ee_update(uint16_t addr, uint8_t value)
+{
+	if (eeprom_read_byte((const uint8_t *)(uintptr_t)addr) != value)
+		eeprom_write_byte((uint8_t *)(uintptr_t)addr, value);
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t hal_ee_ready(uint8_t on)
+{
+	uint8_t was = (EECR & _BV(EERIE)) ? 1 : 0;
+
+	if (on)
+		EECR |= _BV(EERIE);
+	else
+		EECR &= ~_BV(EERIE);
+	return was;
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t hal_ee_poll(void)
+{
+	// With the interrupts on the handler does it
+	if (!(SREG & _BV(SREG_I)) && (EECR & _BV(EERIE)) && !(EECR & _BV(EEPE)))
+		if (!eeq_step())
+			EECR &= ~_BV(EERIE);
+	return (EECR & _BV(EEPE)) ? 1 : 0;
+}
+
+/*--------------------------------------------------------------------*/
+ISR(EE_READY_vect)
+{
+	stack_isr_enter(STACK_ISR_EEPROM);
+	if (!eeq_step())
+		EECR &= ~_BV(EERIE);
+	stack_isr_leave();
+}
@@ -498,6 +498,10 @@ void lcd_puts_p(const char *progmem_s)
     }
 }/* lcd_puts_p */
 
+/* DUMBLEDOOR: set by lcd_init_warm() */
+static uint8_t lcd_warm = 0;
+
+
 /*************************************************************************
 *  Initialize display and select type of cursor
 *  Input:    dispAttr LCD_DISP_OFF            display off
@@ -542,7 +546,8 @@ void lcd_init(uint8_t dispAttr)
         DDR(LCD_DATA2_PORT) |= _BV(LCD_DATA2_PIN);
         DDR(LCD_DATA3_PORT) |= _BV(LCD_DATA3_PIN);
     }
-    delay(LCD_DELAY_BOOTUP); /* wait 16ms or more after power-on       */
+    if (!lcd_warm)               /* DUMBLEDOOR: powered already */
+        delay(LCD_DELAY_BOOTUP); /* wait 16ms or more after power-on       */
 
     /* initial write to lcd is 8bit */
     LCD_DATA1_PORT |= _BV(LCD_DATA1_PIN); // LCD_FUNCTION>>4;
@@ -596,3 +601,16 @@ void lcd_init(uint8_t dispAttr)
     lcd_command(LCD_MODE_DEFAULT); /* set entry mode               */
     lcd_command(dispAttr);         /* display/cursor control       */
 }/* lcd_init */
+
+
+/*************************************************************************
+*  DUMBLEDOOR: initialize a display which stayed powered over a reset
+*  Input:    dispAttr see lcd_init()
+*  Returns:  none
+*************************************************************************/
+void lcd_init_warm(uint8_t dispAttr)
+{
+    lcd_warm = 1;
+    lcd_init(dispAttr);
+    lcd_warm = 0;
+}/* lcd_init_warm */
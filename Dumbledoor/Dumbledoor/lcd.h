@@ -290,6 +290,15 @@
 extern void lcd_init(uint8_t dispAttr);
 
 
+/**
+ * @brief    Initialize a display which kept its power over a reset of
+ *           the MCU, without the power-on wait. DUMBLEDOOR
+ * @param    dispAttr see lcd_init()
+ * @return  none
+ */
+extern void lcd_init_warm(uint8_t dispAttr);
+
+
 /**
  * @brief    Clear display and set cursor to home position
  * @return   none
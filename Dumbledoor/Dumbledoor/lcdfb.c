@@ -0,0 +1,126 @@
+/***********************************************************************
+ *
+ * LCD framebuffer library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/* Includes ----------------------------------------------------------*/
+#include <util/atomic.h>    // ATOMIC_BLOCK
+#include "lcdfb.h"
+#include "hal.h"            // Display output
+
+/* Definitions -------------------------------------------------------*/
+#define LCDFB_CLEAN 0xFF    // dirtyLo value of a line without changes
+
+/* Global Variables --------------------------------------------------*/
+static char frame[LCD_LINES][LCD_DISP_LENGTH];     // Display contents
+static volatile uint8_t dirtyLo[LCD_LINES] = {     // First changed column
+	[0 ... LCD_LINES - 1] = LCDFB_CLEAN
+};
+static volatile uint8_t dirtyHi[LCD_LINES];        // Last changed column
+static uint8_t curX = 0;                           // Cursor column
+static uint8_t curY = 0;                           // Cursor line
+
+/* Function definitions ----------------------------------------------*/
+void lcdfb_clear(void)
+{
+	for (uint8_t y = 0; y < LCD_LINES; y++)
+	{
+		for (uint8_t x = 0; x < LCD_DISP_LENGTH; x++)
+			frame[y][x] = ' ';
+		dirtyLo[y] = 0;
+		dirtyHi[y] = LCD_DISP_LENGTH - 1;
+	}
+	curX = 0;
+	curY = 0;
+}
+
+/*--------------------------------------------------------------------*/
+void lcdfb_gotoxy(uint8_t x, uint8_t y)
+{
+	curX = x;
+	curY = y;
+}
+
+/*--------------------------------------------------------------------*/
+void lcdfb_putxy(uint8_t x, uint8_t y, char c)
+{
+	if (x >= LCD_DISP_LENGTH || y >= LCD_LINES)
+		return;
+	// The display already shows the cell or will get it with the next flush
+	if (frame[y][x] == c)
+		return;
+
+	frame[y][x] = c;
+	if (dirtyLo[y] == LCDFB_CLEAN)
+	{
+		dirtyLo[y] = x;
+		dirtyHi[y] = x;
+	}
+	else
+	{
+		if (x < dirtyLo[y])
+			dirtyLo[y] = x;
+		if (x > dirtyHi[y])
+			dirtyHi[y] = x;
+	}
+}
+
+/*--------------------------------------------------------------------*/
+void lcdfb_putc(char c)
+{
+	lcdfb_putxy(curX, curY, c);
+	if (curX < LCD_DISP_LENGTH)
+		curX++;
+}
+
+/*--------------------------------------------------------------------*/
+void lcdfb_puts(const char *s)
+{
+	char c;
+
+	while ((c = *s++))
+		lcdfb_putc(c);
+}
+
+/*--------------------------------------------------------------------*/
+void lcdfb_puts_p(const char *progmem_s)
+{
+	char c;
+
+	while ((c = pgm_read_byte(progmem_s++)))
+		lcdfb_putc(c);
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t lcdfb_flush(void)
+{
+	uint8_t written = 0;
+	uint8_t lo, hi;
+
+	for (uint8_t y = 0; y < LCD_LINES; y++)
+	{
+		// Take the dirty span, a write during the flush marks it again
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			lo = dirtyLo[y];
+			hi = dirtyHi[y];
+			dirtyLo[y] = LCDFB_CLEAN;
+			dirtyHi[y] = 0;
+		}
+		if (lo == LCDFB_CLEAN)
+			continue;
+
+		hal_display_goto(lo, y);
+		for (uint8_t x = lo; x <= hi; x++)
+		{
+			hal_display_putc(frame[y][x]);
+			written++;
+		}
+	}
+	return written;
+}
@@ -0,0 +1,108 @@
+#ifndef LCDFB_H_
+#define LCDFB_H_
+
+/***********************************************************************
+ *
+ * LCD framebuffer library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/**
+ * @file  lcdfb.h
+ * @defgroup dumbledoor_lcdfb LCD Framebuffer Library <lcdfb.h>
+ * @code #include <lcdfb.h> @endcode
+ *
+ * @brief SRAM shadow of the HD44780 display for AVR-GCC.
+ *
+ * @details
+ * Every write to the HD44780 costs about 0.8 ms in 4-bit mode without
+ * the R/W line, which is far too slow for the interrupt handlers. The
+ * library keeps a copy of the whole display in SRAM and records the
+ * changed column span of each line. Interrupt handlers only touch the
+ * SRAM copy, and lcdfb_flush() copies the changed cells to the display
+ * from the main loop.
+ *
+ * @author
+ * Demirkan Korbey Baglamac and Rasit Demiroren
+ *
+ * @copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * Programmed for the Digital Electronics 2 project.
+ * This work is licensed under the terms of the MIT license.
+ */
+
+/* Includes ----------------------------------------------------------*/
+#include <avr/pgmspace.h>   // Program memory strings
+#include "lcd.h"            // LCD library for AVR-GCC
+
+/* Function prototypes -----------------------------------------------*/
+/**
+ * @brief    Fills the framebuffer with spaces and moves the cursor
+ *           to the home position. The whole display is marked dirty.
+ * @return   none
+ */
+void lcdfb_clear(void);
+
+/**
+ * @brief    Sets the framebuffer cursor used by lcdfb_putc() and
+ *           lcdfb_puts().
+ * @param    x  Column (0: left most position)
+ * @param    y  Line (0: first line)
+ * @return   none
+ */
+void lcdfb_gotoxy(uint8_t x, uint8_t y);
+
+/**
+ * @brief    Stores one character at the given cell. Cells outside the
+ *           display are ignored, so callers can never write past the
+ *           framebuffer.
+ * @param    x  Column
+ * @param    y  Line
+ * @param    c  Character code (0..7 are the CGRAM characters)
+ * @return   none
+ */
+void lcdfb_putxy(uint8_t x, uint8_t y, char c);
+
+/**
+ * @brief    Stores one character at the cursor and advances the cursor.
+ *           There is no line wrap, characters past the end of the line
+ *           are dropped.
+ * @param    c  Character code
+ * @return   none
+ */
+void lcdfb_putc(char c);
+
+/**
+ * @brief    Stores a string from SRAM at the cursor.
+ * @param    s  Zero terminated string
+ * @return   none
+ */
+void lcdfb_puts(const char *s);
+
+/**
+ * @brief    Stores a string from program memory at the cursor.
+ * @param    progmem_s  Zero terminated string in flash
+ * @return   none
+ */
+void lcdfb_puts_p(const char *progmem_s);
+
+/**
+ * @brief    Macro to automatically put a string constant into program
+ *           memory.
+ */
+#define lcdfb_puts_P(__s) lcdfb_puts_p(PSTR(__s))
+
+/**
+ * @brief    Writes the dirty cells of the framebuffer to the display.
+ *           Must be called from the main loop only, it is the only
+ *           function of the library which talks to the display.
+ *           Cells changed by an interrupt during the flush are written
+ *           again by the next call.
+ * @return   Number of characters written to the display
+ */
+uint8_t lcdfb_flush(void);
+
+#endif /* LCDFB_H_ */
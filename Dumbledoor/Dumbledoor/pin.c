@@ -0,0 +1,59 @@
+/***********************************************************************
+ *
+ * PIN accumulator library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/* Includes ----------------------------------------------------------*/
+#include <string.h>         // memset
+#include <avr/pgmspace.h>   // Key in program memory
+#include "pin.h"
+
+/* Global Variables --------------------------------------------------*/
+static const uint8_t pinKey[SIPHASH_KEY_LEN] PROGMEM = {PIN_KEY};
+
+/* Function definitions ----------------------------------------------*/
+void pin_start(pin_t *pin)
+{
+	uint8_t key[SIPHASH_KEY_LEN];
+
+	memcpy_P(key, pinKey, sizeof(key));
+	siphash_init(&pin->hash, key);
+	memset(key, 0, sizeof(key));
+	pin->len = 0;
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t pin_digit(pin_t *pin, char digit)
+{
+	if (pin->len < PIN_MAX)
+	{
+		siphash_word(&pin->hash, (uint8_t)digit);
+		pin->len++;
+	}
+	return pin->len;
+}
+
+/*--------------------------------------------------------------------*/
+uint64_t pin_finish(pin_t *pin)
+{
+	uint64_t h = siphash_final(&pin->hash, 0, pin->len * 8);
+
+	memset(pin, 0, sizeof(*pin));
+	return h;
+}
+
+/*--------------------------------------------------------------------*/
+uint64_t pin_hash(const char *digits, uint8_t len)
+{
+	pin_t pin;
+
+	pin_start(&pin);
+	while (len--)
+		pin_digit(&pin, *digits++);
+	return pin_finish(&pin);
+}
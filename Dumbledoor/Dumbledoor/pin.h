@@ -0,0 +1,101 @@
+#ifndef PIN_H_
+#define PIN_H_
+
+/***********************************************************************
+ *
+ * PIN accumulator library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/**
+ * @file  pin.h
+ * @defgroup dumbledoor_pin PIN Accumulator Library <pin.h>
+ * @code #include <pin.h> @endcode
+ *
+ * @brief PIN entry of PIN_MIN to PIN_MAX digits without a digit buffer.
+ *
+ * @details
+ * Every typed digit goes into a SipHash-2-4 state (siphash.h) under
+ * PIN_KEY at once, as a message word of its own: the digit in the low
+ * byte, seven zero bytes. The key pad tick keeps the state and the
+ * count and nothing else. `#` or the PIN_MAX-th digit ends the entry:
+ * pin_finish() gives the 64-bit hash of the 8 * len byte message and
+ * clears the state. The user table stores this hash as the credential
+ * of a user and looks it up with users_match(), a filter and one probe
+ * of an index in SRAM.
+ *
+ * PIN_KEY is the secret of an installation and has no default, the
+ * build stops without it: 16 random bytes of its own for every
+ * installation, kept out of the repository, for example in the symbols
+ * of the project as PIN_KEY=0x.., ... A hash of one of the 10^4 four
+ * digit pins is reversed in milliseconds by whoever knows the key, so
+ * the table read out of the EEPROM is only safe as long as the key is.
+ * The firmware and the host tools (doorprov) must be built with the
+ * same key.
+ *
+ * @author
+ * Demirkan Korbey Baglamac and Rasit Demiroren
+ *
+ * @copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * Programmed for the Digital Electronics 2 project.
+ * This work is licensed under the terms of the MIT license.
+ */
+
+/* Includes ----------------------------------------------------------*/
+#include <stdint.h>         // Fixed width integer types
+#include "siphash.h"        // SipHash library
+
+/* Definitions -------------------------------------------------------*/
+#define PIN_MIN             4       // Shorter entries are wrong
+#define PIN_MAX             10      // The entry ends by itself
+
+// Key of the credentials, SIPHASH_KEY_LEN bytes of the installation
+#ifndef PIN_KEY
+# error PIN_KEY is the key of this installation, define it for the build
+#endif
+
+/**
+ * @brief An entry being typed.
+ */
+typedef struct {
+	siphash_t hash;         // Of the digits so far
+	uint8_t len;            // Digits so far
+} pin_t;
+
+/* Function prototypes -----------------------------------------------*/
+/**
+ * @brief    Starts an entry.
+ * @param    pin  Entry
+ * @return   none
+ */
+void pin_start(pin_t *pin);
+
+/**
+ * @brief    Adds a digit to an entry, two SipRounds. Digits past
+ *           PIN_MAX are ignored.
+ * @param    pin    Entry
+ * @param    digit  '0' to '9'
+ * @return   Digits so far
+ */
+uint8_t pin_digit(pin_t *pin, char digit);
+
+/**
+ * @brief    Ends an entry and clears it, six SipRounds.
+ * @param    pin  Entry
+ * @return   Credential for users_match()
+ */
+uint64_t pin_finish(pin_t *pin);
+
+/**
+ * @brief    Credential of a PIN, the same as typing it.
+ * @param    digits  Digits
+ * @param    len     Number of digits
+ * @return   Credential
+ */
+uint64_t pin_hash(const char *digits, uint8_t len);
+
+#endif /* PIN_H_ */
@@ -0,0 +1,71 @@
+/***********************************************************************
+ *
+ * Door lock relay library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/* Includes ----------------------------------------------------------*/
+#include <util/atomic.h>    // ATOMIC_BLOCK
+#include "relay.h"
+#include "hal.h"            // Relay output
+#include "config.h"         // Unlock time and relay drive
+
+/* Global Variables --------------------------------------------------*/
+static volatile uint8_t relaySeconds = 0;   // Second ticks left, 0: locked
+static volatile uint8_t relayPullIn = 0;    // Sound ticks left at full current
+
+/* Function definitions ----------------------------------------------*/
+void relay_lock(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		relaySeconds = 0;
+		relayPullIn = 0;
+		hal_relay(0);
+	}
+}
+
+/*--------------------------------------------------------------------*/
+void relay_unlock(uint8_t seconds)
+{
+	if (seconds == 0)
+		seconds = config.unlock;
+	if (seconds > RELAY_UNLOCK_MAX_S)
+		seconds = RELAY_UNLOCK_MAX_S;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		// The first second tick comes within a second, one more tick
+		// makes the time a lower bound
+		relaySeconds = seconds + 1;
+		relayPullIn = config.pullIn;
+		hal_relay(HAL_RELAY_FULL);
+	}
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t relay_open(void)
+{
+	return relaySeconds != 0;
+}
+
+/*--------------------------------------------------------------------*/
+void relay_tick_sound(void)
+{
+	if (relayPullIn && --relayPullIn == 0 && relaySeconds)
+		hal_relay(config.holdDuty);
+}
+
+/*--------------------------------------------------------------------*/
+void relay_tick_second(void)
+{
+	if (relaySeconds && --relaySeconds == 0)
+	{
+		relayPullIn = 0;
+		hal_relay(0);
+	}
+}
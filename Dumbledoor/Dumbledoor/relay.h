@@ -0,0 +1,91 @@
+#ifndef RELAY_H_
+#define RELAY_H_
+
+/***********************************************************************
+ *
+ * Door lock relay library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/**
+ * @file  relay.h
+ * @defgroup dumbledoor_relay Relay Library <relay.h>
+ * @code #include <relay.h> @endcode
+ *
+ * @brief Timed unlock with a pull-in pulse and a reduced hold current.
+ *
+ * @details
+ * relay_unlock() drives the relay at full current for RELAY_PULL_IN
+ * sound ticks, long enough for the armature to pull in, then holds it
+ * with RELAY_HOLD_DUTY on the Timer/Counter2 compare output, which
+ * needs far less current than pulling in. The relay is released after
+ * the unlock time, counted by the second tick, whatever the door logic
+ * does meanwhile. Both ticks run in timer interrupts, so a stuck main
+ * loop cannot keep the door open; when the interrupts stop as well the
+ * watchdog resets the door and the reset releases the relay pin.
+ *
+ * The unlock time is the one of the configuration (see config.h)
+ * unless the user has an own time in the user table. The pull-in and the
+ * hold duty are settings there as well, the values here are their
+ * defaults.
+ *
+ * @author
+ * Demirkan Korbey Baglamac and Rasit Demiroren
+ *
+ * @copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * Programmed for the Digital Electronics 2 project.
+ * This work is licensed under the terms of the MIT license.
+ */
+
+/* Includes ----------------------------------------------------------*/
+#include <stdint.h>         // Fixed width integer types
+
+/* Definitions -------------------------------------------------------*/
+#ifndef RELAY_UNLOCK_S
+#define RELAY_UNLOCK_S      3       // Unlock time of the door in seconds
+#endif
+#define RELAY_UNLOCK_MAX_S  30      // Longest unlock time of a user
+#define RELAY_PULL_IN       6       // Sound ticks at full current, 98 ms
+#define RELAY_HOLD_DUTY     96      // Hold duty of 255, 38 %
+
+/* Function prototypes -----------------------------------------------*/
+/**
+ * @brief    Releases the relay at once and stops the unlock timer.
+ * @return   none
+ */
+void relay_lock(void);
+
+/**
+ * @brief    Pulls the relay in and starts the unlock timer, again from
+ *           the start when the door is unlocked already.
+ * @param    seconds  Unlock time, 0 for the door default, at most
+ *                    RELAY_UNLOCK_MAX_S
+ * @return   none
+ */
+void relay_unlock(uint8_t seconds);
+
+/**
+ * @brief    Tells whether the door is unlocked.
+ * @return   1 while the relay is driven
+ */
+uint8_t relay_open(void);
+
+/**
+ * @brief    Goes from the pull-in pulse to the hold current. Called by
+ *           door_tick_sound().
+ * @return   none
+ */
+void relay_tick_sound(void);
+
+/**
+ * @brief    Counts the unlock time down and releases the relay. Called
+ *           by door_tick_second().
+ * @return   none
+ */
+void relay_tick_second(void);
+
+#endif /* RELAY_H_ */
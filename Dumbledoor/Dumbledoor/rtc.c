@@ -0,0 +1,246 @@
+/***********************************************************************
+ *
+ * Wall clock library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/* Includes ----------------------------------------------------------*/
+#include <util/atomic.h>    // ATOMIC_BLOCK
+#include "rtc.h"
+#include "config.h"         // Time zone
+#include "eemap.h"          // EEPROM layout
+#include "eeq.h"            // EEPROM access
+#include "frame.h"          // FRAME_NO_REPLY
+
+/* Definitions -------------------------------------------------------*/
+#define RTC_TRIM_CHECK  0x5A    // Third byte at EE_RTC_TRIM: lo ^ hi ^ this
+#define RTC_TRIM_SAVE   17      // About 1 ppm, smaller changes are not written
+
+/* Global Variables --------------------------------------------------*/
+static volatile uint32_t rtcTime = 0;      // Unix time, 0: not set
+static volatile int32_t rtcFrac = 0;       // Trim summed up, 1 / RTC_TRIM_ONE s
+static volatile int16_t rtcTrim = 0;
+static int16_t rtcTrimSaved = 0;
+
+// Local time for the schedules, counted along with rtcTime
+static volatile uint16_t rtcSec = 0;       // Seconds into the hour
+static volatile uint8_t rtcHour = RTC_NO_HOUR;
+
+// Time of the master at the first sync, and the ticks since then
+static uint32_t rtcRef = 0;
+static volatile uint32_t rtcTicks = 0;
+
+/* Function definitions ----------------------------------------------*/
+// Hour of the week of rtcTime, with the interrupts off
+static void rtc_local(void)
+{
+	uint32_t local = rtcTime + (uint32_t)(((int32_t)config.tz - CONFIG_TZ_UTC) * 900);
+	uint32_t days = local / 86400UL;
+	uint32_t sec = local % 86400UL;
+
+	// 1970-01-01 was a Thursday, day 3 of a week starting on Monday
+	rtcHour = (uint8_t)((days + 3) % 7) * 24 + (uint8_t)(sec / 3600);
+	rtcSec = (uint16_t)(sec % 3600);
+}
+
+/*--------------------------------------------------------------------*/
+static void trim_save(int16_t trim)
+{
+	uint8_t buf[3];
+
+	if (trim - rtcTrimSaved < RTC_TRIM_SAVE && rtcTrimSaved - trim < RTC_TRIM_SAVE)
+		return;
+	buf[0] = trim & 0xFF;
+	buf[1] = (uint16_t)trim >> 8;
+	buf[2] = buf[0] ^ buf[1] ^ RTC_TRIM_CHECK;
+	eeq_write(EE_RTC_TRIM, buf, sizeof(buf));
+	rtcTrimSaved = trim;
+}
+
+/*--------------------------------------------------------------------*/
+void rtc_init(void)
+{
+	uint8_t buf[3];
+	int16_t trim;
+
+	// Erased EEPROM fails the check, no trim
+	eeq_read(buf, EE_RTC_TRIM, sizeof(buf));
+	trim = (int16_t)(buf[0] | (buf[1] << 8));
+	if ((buf[0] ^ buf[1] ^ RTC_TRIM_CHECK) != buf[2] || trim > RTC_TRIM_MAX || trim < -RTC_TRIM_MAX)
+		trim = 0;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		rtcTrim = trim;
+	}
+	rtcTrimSaved = trim;
+}
+
+/*--------------------------------------------------------------------*/
+void rtc_tick(void)
+{
+	uint8_t step = 1;
+
+	if (!rtcTime)
+		return;
+
+	// A second more or less whenever the trim adds up to one
+	rtcTicks++;
+	rtcFrac += rtcTrim;
+	if (rtcFrac >= RTC_TRIM_ONE)
+	{
+		rtcFrac -= RTC_TRIM_ONE;
+		step = 2;
+	}
+	else if (rtcFrac <= -RTC_TRIM_ONE)
+	{
+		rtcFrac += RTC_TRIM_ONE;
+		step = 0;
+	}
+
+	rtcTime += step;
+	rtcSec += step;
+	if (rtcSec >= 3600)
+	{
+		rtcSec -= 3600;
+		if (++rtcHour >= RTC_WEEK_HOURS)
+			rtcHour = 0;
+	}
+}
+
+/*--------------------------------------------------------------------*/
+void rtc_set(uint32_t t)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		rtcTime = t;
+		rtcFrac = 0;
+		if (t)
+			rtc_local();
+		else
+			rtcHour = RTC_NO_HOUR;
+	}
+
+	// A time from anywhere but the master is no reference for the drift
+	rtcRef = 0;
+}
+
+/*--------------------------------------------------------------------*/
+void rtc_sync(uint32_t t)
+{
+	uint32_t now = rtc_now();
+	int32_t diff = (int32_t)(t - now);
+	uint32_t ticks;
+	int32_t trim;
+
+	// The first sync, or a new setting: only the reference
+	if (!now || !rtcRef || diff > RTC_JUMP_S || diff < -RTC_JUMP_S)
+	{
+		rtc_set(t);
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			rtcTicks = 0;
+		}
+		rtcRef = t;
+		return;
+	}
+
+	// The master counted t - rtcRef seconds while the tick counted ticks
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		ticks = rtcTicks;
+	}
+	if (ticks >= RTC_LEARN_S)
+	{
+		trim = (int32_t)((int64_t)(int32_t)(t - rtcRef - ticks) * RTC_TRIM_ONE / (int64_t)ticks);
+		if (trim > RTC_TRIM_MAX)
+			trim = RTC_TRIM_MAX;
+		if (trim < -RTC_TRIM_MAX)
+			trim = -RTC_TRIM_MAX;
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			rtcTrim = (int16_t)trim;
+		}
+		trim_save((int16_t)trim);
+	}
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		rtcTime = t;
+		rtcFrac = 0;
+		rtc_local();
+	}
+}
+
+/*--------------------------------------------------------------------*/
+uint32_t rtc_now(void)
+{
+	uint32_t t;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		t = rtcTime;
+	}
+	return t;
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t rtc_valid(void)
+{
+	return rtc_now() != 0;
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t rtc_hour(void)
+{
+	return rtcHour;
+}
+
+/*--------------------------------------------------------------------*/
+int16_t rtc_trim(void)
+{
+	int16_t trim;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		trim = rtcTrim;
+	}
+	return trim;
+}
+
+/*--------------------------------------------------------------------*/
+void rtc_zone(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		if (rtcTime)
+			rtc_local();
+	}
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t rtc_frame(uint8_t type, const uint8_t *payload, uint8_t len, uint8_t *reply)
+{
+	uint32_t t;
+	int16_t trim;
+
+	if (type != FT_TIME)
+		return FRAME_NO_REPLY;
+
+	if (len >= 4)
+		rtc_sync((uint32_t)payload[0] | (uint32_t)payload[1] << 8 |
+			(uint32_t)payload[2] << 16 | (uint32_t)payload[3] << 24);
+
+	t = rtc_now();
+	trim = rtc_trim();
+	reply[0] = t != 0;
+	for (uint8_t i = 0; i < 4; i++)
+		reply[1 + i] = (uint8_t)(t >> (8 * i));
+	reply[5] = trim & 0xFF;
+	reply[6] = (uint16_t)trim >> 8;
+	return RTC_REPLY_LEN;
+}
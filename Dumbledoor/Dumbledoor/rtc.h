@@ -0,0 +1,138 @@
+#ifndef RTC_H_
+#define RTC_H_
+
+/***********************************************************************
+ *
+ * Wall clock library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/**
+ * @file  rtc.h
+ * @defgroup dumbledoor_rtc Wall Clock Library <rtc.h>
+ * @code #include <rtc.h> @endcode
+ *
+ * @brief Unix time counted by the second tick of Timer/Counter1,
+ *        disciplined by the master.
+ *
+ * @details
+ * The board has no clock chip. The door counts the seconds from the
+ * time it was last told, by the master with FT_TIME or on the console
+ * with `time`. After a reset the clock is unknown until it is set
+ * again, rtc_valid() is 0 and everything which needs the time of day,
+ * the one-time codes of totp.h and the schedules of schedule.h, stays off.
+ *
+ * The crystal of the board is off by some ten ppm, a few seconds a day.
+ * Each FT_TIME compares the time of the master with the seconds the
+ * tick counted since the first one, and from RTC_LEARN_S on sets the
+ * trim to the difference: the ticks add a second or leave one out
+ * whenever the trim, summed up every second, passes a whole second. The
+ * longer the master keeps syncing, the finer the trim gets; after a day
+ * a whole second of difference is 12 ppm. A time more than RTC_JUMP_S
+ * off is taken as a new setting, not as drift, and starts over. The
+ * trim is kept at EE_RTC_TRIM for the next reset.
+ *
+ * The tick also counts the hour of the week in local time (config.tz),
+ * so rtc_hour() for the schedules is one byte read.
+ *
+ * @author
+ * Demirkan Korbey Baglamac and Rasit Demiroren
+ *
+ * @copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * Programmed for the Digital Electronics 2 project.
+ * This work is licensed under the terms of the MIT license.
+ */
+
+/* Includes ----------------------------------------------------------*/
+#include <stdint.h>         // Fixed width integer types
+
+/* Definitions -------------------------------------------------------*/
+#define RTC_TRIM_ONE        16777216L   // A second of trim, 2^24
+#define RTC_TRIM_MAX        8389        // 500 ppm
+#define RTC_LEARN_S         21600UL     // Ticks before the first trim
+#define RTC_JUMP_S          600         // More is a new setting, not drift
+
+#define RTC_WEEK_HOURS      168
+#define RTC_NO_HOUR         0xFF        // rtc_hour() while not set
+
+// Clock frame, the door answers with type | FT_REPLY
+#define FT_TIME             0x28    // [] or [unix 4 bytes] -> [valid, unix 4 bytes,
+                                    //                          trim lo, trim hi]
+#define RTC_REPLY_LEN       7
+
+/* Function prototypes -----------------------------------------------*/
+/**
+ * @brief    Loads the trim from EEPROM. Call it after config_init().
+ * @return   none
+ */
+void rtc_init(void);
+
+/**
+ * @brief    Counts a second. Call it from the second tick.
+ * @return   none
+ */
+void rtc_tick(void);
+
+/**
+ * @brief    Sets the clock without learning the drift from it.
+ * @param    t     Seconds since 1970-01-01 00:00 UTC
+ * @return   none
+ */
+void rtc_set(uint32_t t);
+
+/**
+ * @brief    Sets the clock to the time of the master and corrects the
+ *           trim. Takes a few ms with a trim write, call it from the
+ *           main loop.
+ * @param    t     Seconds since 1970-01-01 00:00 UTC
+ * @return   none
+ */
+void rtc_sync(uint32_t t);
+
+/**
+ * @brief    Reads the clock.
+ * @return   Seconds since 1970-01-01 00:00 UTC, 0 while not set
+ */
+uint32_t rtc_now(void);
+
+/**
+ * @brief    Tells if the clock was set since the reset.
+ * @return   1 when set
+ */
+uint8_t rtc_valid(void);
+
+/**
+ * @brief    Hour of the week in local time. Safe to call from interrupt
+ *           handlers.
+ * @return   0 for Monday 00:00 to 167, RTC_NO_HOUR while not set
+ */
+uint8_t rtc_hour(void);
+
+/**
+ * @brief    Trim of the second tick.
+ * @return   Seconds added per second, in units of 1 / RTC_TRIM_ONE
+ */
+int16_t rtc_trim(void);
+
+/**
+ * @brief    Counts the hour of the week again after a change of
+ *           config.tz. Called by config_set().
+ * @return   none
+ */
+void rtc_zone(void);
+
+/**
+ * @brief    Answers FT_TIME.
+ * @param    type     Frame type
+ * @param    payload  Request payload
+ * @param    len      Request payload length
+ * @param    reply    Reply payload, FRAME_PAYLOAD_MAX bytes
+ * @return   Reply payload length, FRAME_NO_REPLY for other frames
+ */
+uint8_t rtc_frame(uint8_t type, const uint8_t *payload, uint8_t len, uint8_t *reply);
+
+#endif /* RTC_H_ */
@@ -0,0 +1,90 @@
+/***********************************************************************
+ *
+ * Access schedule library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/* Includes ----------------------------------------------------------*/
+#include <string.h>         // memset
+#include "schedule.h"
+#include "eemap.h"          // EEPROM layout
+#include "eeq.h"            // EEPROM access
+#include "frame.h"          // FRAME_NO_REPLY
+#include "rtc.h"            // Hour of the week
+
+typedef char schedule_len_check[(SCHEDULE_LEN * 8 == RTC_WEEK_HOURS) ? 1 : -1];
+
+/* Function definitions ----------------------------------------------*/
+static uint16_t schedule_addr(uint8_t n)
+{
+	return EE_SCHEDULE + (n - 1) * SCHEDULE_LEN;
+}
+
+/*--------------------------------------------------------------------*/
+void schedule_init(void)
+{
+	uint8_t hours[SCHEDULE_LEN];
+	uint8_t magic;
+
+	// The mark after the schedules, a reset in between clears them again
+	eeq_read(&magic, EE_SCHEDULE_SET, 1);
+	if (magic == SCHEDULE_MAGIC)
+		return;
+	memset(hours, 0xFF, sizeof(hours));
+	for (uint8_t n = 1; n <= SCHEDULE_COUNT; n++)
+		schedule_write(n, hours);
+	magic = SCHEDULE_MAGIC;
+	eeq_write(EE_SCHEDULE_SET, &magic, 1);
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t schedule_allowed(uint8_t n)
+{
+	uint8_t hour = rtc_hour();
+	uint8_t bits;
+
+	if (!n)
+		return 1;
+	if (n > SCHEDULE_COUNT || hour == RTC_NO_HOUR)
+		return 0;
+	eeq_read(&bits, schedule_addr(n) + hour / 8, 1);
+	return (bits >> (hour % 8)) & 1;
+}
+
+/*--------------------------------------------------------------------*/
+void schedule_read(uint8_t n, uint8_t *hours)
+{
+	eeq_read(hours, schedule_addr(n), SCHEDULE_LEN);
+}
+
+/*--------------------------------------------------------------------*/
+void schedule_write(uint8_t n, const uint8_t *hours)
+{
+	eeq_write(schedule_addr(n), hours, SCHEDULE_LEN);
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t schedule_frame(uint8_t type, const uint8_t *payload, uint8_t len, uint8_t *reply)
+{
+	uint8_t n;
+
+	if (type != FT_SCHEDULE)
+		return FRAME_NO_REPLY;
+
+	n = (len >= 1) ? payload[0] : 0;
+	reply[0] = SCHEDULE_OK;
+	reply[1] = n;
+	if (n < 1 || n > SCHEDULE_COUNT)
+	{
+		reply[0] = SCHEDULE_E_NUM;
+		return 2;
+	}
+	if (len >= 1 + SCHEDULE_LEN)
+		schedule_write(n, payload + 1);
+	schedule_read(n, reply + 2);
+	return SCHEDULE_REPLY_LEN;
+}
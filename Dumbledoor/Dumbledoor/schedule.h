@@ -0,0 +1,107 @@
+#ifndef SCHEDULE_H_
+#define SCHEDULE_H_
+
+/***********************************************************************
+ *
+ * Access schedule library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/**
+ * @file  schedule.h
+ * @defgroup dumbledoor_schedule Access Schedule Library <schedule.h>
+ * @code #include <schedule.h> @endcode
+ *
+ * @brief Weekly hours in which a user may enter.
+ *
+ * @details
+ * A schedule is a bit per hour of the week, SCHEDULE_LEN bytes: bit h % 8
+ * of byte h / 8 for the hour h = day * 24 + hour, Monday 00:00 to 01:00
+ * being hour 0, in the local time of rtc.h. The door keeps SCHEDULE_COUNT
+ * of them at EE_SCHEDULE. A user record names one in its flags
+ * (USER_F_SCHED), 0 for none: that user may enter at any time.
+ *
+ * The check is one EEPROM byte of the schedule at rtc_hour() and a bit
+ * of it, so it is done on every correct entry with the lookup of
+ * door_task(). A user with a schedule is refused while the clock is
+ * not set.
+ *
+ * Erased EEPROM reads 0xFF, a schedule that was never written allows
+ * every hour. The schedules took over the last block of the event log,
+ * so schedule_init() clears them to 0xFF once, on the first boot
+ * without SCHEDULE_MAGIC at EE_SCHEDULE_SET, and a log block is not
+ * read as hours. The master reads and writes the schedules with
+ * FT_SCHEDULE. A write is not atomic: cut short by a reset, it leaves
+ * some hours of the old schedule and some of the new one.
+ *
+ * @author
+ * Demirkan Korbey Baglamac and Rasit Demiroren
+ *
+ * @copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * Programmed for the Digital Electronics 2 project.
+ * This work is licensed under the terms of the MIT license.
+ */
+
+/* Includes ----------------------------------------------------------*/
+#include <stdint.h>         // Fixed width integer types
+
+/* Definitions -------------------------------------------------------*/
+#define SCHEDULE_COUNT      3       // Schedules 1 to 3, 0 is every hour
+#define SCHEDULE_LEN        21      // 168 hours
+#define SCHEDULE_MAGIC      0x5C    // At EE_SCHEDULE_SET once the area is cleared
+
+// Schedule frame, the door answers with type | FT_REPLY
+#define FT_SCHEDULE         0x29    // [n] or [n, SCHEDULE_LEN bytes] -> [st, n, SCHEDULE_LEN bytes]
+#define SCHEDULE_REPLY_LEN  (2 + SCHEDULE_LEN)
+
+// Reply status
+#define SCHEDULE_OK         0
+#define SCHEDULE_E_NUM      1       // No such schedule
+
+/* Function prototypes -----------------------------------------------*/
+/**
+ * @brief    Clears the schedules left from an older EEPROM layout. Call
+ *           it before the ticks start.
+ * @return   none
+ */
+void schedule_init(void);
+
+/**
+ * @brief    Tells if a schedule allows the current hour. Reads the
+ *           EEPROM, call it from the main loop.
+ * @param    n  Schedule, 0 for none
+ * @return   1 when allowed
+ */
+uint8_t schedule_allowed(uint8_t n);
+
+/**
+ * @brief    Reads a schedule.
+ * @param    n     Schedule, 1 to SCHEDULE_COUNT
+ * @param    hours SCHEDULE_LEN bytes
+ * @return   none
+ */
+void schedule_read(uint8_t n, uint8_t *hours);
+
+/**
+ * @brief    Writes a schedule, up to 70 ms. Call it from the main loop.
+ * @param    n     Schedule, 1 to SCHEDULE_COUNT
+ * @param    hours SCHEDULE_LEN bytes
+ * @return   none
+ */
+void schedule_write(uint8_t n, const uint8_t *hours);
+
+/**
+ * @brief    Answers FT_SCHEDULE.
+ * @param    type     Frame type
+ * @param    payload  Request payload
+ * @param    len      Request payload length
+ * @param    reply    Reply payload, FRAME_PAYLOAD_MAX bytes
+ * @return   Reply payload length, FRAME_NO_REPLY for other frames
+ */
+uint8_t schedule_frame(uint8_t type, const uint8_t *payload, uint8_t len, uint8_t *reply);
+
+#endif /* SCHEDULE_H_ */
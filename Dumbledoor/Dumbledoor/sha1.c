@@ -0,0 +1,153 @@
+/***********************************************************************
+ *
+ * SHA-1 library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/* Includes ----------------------------------------------------------*/
+#include <string.h>         // memset, memcpy
+#include "sha1.h"
+
+/* Definitions -------------------------------------------------------*/
+#define ROTL(x, b)      (((x) << (b)) | ((x) >> (32 - (b))))
+
+#define SHA1_IPAD       0x36
+#define SHA1_OPAD       0x5C
+
+/* Function definitions ----------------------------------------------*/
+/**
+ * @brief  Hashes the full block.
+ */
+static void sha1_block(sha1_t *s)
+{
+	uint32_t w[16];
+	uint32_t a = s->h[0], b = s->h[1], c = s->h[2], d = s->h[3], e = s->h[4];
+	uint32_t f, k, t;
+
+	for (uint8_t i = 0; i < 16; i++)
+		w[i] = (uint32_t)s->block[4 * i] << 24 | (uint32_t)s->block[4 * i + 1] << 16 |
+			(uint32_t)s->block[4 * i + 2] << 8 | s->block[4 * i + 3];
+
+	for (uint8_t i = 0; i < 80; i++)
+	{
+		if (i >= 16)
+		{
+			t = w[(i + 13) & 15] ^ w[(i + 8) & 15] ^ w[(i + 2) & 15] ^ w[i & 15];
+			w[i & 15] = ROTL(t, 1);
+		}
+		if (i < 20)
+		{
+			f = (b & c) | (~b & d);
+			k = 0x5A827999;
+		}
+		else if (i < 40)
+		{
+			f = b ^ c ^ d;
+			k = 0x6ED9EBA1;
+		}
+		else if (i < 60)
+		{
+			f = (b & c) | (b & d) | (c & d);
+			k = 0x8F1BBCDC;
+		}
+		else
+		{
+			f = b ^ c ^ d;
+			k = 0xCA62C1D6;
+		}
+		t = ROTL(a, 5) + f + e + k + w[i & 15];
+		e = d;
+		d = c;
+		c = ROTL(b, 30);
+		b = a;
+		a = t;
+	}
+
+	s->h[0] += a;
+	s->h[1] += b;
+	s->h[2] += c;
+	s->h[3] += d;
+	s->h[4] += e;
+}
+
+/*--------------------------------------------------------------------*/
+void sha1_init(sha1_t *s)
+{
+	s->h[0] = 0x67452301;
+	s->h[1] = 0xEFCDAB89;
+	s->h[2] = 0x98BADCFE;
+	s->h[3] = 0x10325476;
+	s->h[4] = 0xC3D2E1F0;
+	s->fill = 0;
+	s->len = 0;
+}
+
+/*--------------------------------------------------------------------*/
+void sha1_update(sha1_t *s, const void *data, uint8_t len)
+{
+	const uint8_t *p = data;
+
+	s->len += len;
+	while (len--)
+	{
+		s->block[s->fill++] = *p++;
+		if (s->fill == SHA1_BLOCK_LEN)
+		{
+			sha1_block(s);
+			s->fill = 0;
+		}
+	}
+}
+
+/*--------------------------------------------------------------------*/
+void sha1_final(sha1_t *s, uint8_t *out)
+{
+	uint32_t bits = s->len * 8;
+
+	// 0x80, zeros up to the last 8 bytes, the length in bits
+	s->block[s->fill++] = 0x80;
+	if (s->fill > SHA1_BLOCK_LEN - 8)
+	{
+		memset(&s->block[s->fill], 0, SHA1_BLOCK_LEN - s->fill);
+		sha1_block(s);
+		s->fill = 0;
+	}
+	memset(&s->block[s->fill], 0, SHA1_BLOCK_LEN - 4 - s->fill);
+	for (uint8_t i = 0; i < 4; i++)
+		s->block[SHA1_BLOCK_LEN - 1 - i] = (uint8_t)(bits >> (8 * i));
+	sha1_block(s);
+
+	for (uint8_t i = 0; i < SHA1_LEN; i++)
+		out[i] = (uint8_t)(s->h[i / 4] >> (24 - 8 * (i % 4)));
+}
+
+/*--------------------------------------------------------------------*/
+void sha1_hmac(const uint8_t *key, uint8_t keyLen, const void *msg, uint8_t len, uint8_t *out)
+{
+	uint8_t pad[SHA1_BLOCK_LEN];
+	sha1_t s;
+
+	// Inner hash of the key ^ ipad and the message
+	memset(pad, 0, sizeof(pad));
+	memcpy(pad, key, keyLen);
+	for (uint8_t i = 0; i < SHA1_BLOCK_LEN; i++)
+		pad[i] ^= SHA1_IPAD;
+	sha1_init(&s);
+	sha1_update(&s, pad, SHA1_BLOCK_LEN);
+	sha1_update(&s, msg, len);
+	sha1_final(&s, out);
+
+	// Outer hash of the key ^ opad and the inner hash
+	for (uint8_t i = 0; i < SHA1_BLOCK_LEN; i++)
+		pad[i] ^= SHA1_IPAD ^ SHA1_OPAD;
+	sha1_init(&s);
+	sha1_update(&s, pad, SHA1_BLOCK_LEN);
+	sha1_update(&s, out, SHA1_LEN);
+	sha1_final(&s, out);
+
+	memset(pad, 0, sizeof(pad));
+}
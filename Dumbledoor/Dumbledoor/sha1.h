@@ -0,0 +1,89 @@
+#ifndef SHA1_H_
+#define SHA1_H_
+
+/***********************************************************************
+ *
+ * SHA-1 library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/**
+ * @file  sha1.h
+ * @defgroup dumbledoor_sha1 SHA-1 Library <sha1.h>
+ * @code #include <sha1.h> @endcode
+ *
+ * @brief SHA-1 and HMAC-SHA1 for the one-time codes of totp.h.
+ *
+ * @details
+ * SHA-1 (FIPS 180-4) is only used inside HMAC here, as RFC 4226 and
+ * RFC 6238 ask for it; its collisions do not matter for HMAC. The
+ * message schedule is kept as a ring of 16 words, a hash takes about
+ * 180 bytes of stack. A block of 64 bytes is the unit of work, HMAC of
+ * a short message is four of them.
+ *
+ * @author
+ * Demirkan Korbey Baglamac and Rasit Demiroren
+ *
+ * @copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * Programmed for the Digital Electronics 2 project.
+ * This work is licensed under the terms of the MIT license.
+ */
+
+/* Includes ----------------------------------------------------------*/
+#include <stdint.h>         // Fixed width integer types
+
+/* Definitions -------------------------------------------------------*/
+#define SHA1_LEN            20      // Hash length
+#define SHA1_BLOCK_LEN      64
+
+/**
+ * @brief State of a hash.
+ */
+typedef struct {
+	uint32_t h[5];
+	uint8_t block[SHA1_BLOCK_LEN];
+	uint8_t fill;           // Bytes in block
+	uint32_t len;           // Bytes hashed so far
+} sha1_t;
+
+/* Function prototypes -----------------------------------------------*/
+/**
+ * @brief    Starts a hash.
+ * @param    s  State
+ * @return   none
+ */
+void sha1_init(sha1_t *s);
+
+/**
+ * @brief    Adds bytes to a hash.
+ * @param    s     State
+ * @param    data  Bytes
+ * @param    len   Number of bytes
+ * @return   none
+ */
+void sha1_update(sha1_t *s, const void *data, uint8_t len);
+
+/**
+ * @brief    Finishes a hash.
+ * @param    s    State, no longer usable
+ * @param    out  SHA1_LEN bytes
+ * @return   none
+ */
+void sha1_final(sha1_t *s, uint8_t *out);
+
+/**
+ * @brief    HMAC-SHA1 of a message.
+ * @param    key     Key, at most SHA1_BLOCK_LEN bytes
+ * @param    keyLen  Key length
+ * @param    msg     Message
+ * @param    len     Message length
+ * @param    out     SHA1_LEN bytes
+ * @return   none
+ */
+void sha1_hmac(const uint8_t *key, uint8_t keyLen, const void *msg, uint8_t len, uint8_t *out);
+
+#endif /* SHA1_H_ */
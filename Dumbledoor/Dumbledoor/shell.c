@@ -0,0 +1,518 @@
+/***********************************************************************
+ *
+ * Command shell library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/* Includes ----------------------------------------------------------*/
+#include <avr/pgmspace.h>   // Command table in program memory
+#include <util/atomic.h>    // ATOMIC_BLOCK
+#include "shell.h"
+#include "bus.h"            // Link mode
+#include "config.h"         // Settings
+#include "cpuclk.h"         // Timer/Counter1 steps per cycle
+#include "door.h"           // Attempt counters
+#include "eemap.h"          // EEPROM layout
+#include "eeq.h"            // EEPROM
+#include "event.h"          // Event clock
+#include "fmt.h"            // Formatted output library for AVR-GCC
+#include "hal.h"            // Second tick period
+#include "rtc.h"            // Wall clock
+#include "schedule.h"       // Access schedules
+#include "sound.h"          // Melodies
+#include "stack.h"          // Stack report
+#include "trace.h"          // Flight recorder
+#include "uart.h"           // UART library for AVR-GCC
+#include "users.h"          // User table
+
+/* Definitions -------------------------------------------------------*/
+// Output of one command, result line included: "help cfg" prints 73
+// bytes, "ok parse N run N cycles" 39 at most
+#define SHELL_OUT_MAX   112
+#define SHELL_E_LINK    4           // Damaged byte in the line
+
+#if SHELL_OUT_MAX >= UART_TX_LOW_BUFFER_SIZE
+# error The output of a command does not fit the low priority transmit buffer
+#endif
+
+#ifdef __AVR__
+# define SHELL_CLOCK()  shell_clock()       // 16 us
+#else
+# define SHELL_CLOCK()  0
+#endif
+
+typedef uint8_t (*shell_fn_t)(uint8_t argc, char **argv);
+
+typedef struct {
+	const char *name;                   // In program memory
+	const char *help;                   // In program memory
+	shell_fn_t fn;
+} shell_cmd_t;
+
+/* Function prototypes -----------------------------------------------*/
+static uint8_t cmd_help(uint8_t argc, char **argv);
+static uint8_t cmd_stat(uint8_t argc, char **argv);
+static uint8_t cmd_stack(uint8_t argc, char **argv);
+static uint8_t cmd_user(uint8_t argc, char **argv);
+static uint8_t cmd_sound(uint8_t argc, char **argv);
+static uint8_t cmd_play(uint8_t argc, char **argv);
+static uint8_t cmd_link(uint8_t argc, char **argv);
+static uint8_t cmd_tx(uint8_t argc, char **argv);
+static uint8_t cmd_cfg(uint8_t argc, char **argv);
+static uint8_t cmd_time(uint8_t argc, char **argv);
+static uint8_t cmd_sched(uint8_t argc, char **argv);
+
+/* Global Variables --------------------------------------------------*/
+static const char nameHelp[] PROGMEM = "help";
+static const char nameStat[] PROGMEM = "stat";
+static const char nameStack[] PROGMEM = "stack";
+static const char nameUser[] PROGMEM = "user";
+static const char nameSound[] PROGMEM = "sound";
+static const char namePlay[] PROGMEM = "play";
+static const char nameLink[] PROGMEM = "link";
+static const char nameTx[] PROGMEM = "tx";
+static const char nameCfg[] PROGMEM = "cfg";
+static const char nameTime[] PROGMEM = "time";
+static const char nameSched[] PROGMEM = "sched";
+
+static const char helpHelp[] PROGMEM = " [command]: commands, or the help of one";
+static const char helpStat[] PROGMEM = ": attempts, uptime, clock, table version";
+static const char helpStack[] PROGMEM = ": free stack and SRAM use";
+static const char helpUser[] PROGMEM = " <slot>: name, unlock time, chime and schedule";
+static const char helpSound[] PROGMEM = " [event melody]: melody of each event";
+static const char helpPlay[] PROGMEM = " <melody>: plays a melody";
+static const char helpLink[] PROGMEM = " <polled|stream> <addr>: leaves the console";
+static const char helpTx[] PROGMEM = " [clear]: dropped bytes and peak fill of the UART";
+static const char helpCfg[] PROGMEM =
+	" [field [value]]: entry hold unlock pullin duty baud window batch tz";
+static const char helpTime[] PROGMEM = " [unix]: time of day, hour of the week and trim";
+static const char helpSched[] PROGMEM = " <n>: hours of an access schedule, Monday 0:00 first";
+
+static const shell_cmd_t shellCmds[] PROGMEM = {
+	{nameHelp, helpHelp, cmd_help},
+	{nameStat, helpStat, cmd_stat},
+	{nameStack, helpStack, cmd_stack},
+	{nameUser, helpUser, cmd_user},
+	{nameSound, helpSound, cmd_sound},
+	{namePlay, helpPlay, cmd_play},
+	{nameLink, helpLink, cmd_link},
+	{nameTx, helpTx, cmd_tx},
+	{nameCfg, helpCfg, cmd_cfg},
+	{nameTime, helpTime, cmd_time},
+	{nameSched, helpSched, cmd_sched},
+};
+
+#define SHELL_CMDS      (sizeof(shellCmds) / sizeof(shellCmds[0]))
+
+static const char errArgs[] PROGMEM = "arguments";
+static const char errUnknown[] PROGMEM = "unknown command";
+static const char errLong[] PROGMEM = "line too long";
+static const char errLink[] PROGMEM = "receive error";
+
+// SHELL_E_... order
+static const char *const shellErrors[] PROGMEM = {
+	0, errArgs, errUnknown, errLong, errLink
+};
+
+static char shellLine[SHELL_LINE_MAX + 1];
+static uint8_t shellLen = 0;
+static uint8_t shellBad = SHELL_OK;     // SHELL_E_... of the line so far
+static uint8_t shellReady = 0;          // The line is complete
+static uint8_t shellLeave = 0;          // The link command ran
+
+/* Function definitions ----------------------------------------------*/
+#ifdef __AVR__
+// TCNT1 is read through the TEMP register the handlers use as well
+static uint16_t shell_clock(void)
+{
+	uint16_t t;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		t = TCNT1;
+	}
+	return t;
+}
+#endif
+
+/*--------------------------------------------------------------------*/
+// Timer/Counter1 steps from t0 to t1 in CPU cycles, the count wraps
+// with the second tick and the prescaler follows the clock
+static unsigned long shell_cycles(uint16_t t0, uint16_t t1)
+{
+	uint16_t steps = t1 - t0;
+
+	if (t1 < t0)
+		steps += HAL_SECOND_STEPS;
+
+	return (unsigned long)steps << ((cpuclk_state() == CPUCLK_SLOW) ? 6 : 8);
+}
+
+/*--------------------------------------------------------------------*/
+void shell_init(void)
+{
+	shellLen = 0;
+	shellBad = SHELL_OK;
+	shellReady = 0;
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t shell_split(char *line, char **argv)
+{
+	uint8_t argc = 0;
+
+	for (;;)
+	{
+		while (*line == ' ' || *line == '\t')
+			line++;
+		if (*line == '\0')
+			return argc;
+		if (argc == SHELL_ARGS_MAX)
+			return SHELL_ARGS_MAX + 1;
+		argv[argc++] = line;
+		while (*line != '\0' && *line != ' ' && *line != '\t')
+			line++;
+		if (*line != '\0')
+			*line++ = '\0';
+	}
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t shell_number(const char *s, uint16_t max, uint16_t *out)
+{
+	uint16_t n = 0;
+	uint8_t d;
+
+	if (*s == '\0')
+		return 0;
+	for (; *s; s++)
+	{
+		if (*s < '0' || *s > '9')
+			return 0;
+		d = *s - '0';
+		if (d > max || n > (max - d) / 10)
+			return 0;
+		n = n * 10 + d;
+	}
+	*out = n;
+	return 1;
+}
+
+/*--------------------------------------------------------------------*/
+static const shell_cmd_t *shell_find(const char *name)
+{
+	for (uint8_t i = 0; i < SHELL_CMDS; i++)
+		if (strcmp_P(name, pgm_read_ptr(&shellCmds[i].name)) == 0)
+			return &shellCmds[i];
+	return 0;
+}
+
+/*--------------------------------------------------------------------*/
+static uint8_t cmd_help(uint8_t argc, char **argv)
+{
+	const shell_cmd_t *cmd;
+
+	if (argc == 1)
+	{
+		for (uint8_t i = 0; i < SHELL_CMDS; i++)
+			fmt_uart_low_P("%S ", FMT_P(pgm_read_ptr(&shellCmds[i].name)));
+		uart_puts_low_P("\r\n");
+		return SHELL_OK;
+	}
+	if (argc != 2 || !(cmd = shell_find(argv[1])))
+		return SHELL_E_ARGS;
+	fmt_uart_low_P("%S%S\r\n", FMT_P(pgm_read_ptr(&cmd->name)), FMT_P(pgm_read_ptr(&cmd->help)));
+	return SHELL_OK;
+}
+
+/*--------------------------------------------------------------------*/
+static uint8_t cmd_stat(uint8_t argc, char **argv)
+{
+	uint8_t correct;
+	uint8_t wrong;
+
+	(void)argv;
+	if (argc != 1)
+		return SHELL_E_ARGS;
+	door_attempts(&correct, &wrong);
+	fmt_uart_low_P("correct %u wrong %u up %u s clock %S table %u\r\n", correct, wrong,
+	           event_time(), FMT_P((cpuclk_state() == CPUCLK_SLOW) ? PSTR("slow") : PSTR("full")),
+	           users_version());
+	return SHELL_OK;
+}
+
+/*--------------------------------------------------------------------*/
+static uint8_t cmd_stack(uint8_t argc, char **argv)
+{
+	stack_report_t r;
+
+	(void)argv;
+	if (argc != 1)
+		return SHELL_E_ARGS;
+	stack_report(&r);
+	fmt_uart_low_P("stack free %u of %u data %u bss %u\r\n", r.free, r.size, r.data, r.bss);
+	return SHELL_OK;
+}
+
+/*--------------------------------------------------------------------*/
+// Never the PIN
+static uint8_t cmd_user(uint8_t argc, char **argv)
+{
+	char name[USERS_NAME_LEN];
+	uint16_t slot;
+
+	if (argc != 2 || !shell_number(argv[1], USERS_MAX - 1, &slot))
+		return SHELL_E_ARGS;
+	users_name(slot, name);
+	fmt_uart_low_P("user %u '%s' unlock %u chime %u sched %u\r\n", slot, name,
+	           users_unlock(slot), users_chime(slot), users_schedule(slot));
+	return SHELL_OK;
+}
+
+/*--------------------------------------------------------------------*/
+// Same as the FT_SOUND frame, which also keeps the change in EEPROM
+static uint8_t cmd_sound(uint8_t argc, char **argv)
+{
+	uint8_t set[2] = {0, 0};
+	uint8_t map[SOUND_EVENTS];
+	uint16_t event;
+	uint16_t melody;
+
+	if (argc == 3)
+	{
+		if (!shell_number(argv[1], SOUND_EVENTS - 1, &event) ||
+			!shell_number(argv[2], MELODIES - 1, &melody))
+			return SHELL_E_ARGS;
+		set[0] = event;
+		set[1] = melody;
+	}
+	else if (argc != 1)
+		return SHELL_E_ARGS;
+
+	sound_frame(FT_SOUND, set, (argc == 3) ? 2 : 0, map);
+	uart_puts_low_P("sound");
+	for (uint8_t i = 0; i < SOUND_EVENTS; i++)
+		fmt_uart_low_P(" %u", map[i]);
+	uart_puts_low_P("\r\n");
+	return SHELL_OK;
+}
+
+/*--------------------------------------------------------------------*/
+static uint8_t cmd_play(uint8_t argc, char **argv)
+{
+	uint16_t melody;
+
+	if (argc != 2 || !shell_number(argv[1], MELODIES - 1, &melody))
+		return SHELL_E_ARGS;
+	sound_play(melody);
+	return SHELL_OK;
+}
+
+/*--------------------------------------------------------------------*/
+// As FT_SET_ADDR does, the frames start after the result line
+static uint8_t cmd_link(uint8_t argc, char **argv)
+{
+	uint8_t mode;
+	uint8_t node;
+	uint16_t addr;
+
+	if (argc != 3 || !shell_number(argv[2], FRAME_ADDR_MAX, &addr) || addr == FRAME_ADDR_MASTER)
+		return SHELL_E_ARGS;
+	if (strcmp_P(argv[1], PSTR("polled")) == 0)
+		mode = BUS_MODE_POLLED;
+	else if (strcmp_P(argv[1], PSTR("stream")) == 0)
+		mode = BUS_MODE_STREAM;
+	else
+		return SHELL_E_ARGS;
+
+	node = addr;
+	eeq_write(EE_NODE_ADDR, &node, 1);
+	eeq_write(EE_LINK_MODE, &mode, 1);
+	shellLeave = 1;
+	return SHELL_OK;
+}
+
+/*--------------------------------------------------------------------*/
+// Same as the FT_TX_STATS frame
+static uint8_t cmd_tx(uint8_t argc, char **argv)
+{
+	unsigned int dropped[2];
+	uint8_t peak[2];
+	uint8_t clear = 0;
+
+	if (argc == 2 && strcmp_P(argv[1], PSTR("clear")) == 0)
+		clear = 1;
+	else if (argc != 1)
+		return SHELL_E_ARGS;
+	uart_tx_stats(UART_HIGH, &dropped[0], &peak[0], clear);
+	uart_tx_stats(UART_LOW, &dropped[1], &peak[1], clear);
+	fmt_uart_low_P("tx high dropped %u peak %u low dropped %u peak %u\r\n", dropped[0], peak[0],
+	               dropped[1], peak[1]);
+	return SHELL_OK;
+}
+
+/*--------------------------------------------------------------------*/
+// Same as the FT_CONFIG frame, all settings in the order of the help
+static uint8_t cmd_cfg(uint8_t argc, char **argv)
+{
+	uint8_t field;
+	uint16_t value;
+
+	if (argc == 1)
+	{
+		uart_puts_low_P("cfg");
+		for (field = 0; field < CONFIG_FIELDS; field++)
+			fmt_uart_low_P(" %u", config_get(field));
+		uart_puts_low_P("\r\n");
+		return SHELL_OK;
+	}
+	if (argc > 3 || (field = config_find(argv[1])) == CONFIG_FIELDS)
+		return SHELL_E_ARGS;
+	if (argc == 3 && (!shell_number(argv[2], 0xFFFF, &value) || config_set(field, value) != CONFIG_OK))
+		return SHELL_E_ARGS;
+
+	fmt_uart_low_P("cfg %S %u\r\n", FMT_P(config_name(field)), config_get(field));
+	return SHELL_OK;
+}
+
+/*--------------------------------------------------------------------*/
+// Same as the FT_TIME frame
+static uint8_t cmd_time(uint8_t argc, char **argv)
+{
+	uint32_t t = 0;
+
+	if (argc > 2)
+		return SHELL_E_ARGS;
+	if (argc == 2)
+	{
+		for (const char *s = argv[1]; *s; s++)
+		{
+			if (*s < '0' || *s > '9' || t > (0xFFFFFFFFUL - 9) / 10)
+				return SHELL_E_ARGS;
+			t = t * 10 + (*s - '0');
+		}
+		if (!t)
+			return SHELL_E_ARGS;
+		rtc_set(t);
+	}
+
+	if (rtc_valid())
+		fmt_uart_low_P("time %lu hour %u trim %d\r\n", (unsigned long)rtc_now(), rtc_hour(),
+		           rtc_trim());
+	else
+		fmt_uart_low_P("time not set trim %d\r\n", rtc_trim());
+	return SHELL_OK;
+}
+
+/*--------------------------------------------------------------------*/
+static uint8_t cmd_sched(uint8_t argc, char **argv)
+{
+	uint8_t hours[SCHEDULE_LEN];
+	uint16_t n;
+
+	// Too long for a line to set, the master writes them with FT_SCHEDULE
+	if (argc != 2 || !shell_number(argv[1], SCHEDULE_COUNT, &n) || !n)
+		return SHELL_E_ARGS;
+	schedule_read(n, hours);
+	fmt_uart_low_P("sched %u ", n);
+	for (uint8_t i = 0; i < SCHEDULE_LEN; i++)
+		fmt_uart_low_P("%02x", hours[i]);
+	uart_puts_low_P("\r\n");
+	return SHELL_OK;
+}
+
+/*--------------------------------------------------------------------*/
+static void shell_byte(uint8_t c)
+{
+	if (c == '\r' || c == '\n')
+	{
+		// The LF of a CR LF is an empty line
+		if (shellLen || shellBad)
+			shellReady = 1;
+	}
+	else if (c == '\b' || c == 0x7F)
+	{
+		if (shellLen)
+			shellLen--;
+	}
+	else if (shellLen < SHELL_LINE_MAX)
+		shellLine[shellLen++] = c;
+	else if (!shellBad)
+		shellBad = SHELL_E_LONG;
+}
+
+/*--------------------------------------------------------------------*/
+static void shell_run(void)
+{
+	char *argv[SHELL_ARGS_MAX];
+	const shell_cmd_t *cmd = 0;
+	uint8_t argc;
+	uint8_t result = shellBad;
+	uint16_t t0;
+	uint16_t t1;
+	uint16_t t2;
+
+	t0 = SHELL_CLOCK();
+	shellLine[shellLen] = '\0';
+	argc = shell_split(shellLine, argv);
+	if (argc > SHELL_ARGS_MAX)
+		result = SHELL_E_LONG;
+	else if (argc && !result && !(cmd = shell_find(argv[0])))
+		result = SHELL_E_UNKNOWN;
+	t1 = SHELL_CLOCK();
+
+	if (cmd)
+		result = ((shell_fn_t)pgm_read_ptr(&cmd->fn))(argc, argv);
+	t2 = SHELL_CLOCK();
+
+	// A line of spaces gets no answer
+	if (argc || result)
+	{
+		if (result)
+			fmt_uart_low_P("error %S", FMT_P(pgm_read_ptr(&shellErrors[result])));
+		else
+			uart_puts_low_P("ok");
+		fmt_uart_low_P(" parse %lu run %lu cycles\r\n", shell_cycles(t0, t1),
+		           shell_cycles(t1, t2));
+	}
+	shell_init();
+
+	// After the result line, a link command leaves the console
+	if (shellLeave)
+	{
+		shellLeave = 0;
+		bus_init();
+	}
+}
+
+/*--------------------------------------------------------------------*/
+void shell_task(void)
+{
+	unsigned int c;
+
+	if (bus_mode() != BUS_MODE_CONSOLE)
+		return;
+
+	// Bytes of the next line wait in the receive buffer while a line
+	// waits for room in the low priority transmit buffer
+	for (uint8_t n = 0; n < SHELL_RX_PER_TASK && !shellReady; n++)
+	{
+		c = uart_getc();
+		if (c & UART_NO_DATA)
+			break;
+		if (c & (UART_FRAME_ERROR | UART_OVERRUN_ERROR | UART_BUFFER_OVERFLOW))
+		{
+			trace(TR_UART_ERROR, c >> 8);
+			if (!shellBad)
+				shellBad = SHELL_E_LINK;
+		}
+		shell_byte(c & 0xFF);
+	}
+
+	if (shellReady && uart_tx_free(UART_LOW) >= SHELL_OUT_MAX)
+		shell_run();
+}
@@ -0,0 +1,94 @@
+#ifndef SHELL_H_
+#define SHELL_H_
+
+/***********************************************************************
+ *
+ * Command shell library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/**
+ * @file  shell.h
+ * @defgroup dumbledoor_shell Command Shell Library <shell.h>
+ * @code #include <shell.h> @endcode
+ *
+ * @brief Line oriented commands on the console link.
+ *
+ * @details
+ * In console mode shell_task() takes what the UART received, at most
+ * SHELL_RX_PER_TASK bytes per call, into one line buffer. CR or LF ends
+ * a line, backspace removes the last character. The line is split into
+ * words in place: the spaces after the words are overwritten with zero
+ * bytes and argv points into the buffer, nothing is copied.
+ *
+ * The commands are a table in program memory with their help texts.
+ * At most one command runs per call, and every command does a bounded
+ * amount of work and output, so a flood of commands only ever delays
+ * the main loop by one command. The key pad runs in its timer
+ * interrupt and is not delayed at all.
+ *
+ * Every command is answered with "ok" or "error" and the cycles spent
+ * on splitting the line and on running the command, counted with
+ * Timer/Counter1 in steps of 16 us (256 cycles at 16 MHz). On the host
+ * the cycles read 0.
+ *
+ * @author
+ * Demirkan Korbey Baglamac and Rasit Demiroren
+ *
+ * @copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * Programmed for the Digital Electronics 2 project.
+ * This work is licensed under the terms of the MIT license.
+ */
+
+/* Includes ----------------------------------------------------------*/
+#include <stdint.h>         // Fixed width integer types
+
+/* Definitions -------------------------------------------------------*/
+#define SHELL_LINE_MAX      40      // Characters of a line
+#define SHELL_ARGS_MAX      4       // Words of a line, the command included
+#define SHELL_RX_PER_TASK   16      // Received bytes taken per shell_task()
+
+// Results of a command
+#define SHELL_OK            0
+#define SHELL_E_ARGS        1       // Wrong arguments
+#define SHELL_E_UNKNOWN     2       // No such command
+#define SHELL_E_LONG        3       // Line or word count over the limit
+
+/* Function prototypes -----------------------------------------------*/
+/**
+ * @brief    Empties the line buffer. Call it after bus_init().
+ * @return   none
+ */
+void shell_init(void);
+
+/**
+ * @brief    Reads received bytes and runs at most one command. Does
+ *           nothing unless the link is in console mode. Call it from
+ *           the main loop.
+ * @return   none
+ */
+void shell_task(void);
+
+/**
+ * @brief    Splits a line into words in place.
+ * @param    line  Zero terminated line, the spaces after the words are
+ *                 overwritten
+ * @param    argv  SHELL_ARGS_MAX pointers into line
+ * @return   Number of words, SHELL_ARGS_MAX + 1 when there are more
+ */
+uint8_t shell_split(char *line, char **argv);
+
+/**
+ * @brief    Reads a decimal number.
+ * @param    s    Word
+ * @param    max  Largest value accepted
+ * @param    out  Value
+ * @return   1 for a number up to max, otherwise 0
+ */
+uint8_t shell_number(const char *s, uint16_t max, uint16_t *out);
+
+#endif /* SHELL_H_ */
@@ -0,0 +1,99 @@
+/***********************************************************************
+ *
+ * SipHash library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/* Includes ----------------------------------------------------------*/
+#include "siphash.h"
+
+/* Definitions -------------------------------------------------------*/
+#define ROTL(x, b)      (((x) << (b)) | ((x) >> (64 - (b))))
+
+/* Function definitions ----------------------------------------------*/
+/**
+ * @brief  Reads a little endian word.
+ */
+static uint64_t siphash_load(const uint8_t *p, uint8_t len)
+{
+	uint64_t w = 0;
+
+	while (len--)
+		w = (w << 8) | p[len];
+	return w;
+}
+
+/*--------------------------------------------------------------------*/
+void siphash_init(siphash_t *s, const uint8_t *key)
+{
+	uint64_t k0 = siphash_load(key, 8);
+	uint64_t k1 = siphash_load(key + 8, 8);
+
+	s->v[0] = k0 ^ 0x736F6D6570736575ULL;
+	s->v[1] = k1 ^ 0x646F72616E646F6DULL;
+	s->v[2] = k0 ^ 0x6C7967656E657261ULL;
+	s->v[3] = k1 ^ 0x7465646279746573ULL;
+}
+
+/*--------------------------------------------------------------------*/
+void siphash_word(siphash_t *s, uint64_t m)
+{
+	s->v[3] ^= m;
+	siphash_rounds(s, SIPHASH_C_ROUNDS);
+	s->v[0] ^= m;
+}
+
+/*--------------------------------------------------------------------*/
+uint64_t siphash_final(siphash_t *s, uint64_t tail, uint8_t len)
+{
+	siphash_word(s, ((uint64_t)len << 56) | tail);
+	s->v[2] ^= 0xFF;
+	siphash_rounds(s, SIPHASH_D_ROUNDS);
+	return s->v[0] ^ s->v[1] ^ s->v[2] ^ s->v[3];
+}
+
+/*--------------------------------------------------------------------*/
+uint64_t siphash24(const uint8_t *key, const void *data, uint8_t len)
+{
+	const uint8_t *p = data;
+	siphash_t s;
+	uint8_t n;
+
+	siphash_init(&s, key);
+	for (n = len; n >= 8; n -= 8, p += 8)
+		siphash_word(&s, siphash_load(p, 8));
+	return siphash_final(&s, siphash_load(p, n), len);
+}
+
+#if !defined(__AVR__) || defined(BENCH)
+/*--------------------------------------------------------------------*/
+void siphash_rounds_c(siphash_t *s, uint8_t rounds)
+{
+	uint64_t v0 = s->v[0], v1 = s->v[1], v2 = s->v[2], v3 = s->v[3];
+
+	while (rounds--)
+	{
+		v0 += v1; v1 = ROTL(v1, 13); v1 ^= v0; v0 = ROTL(v0, 32);
+		v2 += v3; v3 = ROTL(v3, 16); v3 ^= v2;
+		v0 += v3; v3 = ROTL(v3, 21); v3 ^= v0;
+		v2 += v1; v1 = ROTL(v1, 17); v1 ^= v2; v2 = ROTL(v2, 32);
+	}
+	s->v[0] = v0;
+	s->v[1] = v1;
+	s->v[2] = v2;
+	s->v[3] = v3;
+}
+#endif
+
+#ifndef __AVR__
+/*--------------------------------------------------------------------*/
+// The AVR has siphash_avr.S
+void siphash_rounds(siphash_t *s, uint8_t rounds)
+{
+	siphash_rounds_c(s, rounds);
+}
+#endif
@@ -0,0 +1,112 @@
+#ifndef SIPHASH_H_
+#define SIPHASH_H_
+
+/***********************************************************************
+ *
+ * SipHash library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/**
+ * @file  siphash.h
+ * @defgroup dumbledoor_siphash SipHash Library <siphash.h>
+ * @code #include <siphash.h> @endcode
+ *
+ * @brief SipHash-2-4, a keyed 64-bit hash, with the rounds in assembly.
+ *
+ * @details
+ * SipHash-2-4 (Aumasson and Bernstein, 2012) hashes a message under a
+ * 128-bit key into 64 bits: two rounds per 8 byte word of the message,
+ * four to finish. Without the key nobody can compute or check a hash,
+ * which makes it fit for the credentials of the user table.
+ *
+ * siphash24() hashes a message in one call. The state functions take
+ * the message a word at a time, so a caller can start hashing before
+ * the message is complete; the PIN accumulator (pin.h) feeds each digit
+ * as a word of its own.
+ *
+ * On the AVR siphash_rounds() is siphash_avr.S, 361 cycles per round.
+ * siphash.c has the C version for the host tools and, with BENCH, for
+ * the comparison. A word takes about 0.05 ms at 16 MHz, siphash_final()
+ * about 0.15 ms.
+ *
+ * @author
+ * Demirkan Korbey Baglamac and Rasit Demiroren
+ *
+ * @copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * Programmed for the Digital Electronics 2 project.
+ * This work is licensed under the terms of the MIT license.
+ */
+
+/* Includes ----------------------------------------------------------*/
+#include <stdint.h>         // Fixed width integer types
+
+/* Definitions -------------------------------------------------------*/
+#define SIPHASH_KEY_LEN     16
+#define SIPHASH_C_ROUNDS    2       // Per message word
+#define SIPHASH_D_ROUNDS    4       // To finish
+
+/**
+ * @brief State of a hash, v0 to v3. siphash_avr.S depends on the layout.
+ */
+typedef struct {
+	uint64_t v[4];
+} siphash_t;
+
+/* Function prototypes -----------------------------------------------*/
+/**
+ * @brief    Starts a hash.
+ * @param    s    State
+ * @param    key  SIPHASH_KEY_LEN bytes
+ * @return   none
+ */
+void siphash_init(siphash_t *s, const uint8_t *key);
+
+/**
+ * @brief    Adds a word of the message.
+ * @param    s  State
+ * @param    m  Next 8 bytes of the message, the first in the low byte
+ * @return   none
+ */
+void siphash_word(siphash_t *s, uint64_t m);
+
+/**
+ * @brief    Adds the last word and finishes the hash.
+ * @param    s     State, no longer usable
+ * @param    tail  The 0 to 7 bytes after the last whole word, the first
+ *                 in the low byte
+ * @param    len   Length of the whole message in bytes
+ * @return   Hash
+ */
+uint64_t siphash_final(siphash_t *s, uint64_t tail, uint8_t len);
+
+/**
+ * @brief    SipHash-2-4 of a message.
+ * @param    key   SIPHASH_KEY_LEN bytes
+ * @param    data  Message
+ * @param    len   Length of the message in bytes
+ * @return   Hash
+ */
+uint64_t siphash24(const uint8_t *key, const void *data, uint8_t len);
+
+/**
+ * @brief    Runs SipRounds on a state.
+ * @param    s       State
+ * @param    rounds  1 to 255
+ * @return   none
+ */
+void siphash_rounds(siphash_t *s, uint8_t rounds);
+
+/**
+ * @brief    siphash_rounds() in C. On the AVR only built with BENCH.
+ * @param    s       State
+ * @param    rounds  1 to 255
+ * @return   none
+ */
+void siphash_rounds_c(siphash_t *s, uint8_t rounds);
+
+#endif /* SIPHASH_H_ */
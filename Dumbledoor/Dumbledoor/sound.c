@@ -0,0 +1,167 @@
+/***********************************************************************
+ *
+ * Melody sequencer library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/* Includes ----------------------------------------------------------*/
+#include <avr/pgmspace.h>   // Melodies in program memory
+#include <util/atomic.h>    // ATOMIC_BLOCK
+#include "sound.h"
+#include "hal.h"            // Buzzer and bell outputs
+#include "eeq.h"            // EEPROM access
+#include "eemap.h"          // EEPROM layout
+#include "chime.h"          // Sampled chime library
+#include "frame.h"          // FRAME_NO_REPLY
+
+/* Definitions -------------------------------------------------------*/
+#define STEP_TICKS      0x3F
+
+/* Global Variables --------------------------------------------------*/
+// The sequences of the first firmware, with the off times the toggles
+// of the wrong pin and door bell sequences were meant to have
+static const uint8_t melodyClick[] PROGMEM = {
+	SOUND_STEP(SOUND_BUZZER, 10), SOUND_END
+};
+static const uint8_t melodyAccept[] PROGMEM = {
+	SOUND_STEP(SOUND_BUZZER, 50), SOUND_END
+};
+static const uint8_t melodyDeny[] PROGMEM = {
+	SOUND_STEP(SOUND_BUZZER, 10), SOUND_STEP(SOUND_REST, 10),
+	SOUND_STEP(SOUND_BUZZER, 10), SOUND_STEP(SOUND_REST, 10),
+	SOUND_STEP(SOUND_BUZZER, 10), SOUND_END
+};
+static const uint8_t melodyDingDong[] PROGMEM = {
+	SOUND_STEP(SOUND_BELL, 10), SOUND_STEP(SOUND_REST, 5),
+	SOUND_STEP(SOUND_BELL, 5),  SOUND_STEP(SOUND_REST, 10),
+	SOUND_STEP(SOUND_BELL, 5),  SOUND_STEP(SOUND_REST, 5),
+	SOUND_STEP(SOUND_BELL, 10), SOUND_STEP(SOUND_REST, 10),
+	SOUND_STEP(SOUND_BELL, 5),  SOUND_STEP(SOUND_REST, 5),
+	SOUND_STEP(SOUND_BELL, 10), SOUND_STEP(SOUND_REST, 5),
+	SOUND_STEP(SOUND_BELL, 5),  SOUND_STEP(SOUND_REST, 10),
+	SOUND_END
+};
+static const uint8_t melodyFanfare[] PROGMEM = {
+	SOUND_STEP(SOUND_BUZZER, 5), SOUND_STEP(SOUND_REST, 3),
+	SOUND_STEP(SOUND_BUZZER, 5), SOUND_STEP(SOUND_REST, 3),
+	SOUND_STEP(SOUND_BUZZER, 10), SOUND_STEP(SOUND_BOTH, 20),
+	SOUND_END
+};
+static const uint8_t melodyTriple[] PROGMEM = {
+	SOUND_STEP(SOUND_BUZZER, 4), SOUND_STEP(SOUND_REST, 4),
+	SOUND_STEP(SOUND_BUZZER, 4), SOUND_STEP(SOUND_REST, 4),
+	SOUND_STEP(SOUND_BUZZER, 4), SOUND_END
+};
+
+// MELODY_... order, up to the chime
+static const uint8_t *const soundMelodies[MELODY_CHIME] PROGMEM = {
+	melodyClick, melodyAccept, melodyDeny, melodyDingDong, melodyFanfare, melodyTriple
+};
+
+// Melody of each event, SOUND_... order
+static uint8_t soundEvents[SOUND_EVENTS] = {
+	MELODY_CLICK, MELODY_ACCEPT, MELODY_DENY, MELODY_CHIME
+};
+
+static const uint8_t *volatile soundAt = 0;    // Next step, 0: silent
+static volatile uint8_t soundLeft = 0;         // Ticks left of the step
+
+/* Function definitions ----------------------------------------------*/
+void sound_init(void)
+{
+	uint8_t ee[SOUND_EVENTS];
+
+	// Erased EEPROM keeps the defaults
+	eeq_read(ee, EE_SOUNDS, SOUND_EVENTS);
+	for (uint8_t i = 0; i < SOUND_EVENTS; i++)
+		if (ee[i] < MELODIES)
+			soundEvents[i] = ee[i];
+	sound_stop();
+}
+
+/*--------------------------------------------------------------------*/
+void sound_event(uint8_t event)
+{
+	if (event < SOUND_EVENTS)
+		sound_play(soundEvents[event]);
+}
+
+/*--------------------------------------------------------------------*/
+void sound_play(uint8_t melody)
+{
+	if (melody >= MELODIES)
+		return;
+
+	if (melody == MELODY_CHIME)
+	{
+		sound_stop();
+		chime_play();
+		return;
+	}
+	chime_stop();
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		soundAt = pgm_read_ptr(&soundMelodies[melody]);
+		soundLeft = 0;
+	}
+}
+
+/*--------------------------------------------------------------------*/
+void sound_stop(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		soundAt = 0;
+		soundLeft = 0;
+		hal_pin_write(HAL_BUZZER, 0);
+		hal_pin_write(HAL_BELL, 0);
+		chime_stop();
+	}
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t sound_busy(void)
+{
+	return soundAt != 0 || chime_busy();
+}
+
+/*--------------------------------------------------------------------*/
+void sound_tick(void)
+{
+	const uint8_t *at = soundAt;
+	uint8_t step;
+
+	chime_tick();
+
+	// Within a step nothing changes
+	if (soundLeft && --soundLeft)
+		return;
+	if (!at)
+		return;
+
+	step = pgm_read_byte(at);
+	hal_pin_write(HAL_BUZZER, step & SOUND_BUZZER);
+	hal_pin_write(HAL_BELL, step & SOUND_BELL);
+	soundLeft = step & STEP_TICKS;
+	soundAt = (step == SOUND_END) ? 0 : at + 1;
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t sound_frame(uint8_t type, const uint8_t *payload, uint8_t len, uint8_t *reply)
+{
+	if (type != FT_SOUND)
+		return FRAME_NO_REPLY;
+
+	if (len >= 2 && payload[0] < SOUND_EVENTS && payload[1] < MELODIES)
+	{
+		soundEvents[payload[0]] = payload[1];
+		eeq_write(EE_SOUNDS + payload[0], &payload[1], 1);
+	}
+	for (uint8_t i = 0; i < SOUND_EVENTS; i++)
+		reply[i] = soundEvents[i];
+	return SOUND_EVENTS;
+}
@@ -0,0 +1,127 @@
+#ifndef SOUND_H_
+#define SOUND_H_
+
+/***********************************************************************
+ *
+ * Melody sequencer library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/**
+ * @file  sound.h
+ * @defgroup dumbledoor_sound Melody Library <sound.h>
+ * @code #include <sound.h> @endcode
+ *
+ * @brief Buzzer and door bell melodies played from program memory.
+ *
+ * @details
+ * A melody is a string of steps in flash, one byte each: the voice in
+ * the upper two bits (silent, buzzer, bell or both) and the number of
+ * sound ticks it lasts in the lower six, a zero byte ends it. Both
+ * outputs are plain on/off pins, so the voice is all there is to a note.
+ * sound_tick() costs the same every tick: it counts the step down and
+ * reads the next byte when it ends. MELODY_CHIME is no step string but
+ * the sampled chime of chime.h, played on the speaker.
+ *
+ * Every sound event has a melody, which the master can change with
+ * FT_SOUND, it is kept in EEPROM. A user can have an own melody for the
+ * correct pin in the user table.
+ *
+ * @author
+ * Demirkan Korbey Baglamac and Rasit Demiroren
+ *
+ * @copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * Programmed for the Digital Electronics 2 project.
+ * This work is licensed under the terms of the MIT license.
+ */
+
+/* Includes ----------------------------------------------------------*/
+#include <stdint.h>         // Fixed width integer types
+
+/* Definitions -------------------------------------------------------*/
+// Voices of a step
+#define SOUND_REST          0x00
+#define SOUND_BUZZER        0x40
+#define SOUND_BELL          0x80
+#define SOUND_BOTH          0xC0
+#define SOUND_STEP(voice, ticks)    ((voice) | (ticks))   // ticks 1..63
+#define SOUND_END           0x00
+
+#define SOUND_TICKS_MAX     100     // Longest melody in sound ticks
+
+// Melodies in flash
+#define MELODY_CLICK        0       // Key press
+#define MELODY_ACCEPT       1       // Long beep
+#define MELODY_DENY         2       // Five short beeps
+#define MELODY_DING_DONG    3       // Door bell
+#define MELODY_FANFARE      4       // Rising beeps with the bell
+#define MELODY_TRIPLE       5       // Three beeps
+#define MELODY_CHIME        6       // Sampled door bell, see chime.h
+#define MELODIES            7
+
+// Sound events
+#define SOUND_KEY           0
+#define SOUND_CORRECT       1
+#define SOUND_WRONG         2
+#define SOUND_DOORBELL      3
+#define SOUND_EVENTS        4
+
+// Melody frame, the door answers with type | FT_REPLY
+#define FT_SOUND            0x23    // [] or [event, melody] -> [melody * SOUND_EVENTS]
+
+/* Function prototypes -----------------------------------------------*/
+/**
+ * @brief    Loads the melodies of the events from EEPROM and stops the
+ *           outputs.
+ * @return   none
+ */
+void sound_init(void);
+
+/**
+ * @brief    Starts the melody of an event from its beginning, a melody
+ *           still playing is cut short.
+ * @param    event  SOUND_...
+ * @return   none
+ */
+void sound_event(uint8_t event);
+
+/**
+ * @brief    Starts a melody from its beginning.
+ * @param    melody  MELODY_..., others are not played
+ * @return   none
+ */
+void sound_play(uint8_t melody);
+
+/**
+ * @brief    Stops the melody and the outputs.
+ * @return   none
+ */
+void sound_stop(void);
+
+/**
+ * @brief    Tells whether a melody is playing.
+ * @return   1 while playing
+ */
+uint8_t sound_busy(void);
+
+/**
+ * @brief    Plays the next sound tick. Called by door_tick_sound().
+ * @return   none
+ */
+void sound_tick(void);
+
+/**
+ * @brief    Handles the melody frame. Called by the bus library.
+ * @param    type     Frame type
+ * @param    payload  Request payload
+ * @param    len      Request payload length
+ * @param    reply    FRAME_PAYLOAD_MAX bytes for the reply payload
+ * @return   Reply payload length, FRAME_NO_REPLY for other frames
+ */
+uint8_t sound_frame(uint8_t type, const uint8_t *payload, uint8_t len, uint8_t *reply);
+
+#endif /* SOUND_H_ */
@@ -0,0 +1,146 @@
+/***********************************************************************
+ *
+ * Stack and SRAM usage library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/* Includes ----------------------------------------------------------*/
+#include "stack.h"
+#include "event.h"          // EV_STACK, event clock
+#include "frame.h"          // FRAME_NO_REPLY
+#ifdef __AVR__
+#include <avr/io.h>         // RAMEND, WDRF
+#endif
+
+/* Definitions -------------------------------------------------------*/
+#define STACK_MAGIC     0x5AC5      // stackLast holds a measurement
+
+/* Global Variables --------------------------------------------------*/
+volatile uint8_t stackNesting = 0;
+uint8_t stackIsrDepth[STACK_ISRS];
+
+static uint16_t stackFree = 0;      // Painted bytes at the bottom
+static uint16_t stackSecond = 0;    // Event clock at the last count
+
+#ifdef __AVR__
+// Linker symbols, see the avr-libc linker scripts
+extern uint8_t __data_start[], __data_end[];
+extern uint8_t __bss_start[], __heap_start[];
+
+// Stack and heap, from the end of .noinit to the top of SRAM
+#define STACK_AREA      ((uint16_t)(RAMEND + 1 - (uintptr_t)__heap_start))
+
+// Survives a reset, the C runtime does not clear it and the paint
+// starts above it
+static struct {
+	uint16_t magic;
+	uint16_t free;
+} stackLast __attribute__((section(".noinit")));
+
+/* Function definitions ----------------------------------------------*/
+// Runs in .init1, before the stack pointer, r1, .data and .bss are set
+// up, so neither C nor the stack may be used. The hardware started SP
+// at RAMEND, nothing is on the stack yet.
+void stack_paint(void) __attribute__((naked, used, section(".init1")));
+void stack_paint(void)
+{
+	__asm__ __volatile__(
+		"	ldi r30, lo8(__heap_start)\n"
+		"	ldi r31, hi8(__heap_start)\n"
+		"	ldi r24, %[canary]\n"
+		"	ldi r25, hi8(%[end])\n"
+		"1:	st Z+, r24\n"
+		"	cpi r30, lo8(%[end])\n"
+		"	cpc r31, r25\n"
+		"	brne 1b\n"
+		:: [canary] "M" (STACK_CANARY), [end] "i" (RAMEND + 1));
+}
+
+/*--------------------------------------------------------------------*/
+// The stack only grows down, the count never has to look above the
+// last one
+static void stack_count(void)
+{
+	const uint8_t *p = __heap_start;
+	uint16_t n = 0;
+
+	while (n < stackFree && p[n] == STACK_CANARY)
+		n++;
+	stackFree = n;
+	stackLast.free = n;
+}
+#else
+static void stack_count(void)
+{
+}
+#endif
+
+/*--------------------------------------------------------------------*/
+void stack_init(uint8_t mcusr)
+{
+#ifdef __AVR__
+	// A watchdog reset may well be a stack overflow, report the last
+	// count of the run before
+	if ((mcusr & (1 << WDRF)) && stackLast.magic == STACK_MAGIC)
+		event_post(EV_STACK, (stackLast.free > 0xFF) ? 0xFF : stackLast.free);
+	stackLast.magic = STACK_MAGIC;
+	stackFree = STACK_AREA;
+#else
+	(void)mcusr;
+#endif
+	stack_count();
+	stackSecond = event_time();
+}
+
+/*--------------------------------------------------------------------*/
+void stack_task(void)
+{
+	uint16_t now = event_time();
+
+	if (now == stackSecond)
+		return;
+	stackSecond = now;
+	stack_count();
+}
+
+/*--------------------------------------------------------------------*/
+void stack_report(stack_report_t *r)
+{
+	r->free = stackFree;
+#ifdef __AVR__
+	r->size = STACK_AREA;
+	r->data = (uint16_t)(__data_end - __data_start);
+	r->bss = (uint16_t)(__heap_start - __bss_start);
+#else
+	r->size = r->data = r->bss = 0;
+#endif
+	for (uint8_t i = 0; i < STACK_ISRS; i++)
+		r->depth[i] = stackIsrDepth[i];
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t stack_frame(uint8_t type, uint8_t *reply)
+{
+	stack_report_t r;
+	uint8_t len = 0;
+
+	if (type != FT_STACK_INFO)
+		return FRAME_NO_REPLY;
+
+	stack_report(&r);
+	reply[len++] = r.free & 0xFF;
+	reply[len++] = r.free >> 8;
+	reply[len++] = r.size & 0xFF;
+	reply[len++] = r.size >> 8;
+	reply[len++] = r.data & 0xFF;
+	reply[len++] = r.data >> 8;
+	reply[len++] = r.bss & 0xFF;
+	reply[len++] = r.bss >> 8;
+	for (uint8_t i = 0; i < STACK_ISRS; i++)
+		reply[len++] = r.depth[i];
+	return len;
+}
@@ -0,0 +1,135 @@
+#ifndef STACK_H_
+#define STACK_H_
+
+/***********************************************************************
+ *
+ * Stack and SRAM usage library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/**
+ * @file  stack.h
+ * @defgroup dumbledoor_stack Stack Library <stack.h>
+ * @code #include <stack.h> @endcode
+ *
+ * @brief High-water mark of the stack and the SRAM use of the door.
+ *
+ * @details
+ * Before the C runtime starts, everything between __heap_start and the
+ * top of SRAM is filled with STACK_CANARY. The stack grows down into
+ * that area, the painted bytes left at its bottom are the least free
+ * stack there has been since reset. stack_task() counts them once a
+ * second from the main loop.
+ *
+ * Every interrupt handler records how deep interrupts were nested when
+ * it ran, 1 when it interrupted the main loop. The report is sent to a
+ * FT_STACK_INFO frame. The free stack is kept in .noinit as well, after
+ * a watchdog reset the value of the run before is posted as EV_STACK.
+ *
+ * On the host the sizes and the free stack read 0.
+ *
+ * @author
+ * Demirkan Korbey Baglamac and Rasit Demiroren
+ *
+ * @copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * Programmed for the Digital Electronics 2 project.
+ * This work is licensed under the terms of the MIT license.
+ */
+
+/* Includes ----------------------------------------------------------*/
+#include <stdint.h>         // Fixed width integer types
+
+/* Definitions -------------------------------------------------------*/
+#define STACK_CANARY        0xC5    // Paint of the unused SRAM
+
+// Interrupt handlers with a nesting record
+#define STACK_ISR_KEYPAD    0       // TIMER0_OVF
+#define STACK_ISR_SECOND    1       // TIMER1_COMPA
+#define STACK_ISR_SOUND     2       // TIMER2_OVF
+#define STACK_ISR_UART_RX   3       // USART_RX
+#define STACK_ISR_UART_UDRE 4       // USART_UDRE
+#define STACK_ISR_UART_TXC  5       // USART_TX, RS-485 only
+#define STACK_ISR_WAKE      6       // PCINT2, start bit on a slow clock
+#define STACK_ISR_CHIME     7       // TIMER2_COMPB, chime samples
+#define STACK_ISR_EEPROM    8       // EE_READY, queued EEPROM writes
+#define STACK_ISRS          9
+
+// Report frame, the door answers with type | FT_REPLY
+#define FT_STACK_INFO       0x20    // [] -> [free lo, free hi, size lo, size hi, data lo, data hi,
+                                    //        bss lo, bss hi, depth * STACK_ISRS]
+#define STACK_INFO_LEN      (8 + STACK_ISRS)
+
+/**
+ * @brief SRAM use since reset, in bytes.
+ */
+typedef struct {
+	uint16_t free;                      // Least free stack
+	uint16_t size;                      // Stack and heap area
+	uint16_t data;                      // .data
+	uint16_t bss;                       // .bss and .noinit
+	uint8_t depth[STACK_ISRS];          // Deepest nesting per handler
+} stack_report_t;
+
+/* Global Variables --------------------------------------------------*/
+extern volatile uint8_t stackNesting;
+extern uint8_t stackIsrDepth[STACK_ISRS];
+
+/* Function prototypes -----------------------------------------------*/
+/**
+ * @brief    Measures the stack of the boot. After a watchdog reset
+ *           posts the free stack of the run before as EV_STACK. Call
+ *           it after bus_init().
+ * @param    mcusr  MCUSR at reset
+ * @return   none
+ */
+void stack_init(uint8_t mcusr);
+
+/**
+ * @brief    Counts the free stack once a second. Call it from the main
+ *           loop.
+ * @return   none
+ */
+void stack_task(void);
+
+/**
+ * @brief    Fills in the report.
+ * @param    r  Report
+ * @return   none
+ */
+void stack_report(stack_report_t *r);
+
+/**
+ * @brief    Handles a report frame. Called by the bus library.
+ * @param    type   Frame type
+ * @param    reply  FRAME_PAYLOAD_MAX bytes for the reply payload
+ * @return   Reply payload length, FRAME_NO_REPLY for other frames
+ */
+uint8_t stack_frame(uint8_t type, uint8_t *reply);
+
+/**
+ * @brief    Records the nesting of a handler, first thing in its body.
+ * @param    isr  STACK_ISR_...
+ * @return   none
+ */
+static inline void stack_isr_enter(uint8_t isr)
+{
+	uint8_t depth = ++stackNesting;
+
+	if (depth > stackIsrDepth[isr])
+		stackIsrDepth[isr] = depth;
+}
+
+/**
+ * @brief    Last thing in the body of a handler.
+ * @return   none
+ */
+static inline void stack_isr_leave(void)
+{
+	stackNesting--;
+}
+
+#endif /* STACK_H_ */
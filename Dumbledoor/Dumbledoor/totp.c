@@ -0,0 +1,424 @@
+/***********************************************************************
+ *
+ * One-time code library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/* Includes ----------------------------------------------------------*/
+#include <string.h>         // memset, memcmp
+#include <util/atomic.h>    // ATOMIC_BLOCK
+#include "totp.h"
+#include "eemap.h"          // EEPROM layout
+#include "eeq.h"            // EEPROM access
+#include "frame.h"          // FRAME_NO_REPLY
+#include "sha1.h"           // HMAC-SHA1
+#include "pin.h"            // Credentials
+#include "rtc.h"            // Wall clock library
+#include "users.h"          // User table library
+
+/* Definitions -------------------------------------------------------*/
+#define TOTP_MOD        1000000UL   // 10^TOTP_DIGITS
+#define TOTP_ALL        ((1 << TOTP_WINDOWS) - 1)
+#define TOTP_NEWEST     (1 << (TOTP_WINDOWS - 1))
+
+typedef char totp_digits_check[(TOTP_DIGITS == 6 && TOTP_DIGITS >= PIN_MIN) ? 1 : -1];
+typedef char totp_cred_check[(USERS_CRED_LEN <= SHA1_LEN) ? 1 : -1];
+
+/* Global Variables --------------------------------------------------*/
+// Users in the cache
+static uint16_t totpSlot[TOTP_USERS];
+static uint32_t totpKey[TOTP_USERS];   // Low 32 bits of the fingerprint
+static uint8_t totpEntry[TOTP_USERS];  // Entry of the secret in EE_TOTP
+static uint32_t totpUsed[TOTP_USERS];  // Last step which opened the door
+static uint8_t totpCount = 0;
+static uint16_t totpVer = 0;           // Table version of totpSlot
+static uint8_t totpLoaded = 0;         // totpSlot is known
+static uint8_t totpNewSecret = 0;      // FT_TOTP_SECRET filled an entry
+
+// Low 32 bits of pin_hash() of the codes of steps totpStep - 1 to
+// totpStep + 1, a window bit per user tells which are computed and
+// still unused
+static volatile uint32_t totpCode[TOTP_USERS][TOTP_WINDOWS];
+static volatile uint8_t totpValid[TOTP_USERS];
+static uint8_t totpPending[TOTP_USERS];
+static uint32_t totpStep = 0;
+
+/* Function definitions ----------------------------------------------*/
+uint32_t hotp(const uint8_t *key, uint8_t keyLen, uint32_t counter)
+{
+	uint8_t msg[8] = {0};
+	uint8_t mac[SHA1_LEN];
+	uint8_t off;
+	uint32_t bin;
+
+	// Counter as a 64-bit big endian number
+	for (uint8_t i = 0; i < 4; i++)
+		msg[7 - i] = (uint8_t)(counter >> (8 * i));
+	sha1_hmac(key, keyLen, msg, sizeof(msg), mac);
+
+	// Dynamic truncation
+	off = mac[SHA1_LEN - 1] & 0x0F;
+	bin = (uint32_t)(mac[off] & 0x7F) << 24 | (uint32_t)mac[off + 1] << 16 |
+		(uint32_t)mac[off + 2] << 8 | mac[off + 3];
+	memset(mac, 0, sizeof(mac));
+	return bin % TOTP_MOD;
+}
+
+/*--------------------------------------------------------------------*/
+void totp_fingerprint(const uint8_t *secret, uint8_t *cred)
+{
+	uint8_t digest[SHA1_LEN];
+	sha1_t s;
+
+	sha1_init(&s);
+	sha1_update(&s, secret, TOTP_SECRET_LEN);
+	sha1_final(&s, digest);
+	memcpy(cred, digest, USERS_CRED_LEN);
+}
+
+/*--------------------------------------------------------------------*/
+static uint16_t totp_addr(uint8_t e)
+{
+	return EE_TOTP + e * TOTP_ENTRY_LEN;
+}
+
+/*--------------------------------------------------------------------*/
+// Entry with the secret the record of a slot names, TOTP_USERS when
+// there is none. The fingerprint is only compared for the entries of
+// the slot.
+static uint8_t totp_find(uint16_t slot, const uint8_t *cred)
+{
+	uint8_t secret[TOTP_SECRET_LEN];
+	uint8_t fp[USERS_CRED_LEN];
+	uint8_t held[2];
+	uint8_t e;
+
+	for (e = 0; e < TOTP_USERS; e++)
+	{
+		eeq_read(held, totp_addr(e), sizeof(held));
+		if ((held[0] | held[1] << 8) != slot)
+			continue;
+		eeq_read(secret, totp_addr(e) + 2, sizeof(secret));
+		totp_fingerprint(secret, fp);
+		if (memcmp(fp, cred, USERS_CRED_LEN) == 0)
+			break;
+	}
+	memset(secret, 0, sizeof(secret));
+	return e;
+}
+
+/*--------------------------------------------------------------------*/
+// Tells if an entry holds the secret of the user in its slot
+static uint8_t totp_held(uint8_t e)
+{
+	uint8_t cred[USERS_CRED_LEN];
+	uint8_t held[2];
+	uint16_t slot;
+
+	eeq_read(held, totp_addr(e), sizeof(held));
+	slot = held[0] | held[1] << 8;
+	return slot < USERS_MAX && users_totp(slot, cred) && totp_find(slot, cred) == e;
+}
+
+/*--------------------------------------------------------------------*/
+void totp_init(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		for (uint8_t u = 0; u < TOTP_USERS; u++)
+		{
+			totpValid[u] = 0;
+			totpPending[u] = 0;
+		}
+		totpCount = 0;
+	}
+	totpLoaded = 0;
+	totpNewSecret = 0;
+}
+
+/*--------------------------------------------------------------------*/
+// Finds the users of the table whose secret is kept, and the last step
+// each used. A user whose slot and secret are the same keeps the codes
+// of the cache and which of them are used; the others are computed anew.
+static void totp_load(uint32_t step)
+{
+	uint8_t cred[USERS_CRED_LEN];
+	uint8_t used[4];
+	uint16_t slots[TOTP_USERS];
+	uint32_t keys[TOTP_USERS];
+	uint8_t entries[TOTP_USERS];
+	uint32_t steps[TOTP_USERS];
+	uint8_t count = 0;
+	uint8_t from[TOTP_USERS];
+
+	for (uint16_t slot = 0; slot < USERS_MAX && count < TOTP_USERS; slot++)
+	{
+		if (!users_totp(slot, cred))
+			continue;
+		entries[count] = totp_find(slot, cred);
+		if (entries[count] == TOTP_USERS)
+			continue;
+		eeq_read(used, totp_addr(entries[count]) + 2 + TOTP_SECRET_LEN, sizeof(used));
+		steps[count] = (uint32_t)used[3] << 24 | (uint32_t)used[2] << 16 |
+			(uint16_t)used[1] << 8 | used[0];
+		slots[count] = slot;
+		keys[count] = (uint32_t)cred[3] << 24 | (uint32_t)cred[2] << 16 |
+			(uint16_t)cred[1] << 8 | cred[0];
+		from[count] = TOTP_USERS;
+		for (uint8_t o = 0; totpLoaded && o < totpCount; o++)
+			if (totpSlot[o] == slot && totpKey[o] == keys[count])
+				from[count] = o;
+		count++;
+	}
+
+	// Copied out first, a user may move either way in the order
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		uint32_t code[TOTP_USERS][TOTP_WINDOWS];
+		uint8_t valid[TOTP_USERS];
+		uint8_t pending[TOTP_USERS];
+
+		for (uint8_t u = 0; u < TOTP_USERS; u++)
+		{
+			uint8_t o = (u < count) ? from[u] : TOTP_USERS;
+
+			for (uint8_t w = 0; w < TOTP_WINDOWS; w++)
+				code[u][w] = (o < TOTP_USERS) ? totpCode[o][w] : 0;
+			valid[u] = (o < TOTP_USERS) ? totpValid[o] : 0;
+			pending[u] = (o < TOTP_USERS) ? totpPending[o] : (u < count) ? TOTP_ALL : 0;
+		}
+		for (uint8_t u = 0; u < TOTP_USERS; u++)
+		{
+			if (u < count)
+			{
+				totpSlot[u] = slots[u];
+				totpKey[u] = keys[u];
+				totpEntry[u] = entries[u];
+				totpUsed[u] = steps[u];
+			}
+			for (uint8_t w = 0; w < TOTP_WINDOWS; w++)
+				totpCode[u][w] = code[u][w];
+			totpValid[u] = valid[u];
+			totpPending[u] = pending[u];
+		}
+		totpCount = count;
+	}
+
+	totpVer = users_version();
+	totpNewSecret = 0;
+	if (!totpLoaded)
+		totpStep = step;
+	totpLoaded = 1;
+}
+
+/*--------------------------------------------------------------------*/
+// Moves to the next step, or computes everything again after a jump
+static void totp_move(uint32_t step)
+{
+	uint8_t next = (step == totpStep + 1);
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		for (uint8_t u = 0; u < totpCount; u++)
+		{
+			if (next)
+			{
+				for (uint8_t w = 0; w < TOTP_WINDOWS - 1; w++)
+					totpCode[u][w] = totpCode[u][w + 1];
+				totpValid[u] >>= 1;
+				totpPending[u] = (totpPending[u] >> 1) | TOTP_NEWEST;
+			}
+			else
+			{
+				totpValid[u] = 0;
+				totpPending[u] = TOTP_ALL;
+			}
+		}
+	}
+	totpStep = step;
+}
+
+/*--------------------------------------------------------------------*/
+// Computes one missing code, none for the steps up to the last used
+static void totp_compute(void)
+{
+	uint8_t secret[TOTP_SECRET_LEN];
+	char digits[TOTP_DIGITS];
+	uint32_t code;
+	uint32_t digest;
+
+	for (uint8_t u = 0; u < totpCount; u++)
+	{
+		if (!totpPending[u])
+			continue;
+
+		uint8_t w = 0;
+		while (!(totpPending[u] & (1 << w)))
+			w++;
+		totpPending[u] &= ~(1 << w);
+		if (totpStep - 1 + w <= totpUsed[u])
+			return;
+
+		eeq_read(secret, totp_addr(totpEntry[u]) + 2, sizeof(secret));
+		code = hotp(secret, sizeof(secret), totpStep - 1 + w);
+		for (uint8_t i = TOTP_DIGITS; i--; )
+		{
+			digits[i] = '0' + code % 10;
+			code /= 10;
+		}
+		digest = (uint32_t)pin_hash(digits, TOTP_DIGITS);
+		memset(secret, 0, sizeof(secret));
+		memset(digits, 0, sizeof(digits));
+
+		// The entry is only seen by totp_match() once it is complete
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			totpCode[u][w] = digest;
+			totpValid[u] |= 1 << w;
+		}
+		return;
+	}
+}
+
+/*--------------------------------------------------------------------*/
+void totp_task(void)
+{
+	uint32_t now = rtc_now();
+	uint32_t step = now / TOTP_STEP;
+
+	if (!now)
+	{
+		// No codes without the time
+		if (totpLoaded)
+		{
+			ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+			{
+				for (uint8_t u = 0; u < TOTP_USERS; u++)
+					totpValid[u] = 0;
+			}
+			totpLoaded = 0;
+		}
+		return;
+	}
+
+	if (!totpLoaded || totpNewSecret || totpVer != users_version())
+		totp_load(step);
+	if (step != totpStep)
+		totp_move(step);
+
+	totp_compute();
+}
+
+/*--------------------------------------------------------------------*/
+int16_t totp_match(uint64_t cred)
+{
+	uint32_t digest = (uint32_t)cred;
+	uint8_t hit[TOTP_USERS];
+	uint8_t any = 0;
+
+	// The same work for every entry, used or not, hit or not
+	for (uint8_t u = 0; u < TOTP_USERS; u++)
+	{
+		hit[u] = 0;
+		for (uint8_t w = 0; w < TOTP_WINDOWS; w++)
+		{
+			uint32_t d = totpCode[u][w] ^ digest;
+			uint8_t z = (uint8_t)(d | d >> 8 | d >> 16 | d >> 24);
+			uint8_t eq = (uint8_t)(((uint16_t)z - 1) >> 8);   // 0xFF when z is 0
+
+			hit[u] |= eq & (1 << w);
+		}
+		hit[u] &= totpValid[u];
+		any |= hit[u];
+	}
+	if (!any)
+		return -1;
+
+	for (uint8_t u = 0; u < totpCount; u++)
+	{
+		if (hit[u])
+		{
+			// Used up with the windows before it, also after a reset
+			uint8_t w = TOTP_WINDOWS - 1;
+			uint8_t used[4];
+
+			while (!(hit[u] & (1 << w)))
+				w--;
+			totpValid[u] &= ~((2 << w) - 1);
+			totpUsed[u] = totpStep - 1 + w;
+			for (uint8_t i = 0; i < sizeof(used); i++)
+				used[i] = (uint8_t)(totpUsed[u] >> (8 * i));
+			eeq_write(totp_addr(totpEntry[u]) + 2 + TOTP_SECRET_LEN, used, sizeof(used));
+			eeq_flush();
+			return totpSlot[u];
+		}
+	}
+	return -1;
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t totp_ready(void)
+{
+	for (uint8_t u = 0; u < totpCount; u++)
+		if (totpPending[u])
+			return 0;
+	return totpLoaded || !rtc_valid();
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t totp_frame(uint8_t type, const uint8_t *payload, uint8_t len, uint8_t *reply)
+{
+	uint8_t cred[USERS_CRED_LEN];
+	uint8_t fp[USERS_CRED_LEN];
+	uint8_t used[4] = {0};
+	uint8_t e;
+	uint16_t slot;
+
+	if (type != FT_TOTP_SECRET)
+		return FRAME_NO_REPLY;
+
+	reply[0] = TOTP_OK;
+	if (len != 2 + TOTP_SECRET_LEN)
+	{
+		reply[0] = TOTP_E_LEN;
+		return 1;
+	}
+	slot = payload[0] | payload[1] << 8;
+	if (slot >= USERS_MAX || !users_totp(slot, cred))
+	{
+		reply[0] = TOTP_E_SLOT;
+		return 1;
+	}
+	totp_fingerprint(payload + 2, fp);
+	if (memcmp(fp, cred, USERS_CRED_LEN) != 0)
+	{
+		reply[0] = TOTP_E_SECRET;
+		return 1;
+	}
+
+	// Sent again: the entry keeps the last used step
+	if (totp_find(slot, cred) < TOTP_USERS)
+		return 1;
+	for (e = 0; e < TOTP_USERS && totp_held(e); e++)
+		;
+	if (e == TOTP_USERS)
+	{
+		reply[0] = TOTP_E_FULL;
+		return 1;
+	}
+	// Codes of a user removed since the last totp_task() go with it
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		for (uint8_t u = 0; u < totpCount; u++)
+			if (totpEntry[u] == e)
+				totpValid[u] = 0;
+	}
+	eeq_write(totp_addr(e), payload, 2 + TOTP_SECRET_LEN);
+	eeq_write(totp_addr(e) + 2 + TOTP_SECRET_LEN, used, sizeof(used));
+	totpNewSecret = 1;
+	return 1;
+}
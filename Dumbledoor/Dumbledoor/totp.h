@@ -0,0 +1,147 @@
+#ifndef TOTP_H_
+#define TOTP_H_
+
+/***********************************************************************
+ *
+ * One-time code library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/**
+ * @file  totp.h
+ * @defgroup dumbledoor_totp One-Time Code Library <totp.h>
+ * @code #include <totp.h> @endcode
+ *
+ * @brief Time-based one-time codes (RFC 6238) of authenticator apps.
+ *
+ * @details
+ * A user with USER_F_TOTP has no PIN. The user types the TOTP_DIGITS
+ * digit code an authenticator app shows for the secret, changing every
+ * TOTP_STEP seconds:
+ *
+ *     code = hotp(secret, unix time / TOTP_STEP)
+ *
+ * The secrets are TOTP_SECRET_LEN bytes, 160 bits as the apps make
+ * them; RFC 4226 asks for 128 at least, more than the cred field of a
+ * record holds. The record keeps totp_fingerprint() of the secret in
+ * cred, the secret itself is kept in an EEPROM area of its own
+ * (EE_TOTP), one entry per user: slot, secret and the last step a code
+ * of it opened the door. The master sends it with FT_TOTP_SECRET after
+ * the record is committed, the door takes only the secret the record
+ * names. An entry is free again once its slot holds a different user.
+ *
+ * HMAC-SHA1 takes a few milliseconds, too long for the key pad tick.
+ * totp_task() works ahead in the main loop instead: it keeps the codes
+ * of the first TOTP_USERS such users for the steps t - 1, t and t + 1
+ * in SRAM, one window more on each side for a clock or a phone that is
+ * a little off. At the turn of a step the windows move down by one and
+ * only the new t + 1 codes are computed, one HOTP per call. A jump of
+ * the clock computes them all again, a change of the user table only
+ * those of the users whose slot or secret changed.
+ *
+ * The door only ever has the hash of the typed digits (pin.h), so the
+ * cache holds the low 32 bits of pin_hash() of each code and not the
+ * code itself. totp_match() compares a finished entry with every entry
+ * of the cache in the same time, whether one fits or not. A code that
+ * opened the door is taken out of the cache with the codes of the
+ * steps before it, and its step is written to the entry: no code of
+ * that step or an earlier one works again (RFC 4226 section 7.5), a
+ * sync of the table or a reset in between included.
+ *
+ * Without a valid clock (rtc.h) the cache stays empty and no code
+ * works.
+ *
+ * @author
+ * Demirkan Korbey Baglamac and Rasit Demiroren
+ *
+ * @copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * Programmed for the Digital Electronics 2 project.
+ * This work is licensed under the terms of the MIT license.
+ */
+
+/* Includes ----------------------------------------------------------*/
+#include <stdint.h>         // Fixed width integer types
+
+/* Definitions -------------------------------------------------------*/
+#define TOTP_STEP           30      // Seconds per code
+#define TOTP_DIGITS         6       // Digits of a code
+#define TOTP_WINDOWS        3       // Steps t - 1, t, t + 1
+#ifndef TOTP_USERS
+#define TOTP_USERS          4       // Users with codes in the cache
+#endif
+#define TOTP_SECRET_LEN     20      // Bytes of a secret
+#define TOTP_ENTRY_LEN      (2 + TOTP_SECRET_LEN + 4)   // slot, secret, last used step
+
+// Secret frame, the door answers with type | FT_REPLY
+#define FT_TOTP_SECRET      0x2A    // [slot lo, slot hi, TOTP_SECRET_LEN bytes] -> [st]
+
+// Reply status
+#define TOTP_OK             0       // Kept, or kept already with its last used step
+#define TOTP_E_LEN          1       // Not a whole secret
+#define TOTP_E_SLOT         2       // The slot holds no TOTP user
+#define TOTP_E_SECRET       3       // Not the secret the record names
+#define TOTP_E_FULL         4       // The entries hold the secrets of TOTP_USERS users
+
+/* Function prototypes -----------------------------------------------*/
+/**
+ * @brief    HOTP code of a counter (RFC 4226), HMAC-SHA1 with dynamic
+ *           truncation.
+ * @param    key     Secret
+ * @param    keyLen  Secret length, at most 64 bytes
+ * @param    counter Counter, unix time / TOTP_STEP for TOTP
+ * @return   Code, 0 to 10^TOTP_DIGITS - 1
+ */
+uint32_t hotp(const uint8_t *key, uint8_t keyLen, uint32_t counter);
+
+/**
+ * @brief    Fingerprint of a secret, the cred of its user record: the
+ *           first USERS_CRED_LEN bytes of its SHA-1.
+ * @param    secret  TOTP_SECRET_LEN bytes
+ * @param    cred    USERS_CRED_LEN bytes
+ * @return   none
+ */
+void totp_fingerprint(const uint8_t *secret, uint8_t *cred);
+
+/**
+ * @brief    Forgets the cache, as after a reset.
+ * @return   none
+ */
+void totp_init(void);
+
+/**
+ * @brief    Keeps the cache up to date, at most one HOTP per call. Call
+ *           it from the main loop.
+ * @return   none
+ */
+void totp_task(void);
+
+/**
+ * @brief    Looks up a finished entry in the cache, in constant time.
+ *           A hit waits until its step is in the EEPROM, call it from
+ *           the main loop.
+ * @param    cred  pin_finish() of the entry
+ * @return   Slot of the user, -1 when no cached code fits
+ */
+int16_t totp_match(uint64_t cred);
+
+/**
+ * @brief    Tells if every code of the cache is computed.
+ * @return   1 when totp_task() has no work left
+ */
+uint8_t totp_ready(void);
+
+/**
+ * @brief    Answers FT_TOTP_SECRET. Call it from the main loop.
+ * @param    type     Frame type
+ * @param    payload  Request payload
+ * @param    len      Request payload length
+ * @param    reply    Reply payload, FRAME_PAYLOAD_MAX bytes
+ * @return   Reply payload length, FRAME_NO_REPLY for other frames
+ */
+uint8_t totp_frame(uint8_t type, const uint8_t *payload, uint8_t len, uint8_t *reply);
+
+#endif /* TOTP_H_ */
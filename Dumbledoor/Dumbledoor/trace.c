@@ -0,0 +1,208 @@
+/***********************************************************************
+ *
+ * Flight recorder library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/* Includes ----------------------------------------------------------*/
+#include <avr/io.h>         // TCNT1, reset flags
+#include <util/atomic.h>    // ATOMIC_BLOCK
+#include "trace.h"
+#include "bus.h"            // Link mode
+#include "fmt.h"            // Formatted output library for AVR-GCC
+#include "frame.h"          // CRC
+#include "uart.h"           // Room in the low priority lane
+
+/* Definitions -------------------------------------------------------*/
+#define TRACE_MAGIC     0x7CE1
+#define TRACE_MASK      (TRACE_RECORDS - 1)
+#define TRACE_FULL      0x80        // In pos: the ring has wrapped
+#define TRACE_LINE_MAX  18          // "trace tt aa tttt\r\n"
+
+#if (TRACE_RECORDS & TRACE_MASK) || TRACE_RECORDS > 64
+# error TRACE_RECORDS is not a power of 2 up to 64
+#endif
+
+#ifdef __AVR__
+# define TRACE_CLOCK()  TCNT1               // 16 us, wraps with the second tick
+# define TRACE_NOINIT   __attribute__((section(".noinit")))
+#else
+# define TRACE_CLOCK()  (traceClock++)      // Only the order on the host
+# define TRACE_NOINIT
+static uint16_t traceClock = 0;
+#endif
+
+/* Global Variables --------------------------------------------------*/
+typedef struct {
+	uint8_t type;
+	uint8_t arg;
+	uint16_t time;
+} trace_rec_t;
+
+typedef char trace_rec_len_check[(sizeof(trace_rec_t) == TRACE_REC_LEN) ? 1 : -1];
+
+// Left as it was by a reset
+static struct {
+	uint16_t magic;
+	uint8_t records;                    // TRACE_RECORDS
+	uint8_t recLen;                     // TRACE_REC_LEN
+	uint16_t crc;                       // Of the four bytes above
+	uint8_t pos;                        // Next record | TRACE_FULL
+	uint8_t posInv;                     // ~pos
+	trace_rec_t rec[TRACE_RECORDS];
+} traceBuf TRACE_NOINIT;
+
+static volatile uint8_t traceHeld = 0;  // Ring of the run before, not read yet
+static uint8_t traceLine = 0;           // Console lines printed of the held ring
+
+/* Function definitions ----------------------------------------------*/
+static uint16_t trace_header_crc(void)
+{
+	const uint8_t *h = (const uint8_t *)&traceBuf;
+	uint16_t crc = 0xFFFF;
+
+	for (uint8_t i = 0; i < 4; i++)
+		crc = frame_crc16(crc, h[i]);
+	return crc;
+}
+
+/*--------------------------------------------------------------------*/
+static void trace_clear(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		traceBuf.magic = TRACE_MAGIC;
+		traceBuf.records = TRACE_RECORDS;
+		traceBuf.recLen = TRACE_REC_LEN;
+		traceBuf.crc = trace_header_crc();
+		traceBuf.pos = 0;
+		traceBuf.posInv = 0xFF;
+		traceHeld = 0;
+	}
+	traceLine = 0;
+}
+
+/*--------------------------------------------------------------------*/
+// Oldest record and number of records
+static uint8_t trace_span(uint8_t *first)
+{
+	uint8_t pos = traceBuf.pos;
+
+	*first = (pos & TRACE_FULL) ? (pos & TRACE_MASK) : 0;
+	return (pos & TRACE_FULL) ? TRACE_RECORDS : pos;
+}
+
+/*--------------------------------------------------------------------*/
+void trace_init(uint8_t mcusr)
+{
+	uint8_t valid = traceBuf.magic == TRACE_MAGIC &&
+	                traceBuf.records == TRACE_RECORDS &&
+	                traceBuf.recLen == TRACE_REC_LEN &&
+	                traceBuf.crc == trace_header_crc() &&
+	                (traceBuf.pos ^ traceBuf.posInv) == 0xFF &&
+	                (traceBuf.pos & ~(TRACE_FULL | TRACE_MASK)) == 0;
+
+#if defined(WDRF) && defined(BORF)
+	if (valid && (mcusr & ((1 << WDRF) | (1 << BORF))))
+	{
+		traceHeld = 1;
+		return;
+	}
+#else
+	(void)valid;
+#endif
+	trace_clear();
+	trace(TR_BOOT, mcusr);
+}
+
+/*--------------------------------------------------------------------*/
+void trace_rec(uint8_t type, uint8_t arg)
+{
+	if (traceHeld)
+		return;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		uint8_t pos = traceBuf.pos;
+		trace_rec_t *r = &traceBuf.rec[pos & TRACE_MASK];
+
+		r->type = type;
+		r->arg = arg;
+		r->time = TRACE_CLOCK();
+		pos++;
+		if ((pos & ~TRACE_FULL) == TRACE_RECORDS)
+			pos = TRACE_FULL;
+		traceBuf.pos = pos;
+		traceBuf.posInv = ~pos;
+	}
+}
+
+/*--------------------------------------------------------------------*/
+void trace_task(void)
+{
+	uint8_t first;
+	uint8_t n;
+
+	if (!traceHeld || bus_mode() != BUS_MODE_CONSOLE)
+		return;
+
+	// Held, nothing changes it while it is printed. The lines go to the
+	// low priority lane as far as there is room and the rest waits for
+	// the next call, a whole ring would take 1.3 s at 9600 baud.
+	n = trace_span(&first);
+	while (uart_tx_free(UART_LOW) >= TRACE_LINE_MAX)
+	{
+		if (traceLine == 0)
+		{
+			fmt_uart_low_P("trace %u\r\n", n);
+		}
+		else if (traceLine <= n)
+		{
+			const trace_rec_t *r = &traceBuf.rec[(first + traceLine - 1) & TRACE_MASK];
+			fmt_uart_low_P("trace %02x %02x %04x\r\n", r->type, r->arg, r->time);
+		}
+		else
+		{
+			fmt_uart_low_P("trace end\r\n");
+			trace_clear();
+			return;
+		}
+		traceLine++;
+	}
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t trace_frame(uint8_t type, const uint8_t *payload, uint8_t len, uint8_t *reply)
+{
+	uint8_t first;
+	uint8_t n;
+	uint8_t out = 0;
+
+	if (type == FT_TRACE_CLEAR)
+	{
+		trace_clear();
+		return 0;
+	}
+	if (type != FT_TRACE_READ)
+		return FRAME_NO_REPLY;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		n = trace_span(&first);
+		reply[0] = traceHeld;
+		for (uint8_t i = (len >= 1) ? payload[0] : 0; i < n && out < TRACE_PER_FRAME; i++, out++)
+		{
+			const trace_rec_t *r = &traceBuf.rec[(first + i) & TRACE_MASK];
+			reply[2 + out * TRACE_REC_LEN] = r->type;
+			reply[3 + out * TRACE_REC_LEN] = r->arg;
+			reply[4 + out * TRACE_REC_LEN] = r->time & 0xFF;
+			reply[5 + out * TRACE_REC_LEN] = r->time >> 8;
+		}
+		reply[1] = out;
+	}
+	return 2 + out * TRACE_REC_LEN;
+}
@@ -0,0 +1,125 @@
+#ifndef TRACE_H_
+#define TRACE_H_
+
+/***********************************************************************
+ *
+ * Flight recorder library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/**
+ * @file  trace.h
+ * @defgroup dumbledoor_trace Flight Recorder Library <trace.h>
+ * @code #include <trace.h> @endcode
+ *
+ * @brief Ring of the last things the door did, kept over a reset.
+ *
+ * @details
+ * trace() writes a 4 byte record: type, argument and the Timer/Counter1
+ * count, 16 us per count. Timer/Counter1 wraps after HAL_SECOND_STEPS
+ * counts with the second tick, which is recorded as TR_ISR_SECOND, so a decoder can put the
+ * records on one time line. Types left out of TRACE_TYPES cost nothing,
+ * by default the ticks every 4 and 16 ms are left out, they would fill
+ * the ring in a quarter of a second.
+ *
+ * The ring is in .noinit, which the C runtime does not clear. Its
+ * header has a magic value and a CRC of the layout, the write position
+ * is stored with its complement. After a watchdog or brown-out reset a
+ * valid ring is held: nothing is recorded until it has been read. In
+ * console mode trace_task() prints it as "trace" lines, on the bus the
+ * master reads it with FT_TRACE_READ and frees it with FT_TRACE_CLEAR.
+ * Host/trace/doortrace turns either into a time line.
+ *
+ * @author
+ * Demirkan Korbey Baglamac and Rasit Demiroren
+ *
+ * @copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * Programmed for the Digital Electronics 2 project.
+ * This work is licensed under the terms of the MIT license.
+ */
+
+/* Includes ----------------------------------------------------------*/
+#include <stdint.h>         // Fixed width integer types
+
+/* Definitions -------------------------------------------------------*/
+#define TRACE_RECORDS       64      // Ring size, power of 2, at most 64
+#define TRACE_REC_LEN       4
+
+// Record types, the argument is given in brackets
+#define TR_BOOT             0x0     // Reset [MCUSR]
+#define TR_ISR_KEYPAD       0x1     // TIMER0_OVF [0]
+#define TR_ISR_SECOND       0x2     // TIMER1_COMPA [event clock, low byte]
+#define TR_ISR_SOUND        0x3     // TIMER2_OVF [0]
+#define TR_KEY              0x8     // Key pressed [key]
+#define TR_STATE            0x9     // Door state [scanning stage << 4 | timer stage]
+#define TR_CORRECT          0xA     // Correct pin [correct attempts]
+#define TR_WRONG            0xB     // Wrong pin [wrong attempts]
+#define TR_UART_ERROR       0xC     // Damaged byte [uart_getc() error bits >> 8]
+#define TR_EV_LOST          0xD     // Event queue full [event type]
+
+// Bit (1 << type) enables a type
+#ifndef TRACE_TYPES
+#define TRACE_TYPES         (0xFFFF & ~((1U << TR_ISR_KEYPAD) | (1U << TR_ISR_SOUND)))
+#endif
+
+// Trace frames, the door answers with type | FT_REPLY
+#define FT_TRACE_READ       0x21    // [first] -> [held, n, (type, arg, time lo, time hi) * n],
+                                    //            first 0 is the oldest record
+#define FT_TRACE_CLEAR      0x22    // [] -> [], frees a held ring
+#define TRACE_PER_FRAME     11
+
+/* Function prototypes -----------------------------------------------*/
+/**
+ * @brief    Checks the ring left by the run before. Holds it after a
+ *           watchdog or brown-out reset, otherwise starts a new one.
+ *           Call it after bus_init().
+ * @param    mcusr  MCUSR at reset
+ * @return   none
+ */
+void trace_init(uint8_t mcusr);
+
+/**
+ * @brief    Prints a held ring in console mode, as many lines as the
+ *           low priority UART lane has room for, and frees it after
+ *           the last one. Call it from the main loop, with interrupts
+ *           enabled.
+ * @return   none
+ */
+void trace_task(void);
+
+/**
+ * @brief    Writes a record, use trace() instead. Safe to call from
+ *           interrupt handlers.
+ * @param    type  TR_...
+ * @param    arg   Argument
+ * @return   none
+ */
+void trace_rec(uint8_t type, uint8_t arg);
+
+/**
+ * @brief    Handles a trace frame. Called by the bus library.
+ * @param    type     Frame type FT_TRACE_...
+ * @param    payload  Request payload
+ * @param    len      Request payload length
+ * @param    reply    FRAME_PAYLOAD_MAX bytes for the reply payload
+ * @return   Reply payload length, FRAME_NO_REPLY for other frames
+ */
+uint8_t trace_frame(uint8_t type, const uint8_t *payload, uint8_t len, uint8_t *reply);
+
+/**
+ * @brief    Records an event when its type is in TRACE_TYPES.
+ * @param    type  TR_...
+ * @param    arg   Argument
+ * @return   none
+ */
+static inline void trace(uint8_t type, uint8_t arg)
+{
+	if (TRACE_TYPES & (1U << type))
+		trace_rec(type, arg);
+}
+
+#endif /* TRACE_H_ */
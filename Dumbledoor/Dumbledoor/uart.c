@@ -39,7 +39,10 @@
 #include <avr/io.h>
 #include <avr/interrupt.h>
 #include <avr/pgmspace.h>
+#include <util/atomic.h> /* DUMBLEDOOR: ISRs and the main loop share the lanes */
 #include "uart.h"
+#include "stack.h"   /* DUMBLEDOOR: interrupt nesting record */
+#include "cpuclk.h"  /* DUMBLEDOOR: traffic keeps the clock at full speed */
 
 
 /*
@@ -57,6 +60,16 @@
 # error TX buffer size is not a power of 2
 #endif
 
+/* DUMBLEDOOR: low priority transmit lane */
+#define UART_TX_LOW_BUFFER_MASK ( UART_TX_LOW_BUFFER_SIZE - 1)
+
+#if ( UART_TX_LOW_BUFFER_SIZE & UART_TX_LOW_BUFFER_MASK )
+# error TX low buffer size is not a power of 2
+#endif
+#if ( UART_TX_BUFFER_SIZE > 256 ) || ( UART_TX_LOW_BUFFER_SIZE > 256 )
+# error TX buffer sizes above 256 do not fit the fill counters
+#endif
+
 
 #if defined(__AVR_AT90S2313__) || defined(__AVR_AT90S4414__) || defined(__AVR_AT90S8515__) || \
     defined(__AVR_AT90S4434__) || defined(__AVR_AT90S8535__) || \
@@ -218,6 +231,7 @@
 /* ATmega with one USART */
 # define UART0_RECEIVE_INTERRUPT  USART_RX_vect
 # define UART0_TRANSMIT_INTERRUPT USART_UDRE_vect
+# define UART0_TXC_INTERRUPT      USART_TX_vect
 # define UART0_STATUS             UCSR0A
 # define UART0_CONTROL            UCSR0B
 # define UART0_CONTROLC           UCSR0C
@@ -229,6 +243,8 @@
 # define UART0_BIT_RXCIE          RXCIE0
 # define UART0_BIT_RXEN           RXEN0
 # define UART0_BIT_TXEN           TXEN0
+# define UART0_BIT_TXC            TXC0
+# define UART0_BIT_TXCIE          TXCIE0
 # define UART0_BIT_UCSZ0          UCSZ00
 # define UART0_BIT_UCSZ1          UCSZ01
 #elif defined(__AVR_ATtiny2313__) || defined(__AVR_ATtiny2313A__) || defined(__AVR_ATtiny4313__)
@@ -334,6 +350,14 @@
 # error "no UART definition for MCU available"
 #endif /* if defined(__AVR_AT90S2313__) || defined(__AVR_AT90S4414__) || defined(__AVR_AT90S8515__) || defined(__AVR_AT90S4434__) || defined(__AVR_AT90S8535__) || defined(__AVR_ATmega103__) */
 
+/* DUMBLEDOOR: RS-485 driver enable, needs the transmit complete interrupt */
+#if defined(UART_DE_PORT) && defined(UART0_TXC_INTERRUPT)
+# define UART_DE
+# define UART_DE_DDR    (*(&UART_DE_PORT - 1))
+# define uart_de_high() UART_DE_PORT |= _BV(UART_DE_PIN)
+# define uart_de_low()  UART_DE_PORT &= ~_BV(UART_DE_PIN)
+#endif
+
 
 /*
  *  module global variables
@@ -346,6 +370,14 @@ static volatile unsigned char UART_RxHead;
 static volatile unsigned char UART_RxTail;
 static volatile unsigned char UART_LastRxError;
 
+/* DUMBLEDOOR: low priority lane and the counters of both lanes */
+static volatile unsigned char UART_TxLowBuf[UART_TX_LOW_BUFFER_SIZE];
+static volatile unsigned char UART_TxLowHead;
+static volatile unsigned char UART_TxLowTail;
+static unsigned int  UART_TxDropped[2];
+static unsigned char UART_TxPeak[2];
+static volatile unsigned char UART_TxActive;    /* TXC not yet seen since the last start */
+
 #if defined( ATMEGA_USART1 )
 static volatile unsigned char UART1_TxBuf[UART_TX_BUFFER_SIZE];
 static volatile unsigned char UART1_RxBuf[UART_RX_BUFFER_SIZE];
@@ -370,6 +402,8 @@ ISR(UART0_RECEIVE_INTERRUPT)
     unsigned char lastRxError = 0;
 
 
+    stack_isr_enter(STACK_ISR_UART_RX);     /* DUMBLEDOOR */
+
     /* read UART status register and UART data register */
     usr  = UART0_STATUS;
     data = UART0_DATA;
@@ -401,6 +435,10 @@ ISR(UART0_RECEIVE_INTERRUPT)
         UART_RxBuf[tmphead] = data;
     }
     UART_LastRxError |= lastRxError;
+
+    /* DUMBLEDOOR: the receiver waits in the stop bit, the clock may change */
+    cpuclk_rx();
+    stack_isr_leave();                      /* DUMBLEDOOR */
 }
 
 
@@ -414,6 +452,7 @@ ISR(UART0_TRANSMIT_INTERRUPT)
     unsigned char tmptail;
 
 
+    stack_isr_enter(STACK_ISR_UART_UDRE);   /* DUMBLEDOOR */
     if (UART_TxHead != UART_TxTail)
     {
         /* calculate and store new buffer index */
@@ -422,14 +461,47 @@ ISR(UART0_TRANSMIT_INTERRUPT)
         /* get one byte from buffer and write it to UART */
         UART0_DATA = UART_TxBuf[tmptail]; /* start transmission */
     }
+    else if (UART_TxLowHead != UART_TxLowTail)
+    {
+        /* DUMBLEDOOR: low priority lane only when the high one is empty */
+        tmptail        = (UART_TxLowTail + 1) & UART_TX_LOW_BUFFER_MASK;
+        UART_TxLowTail = tmptail;
+        UART0_DATA     = UART_TxLowBuf[tmptail];
+    }
     else
     {
-        /* tx buffer empty, disable UDRE interrupt */
+        /* tx buffers empty, disable UDRE interrupt */
         UART0_CONTROL &= ~_BV(UART0_UDRIE);
+        #ifdef UART_DE
+        /* release the bus after the last stop bit */
+        UART0_CONTROL |= _BV(UART0_BIT_TXCIE);
+        #endif
     }
+    stack_isr_leave();                      /* DUMBLEDOOR */
 }
 
 
+#ifdef UART_DE
+ISR(UART0_TXC_INTERRUPT)
+
+/*************************************************************************
+ * Function: UART Transmit Complete interrupt
+ * Purpose:  called when the last byte has left the UART, releases the bus
+ **************************************************************************/
+{
+    stack_isr_enter(STACK_ISR_UART_TXC);    /* DUMBLEDOOR */
+    UART0_CONTROL &= ~_BV(UART0_BIT_TXCIE);
+    if (UART_TxHead == UART_TxTail && UART_TxLowHead == UART_TxLowTail)
+    {
+        uart_de_low();
+        /* running the handler cleared TXC, the transmitter is idle */
+        UART_TxActive = 0;
+    }
+    stack_isr_leave();                      /* DUMBLEDOOR */
+}
+#endif
+
+
 /*************************************************************************
  * Function: uart_init()
  * Purpose:  initialize UART and set baudrate
@@ -442,6 +514,14 @@ void uart_init(unsigned int baudrate)
     UART_TxTail = 0;
     UART_RxHead = 0;
     UART_RxTail = 0;
+    UART_TxLowHead = 0;     /* DUMBLEDOOR */
+    UART_TxLowTail = 0;
+
+    #ifdef UART_DE
+    /* transceiver listens until there is something to send */
+    uart_de_low();
+    UART_DE_DDR |= _BV(UART_DE_PIN);
+    #endif
 
     #ifdef UART_TEST
     # ifndef UART0_BIT_U2X
@@ -517,6 +597,37 @@ unsigned int uart_getc(void)
     return (lastRxError << 8) + data;
 }/* uart_getc */
 
+/*************************************************************************
+ * Function: uart_tx_start()
+ * Purpose:  DUMBLEDOOR: a byte was queued, make the UART send it
+ **************************************************************************/
+static inline void uart_tx_start(void)
+{
+    #ifdef UART_DE
+    /* drive the bus */
+    uart_de_high();
+    #endif
+    /* a stale transmit complete flag must not release the bus or let the
+       clock change while the byte shifts out */
+    UART0_STATUS |= _BV(UART0_BIT_TXC);
+    UART_TxActive = 1;
+
+    /* enable UDRE interrupt */
+    UART0_CONTROL |= _BV(UART0_UDRIE);
+}/* uart_tx_start */
+
+/*************************************************************************
+ * Function: uart_tx_drop()
+ * Purpose:  DUMBLEDOOR: count a byte that did not fit into a lane
+ **************************************************************************/
+static inline void uart_tx_drop(unsigned char lane)
+{
+    if (UART_TxDropped[lane] != 0xFFFF)
+    {
+        UART_TxDropped[lane]++;
+    }
+}/* uart_tx_drop */
+
 /*************************************************************************
  * Function: uart_putc()
  * Purpose:  write byte to ringbuffer for transmitting via UART
@@ -526,21 +637,135 @@ unsigned int uart_getc(void)
 void uart_putc(unsigned char data)
 {
     unsigned char tmphead;
+    unsigned char used;
+
+
+    /* DUMBLEDOOR: the keypad interrupt puts door events, never wait */
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        /* a byte to send is activity, full speed before it starts */
+        cpuclk_full();
+        tmphead = (UART_TxHead + 1) & UART_TX_BUFFER_MASK;
+
+        if (tmphead == UART_TxTail)
+        {
+            uart_tx_drop(UART_HIGH);
+        }
+        else
+        {
+            UART_TxBuf[tmphead] = data;
+            UART_TxHead         = tmphead;
+
+            used = (tmphead - UART_TxTail) & UART_TX_BUFFER_MASK;
+            if (used > UART_TxPeak[UART_HIGH])
+            {
+                UART_TxPeak[UART_HIGH] = used;
+            }
+            uart_tx_start();
+        }
+    }
+}/* uart_putc */
+
+/*************************************************************************
+ * Function: uart_putc_low()
+ * Purpose:  DUMBLEDOOR: write byte to the low priority ringbuffer
+ * Input:    byte to be transmitted
+ * Returns:  none
+ **************************************************************************/
+void uart_putc_low(unsigned char data)
+{
+    unsigned char tmphead;
+    unsigned char used;
 
 
-    tmphead = (UART_TxHead + 1) & UART_TX_BUFFER_MASK;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        cpuclk_full();
+        tmphead = (UART_TxLowHead + 1) & UART_TX_LOW_BUFFER_MASK;
+
+        if (tmphead == UART_TxLowTail)
+        {
+            uart_tx_drop(UART_LOW);
+        }
+        else
+        {
+            UART_TxLowBuf[tmphead] = data;
+            UART_TxLowHead         = tmphead;
+
+            used = (tmphead - UART_TxLowTail) & UART_TX_LOW_BUFFER_MASK;
+            if (used > UART_TxPeak[UART_LOW])
+            {
+                UART_TxPeak[UART_LOW] = used;
+            }
+            uart_tx_start();
+        }
+    }
+}/* uart_putc_low */
+
+/*************************************************************************
+ * Function: uart_tx_free()
+ * Purpose:  DUMBLEDOOR: room left in a transmit ringbuffer
+ * Input:    UART_HIGH or UART_LOW
+ * Returns:  number of bytes the lane takes without dropping
+ **************************************************************************/
+unsigned int uart_tx_free(unsigned char lane)
+{
+    unsigned char head;
+    unsigned char tail;
 
-    while (tmphead == UART_TxTail)
+    if (lane == UART_LOW)
     {
-        ;/* wait for free space in buffer */
+        head = UART_TxLowHead;
+        tail = UART_TxLowTail;
+        return (unsigned char)(tail - head - 1) & UART_TX_LOW_BUFFER_MASK;
     }
+    head = UART_TxHead;
+    tail = UART_TxTail;
+    return (unsigned char)(tail - head - 1) & UART_TX_BUFFER_MASK;
+}/* uart_tx_free */
 
-    UART_TxBuf[tmphead] = data;
-    UART_TxHead         = tmphead;
+/*************************************************************************
+ * Function: uart_tx_idle()
+ * Purpose:  DUMBLEDOOR: both lanes are empty and the last stop bit is out
+ * Returns:  1 when idle
+ **************************************************************************/
+unsigned char uart_tx_idle(void)
+{
+    unsigned char idle = 0;
 
-    /* enable UDRE interrupt */
-    UART0_CONTROL |= _BV(UART0_UDRIE);
-}/* uart_putc */
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        if (UART_TxHead == UART_TxTail && UART_TxLowHead == UART_TxLowTail &&
+            (!UART_TxActive || (UART0_STATUS & _BV(UART0_BIT_TXC))))
+        {
+            UART_TxActive = 0;
+            idle = 1;
+        }
+    }
+    return idle;
+}/* uart_tx_idle */
+
+/*************************************************************************
+ * Function: uart_tx_stats()
+ * Purpose:  DUMBLEDOOR: dropped bytes and highest fill of a lane
+ * Input:    UART_HIGH or UART_LOW, nonzero clear to start counting again
+ * Returns:  none
+ **************************************************************************/
+void uart_tx_stats(unsigned char lane, unsigned int *dropped, unsigned char *peak,
+                   unsigned char clear)
+{
+    lane = (lane == UART_LOW) ? UART_LOW : UART_HIGH;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        *dropped = UART_TxDropped[lane];
+        *peak    = UART_TxPeak[lane];
+        if (clear)
+        {
+            UART_TxDropped[lane] = 0;
+            UART_TxPeak[lane]    = 0;
+        }
+    }
+}/* uart_tx_stats */
 
 /*************************************************************************
  * Function: uart_puts()
@@ -568,6 +793,21 @@ void uart_puts_p(const char *progmem_s)
         uart_putc(c);
 }/* uart_puts_p */
 
+/*************************************************************************
+ * Function: uart_puts_low_p()
+ * Purpose:  DUMBLEDOOR: transmit string from program memory on the low
+ *           priority lane
+ * Input:    program memory string to be transmitted
+ * Returns:  none
+ **************************************************************************/
+void uart_puts_low_p(const char *progmem_s)
+{
+    register char c;
+
+    while ( (c = pgm_read_byte(progmem_s++)) )
+        uart_putc_low(c);
+}/* uart_puts_low_p */
+
 /*
  * these functions are only for ATmegas with two USART
  */
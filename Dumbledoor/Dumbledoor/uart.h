@@ -93,9 +93,37 @@
 # define UART_TX_BUFFER_SIZE 128
 #endif
 
+/** @brief  Size of the circular low priority transmit buffer, must be power of 2
+ *
+ *  DUMBLEDOOR: uart_putc() fills the high priority lane, which carries the door
+ *  events and the bus frames, uart_putc_low() the low priority lane with status
+ *  and debug text. The transmit interrupt only takes a low priority byte when
+ *  the high priority lane is empty. Neither function waits: a byte that does not
+ *  fit is dropped and counted, see uart_tx_stats().
+ */
+#ifndef UART_TX_LOW_BUFFER_SIZE
+# define UART_TX_LOW_BUFFER_SIZE 128
+#endif
+
+/** @brief  DUMBLEDOOR: transmit lanes of uart_tx_free() and uart_tx_stats() */
+#define UART_HIGH 0
+#define UART_LOW  1
+
+/** @brief  RS-485 transceiver driver enable pin
+ *
+ *  DUMBLEDOOR: The pin is driven high from the first byte put into the transmit
+ *  buffer until the last stop bit has left the UART, otherwise it is low and the
+ *  transceiver listens. Add CDEFS += -DUART_NO_DE to your Makefile for a plain
+ *  point to point UART.
+ */
+#if !defined(UART_DE_PORT) && !defined(UART_NO_DE)
+# define UART_DE_PORT PORTD
+# define UART_DE_PIN  PD2
+#endif
+
 /* test if the size of the circular buffers fits into SRAM */
-#if ( (UART_RX_BUFFER_SIZE + UART_TX_BUFFER_SIZE) >= (RAMEND - 0x60 ) )
-# error "size of UART_RX_BUFFER_SIZE + UART_TX_BUFFER_SIZE larger than size of SRAM"
+#if ( (UART_RX_BUFFER_SIZE + UART_TX_BUFFER_SIZE + UART_TX_LOW_BUFFER_SIZE) >= (RAMEND - 0x60 ) )
+# error "size of UART_RX_BUFFER_SIZE + UART_TX_BUFFER_SIZE + UART_TX_LOW_BUFFER_SIZE larger than size of SRAM"
 #endif
 
 /*
@@ -149,18 +177,62 @@ extern unsigned int uart_getc(void);
 
 /**
  *  @brief   Put byte to ringbuffer for transmitting via UART
+ *
+ *  DUMBLEDOOR: High priority lane. Never waits, the byte is dropped and counted
+ *  when the ringbuffer is full.
+ *
  *  @param   data byte to be transmitted
  *  @return  none
  */
 extern void uart_putc(unsigned char data);
 
 
+/**
+ *  @brief   DUMBLEDOOR: Put byte to the low priority ringbuffer
+ *
+ *  Sent when the high priority lane is empty. Never waits, the byte is dropped
+ *  and counted when the ringbuffer is full.
+ *
+ *  @param   data byte to be transmitted
+ *  @return  none
+ */
+extern void uart_putc_low(unsigned char data);
+
+
+/**
+ *  @brief   DUMBLEDOOR: Room left in a transmit ringbuffer
+ *  @param   lane UART_HIGH or UART_LOW
+ *  @return  Number of bytes the lane takes without dropping
+ */
+extern unsigned int uart_tx_free(unsigned char lane);
+
+
+/**
+ *  @brief   DUMBLEDOOR: Nothing left to send
+ *  @return  1 when both ringbuffers are empty and the last stop bit has
+ *           left the UART (TXC), the baud rate may change then
+ */
+extern unsigned char uart_tx_idle(void);
+
+
+/**
+ *  @brief   DUMBLEDOOR: Dropped bytes and highest fill of a transmit ringbuffer
+ *  @param   lane    UART_HIGH or UART_LOW
+ *  @param   dropped Bytes dropped because the lane was full, stops at 65535
+ *  @param   peak    Most bytes waiting in the lane at once
+ *  @param   clear   Nonzero: start counting again
+ *  @return  none
+ */
+extern void uart_tx_stats(unsigned char lane, unsigned int *dropped, unsigned char *peak,
+                          unsigned char clear);
+
+
 /**
  *  @brief   Put string to ringbuffer for transmitting via UART
  *
  *  The string is buffered by the uart library in a circular buffer
  *  and one character at a time is transmitted to the UART using interrupts.
- *  Blocks if it can not write the whole string into the circular buffer.
+ *  DUMBLEDOOR: Drops what does not fit into the circular buffer.
  *
  *  @param   s string to be transmitted
  *  @return  none
@@ -173,7 +245,7 @@ extern void uart_puts(const char *s);
  *
  * The string is buffered by the uart library in a circular buffer
  * and one character at a time is transmitted to the UART using interrupts.
- * Blocks if it can not write the whole string into the circular buffer.
+ * DUMBLEDOOR: Drops what does not fit into the circular buffer.
  *
  * @param    s program memory string to be transmitted
  * @return   none
@@ -186,6 +258,20 @@ extern void uart_puts_p(const char *s);
  */
 #define uart_puts_P(__s) uart_puts_p(PSTR(__s))
 
+/**
+ * @brief    DUMBLEDOOR: Put string from program memory to the low priority ringbuffer
+ * @param    s program memory string to be transmitted
+ * @return   none
+ * @see      uart_putc_low
+ */
+extern void uart_puts_low_p(const char *s);
+
+/**
+ * @brief    DUMBLEDOOR: Macro to put a string constant into program memory and
+ *           into the low priority ringbuffer
+ */
+#define uart_puts_low_P(__s) uart_puts_low_p(PSTR(__s))
+
 
 /** @brief  Initialize USART1 (only available on selected ATmegas) @see uart_init */
 extern void uart1_init(unsigned int baudrate);
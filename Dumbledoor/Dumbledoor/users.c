@@ -0,0 +1,610 @@
+/***********************************************************************
+ *
+ * User table library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/* Includes ----------------------------------------------------------*/
+#include <stddef.h>         // offsetof
+#include <string.h>         // memcmp, memcpy
+#include <avr/pgmspace.h>   // Bench board users
+#include <util/atomic.h>    // ATOMIC_BLOCK
+#include "users.h"
+#include "eeq.h"            // EEPROM access
+#include "eemap.h"          // EEPROM layout
+#include "pin.h"            // Credentials
+
+/* Definitions -------------------------------------------------------*/
+#define USERS_MAGIC     0xD6    // 0xD5: PINs in plaintext
+
+// Bank header, the magic byte is written last
+#define HDR_MAGIC       0
+#define HDR_GEN         1
+#define HDR_VERSION     2
+#define HDR_ROOT        4
+#define HDR_CRC         6
+
+#define USERS_HASHES_PER_FRAME  ((FRAME_PAYLOAD_MAX - 2) / 2)
+
+// Index by PIN digest, at most half full so a lookup is one probe
+// nearly always
+#define USERS_INDEX     (USERS_MAX <= 8 ? 16 : USERS_MAX <= 64 ? 128 : \
+                         USERS_MAX <= 512 ? 1024 : 8192)
+
+typedef char users_index_check[(2 * USERS_MAX <= USERS_INDEX) ? 1 : -1];
+
+// Bloom filter of the credentials, 16 bits per slot and USERS_PROBES
+// bits per credential: 0.24 % of the wrong entries get past a full table
+#define USERS_BLOOM     (USERS_MAX <= 8 ? 128 : USERS_MAX <= 64 ? 1024 : \
+                         USERS_MAX <= 512 ? 8192 : 65536UL)
+#define USERS_PROBES    4
+
+typedef char users_bloom_check[(16UL * USERS_MAX <= USERS_BLOOM) ? 1 : -1];
+
+#if USERS_MAX < 0xFF
+typedef uint8_t users_ix_t;     // Slot + 1, 0: free
+#else
+typedef uint16_t users_ix_t;
+#endif
+
+/* Global Variables --------------------------------------------------*/
+#ifdef USERS_DEMO
+// Users of the first firmware, written on a bench board when the
+// EEPROM has no table. Their pins are public, never build a door with it
+static const struct {
+	char pin[PIN_MIN + 1];
+	char name[USERS_NAME_LEN];
+} usersDefault[] PROGMEM = {
+	{"3467", "Mr Harrman"},         // ID = 0
+	{"4324", "Mrs Leyla"},          // ID = 1
+	{"1962", "Mr Baglamac"},        // ID = 2
+	{"7034", "Mr Demiroren"}        // ID = 3
+};
+#endif
+
+// Active table
+static volatile uint8_t usersBank = 0;
+static uint8_t usersGen = 0;
+static uint16_t usersVer = 0;
+static uint16_t usersRoot = 0;
+static uint16_t usersBucket[USERS_BUCKETS];
+
+// Sync in progress, it writes the other bank
+static uint8_t usersSync = 0;
+static uint16_t usersSyncRoot = 0;
+static uint16_t usersSyncBucket[USERS_BUCKETS];
+
+// Slots which differ between the banks, all of them after a reset
+static uint8_t usersDirty[(USERS_MAX + 7) / 8];
+static uint16_t usersDirtyCount = 0;
+static uint16_t usersCopyNext = 0;     // users_task() position
+
+// Credentials of the active bank, the full ones are only in EEPROM
+static volatile uint8_t usersBloom[USERS_BLOOM / 8];
+static volatile users_ix_t usersIndex[USERS_INDEX];
+
+/* Function definitions ----------------------------------------------*/
+static uint16_t bank_addr(uint8_t bank)
+{
+	return EE_USERS + (bank ? USERS_BANK_LEN : 0);
+}
+
+/*--------------------------------------------------------------------*/
+static uint16_t record_addr(uint8_t bank, uint16_t slot)
+{
+	return bank_addr(bank) + USERS_HEADER_LEN + slot * USERS_RECORD_LEN;
+}
+
+/*--------------------------------------------------------------------*/
+static uint16_t header_crc(const uint8_t *hdr)
+{
+	uint16_t crc = 0xFFFF;
+
+	for (uint8_t i = 0; i < HDR_CRC; i++)
+		crc = frame_crc16(crc, hdr[i]);
+	return crc;
+}
+
+/*--------------------------------------------------------------------*/
+// Checks a bank and computes its bucket hashes, returns 1 when valid
+static uint8_t bank_load(uint8_t bank, uint8_t *hdr, uint16_t *buckets)
+{
+	uint8_t rec[USERS_RECORD_LEN];
+	uint16_t root = 0;
+
+	eeq_read(hdr, bank_addr(bank), USERS_HEADER_LEN);
+	if (hdr[HDR_MAGIC] != USERS_MAGIC ||
+		header_crc(hdr) != (hdr[HDR_CRC] | (hdr[HDR_CRC + 1] << 8)))
+		return 0;
+
+	memset(buckets, 0, USERS_BUCKETS * sizeof(uint16_t));
+	for (uint16_t slot = 0; slot < USERS_MAX; slot++)
+	{
+		eeq_read(rec, record_addr(bank, slot), USERS_RECORD_LEN);
+		uint16_t h = users_record_hash(slot, rec);
+		buckets[slot / USERS_BUCKET] ^= h;
+		root ^= h;
+	}
+	return root == (hdr[HDR_ROOT] | (hdr[HDR_ROOT + 1] << 8));
+}
+
+/*--------------------------------------------------------------------*/
+// Makes a bank valid, the magic byte goes last so a torn write is seen
+static void bank_commit(uint8_t bank, uint8_t gen, uint16_t version, uint16_t root)
+{
+	uint8_t hdr[USERS_HEADER_LEN];
+	uint16_t crc;
+
+	hdr[HDR_MAGIC] = USERS_MAGIC;
+	hdr[HDR_GEN] = gen;
+	hdr[HDR_VERSION] = version & 0xFF;
+	hdr[HDR_VERSION + 1] = version >> 8;
+	hdr[HDR_ROOT] = root & 0xFF;
+	hdr[HDR_ROOT + 1] = root >> 8;
+	crc = header_crc(hdr);
+	hdr[HDR_CRC] = crc & 0xFF;
+	hdr[HDR_CRC + 1] = crc >> 8;
+
+	eeq_write(bank_addr(bank) + 1, hdr + 1, USERS_HEADER_LEN - 1);
+	eeq_write(bank_addr(bank), hdr, 1);
+}
+
+/*--------------------------------------------------------------------*/
+static void bank_invalidate(uint8_t bank)
+{
+	uint8_t zero = 0;
+
+	eeq_write(bank_addr(bank), &zero, 1);
+}
+
+/*--------------------------------------------------------------------*/
+static void dirty_set(uint16_t slot)
+{
+	if (!(usersDirty[slot / 8] & (1 << (slot % 8))))
+	{
+		usersDirty[slot / 8] |= 1 << (slot % 8);
+		usersDirtyCount++;
+	}
+}
+
+/*--------------------------------------------------------------------*/
+static void dirty_all(void)
+{
+	for (uint16_t slot = 0; slot < USERS_MAX; slot++)
+		usersDirty[slot / 8] |= 1 << (slot % 8);
+	usersDirtyCount = USERS_MAX;
+	usersCopyNext = 0;
+}
+
+/*--------------------------------------------------------------------*/
+// Filter bits of a credential, from the upper half of the hash: the
+// lower one places it in the index
+static void bloom_bits(uint64_t cred, uint16_t *bits)
+{
+	uint16_t h[2];
+
+	// The AVR and the host tools are both little endian
+	memcpy(h, (const uint8_t *)&cred + 4, sizeof(h));
+	h[1] |= 1;
+	for (uint8_t i = 0; i < USERS_PROBES; i++)
+	{
+		bits[i] = h[0] & (uint16_t)(USERS_BLOOM - 1);
+		h[0] += h[1];
+	}
+}
+
+/*--------------------------------------------------------------------*/
+static void index_clear(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		for (uint16_t i = 0; i < USERS_INDEX; i++)
+			usersIndex[i] = 0;
+		for (uint16_t i = 0; i < USERS_BLOOM / 8; i++)
+			usersBloom[i] = 0;
+	}
+}
+
+/*--------------------------------------------------------------------*/
+// Indexes the credentials of the active bank. A slot is only entered
+// after its filter bits, so a lookup in between finds the user of the
+// new bank or, until the slot is entered, nobody.
+static void index_build(void)
+{
+	uint8_t rec[1 + USERS_CRED_LEN];
+	uint16_t bits[USERS_PROBES];
+	uint64_t cred;
+	uint16_t i;
+
+	index_clear();
+	for (uint16_t slot = 0; slot < USERS_MAX; slot++)
+	{
+		eeq_read(rec, record_addr(usersBank, slot), sizeof(rec));
+		if ((rec[0] & (USER_F_ACTIVE | USER_F_TOTP)) != USER_F_ACTIVE)
+			continue;
+		memcpy(&cred, rec + 1, sizeof(cred));
+		bloom_bits(cred, bits);
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			for (uint8_t b = 0; b < USERS_PROBES; b++)
+				usersBloom[bits[b] / 8] |= 1 << (bits[b] % 8);
+		}
+
+		i = (uint32_t)cred % USERS_INDEX;
+		while (usersIndex[i])
+			i = (i + 1) % USERS_INDEX;
+		usersIndex[i] = slot + 1;
+	}
+}
+
+/*--------------------------------------------------------------------*/
+// An empty table, the door stays locked until the first sync
+static void users_defaults(void)
+{
+	user_t u;
+	uint16_t h;
+
+	bank_invalidate(0);
+	usersRoot = 0;
+	memset(usersBucket, 0, sizeof(usersBucket));
+	for (uint16_t slot = 0; slot < USERS_MAX; slot++)
+	{
+		memset(&u, 0, sizeof(u));
+#ifdef USERS_DEMO
+		if (slot < sizeof(usersDefault) / sizeof(usersDefault[0]))
+		{
+			char pin[PIN_MIN];
+			uint64_t cred;
+
+			memcpy_P(pin, usersDefault[slot].pin, PIN_MIN);
+			cred = pin_hash(pin, PIN_MIN);
+			memcpy(u.cred, &cred, USERS_CRED_LEN);
+			memcpy_P(u.name, usersDefault[slot].name, USERS_NAME_LEN);
+			u.flags = USER_F_ACTIVE;
+		}
+#endif
+		eeq_write(record_addr(0, slot), &u, USERS_RECORD_LEN);
+		h = users_record_hash(slot, (const uint8_t *)&u);
+		usersBucket[slot / USERS_BUCKET] ^= h;
+		usersRoot ^= h;
+	}
+	bank_commit(0, 0, 0, usersRoot);
+
+	usersBank = 0;
+	usersGen = 0;
+	usersVer = 0;
+}
+
+/*--------------------------------------------------------------------*/
+void users_init(void)
+{
+	uint8_t hdr0[USERS_HEADER_LEN];
+	uint8_t hdr1[USERS_HEADER_LEN];
+	uint8_t ok0, ok1;
+	uint8_t *hdr;
+
+	// The sync buckets are free here, use them for bank 1
+	ok0 = bank_load(0, hdr0, usersBucket);
+	ok1 = bank_load(1, hdr1, usersSyncBucket);
+	usersSync = 0;
+
+	// Nothing is known about the other bank, compare every slot
+	dirty_all();
+
+	if (!ok0 && !ok1)
+	{
+		users_defaults();
+		index_build();
+		return;
+	}
+
+	// Both valid: the newer generation wins, counting wraps around
+	if (ok1 && (!ok0 || (int8_t)(hdr1[HDR_GEN] - hdr0[HDR_GEN]) > 0))
+	{
+		usersBank = 1;
+		memcpy(usersBucket, usersSyncBucket, sizeof(usersBucket));
+		hdr = hdr1;
+	}
+	else
+	{
+		usersBank = 0;
+		hdr = hdr0;
+	}
+	usersGen = hdr[HDR_GEN];
+	usersVer = hdr[HDR_VERSION] | (hdr[HDR_VERSION + 1] << 8);
+	usersRoot = hdr[HDR_ROOT] | (hdr[HDR_ROOT + 1] << 8);
+	index_build();
+}
+
+/*--------------------------------------------------------------------*/
+int16_t users_find(const char *pin, uint8_t len)
+{
+	uint8_t rec[1 + USERS_CRED_LEN];
+	uint8_t bank = usersBank;
+	uint64_t cred;
+
+	if (len < PIN_MIN || len > PIN_MAX)
+		return -1;
+
+	cred = pin_hash(pin, len);
+	for (uint16_t slot = 0; slot < USERS_MAX; slot++)
+	{
+		eeq_read(rec, record_addr(bank, slot), sizeof(rec));
+		if ((rec[0] & (USER_F_ACTIVE | USER_F_TOTP)) == USER_F_ACTIVE &&
+			memcmp(rec + 1, &cred, USERS_CRED_LEN) == 0)
+			return slot;
+	}
+	return -1;
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t users_maybe(uint64_t cred)
+{
+	uint16_t bits[USERS_PROBES];
+
+	bloom_bits(cred, bits);
+	for (uint8_t b = 0; b < USERS_PROBES; b++)
+		if (!((usersBloom[bits[b] / 8] >> (bits[b] % 8)) & 1))
+			return 0;
+	return 1;
+}
+
+/*--------------------------------------------------------------------*/
+int16_t users_match(uint64_t cred)
+{
+	uint16_t i = (uint32_t)cred % USERS_INDEX;
+	uint8_t rec[1 + USERS_CRED_LEN];
+	users_ix_t slot;
+
+	// Most wrong entries end here, without a read of the EEPROM
+	if (!users_maybe(cred))
+		return -1;
+
+	// The record decides, not the index: it is only a hint where to look
+	while ((slot = usersIndex[i]) != 0)
+	{
+		eeq_read(rec, record_addr(usersBank, slot - 1), sizeof(rec));
+		if ((rec[0] & (USER_F_ACTIVE | USER_F_TOTP)) == USER_F_ACTIVE &&
+			memcmp(rec + 1, &cred, USERS_CRED_LEN) == 0)
+			return slot - 1;
+		i = (i + 1) % USERS_INDEX;
+	}
+	return -1;
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t users_totp(uint16_t slot, uint8_t *cred)
+{
+	uint8_t flags;
+
+	eeq_read(&flags, record_addr(usersBank, slot), 1);
+	if ((flags & (USER_F_ACTIVE | USER_F_TOTP)) != (USER_F_ACTIVE | USER_F_TOTP))
+		return 0;
+	if (cred)
+		eeq_read(cred, record_addr(usersBank, slot) + 1, USERS_CRED_LEN);
+	return 1;
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t users_schedule(uint16_t slot)
+{
+	uint8_t flags;
+
+	eeq_read(&flags, record_addr(usersBank, slot), 1);
+	return (flags & USER_F_SCHED) >> USER_SCHED_SHIFT;
+}
+
+/*--------------------------------------------------------------------*/
+void users_name(uint16_t slot, char *name)
+{
+	eeq_read(name, record_addr(usersBank, slot) + 1 + USERS_CRED_LEN, USERS_NAME_LEN);
+	name[USERS_NAME_LEN - 1] = '\0';
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t users_unlock(uint16_t slot)
+{
+	uint8_t seconds;
+
+	eeq_read(&seconds, record_addr(usersBank, slot) + offsetof(user_t, unlock), 1);
+	return seconds;
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t users_chime(uint16_t slot)
+{
+	uint8_t chime;
+
+	eeq_read(&chime, record_addr(usersBank, slot) + offsetof(user_t, chime), 1);
+	return chime;
+}
+
+/*--------------------------------------------------------------------*/
+uint16_t users_version(void)
+{
+	return usersVer;
+}
+
+/*--------------------------------------------------------------------*/
+void users_task(void)
+{
+	uint8_t rec[USERS_RECORD_LEN];
+	uint8_t other = usersBank ^ 1;
+	uint16_t slot;
+
+	if (usersSync || !usersDirtyCount)
+		return;
+
+	while (!(usersDirty[usersCopyNext / 8] & (1 << (usersCopyNext % 8))))
+		usersCopyNext = (usersCopyNext + 1) % USERS_MAX;
+	slot = usersCopyNext;
+
+	// The other bank stops being a valid fallback with the first copy
+	bank_invalidate(other);
+	eeq_read(rec, record_addr(usersBank, slot), USERS_RECORD_LEN);
+	eeq_write(record_addr(other, slot), rec, USERS_RECORD_LEN);
+
+	usersDirty[slot / 8] &= ~(1 << (slot % 8));
+	usersDirtyCount--;
+}
+
+/*--------------------------------------------------------------------*/
+// Opens a sync on the other bank, it must equal the active one
+static uint8_t sync_begin(void)
+{
+	// A sync that was never committed is thrown away, users_task()
+	// restores the slots it wrote
+	usersSync = 0;
+	if (usersDirtyCount)
+		return USR_BUSY;
+
+	bank_invalidate(usersBank ^ 1);
+	usersSyncRoot = usersRoot;
+	memcpy(usersSyncBucket, usersBucket, sizeof(usersBucket));
+	usersSync = 1;
+	return USR_OK;
+}
+
+/*--------------------------------------------------------------------*/
+static void sync_write(uint16_t slot, const uint8_t *rec)
+{
+	uint8_t old[USERS_RECORD_LEN];
+	uint16_t addr = record_addr(usersBank ^ 1, slot);
+	uint16_t h;
+
+	eeq_read(old, addr, USERS_RECORD_LEN);
+	h = users_record_hash(slot, old) ^ users_record_hash(slot, rec);
+	if (h == 0 && memcmp(old, rec, USERS_RECORD_LEN) == 0)
+		return;
+
+	usersSyncBucket[slot / USERS_BUCKET] ^= h;
+	usersSyncRoot ^= h;
+	eeq_write(addr, rec, USERS_RECORD_LEN);
+	dirty_set(slot);
+}
+
+/*--------------------------------------------------------------------*/
+static void sync_commit(uint16_t version)
+{
+	uint8_t other = usersBank ^ 1;
+
+	bank_commit(other, usersGen + 1, version, usersSyncRoot);
+	// The master takes the reply for the table being stored, a reset
+	// after it must not bring back the old one
+	eeq_flush();
+
+	// The index of the old bank goes with it, a lookup finds nobody
+	// until index_build() enters the users of the new one
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		index_clear();
+		usersBank = other;
+	}
+	usersGen++;
+	usersVer = version;
+	usersRoot = usersSyncRoot;
+	memcpy(usersBucket, usersSyncBucket, sizeof(usersBucket));
+	usersSync = 0;
+	index_build();
+
+	// The written slots are now the ones users_task() copies back
+	usersCopyNext = 0;
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t users_frame(uint8_t type, const uint8_t *payload, uint8_t len, uint8_t *reply)
+{
+	uint16_t arg = (len >= 2) ? (payload[0] | (payload[1] << 8)) : 0;
+	uint8_t n = 0;
+	uint8_t rec[USERS_RECORD_LEN];
+
+	reply[0] = USR_OK;
+
+	switch (type)
+	{
+	case FT_USR_INFO:
+		reply[1] = usersVer & 0xFF;
+		reply[2] = usersVer >> 8;
+		reply[3] = usersGen;
+		reply[4] = USERS_MAX & 0xFF;
+		reply[5] = USERS_MAX >> 8;
+		reply[6] = USERS_BUCKET;
+		reply[7] = usersRoot & 0xFF;
+		reply[8] = usersRoot >> 8;
+		reply[9] = (usersSync ? USERS_INFO_SYNC : 0) | (usersDirtyCount ? USERS_INFO_COPYING : 0);
+		return 10;
+
+	case FT_USR_BUCKETS:
+		if (len < 2)
+			break;
+		for (uint16_t b = arg; b < USERS_BUCKETS && n < USERS_HASHES_PER_FRAME; b++, n++)
+		{
+			reply[2 + 2 * n] = usersBucket[b] & 0xFF;
+			reply[3 + 2 * n] = usersBucket[b] >> 8;
+		}
+		reply[1] = n;
+		return 2 + 2 * n;
+
+	case FT_USR_HASHES:
+		if (len < 2)
+			break;
+		if (arg >= USERS_BUCKETS)
+		{
+			reply[0] = USR_BAD_SLOT;
+			return 1;
+		}
+		for (uint16_t slot = arg * USERS_BUCKET; slot < USERS_MAX && n < USERS_BUCKET; slot++, n++)
+		{
+			eeq_read(rec, record_addr(usersBank, slot), USERS_RECORD_LEN);
+			uint16_t h = users_record_hash(slot, rec);
+			reply[2 + 2 * n] = h & 0xFF;
+			reply[3 + 2 * n] = h >> 8;
+		}
+		reply[1] = n;
+		return 2 + 2 * n;
+
+	case FT_USR_BEGIN:
+		if (len < 2)
+			break;
+		// Changes made against another version would be lost
+		if (arg != usersVer)
+			reply[0] = USR_BAD_VERSION;
+		else
+			reply[0] = sync_begin();
+		reply[1] = usersVer & 0xFF;
+		reply[2] = usersVer >> 8;
+		return 3;
+
+	case FT_USR_WRITE:
+		if (len < 2 + USERS_RECORD_LEN)
+			break;
+		if (!usersSync)
+			reply[0] = USR_NO_SYNC;
+		else if (arg >= USERS_MAX)
+			reply[0] = USR_BAD_SLOT;
+		else
+			sync_write(arg, payload + 2);
+		return 1;
+
+	case FT_USR_COMMIT:
+		if (len < 2)
+			break;
+		if (!usersSync)
+			reply[0] = USR_NO_SYNC;
+		else
+			sync_commit(arg);
+		reply[1] = usersRoot & 0xFF;
+		reply[2] = usersRoot >> 8;
+		return 3;
+
+	default:
+		return FRAME_NO_REPLY;
+	}
+
+	reply[0] = USR_BAD_LEN;
+	return 1;
+}
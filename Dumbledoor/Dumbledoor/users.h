@@ -0,0 +1,239 @@
+#ifndef USERS_H_
+#define USERS_H_
+
+/***********************************************************************
+ *
+ * User table library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/**
+ * @file  users.h
+ * @defgroup dumbledoor_users User Table Library <users.h>
+ * @code #include <users.h> @endcode
+ *
+ * @brief Versioned user table in EEPROM, updated by delta sync.
+ *
+ * @details
+ * The table has USERS_MAX slots of USERS_RECORD_LEN bytes. It is kept
+ * twice in EEPROM: the active bank is read by the application, a sync
+ * writes only the other bank and switches over with a header write as
+ * its last step. A sync cut short by a reset leaves the old table.
+ *
+ * Every record has a 16-bit hash of its slot number and its bytes. A
+ * bucket of USERS_BUCKET slots has the XOR of its record hashes, the
+ * table root is the XOR of all buckets. XOR lets the door update them
+ * for every written record instead of hashing the table again.
+ *
+ * A provisioning tool syncs a door like this:
+ *
+ *     FT_USR_INFO       version and root of the door
+ *     FT_USR_BUCKETS    only when the door's version is unknown to the
+ *     FT_USR_HASHES     tool: find the changed slots by their hashes
+ *     FT_USR_BEGIN      start from the version the changes are based on
+ *     FT_USR_WRITE      one per changed slot
+ *     FT_USR_COMMIT     new version, the door answers with its root
+ *
+ * so the bytes on the wire and the EEPROM writes grow with the number
+ * of changed users, not with the size of the table. Every reply starts
+ * with a status byte USR_...
+ *
+ * A record holds no PIN, only its keyed hash pin_hash() (see pin.h).
+ * users_match() first tests four bits picked by the upper 32 bits of
+ * the hash in a Bloom filter of 16 bits per slot, which turns away all
+ * but 0.24 % of the wrong PINs of a full table without a read of the
+ * EEPROM. The rest are looked up by the low 32 bits in an index of the
+ * slots and the whole hash is compared with the record. Filter and
+ * index are in SRAM, 4 to 6 bytes per slot, and are rebuilt from the
+ * active bank at users_init() and at every commit. A user
+ * with USER_F_TOTP has the fingerprint of its TOTP secret in place of
+ * the hash and opens the door with the codes of totp.h instead. The bits USER_F_SCHED name the
+ * access schedule of the user, see schedule.h.
+ *
+ * After a commit users_task() copies the written slots to the other
+ * bank too, in the background from the main loop, so the next sync can
+ * start from equal banks. Until then FT_USR_BEGIN answers USR_BUSY.
+ *
+ * @author
+ * Demirkan Korbey Baglamac and Rasit Demiroren
+ *
+ * @copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * Programmed for the Digital Electronics 2 project.
+ * This work is licensed under the terms of the MIT license.
+ */
+
+/* Includes ----------------------------------------------------------*/
+#include <stdint.h>         // Fixed width integer types
+#include "frame.h"          // Frame codec library
+
+/* Definitions -------------------------------------------------------*/
+#ifndef USERS_MAX
+#define USERS_MAX           8       // Slots in the table
+#endif
+#define USERS_BUCKET        4       // Slots per bucket hash
+#define USERS_BUCKETS       ((USERS_MAX + USERS_BUCKET - 1) / USERS_BUCKET)
+
+#define USERS_CRED_LEN      8       // pin_hash() of the PIN
+#define USERS_NAME_LEN      13      // Name with terminating zero
+#define USERS_RECORD_LEN    24
+#define USERS_HEADER_LEN    8       // magic, gen, version, root, crc
+#define USERS_BANK_LEN      (USERS_HEADER_LEN + USERS_MAX * USERS_RECORD_LEN)
+
+#define USER_F_ACTIVE       0x01    // Slot holds a user
+#define USER_F_TOTP         0x02    // cred names a TOTP secret, see totp.h
+#define USER_F_SCHED        0x0C    // Access schedule, 0: any time
+#define USER_SCHED_SHIFT    2
+
+// Sync frames, the door answers with type | FT_REPLY
+#define FT_USR_INFO         0x10    // [] -> [st, ver lo, ver hi, gen, slots lo, slots hi,
+                                    //        bucket size, root lo, root hi, USERS_INFO_...]
+#define FT_USR_BUCKETS      0x11    // [first lo, first hi] -> [st, n, hash lo, hash hi, ...]
+#define FT_USR_HASHES       0x12    // [bucket lo, bucket hi] -> [st, n, hash lo, hash hi, ...]
+#define FT_USR_BEGIN        0x13    // [base ver lo, base ver hi] -> [st, ver lo, ver hi]
+#define FT_USR_WRITE        0x14    // [slot lo, slot hi, record] -> [st]
+#define FT_USR_COMMIT       0x15    // [ver lo, ver hi] -> [st, root lo, root hi]
+
+// Reply status
+#define USR_OK              0
+#define USR_BAD_VERSION     1       // Base version is not the door's
+#define USR_NO_SYNC         2       // FT_USR_BEGIN missing
+#define USR_BAD_SLOT        3
+#define USR_BAD_LEN         4
+#define USR_BUSY            5       // Banks not equal yet, try again
+
+// Flags in the FT_USR_INFO reply
+#define USERS_INFO_SYNC     0x01    // Sync open
+#define USERS_INFO_COPYING  0x02    // users_task() has work left
+
+/**
+ * @brief One slot of the table.
+ */
+typedef struct {
+	uint8_t flags;                      // USER_F_...
+	uint8_t cred[USERS_CRED_LEN];       // pin_hash() of the PIN, low byte first,
+	                                    // or totp_fingerprint() with USER_F_TOTP
+	char name[USERS_NAME_LEN];          // Shown on entry
+	uint8_t unlock;                     // Unlock time in seconds, 0: door default
+	uint8_t chime;                      // Melody of the correct pin + 1, 0: door default
+} user_t;
+
+typedef char users_record_len_check[(sizeof(user_t) == USERS_RECORD_LEN) ? 1 : -1];
+
+/* Function prototypes -----------------------------------------------*/
+/**
+ * @brief    Loads the newest valid bank. With no valid bank, after
+ *           a corrupted EEPROM or a change of the record format, an
+ *           empty table is written as version 0 and no pin opens the
+ *           door until a sync. Built with USERS_DEMO, for a bench
+ *           board only, the four users of the first firmware instead.
+ * @return   none
+ */
+void users_init(void);
+
+/**
+ * @brief    Copies one changed slot to the other bank. Call it from the
+ *           main loop.
+ * @return   none
+ */
+void users_task(void);
+
+/**
+ * @brief    Looks up a PIN, reading every record. The reference of the
+ *           fuzz target and the benches, the key pad uses
+ *           users_match().
+ * @param    pin  Typed digits
+ * @param    len  Number of digits, PIN_MIN to PIN_MAX
+ * @return   Slot of the user, -1 when no user has this PIN
+ */
+int16_t users_find(const char *pin, uint8_t len);
+
+/**
+ * @brief    Tests a finished entry against the filter of the active
+ *           bank. Safe to call from interrupt handlers.
+ * @param    cred  pin_finish() of the entry
+ * @return   0 when no user has this PIN, 1 when one may have it
+ */
+uint8_t users_maybe(uint64_t cred);
+
+/**
+ * @brief    Looks up a finished entry, the filter and one probe of the
+ *           index. Reads the EEPROM, call it from the main loop.
+ * @param    cred  pin_finish() of the entry
+ * @return   Slot of the user, -1 when no user has this PIN
+ */
+int16_t users_match(uint64_t cred);
+
+/**
+ * @brief    Reads the fingerprint of the secret of a TOTP user.
+ * @param    slot  Slot number
+ * @param    cred  USERS_CRED_LEN bytes, or 0 for only the check
+ * @return   1 when the slot holds an active user with USER_F_TOTP
+ */
+uint8_t users_totp(uint16_t slot, uint8_t *cred);
+
+/**
+ * @brief    Reads the access schedule of a user.
+ * @param    slot  Slot number
+ * @return   Schedule of schedule.h, 0 for none
+ */
+uint8_t users_schedule(uint16_t slot);
+
+/**
+ * @brief    Copies the name of a user.
+ * @param    slot  Slot returned by users_match()
+ * @param    name  USERS_NAME_LEN bytes, zero terminated on return
+ * @return   none
+ */
+void users_name(uint16_t slot, char *name);
+
+/**
+ * @brief    Unlock time of a user.
+ * @param    slot  Slot returned by users_match()
+ * @return   Seconds, 0 for the time of the door
+ */
+uint8_t users_unlock(uint16_t slot);
+
+/**
+ * @brief    Melody of a user for the correct pin.
+ * @param    slot  Slot returned by users_match()
+ * @return   MELODY_... + 1, 0 for the melody of the door
+ */
+uint8_t users_chime(uint16_t slot);
+
+/**
+ * @brief    Version of the active table.
+ * @return   Version, set by the last FT_USR_COMMIT
+ */
+uint16_t users_version(void);
+
+/**
+ * @brief    Handles a sync frame. Called by the bus library.
+ * @param    type     Frame type FT_USR_...
+ * @param    payload  Request payload
+ * @param    len      Request payload length
+ * @param    reply    FRAME_PAYLOAD_MAX bytes for the reply payload
+ * @return   Reply payload length, FRAME_NO_REPLY for other frames
+ */
+uint8_t users_frame(uint8_t type, const uint8_t *payload, uint8_t len, uint8_t *reply);
+
+/**
+ * @brief    Hash of a record in a slot. The provisioning tool uses the
+ *           same function.
+ * @param    slot  Slot number
+ * @param    rec   USERS_RECORD_LEN record bytes
+ * @return   16-bit hash
+ */
+static inline uint16_t users_record_hash(uint16_t slot, const uint8_t *rec)
+{
+	uint16_t h = frame_crc16(frame_crc16(0xFFFF, slot & 0xFF), slot >> 8);
+
+	for (uint8_t i = 0; i < USERS_RECORD_LEN; i++)
+		h = frame_crc16(h, rec[i]);
+	return h;
+}
+
+#endif /* USERS_H_ */
@@ -0,0 +1,66 @@
+/***********************************************************************
+ *
+ * Watchdog supervisor library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/* Includes ----------------------------------------------------------*/
+#include <avr/io.h>         // MCUSR
+#include <avr/wdt.h>        // Watchdog
+#include <util/atomic.h>    // ATOMIC_BLOCK
+#include "wdog.h"
+
+/* Global Variables --------------------------------------------------*/
+volatile uint8_t wdogSeen = 0;
+
+// Written in .init3, before .bss is cleared
+static uint8_t wdogMcusr __attribute__((section(".noinit")));
+
+/* Function definitions ----------------------------------------------*/
+// Runs in .init3, the stack and r1 are set up but .data and .bss are
+// not yet
+void wdog_early(void) __attribute__((naked, used, section(".init3")));
+void wdog_early(void)
+{
+	wdogMcusr = MCUSR;
+	MCUSR = 0;
+	wdt_disable();
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t wdog_mcusr(void)
+{
+	return wdogMcusr;
+}
+
+/*--------------------------------------------------------------------*/
+uint8_t wdog_warm(void)
+{
+	// A boot loader may hand over a cleared MCUSR, that is cold
+	return (wdogMcusr & (_BV(WDRF) | _BV(EXTRF))) &&
+	       !(wdogMcusr & (_BV(PORF) | _BV(BORF)));
+}
+
+/*--------------------------------------------------------------------*/
+void wdog_start(void)
+{
+	wdogSeen = 0;
+	wdt_enable(WDOG_TIMEOUT);
+}
+
+/*--------------------------------------------------------------------*/
+void wdog_task(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		if ((wdogSeen & WDOG_TICKS) == WDOG_TICKS)
+		{
+			wdogSeen = 0;
+			wdt_reset();
+		}
+	}
+}
@@ -0,0 +1,96 @@
+#ifndef WDOG_H_
+#define WDOG_H_
+
+/***********************************************************************
+ *
+ * Watchdog supervisor library for AVR-GCC.
+ * ATmega328P (Arduino Uno), 16 MHz, AVR 8-bit Toolchain 3.6.2
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ *
+ **********************************************************************/
+
+/**
+ * @file  wdog.h
+ * @defgroup dumbledoor_wdog Watchdog Library <wdog.h>
+ * @code #include <wdog.h> @endcode
+ *
+ * @brief Resets the door when the main loop or one of the ticks stops.
+ *
+ * @details
+ * Every tick handler checks in with wdog_checkin(), the main loop calls
+ * wdog_task(). The watchdog is only reset when all ticks have checked
+ * in since the last time, so a stuck main loop, a stuck handler and
+ * interrupts left disabled all end in a reset after WDOG_TIMEOUT.
+ *
+ * The reset flags are taken in .init3, before the C runtime, and the
+ * watchdog is stopped there: after a watchdog reset it keeps running
+ * with its shortest timeout and would reset the door again during the
+ * boot. wdog_warm() tells whether the door kept its power, in that case
+ * main() skips the power-on wait of the display and door_restore() takes
+ * the attempt counters of the run before.
+ *
+ * @author
+ * Demirkan Korbey Baglamac and Rasit Demiroren
+ *
+ * @copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * Programmed for the Digital Electronics 2 project.
+ * This work is licensed under the terms of the MIT license.
+ */
+
+/* Includes ----------------------------------------------------------*/
+#include <stdint.h>         // Fixed width integer types
+#include <avr/wdt.h>        // Watchdog timeouts
+
+/* Definitions -------------------------------------------------------*/
+#define WDOG_TIMEOUT    WDTO_2S     // Twice the second tick
+
+// Check-in bits of the tick handlers
+#define WDOG_KEYPAD     0x01        // TIMER0_OVF
+#define WDOG_SECOND     0x02        // TIMER1_COMPA
+#define WDOG_SOUND      0x04        // TIMER2_OVF
+#define WDOG_TICKS      0x07
+
+/* Global Variables --------------------------------------------------*/
+extern volatile uint8_t wdogSeen;
+
+/* Function prototypes -----------------------------------------------*/
+/**
+ * @brief    MCUSR at reset, saved before the C runtime cleared it.
+ * @return   Reset flags
+ */
+uint8_t wdog_mcusr(void);
+
+/**
+ * @brief    Tells whether the reset left the power on: a watchdog or
+ *           external reset without a power-on or brown-out.
+ * @return   1 when warm, 0 after a power-on
+ */
+uint8_t wdog_warm(void);
+
+/**
+ * @brief    Starts the watchdog. Call it after the ticks are started,
+ *           just before interrupts are enabled.
+ * @return   none
+ */
+void wdog_start(void);
+
+/**
+ * @brief    Resets the watchdog when all ticks have checked in. Call it
+ *           once per pass of the main loop.
+ * @return   none
+ */
+void wdog_task(void);
+
+/**
+ * @brief    Checks a tick in, from its interrupt handler.
+ * @param    tick  WDOG_...
+ * @return   none
+ */
+static inline void wdog_checkin(uint8_t tick)
+{
+	wdogSeen |= tick;
+}
+
+#endif /* WDOG_H_ */
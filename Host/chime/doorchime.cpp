@@ -0,0 +1,196 @@
+// Encodes the door bell chime of the firmware, chime_data.c.
+//
+//     doorchime [sound.wav] > chime_data.c
+//
+// The WAV file is PCM, 8 or 16 bit, mono or stereo, at any rate; it is
+// mixed to mono and resampled to CHIME_RATE. Without a file a two note
+// ding-dong is synthesized. Each sample gets the 4 bit code whose
+// decoded value is nearest, decoded with adpcm_decode() of the firmware
+// (chime.c), so the door plays exactly what is measured here. The
+// length and the signal to noise ratio are printed to stderr.
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "chime.h"
+}
+
+namespace {
+
+constexpr double kRate = 16e6 / 8 / 256;   // Timer/Counter2 PWM periods per second
+constexpr double kPi = 3.14159265358979323846;
+
+uint32_t le(const uint8_t *p, unsigned n)
+{
+	uint32_t v = 0;
+	for (unsigned i = 0; i < n; i++)
+		v |= static_cast<uint32_t>(p[i]) << (8 * i);
+	return v;
+}
+
+// Mono samples of -1..1 and their rate
+std::vector<double> read_wav(const char *path, double &rate)
+{
+	std::ifstream f(path, std::ios::binary);
+	if (!f)
+		throw std::runtime_error(std::string("cannot read ") + path);
+	std::vector<uint8_t> b((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+	if (b.size() < 12 || std::string(b.begin(), b.begin() + 4) != "RIFF" ||
+	    std::string(b.begin() + 8, b.begin() + 12) != "WAVE")
+		throw std::runtime_error(std::string(path) + ": not a WAV file");
+
+	unsigned channels = 0, bits = 0;
+	for (size_t at = 12; at + 8 <= b.size();) {
+		const std::string id(b.begin() + at, b.begin() + at + 4);
+		const size_t len = le(&b[at + 4], 4);
+		const size_t body = at + 8;
+		if (body + len > b.size())
+			break;
+		if (id == "fmt " && len >= 16) {
+			if (le(&b[body], 2) != 1)
+				throw std::runtime_error(std::string(path) + ": not PCM");
+			channels = le(&b[body + 2], 2);
+			rate = le(&b[body + 4], 4);
+			bits = le(&b[body + 14], 2);
+		} else if (id == "data") {
+			if (!channels || (bits != 8 && bits != 16))
+				throw std::runtime_error(std::string(path) + ": 8 or 16 bit PCM only");
+			const unsigned frame = channels * bits / 8;
+			std::vector<double> out;
+			for (size_t i = body; i + frame <= body + len; i += frame) {
+				double sum = 0;
+				for (unsigned c = 0; c < channels; c++) {
+					const uint8_t *p = &b[i + c * bits / 8];
+					sum += bits == 8 ? (p[0] - 128) / 128.0
+					                 : static_cast<int16_t>(le(p, 2)) / 32768.0;
+				}
+				out.push_back(sum / channels);
+			}
+			return out;
+		}
+		at = body + len + (len & 1);
+	}
+	throw std::runtime_error(std::string(path) + ": no samples");
+}
+
+// Linear interpolation, enough for a chime that is filtered by a speaker
+std::vector<double> resample(const std::vector<double> &in, double from)
+{
+	std::vector<double> out;
+	const double step = from / kRate;
+	for (double t = 0; t + 1 < in.size(); t += step) {
+		const size_t i = static_cast<size_t>(t);
+		out.push_back(in[i] + (in[i + 1] - in[i]) * (t - i));
+	}
+	return out;
+}
+
+// E5 and C5 bell strikes, each with its inharmonic partials
+std::vector<double> ding_dong()
+{
+	struct Partial { double ratio, level, decay; };
+	static const Partial kBell[] = {
+		{1.0, 1.0, 2.2}, {2.0, 0.45, 3.5}, {2.76, 0.25, 5.0}, {4.2, 0.08, 9.0},
+	};
+	const double notes[][2] = {{0.0, 659.25}, {0.45, 523.25}};
+	std::vector<double> out(static_cast<size_t>(1.1 * kRate));
+
+	for (const auto &n : notes) {
+		for (size_t i = static_cast<size_t>(n[0] * kRate); i < out.size(); i++) {
+			const double t = i / kRate - n[0];
+			double v = 0;
+			for (const Partial &p : kBell)
+				v += p.level * std::exp(-p.decay * t) * std::sin(2 * kPi * n[1] * p.ratio * t);
+			out[i] += 0.45 * v * std::min(1.0, t * 2000);     // 0.5 ms attack
+		}
+	}
+	return out;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	if (argc > 2) {
+		std::fprintf(stderr, "usage: doorchime [sound.wav] > chime_data.c\n");
+		return 2;
+	}
+
+	std::vector<double> pcm;
+	try {
+		if (argc == 2) {
+			double rate = 0;
+			pcm = read_wav(argv[1], rate);
+			pcm = resample(pcm, rate);
+		} else {
+			pcm = ding_dong();
+		}
+	} catch (const std::exception &e) {
+		std::fprintf(stderr, "doorchime: %s\n", e.what());
+		return 1;
+	}
+	if (pcm.empty() || pcm.size() > CHIME_SAMPLES_MAX) {
+		std::fprintf(stderr, "doorchime: %zu samples, at most %u fit in the sound ticks\n",
+		             pcm.size(), CHIME_SAMPLES_MAX);
+		return 1;
+	}
+
+	adpcm_t state{};
+	std::vector<uint8_t> codes;
+	double signal = 0, noise = 0;
+	for (double x : pcm) {
+		const double want = std::max(-32768.0, std::min(32767.0, std::round(x * 32767)));
+		uint8_t best = 0;
+		double err = 1e18;
+		for (uint8_t c = 0; c < 16; c++) {
+			adpcm_t t = state;
+			const double e = std::fabs(adpcm_decode(&t, c) - want);
+			if (e < err) {
+				err = e;
+				best = c;
+			}
+		}
+		adpcm_decode(&state, best);
+		codes.push_back(best);
+		signal += want * want;
+		noise += err * err;
+	}
+	if (codes.size() & 1)
+		codes.push_back(0);
+
+	std::printf("/***********************************************************************\n"
+	            " *\n"
+	            " * Door bell chime, IMA ADPCM at %u samples per second.\n"
+	            " * Written by Host/chime/doorchime, do not edit.\n"
+	            " *\n"
+	            " **********************************************************************/\n\n"
+	            "/* Includes ----------------------------------------------------------*/\n"
+	            "#include <avr/pgmspace.h>   // Sample in program memory\n"
+	            "#include \"chime.h\"\n\n"
+	            "/* Definitions -------------------------------------------------------*/\n"
+	            "#define CHIME_SAMPLES   %zu\n\n"
+	            "typedef char chime_samples_check[(CHIME_SAMPLES <= CHIME_SAMPLES_MAX) ? 1 : -1];\n\n"
+	            "/* Global Variables --------------------------------------------------*/\n"
+	            "const uint16_t chimeSamples = CHIME_SAMPLES;\n\n"
+	            "const uint8_t chimeData[(CHIME_SAMPLES + 1) / 2] PROGMEM = {\n",
+	            CHIME_RATE, pcm.size());
+	for (size_t i = 0; i < codes.size(); i += 2)
+		std::printf("%s0x%02x,%s", i % 24 == 0 ? "\t" : "", codes[i] | codes[i + 1] << 4,
+		            i % 24 == 22 || i + 2 == codes.size() ? "\n" : " ");
+	std::printf("};\n");
+
+	std::fprintf(stderr, "%zu samples, %.2f s, %zu bytes, SNR %.1f dB\n", pcm.size(),
+	             pcm.size() / kRate, codes.size() / 2, 10 * std::log10(signal / std::max(noise, 1.0)));
+	return 0;
+}
@@ -0,0 +1,130 @@
+// Door event helpers shared by the host tools (see event.h).
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+extern "C" {
+#include "bus.h"
+#include "event.h"
+}
+
+namespace door {
+
+inline const char *event_name(uint8_t type)
+{
+	switch (type) {
+	case EV_BOOT: return "boot";
+	case EV_ENTRY: return "entry";
+	case EV_DENIED: return "denied";
+	case EV_BELL: return "bell";
+	case EV_STACK: return "stack";
+	case EV_KEY: return "key";
+	default: return "unknown";
+	}
+}
+
+// Drops events a door sent again because their acknowledgement got
+// lost, those are at or behind the last one taken. A reset starts the
+// sequence numbers over in a new epoch (see bus.h), which starts afresh.
+class EventDedup {
+public:
+	bool accept(uint8_t epoch, uint8_t seq)
+	{
+		if (epoch_ != epoch) {
+			epoch_ = epoch;
+			last_.reset();
+		}
+		if (last_ && static_cast<int8_t>(*last_ - seq) >= 0)
+			return false;
+		last_ = seq;
+		return true;
+	}
+
+	// Payload of the next FT_POLL or FT_EV_ACK, epoch and the last
+	// sequence number. Returns 0 before the first event.
+	uint8_t ack(uint8_t *out) const
+	{
+		if (!last_)
+			return 0;
+		out[0] = *epoch_;
+		out[1] = *last_;
+		return 2;
+	}
+	void reset()
+	{
+		epoch_.reset();
+		last_.reset();
+	}
+
+private:
+	std::optional<uint8_t> epoch_;
+	std::optional<uint8_t> last_;
+};
+
+// One event of an FT_EVENTS or FT_BATCH frame
+struct Event {
+	uint8_t seq;
+	uint8_t type;
+	uint8_t arg;
+	uint16_t time;
+};
+
+// Reads the events of an FT_EVENTS payload (see bus.h) into out.
+// Returns false when the header is cut short.
+inline bool decode_events(const uint8_t *p, size_t len, uint8_t &epoch, uint8_t &lost, std::vector<Event> &out)
+{
+	if (len < 2)
+		return false;
+	epoch = p[0];
+	lost = p[1];
+	for (size_t i = 2; i + BUS_EVENT_LEN <= len; i += BUS_EVENT_LEN)
+		out.push_back({p[i], p[i + 1], p[i + 2], static_cast<uint16_t>(p[i + 3] | p[i + 4] << 8)});
+	return true;
+}
+
+// Reads the events of an FT_BATCH payload (see bus.h) into out. Returns
+// false when the payload is cut short or a varint does not fit 16 bits,
+// out then holds the events before.
+inline bool decode_batch(const uint8_t *p, size_t len, uint8_t &epoch, uint8_t &lost, std::vector<Event> &out)
+{
+	if (len < BUS_BATCH_HEADER)
+		return false;
+	epoch = p[0];
+	lost = p[1];
+	uint8_t seq = p[2];
+	uint16_t time = static_cast<uint16_t>(p[3] | p[4] << 8);
+
+	size_t at = BUS_BATCH_HEADER;
+	const auto varint = [&](uint16_t &v) {
+		uint32_t x = 0;
+		for (unsigned shift = 0; at < len && shift < 21; shift += 7) {
+			const uint8_t b = p[at++];
+			x |= static_cast<uint32_t>(b & 0x7F) << shift;
+			if (!(b & 0x80)) {
+				v = static_cast<uint16_t>(x);
+				return x <= 0xFFFF;
+			}
+		}
+		return false;
+	};
+	while (at < len) {
+		Event e{seq++, p[at++], 0, 0};
+		uint16_t arg, dt;
+		if (!varint(arg) || arg > 0xFF || !varint(dt))
+			return false;
+		time = static_cast<uint16_t>(time + dt);
+		e.arg = static_cast<uint8_t>(arg);
+		e.time = time;
+		out.push_back(e);
+	}
+	return true;
+}
+
+} // namespace door
@@ -0,0 +1,26 @@
+// C++ helpers around the firmware frame codec (frame.h).
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+extern "C" {
+#include "frame.h"
+}
+
+namespace door {
+
+// Appends one encoded frame to out.
+inline void append_frame(std::vector<uint8_t> &out, uint8_t addr, uint8_t type, uint8_t seq,
+                         const uint8_t *payload, uint8_t len)
+{
+	frame_write(
+		[](void *ctx, uint8_t b) { static_cast<std::vector<uint8_t> *>(ctx)->push_back(b); },
+		&out, addr, type, seq, payload, len);
+}
+
+} // namespace door
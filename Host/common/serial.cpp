@@ -0,0 +1,148 @@
+// Serial port, pseudo-terminal and timing helpers for the host tools.
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include "serial.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <ctime>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdexcept>
+#include <system_error>
+#include <termios.h>
+#include <unistd.h>
+
+namespace door {
+
+namespace {
+
+speed_t baud_constant(int baud)
+{
+	switch (baud) {
+	case 1200: return B1200;
+	case 2400: return B2400;
+	case 4800: return B4800;
+	case 9600: return B9600;
+	case 19200: return B19200;
+	case 38400: return B38400;
+	case 57600: return B57600;
+	case 115200: return B115200;
+	case 230400: return B230400;
+	default: throw std::invalid_argument("unsupported baud rate " + std::to_string(baud));
+	}
+}
+
+[[noreturn]] void fail(const std::string &what)
+{
+	throw std::system_error(errno, std::generic_category(), what);
+}
+
+} // namespace
+
+int open_serial(const std::string &path, int baud, bool nonblocking)
+{
+	int fd = ::open(path.c_str(), O_RDWR | O_NOCTTY | O_CLOEXEC | (nonblocking ? O_NONBLOCK : 0));
+	if (fd < 0)
+		fail("open " + path);
+
+	termios tio{};
+	if (tcgetattr(fd, &tio) < 0) {
+		::close(fd);
+		fail("tcgetattr " + path);
+	}
+	cfmakeraw(&tio);
+	tio.c_cflag |= CLOCAL | CREAD;
+	tio.c_cflag &= ~(CSTOPB | PARENB | CRTSCTS);
+	tio.c_cc[VMIN] = 0;
+	tio.c_cc[VTIME] = 0;
+	cfsetispeed(&tio, baud_constant(baud));
+	cfsetospeed(&tio, baud_constant(baud));
+	if (tcsetattr(fd, TCSANOW, &tio) < 0) {
+		::close(fd);
+		fail("tcsetattr " + path);
+	}
+	return fd;
+}
+
+Pty open_pty()
+{
+	Pty pty;
+	pty.master = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC | O_NONBLOCK);
+	if (pty.master < 0)
+		fail("posix_openpt");
+	if (grantpt(pty.master) < 0 || unlockpt(pty.master) < 0) {
+		::close(pty.master);
+		fail("grantpt/unlockpt");
+	}
+	char name[128];
+	if (ptsname_r(pty.master, name, sizeof name) != 0) {
+		::close(pty.master);
+		fail("ptsname_r");
+	}
+	pty.slave_path = name;
+
+	// Raw mode lives on the slave side, set it once so no echo or line
+	// editing mangles frames written before the client configures it.
+	int slave = ::open(name, O_RDWR | O_NOCTTY | O_CLOEXEC);
+	if (slave >= 0) {
+		termios tio{};
+		if (tcgetattr(slave, &tio) == 0) {
+			cfmakeraw(&tio);
+			tcsetattr(slave, TCSANOW, &tio);
+		}
+		::close(slave);
+	}
+	return pty;
+}
+
+bool write_all(int fd, const uint8_t *data, size_t len)
+{
+	while (len) {
+		ssize_t n = ::write(fd, data, len);
+		if (n > 0) {
+			data += n;
+			len -= static_cast<size_t>(n);
+			continue;
+		}
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n < 0 && errno == EAGAIN) {
+			pollfd p{fd, POLLOUT, 0};
+			::poll(&p, 1, 100);
+			continue;
+		}
+		return false;
+	}
+	return true;
+}
+
+uint64_t now_ns()
+{
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+uint64_t LatencyStats::percentile(double p)
+{
+	if (samples_.empty())
+		return 0;
+	if (!sorted_) {
+		std::sort(samples_.begin(), samples_.end());
+		sorted_ = true;
+	}
+	size_t idx = static_cast<size_t>(std::ceil(p / 100.0 * samples_.size()));
+	idx = std::min(samples_.size() - 1, idx ? idx - 1 : 0);
+	return samples_[idx];
+}
+
+uint64_t LatencyStats::max()
+{
+	return percentile(100.0);
+}
+
+} // namespace door
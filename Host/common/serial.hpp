@@ -0,0 +1,52 @@
+// Serial port, pseudo-terminal and timing helpers for the host tools.
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace door {
+
+// Opens a serial device (or the slave side of a PTY) in raw 8N1 mode.
+// Throws std::system_error on failure.
+int open_serial(const std::string &path, int baud, bool nonblocking = false);
+
+// A pseudo-terminal pair. The tools simulating doors keep the master
+// side, the slave path is what a real serial device path would be.
+struct Pty {
+	int master = -1;
+	std::string slave_path;
+};
+
+// Creates a raw, non-blocking PTY. Throws std::system_error on failure.
+Pty open_pty();
+
+// Writes all bytes, retrying on EAGAIN/EINTR. Returns false on error.
+bool write_all(int fd, const uint8_t *data, size_t len);
+
+// Monotonic clock in nanoseconds.
+uint64_t now_ns();
+
+// Time one byte takes on the wire at the given baud rate (8N1).
+inline uint64_t byte_time_ns(int baud) { return baud > 0 ? 10000000000ULL / baud : 0; }
+
+// Collects latency samples and reports percentiles.
+class LatencyStats {
+public:
+	void add(uint64_t ns) { samples_.push_back(ns); sorted_ = false; }
+	size_t count() const { return samples_.size(); }
+	// p in [0, 100], returns 0 without samples.
+	uint64_t percentile(double p);
+	uint64_t max();
+	void clear() { samples_.clear(); sorted_ = false; }
+
+private:
+	std::vector<uint64_t> samples_;
+	bool sorted_ = false;
+};
+
+} // namespace door
@@ -0,0 +1,100 @@
+// Master side of the RS-485 door bus (see bus.h in the firmware).
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include "bus_master.hpp"
+
+#include "frame.hpp"
+#include "serial.hpp"
+
+#include <cerrno>
+#include <poll.h>
+#include <unistd.h>
+
+extern "C" {
+#include "bus.h"
+}
+
+namespace door {
+
+bool BusMaster::request(uint8_t addr, uint8_t type, const uint8_t *payload, uint8_t len,
+                        int timeout_ms, std::vector<uint8_t> &reply)
+{
+	const uint8_t seq = ++seq_;
+	std::vector<uint8_t> out;
+	append_frame(out, addr, type, seq, payload, len);
+
+	// Anything still in the buffer belongs to an earlier, timed out request
+	rx_.clear();
+	if (!write_all(fd_, out.data(), out.size()))
+		return false;
+	tx_bytes_ += out.size();
+
+	const uint64_t deadline = now_ns() + static_cast<uint64_t>(timeout_ms) * 1000000ULL;
+	uint8_t chunk[256];
+	for (;;) {
+		frame_view_t f;
+		size_t consumed = 0;
+		while (frame_find(rx_.data(), rx_.size(), &f, &consumed)) {
+			const bool match = f.addr == addr && f.type == (type | FT_REPLY) && f.seq == seq;
+			if (match)
+				reply.assign(f.payload, f.payload + f.len);
+			dropped_bytes_ += consumed - (f.len + FRAME_OVERHEAD);
+			rx_.erase(rx_.begin(), rx_.begin() + static_cast<long>(consumed));
+			if (match)
+				return true;
+		}
+		dropped_bytes_ += consumed;
+		rx_.erase(rx_.begin(), rx_.begin() + static_cast<long>(consumed));
+
+		const uint64_t now = now_ns();
+		if (now >= deadline)
+			return false;
+		pollfd p{fd_, POLLIN, 0};
+		int left_ms = static_cast<int>((deadline - now + 999999) / 1000000);
+		if (::poll(&p, 1, left_ms) <= 0)
+			continue;
+		ssize_t n = ::read(fd_, chunk, sizeof chunk);
+		if (n > 0) {
+			rx_.insert(rx_.end(), chunk, chunk + n);
+			rx_bytes_ += static_cast<uint64_t>(n);
+		} else if (n < 0 && errno != EAGAIN && errno != EINTR) {
+			return false;
+		}
+	}
+}
+
+PollResult BusMaster::poll(uint8_t addr, int timeout_ms)
+{
+	PollResult res;
+	std::vector<uint8_t> reply;
+	std::vector<Event> events;
+	uint8_t ack[2], epoch;
+	const uint8_t len = dedup_[addr].ack(ack);
+
+	const uint64_t t0 = now_ns();
+	if (!request(addr, FT_POLL, ack, len, timeout_ms, reply) ||
+	    !decode_events(reply.data(), reply.size(), epoch, res.lost, events))
+		return res;
+	res.rtt_ns = now_ns() - t0;
+	res.answered = true;
+
+	for (const Event &e : events) {
+		if (dedup_[addr].accept(epoch, e.seq))
+			res.events.push_back({addr, e.seq, e.type, e.arg, e.time});
+	}
+	return res;
+}
+
+bool BusMaster::set_address(uint8_t addr, uint8_t new_addr, uint8_t mode, int timeout_ms)
+{
+	std::vector<uint8_t> reply;
+	const uint8_t payload[2] = {new_addr, mode};
+	if (!request(addr, FT_SET_ADDR, payload, sizeof payload, timeout_ms, reply))
+		return false;
+	dedup_[new_addr] = dedup_[addr];
+	return true;
+}
+
+} // namespace door
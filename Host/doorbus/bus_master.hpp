@@ -0,0 +1,62 @@
+// Master side of the RS-485 door bus (see bus.h in the firmware).
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#pragma once
+
+#include "events.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace door {
+
+struct BusEvent {
+	uint8_t addr;
+	uint8_t seq;
+	uint8_t type;
+	uint8_t arg;
+	uint16_t time;
+};
+
+struct PollResult {
+	bool answered = false;      // false: timeout or no valid reply
+	uint8_t lost = 0;           // events the door dropped since last poll
+	uint64_t rtt_ns = 0;        // request written to reply parsed
+	std::vector<BusEvent> events;  // new events, retransmissions removed
+};
+
+// Polls doors one at a time over a serial device. Keeps the per door
+// acknowledgement state, so every event is delivered exactly once as
+// long as the door does not lose its queue.
+class BusMaster {
+public:
+	explicit BusMaster(int fd) : fd_(fd) {}
+
+	PollResult poll(uint8_t addr, int timeout_ms);
+
+	// Gives a door a new address and link mode. Returns true when acked.
+	bool set_address(uint8_t addr, uint8_t new_addr, uint8_t mode, int timeout_ms);
+
+	// Sends a request and waits for the matching reply. The reply payload
+	// is copied to reply. Returns false on timeout.
+	bool request(uint8_t addr, uint8_t type, const uint8_t *payload, uint8_t len,
+	             int timeout_ms, std::vector<uint8_t> &reply);
+
+	uint64_t bytes_sent() const { return tx_bytes_; }
+	uint64_t bytes_received() const { return rx_bytes_; }
+	uint64_t crc_or_sync_errors() const { return dropped_bytes_; }
+
+private:
+	int fd_;
+	uint8_t seq_ = 0;
+	std::vector<uint8_t> rx_;
+	std::array<EventDedup, 256> dedup_{};
+	uint64_t tx_bytes_ = 0;
+	uint64_t rx_bytes_ = 0;
+	uint64_t dropped_bytes_ = 0;
+};
+
+} // namespace door
@@ -0,0 +1,148 @@
+// Simulated doors on a pseudo-terminal, for testing the bus master
+// without hardware.
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include "bus_sim.hpp"
+
+#include "frame.hpp"
+
+#include <chrono>
+#include <poll.h>
+#include <unistd.h>
+
+extern "C" {
+#include "bus.h"
+#include "event.h"
+}
+
+namespace door {
+
+BusSim::BusSim(const BusSimConfig &cfg)
+	: cfg_(cfg), pty_(open_pty()), doors_(cfg.doors)
+{
+}
+
+BusSim::~BusSim()
+{
+	stop();
+	if (pty_.master >= 0)
+		::close(pty_.master);
+}
+
+void BusSim::start()
+{
+	if (running_.exchange(true))
+		return;
+	start_ns_ = now_ns();
+	std::exponential_distribution<double> gap(cfg_.events_per_s > 0 ? cfg_.events_per_s : 1.0);
+	for (auto &d : doors_) {
+		d.queue.push_back({d.next_seq++, EV_BOOT, 0, 0});
+		d.next_event_ns = start_ns_ + static_cast<uint64_t>(gap(rng_) * 1e9);
+	}
+	generated_ += doors_.size();
+	thread_ = std::thread(&BusSim::run, this);
+}
+
+void BusSim::stop()
+{
+	if (!running_.exchange(false))
+		return;
+	thread_.join();
+}
+
+void BusSim::generate(uint64_t now)
+{
+	const uint16_t time = static_cast<uint16_t>((now - start_ns_) / 1000000000ULL);
+	const uint8_t addr = reset_.exchange(0);
+	if (addr >= 1 && addr <= doors_.size()) {
+		Door &d = doors_[addr - 1];
+		d.queue.clear();
+		d.epoch++;
+		d.next_seq = 0;
+		d.lost = 0;
+		d.queue.push_back({d.next_seq++, EV_BOOT, 0, time});
+		generated_++;
+		resets_++;
+	}
+
+	if (cfg_.events_per_s <= 0)
+		return;
+	std::exponential_distribution<double> gap(cfg_.events_per_s);
+	for (auto &d : doors_) {
+		while (d.next_event_ns <= now) {
+			d.next_event_ns += static_cast<uint64_t>(gap(rng_) * 1e9);
+			generated_++;
+			if (d.queue.size() == BUS_EVENTS_MAX) {
+				if (d.lost != 0xFF)
+					d.lost++;
+				dropped_++;
+				continue;
+			}
+			const uint8_t arg = static_cast<uint8_t>(rng_() & 0x07);
+			d.queue.push_back({d.next_seq++, EV_ENTRY, arg, time});
+		}
+	}
+}
+
+void BusSim::handle(uint8_t addr, uint8_t type, uint8_t seq, const uint8_t *payload, uint8_t len)
+{
+	if (addr == FRAME_ADDR_MASTER || addr > doors_.size() || (type & FT_REPLY) || type != FT_POLL)
+		return;
+	Door &d = doors_[addr - 1];
+
+	if (len >= 2 && payload[0] == d.epoch) {
+		while (!d.queue.empty() &&
+		       static_cast<uint8_t>(payload[1] - d.queue.front().seq) <
+		           static_cast<uint8_t>(d.next_seq - d.queue.front().seq))
+			d.queue.pop_front();
+	}
+
+	uint8_t out[2 + BUS_EVENTS_PER_FRAME * BUS_EVENT_LEN];
+	uint8_t n = 2;
+	out[0] = d.epoch;
+	out[1] = d.lost;
+	d.lost = 0;
+	for (size_t i = 0; i < d.queue.size() && i < BUS_EVENTS_PER_FRAME; i++) {
+		const Event &ev = d.queue[i];
+		out[n++] = ev.seq;
+		out[n++] = ev.type;
+		out[n++] = ev.arg;
+		out[n++] = ev.time & 0xFF;
+		out[n++] = ev.time >> 8;
+	}
+
+	std::vector<uint8_t> reply;
+	append_frame(reply, addr, FT_EVENTS, seq, out, n);
+
+	// The request took its wire time to arrive, the reply takes its own
+	// to leave. The master only sees the reply once all of it is out.
+	if (cfg_.baud > 0) {
+		const uint64_t wire = (FRAME_OVERHEAD + len + reply.size()) * byte_time_ns(cfg_.baud);
+		std::this_thread::sleep_for(std::chrono::nanoseconds(wire + cfg_.turnaround_us * 1000ULL));
+	}
+	write_all(pty_.master, reply.data(), reply.size());
+}
+
+void BusSim::run()
+{
+	frame_rx_t rx;
+	frame_rx_reset(&rx);
+	uint8_t buf[256];
+
+	while (running_) {
+		pollfd p{pty_.master, POLLIN, 0};
+		int r = ::poll(&p, 1, 5);
+		generate(now_ns());
+		if (r <= 0)
+			continue;
+		ssize_t n = ::read(pty_.master, buf, sizeof buf);
+		for (ssize_t i = 0; i < n; i++) {
+			if (frame_rx_byte(&rx, buf[i]))
+				handle(rx.addr, rx.type, rx.seq, rx.payload, rx.len);
+		}
+	}
+}
+
+} // namespace door
@@ -0,0 +1,82 @@
+// Simulated doors on a pseudo-terminal, for testing the bus master
+// without hardware.
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#pragma once
+
+#include "serial.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace door {
+
+struct BusSimConfig {
+	unsigned doors = 1;             // Addresses 1..doors
+	double events_per_s = 1.0;      // Per door
+	int baud = 9600;                // Wire time pacing, 0 disables it
+	unsigned turnaround_us = 200;   // Door reaction time before replying
+};
+
+// Behaves like doors running bus.c: same queue size, same lost counter,
+// same ack rule. All doors see every byte, like on a real RS-485 pair.
+class BusSim {
+public:
+	explicit BusSim(const BusSimConfig &cfg);
+	~BusSim();
+
+	BusSim(const BusSim &) = delete;
+	BusSim &operator=(const BusSim &) = delete;
+
+	// Path a master opens as its serial device.
+	const std::string &device() const { return pty_.slave_path; }
+
+	void start();
+	void stop();
+
+	// Resets a door at its next step: the queue is gone, the sequence
+	// numbers start over at EV_BOOT in a new epoch.
+	void reset(uint8_t addr) { reset_ = addr; }
+
+	uint64_t events_generated() const { return generated_; }
+	uint64_t events_dropped() const { return dropped_; }
+	uint64_t resets() const { return resets_; }
+
+private:
+	struct Event {
+		uint8_t seq, type, arg;
+		uint16_t time;
+	};
+	struct Door {
+		std::deque<Event> queue;
+		uint8_t epoch = 0;
+		uint8_t next_seq = 0;
+		uint8_t lost = 0;
+		uint64_t next_event_ns = 0;
+	};
+
+	void run();
+	void generate(uint64_t now);
+	void handle(uint8_t addr, uint8_t type, uint8_t seq, const uint8_t *payload, uint8_t len);
+
+	BusSimConfig cfg_;
+	Pty pty_;
+	std::vector<Door> doors_;   // Index 0 is address 1
+	std::mt19937 rng_{1};
+	uint64_t start_ns_ = 0;
+	std::thread thread_;
+	std::atomic<bool> running_{false};
+	std::atomic<uint64_t> generated_{0};
+	std::atomic<uint64_t> dropped_{0};
+	std::atomic<uint8_t> reset_{0};
+	std::atomic<uint64_t> resets_{0};
+};
+
+} // namespace door
@@ -0,0 +1,108 @@
+// Round robin polling benchmark against simulated doors.
+//
+//     doorbus_bench [seconds per run] [events/s per door] [baud]
+//
+// For each bus size it reports the poll rate, the poll round trip
+// time, the event throughput and how many events the doors dropped
+// because they were not polled often enough. Every door starts with
+// EV_BOOT, and halfway through door 1 resets; the boots and every
+// event after them must arrive, in order and once, or the run counts
+// as wrong.
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include "bus_master.hpp"
+#include "bus_sim.hpp"
+#include "serial.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <unistd.h>
+#include <vector>
+
+extern "C" {
+#include "event.h"
+}
+
+int main(int argc, char **argv)
+{
+	const double seconds = argc > 1 ? std::atof(argv[1]) : 2.0;
+	const double rate = argc > 2 ? std::atof(argv[2]) : 0.5;
+	const int baud = argc > 3 ? std::atoi(argv[3]) : 9600;
+
+	std::printf("%5s %9s %9s %9s %10s %8s %8s %6s %6s\n",
+	            "doors", "polls/s", "rtt p50", "rtt p99", "events/s", "lost", "timeouts", "boots", "wrong");
+	unsigned wrong = 0;
+	try {
+		for (unsigned doors : {1u, 2u, 4u, 8u, 16u, 32u, 64u, 128u}) {
+			door::BusSimConfig cfg;
+			cfg.doors = doors;
+			cfg.events_per_s = rate;
+			cfg.baud = baud;
+			door::BusSim sim(cfg);
+			sim.start();
+
+			int fd = door::open_serial(sim.device(), baud > 0 ? baud : 9600);
+			door::BusMaster bus(fd);
+			door::LatencyStats rtt;
+			uint64_t polls = 0, events = 0, lost = 0, timeouts = 0, boots = 0;
+			unsigned bad = 0;
+			std::vector<int> next(doors + 1, 0);    // Sequence number expected
+
+			// Dropped events take no sequence number, a reset starts
+			// over at EV_BOOT
+			const auto take = [&](unsigned a, const door::PollResult &r) {
+				for (const door::BusEvent &e : r.events) {
+					if (e.type == EV_BOOT && e.seq == 0) {
+						boots++;
+						next[a] = 0;
+					}
+					bad += e.seq != next[a];
+					next[a] = (e.seq + 1) & 0xFF;
+				}
+			};
+
+			const uint64_t t0 = door::now_ns();
+			const uint64_t end = t0 + static_cast<uint64_t>(seconds * 1e9);
+			bool reset = false;
+			while (door::now_ns() < end) {
+				for (unsigned a = 1; a <= doors; a++) {
+					if (!reset && door::now_ns() >= t0 + (end - t0) / 2) {
+						sim.reset(1);
+						reset = true;
+					}
+					door::PollResult r = bus.poll(static_cast<uint8_t>(a), 100);
+					polls++;
+					if (!r.answered) {
+						timeouts++;
+						continue;
+					}
+					rtt.add(r.rtt_ns);
+					events += r.events.size();
+					lost += r.lost;
+					take(a, r);
+				}
+			}
+			// A big bus may not have come back to door 1 since
+			for (int i = 0; i < 10 && boots < doors + sim.resets(); i++)
+				take(1, bus.poll(1, 100));
+			const double elapsed = (door::now_ns() - t0) / 1e9;
+			sim.stop();
+			::close(fd);
+			bad += boots != doors + sim.resets();
+			wrong += bad;
+
+			std::printf("%5u %9.1f %7.2fms %7.2fms %10.1f %8llu %8llu %6llu %6u\n", doors,
+			            polls / elapsed, rtt.percentile(50) / 1e6, rtt.percentile(99) / 1e6,
+			            events / elapsed, static_cast<unsigned long long>(lost),
+			            static_cast<unsigned long long>(timeouts),
+			            static_cast<unsigned long long>(boots), bad);
+		}
+	} catch (const std::exception &e) {
+		std::fprintf(stderr, "doorbus_bench: %s\n", e.what());
+		return 1;
+	}
+	return wrong ? 1 : 0;
+}
@@ -0,0 +1,358 @@
+// Polls the doors on an RS-485 bus and prints their events.
+//
+//     doorbus_master <device> [first addr] [last addr] [baud]
+//     doorbus_master <device> --set-addr <addr> <new addr> [baud]
+//     doorbus_master <device> --stack <addr> [baud]
+//     doorbus_master <device> --sound <addr> [<event> <melody> [baud]]
+//     doorbus_master <device> --tx <addr> [baud]
+//     doorbus_master <device> --batch <addr> [baud]
+//     doorbus_master <device> --config <addr> [<field> <value> [baud]]
+//     doorbus_master <device> --time <addr> [<unix>|now [baud]]
+//     doorbus_master <device> --schedule <addr> <n> [<hours> [baud]]
+//
+// The hours of a schedule are day ranges with hour ranges, local time,
+// the end hour not included: "mon-fri/8-18,sat/9-13". "all" and "none"
+// set every or no hour.
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include "bus_master.hpp"
+#include "events.hpp"
+#include "serial.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <exception>
+#include <string>
+
+extern "C" {
+#include "bus.h"
+#include "config.h"
+#include "rtc.h"
+#include "schedule.h"
+#include "sound.h"
+#include "stack.h"
+}
+
+namespace {
+
+int usage()
+{
+	std::fprintf(stderr,
+		"usage: doorbus_master <device> [first addr] [last addr] [baud]\n"
+		"       doorbus_master <device> --set-addr <addr> <new addr> [baud]\n"
+		"       doorbus_master <device> --stack <addr> [baud]\n"
+		"       doorbus_master <device> --sound <addr> [<event> <melody> [baud]]\n"
+		"       doorbus_master <device> --tx <addr> [baud]\n"
+		"       doorbus_master <device> --batch <addr> [baud]\n"
+		"       doorbus_master <device> --config <addr> [<field> <value> [baud]]\n"
+		"       doorbus_master <device> --time <addr> [<unix>|now [baud]]\n"
+		"       doorbus_master <device> --schedule <addr> <n> [<hours> [baud]]\n");
+	return 2;
+}
+
+// SRAM use and interrupt nesting of one door, see stack.h
+int print_stack(door::BusMaster &bus, uint8_t addr)
+{
+	static const char *const isrs[STACK_ISRS] = {
+		"TIMER0_OVF", "TIMER1_COMPA", "TIMER2_OVF", "USART_RX", "USART_UDRE", "USART_TX",
+		"PCINT2", "TIMER2_COMPB", "EE_READY",
+	};
+	std::vector<uint8_t> r;
+	if (!bus.request(addr, FT_STACK_INFO, nullptr, 0, 200, r) || r.size() < STACK_INFO_LEN) {
+		std::fprintf(stderr, "door %u did not answer\n", addr);
+		return 1;
+	}
+	const auto u16 = [&](size_t i) { return static_cast<unsigned>(r[i] | r[i + 1] << 8); };
+	std::printf("door %u\n", addr);
+	std::printf("  stack free  %5u of %u bytes\n", u16(0), u16(2));
+	std::printf("  .data       %5u bytes\n", u16(4));
+	std::printf("  .bss        %5u bytes\n", u16(6));
+	for (unsigned i = 0; i < STACK_ISRS; i++)
+		std::printf("  %-12s nesting %u\n", isrs[i], r[8 + i]);
+	return 0;
+}
+
+// Melody of every sound event of one door, see sound.h. With an event
+// and a melody that event is set first.
+int sound_map(door::BusMaster &bus, uint8_t addr, const uint8_t *set)
+{
+	static const char *const events[SOUND_EVENTS] = {"key", "correct", "wrong", "doorbell"};
+	std::vector<uint8_t> r;
+	if (!bus.request(addr, FT_SOUND, set, set ? 2 : 0, 200, r) || r.size() < SOUND_EVENTS) {
+		std::fprintf(stderr, "door %u did not answer\n", addr);
+		return 1;
+	}
+	std::printf("door %u\n", addr);
+	for (unsigned i = 0; i < SOUND_EVENTS; i++)
+		std::printf("  %-9s melody %u\n", events[i], r[i]);
+	return 0;
+}
+
+// Dropped bytes and peak fill of the UART transmit lanes of one door,
+// see uart.h
+int print_tx(door::BusMaster &bus, uint8_t addr)
+{
+	static const char *const lanes[2] = {"high", "low"};
+	std::vector<uint8_t> r;
+	if (!bus.request(addr, FT_TX_STATS, nullptr, 0, 200, r) || r.size() < TX_STATS_LEN) {
+		std::fprintf(stderr, "door %u did not answer\n", addr);
+		return 1;
+	}
+	std::printf("door %u\n", addr);
+	for (unsigned i = 0; i < 2; i++)
+		std::printf("  %-4s lane  dropped %5u  peak %3u bytes\n", lanes[i],
+		            r[3 * i] | r[3 * i + 1] << 8, r[3 * i + 2]);
+	return 0;
+}
+
+// Histograms of the stream mode batches of one door, see bus.h
+int print_batch(door::BusMaster &bus, uint8_t addr)
+{
+	static const char *const sizes[BUS_HIST_SIZES] = {"1", "2-3", "4-7", "8+"};
+	std::vector<uint8_t> r;
+	if (!bus.request(addr, FT_BATCH_STATS, nullptr, 0, 200, r) || r.size() < BATCH_STATS_LEN) {
+		std::fprintf(stderr, "door %u did not answer\n", addr);
+		return 1;
+	}
+	const auto u16 = [&](size_t i) { return static_cast<unsigned>(r[2 * i] | r[2 * i + 1] << 8); };
+	std::printf("door %u\n", addr);
+	for (unsigned i = 0; i < BUS_HIST_SIZES; i++)
+		std::printf("  %-3s events   %5u batches\n", sizes[i], u16(i));
+	for (unsigned i = 0; i < BUS_HIST_LATENCIES; i++) {
+		const double lo = (i ? 1u << (i - 1) : 0) * EVENT_TICK_US / 1e3;
+		std::printf("  %s%6.0f ms  %5u events\n", i == BUS_HIST_LATENCIES - 1 ? ">=" : "  ", lo,
+		            u16(BUS_HIST_SIZES + i));
+	}
+	return 0;
+}
+
+// Settings of one door, see config.h, and a change of one
+int print_config(door::BusMaster &bus, uint8_t addr, const char *field, const char *value)
+{
+	static const char *const fields[CONFIG_FIELDS] = {
+		"entry", "hold", "unlock", "pullin", "duty", "baud", "window", "batch", "tz",
+	};
+	static const char *const status[] = {"ok", "no such field", "out of range"};
+	uint8_t req[3] = {0, 0, 0};
+	if (field) {
+		while (req[0] < CONFIG_FIELDS && std::strcmp(fields[req[0]], field) != 0)
+			req[0]++;
+		if (req[0] == CONFIG_FIELDS) {
+			std::fprintf(stderr, "no field %s\n", field);
+			return 2;
+		}
+		const unsigned long v = std::strtoul(value, nullptr, 10);
+		req[1] = static_cast<uint8_t>(v);
+		req[2] = static_cast<uint8_t>(v >> 8);
+	}
+	std::vector<uint8_t> r;
+	if (!bus.request(addr, FT_CONFIG, req, field ? 3 : 0, 500, r) || r.size() < 4 ||
+	    r.size() < 4u + 2 * r[3]) {
+		std::fprintf(stderr, "door %u did not answer\n", addr);
+		return 1;
+	}
+	std::printf("door %u, generation %u, schema %u%s%s\n", addr, r[1], r[2], field ? ", " : "",
+	            field ? (r[0] < 3 ? status[r[0]] : "refused") : "");
+	for (unsigned i = 0; i < r[3]; i++)
+		std::printf("  %-7s %5u\n", i < CONFIG_FIELDS ? fields[i] : "?", r[4 + 2 * i] | r[5 + 2 * i] << 8);
+	return r[0] == CONFIG_OK ? 0 : 1;
+}
+
+// Clock of one door, see rtc.h, and a setting of it
+int print_time(door::BusMaster &bus, uint8_t addr, const char *set)
+{
+	uint8_t req[4];
+	if (set) {
+		const unsigned long t = std::strcmp(set, "now") == 0 ? static_cast<unsigned long>(std::time(nullptr))
+		                                                     : std::strtoul(set, nullptr, 10);
+		for (unsigned i = 0; i < 4; i++)
+			req[i] = static_cast<uint8_t>(t >> (8 * i));
+	}
+	std::vector<uint8_t> r;
+	if (!bus.request(addr, FT_TIME, req, set ? 4 : 0, 200, r) || r.size() < RTC_REPLY_LEN) {
+		std::fprintf(stderr, "door %u did not answer\n", addr);
+		return 1;
+	}
+	const unsigned long t = r[1] | r[2] << 8 | r[3] << 16 | static_cast<unsigned long>(r[4]) << 24;
+	const double ppm = static_cast<int16_t>(r[5] | r[6] << 8) * 1e6 / RTC_TRIM_ONE;
+	if (r[0])
+		std::printf("door %u, time %lu, trim %+.1f ppm\n", addr, t, ppm);
+	else
+		std::printf("door %u, time not set, trim %+.1f ppm\n", addr, ppm);
+	return 0;
+}
+
+const char *const kDays[7] = {"mon", "tue", "wed", "thu", "fri", "sat", "sun"};
+
+int day_of(const std::string &s)
+{
+	for (int d = 0; d < 7; d++)
+		if (s == kDays[d])
+			return d;
+	return -1;
+}
+
+// "mon-fri/8-18,sat/9-13" into the bits of schedule.h, false when malformed
+bool parse_hours(const std::string &spec, uint8_t *hours)
+{
+	std::fill_n(hours, SCHEDULE_LEN, spec == "all" ? 0xFF : 0);
+	if (spec == "all" || spec == "none")
+		return true;
+	size_t at = 0;
+	while (at < spec.size()) {
+		size_t end = spec.find(',', at);
+		if (end == std::string::npos)
+			end = spec.size();
+		const std::string part = spec.substr(at, end - at);
+		at = end + 1;
+
+		const size_t slash = part.find('/');
+		if (slash == std::string::npos)
+			return false;
+		const std::string days = part.substr(0, slash);
+		const size_t dash = days.find('-');
+		const int d0 = day_of(days.substr(0, dash));
+		const int d1 = dash == std::string::npos ? d0 : day_of(days.substr(dash + 1));
+		unsigned h0 = 0, h1 = 0;
+		if (d0 < 0 || d1 < d0 || std::sscanf(part.c_str() + slash + 1, "%u-%u", &h0, &h1) != 2 ||
+		    h0 >= h1 || h1 > 24)
+			return false;
+		for (int d = d0; d <= d1; d++)
+			for (unsigned h = h0; h < h1; h++) {
+				const unsigned bit = d * 24 + h;
+				hours[bit / 8] |= static_cast<uint8_t>(1u << (bit % 8));
+			}
+	}
+	return true;
+}
+
+// Access schedule of one door, see schedule.h, and a change of it
+int print_schedule(door::BusMaster &bus, uint8_t addr, uint8_t n, const char *spec)
+{
+	uint8_t req[1 + SCHEDULE_LEN] = {n};
+	if (spec && !parse_hours(spec, req + 1)) {
+		std::fprintf(stderr, "bad hours %s, e.g. mon-fri/8-18,sat/9-13\n", spec);
+		return 2;
+	}
+	std::vector<uint8_t> r;
+	if (!bus.request(addr, FT_SCHEDULE, req, spec ? sizeof req : 1, 500, r) || r.size() < 2) {
+		std::fprintf(stderr, "door %u did not answer\n", addr);
+		return 1;
+	}
+	if (r[0] != SCHEDULE_OK || r.size() < SCHEDULE_REPLY_LEN) {
+		std::fprintf(stderr, "door %u has no schedule %u, 1 to %u\n", addr, n, SCHEDULE_COUNT);
+		return 1;
+	}
+	std::printf("door %u, schedule %u\n  hour 0     6     12    18\n", addr, n);
+	for (unsigned d = 0; d < 7; d++) {
+		std::printf("  %s  ", kDays[d]);
+		for (unsigned h = 0; h < 24; h++) {
+			const unsigned bit = d * 24 + h;
+			std::putchar(r[2 + bit / 8] >> (bit % 8) & 1 ? '#' : '.');
+		}
+		std::putchar('\n');
+	}
+	return 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	if (argc < 2)
+		return usage();
+
+	try {
+		if (argc >= 5 && std::strcmp(argv[2], "--set-addr") == 0) {
+			const int baud = argc > 5 ? std::atoi(argv[5]) : 9600;
+			door::BusMaster bus(door::open_serial(argv[1], baud));
+			const auto addr = static_cast<uint8_t>(std::atoi(argv[3]));
+			const auto new_addr = static_cast<uint8_t>(std::atoi(argv[4]));
+			if (!bus.set_address(addr, new_addr, BUS_MODE_POLLED, 200)) {
+				std::fprintf(stderr, "door %u did not answer\n", addr);
+				return 1;
+			}
+			std::printf("door %u is now %u\n", addr, new_addr);
+			return 0;
+		}
+
+		if (argc >= 4 && std::strcmp(argv[2], "--stack") == 0) {
+			const int baud = argc > 4 ? std::atoi(argv[4]) : 9600;
+			door::BusMaster bus(door::open_serial(argv[1], baud));
+			return print_stack(bus, static_cast<uint8_t>(std::atoi(argv[3])));
+		}
+
+		if (argc >= 4 && std::strcmp(argv[2], "--sound") == 0) {
+			const bool set = argc >= 6;
+			const int baud = set ? (argc > 6 ? std::atoi(argv[6]) : 9600)
+			                     : (argc > 4 ? std::atoi(argv[4]) : 9600);
+			const uint8_t req[2] = {static_cast<uint8_t>(set ? std::atoi(argv[4]) : 0),
+			                        static_cast<uint8_t>(set ? std::atoi(argv[5]) : 0)};
+			door::BusMaster bus(door::open_serial(argv[1], baud));
+			return sound_map(bus, static_cast<uint8_t>(std::atoi(argv[3])), set ? req : nullptr);
+		}
+
+		if (argc >= 4 && std::strcmp(argv[2], "--tx") == 0) {
+			const int baud = argc > 4 ? std::atoi(argv[4]) : 9600;
+			door::BusMaster bus(door::open_serial(argv[1], baud));
+			return print_tx(bus, static_cast<uint8_t>(std::atoi(argv[3])));
+		}
+
+		if (argc >= 4 && std::strcmp(argv[2], "--batch") == 0) {
+			const int baud = argc > 4 ? std::atoi(argv[4]) : 9600;
+			door::BusMaster bus(door::open_serial(argv[1], baud));
+			return print_batch(bus, static_cast<uint8_t>(std::atoi(argv[3])));
+		}
+
+		if (argc >= 4 && std::strcmp(argv[2], "--config") == 0) {
+			const bool set = argc >= 6;
+			const int baud = set ? (argc > 6 ? std::atoi(argv[6]) : 9600)
+			                     : (argc > 4 ? std::atoi(argv[4]) : 9600);
+			door::BusMaster bus(door::open_serial(argv[1], baud));
+			return print_config(bus, static_cast<uint8_t>(std::atoi(argv[3])), set ? argv[4] : nullptr,
+			                    set ? argv[5] : nullptr);
+		}
+
+		if (argc >= 4 && std::strcmp(argv[2], "--time") == 0) {
+			const int baud = argc > 5 ? std::atoi(argv[5]) : 9600;
+			door::BusMaster bus(door::open_serial(argv[1], baud));
+			return print_time(bus, static_cast<uint8_t>(std::atoi(argv[3])), argc > 4 ? argv[4] : nullptr);
+		}
+
+		if (argc >= 5 && std::strcmp(argv[2], "--schedule") == 0) {
+			const int baud = argc > 6 ? std::atoi(argv[6]) : 9600;
+			door::BusMaster bus(door::open_serial(argv[1], baud));
+			return print_schedule(bus, static_cast<uint8_t>(std::atoi(argv[3])),
+			                      static_cast<uint8_t>(std::atoi(argv[4])), argc > 5 ? argv[5] : nullptr);
+		}
+
+		const int first = argc > 2 ? std::atoi(argv[2]) : 1;
+		const int last = argc > 3 ? std::atoi(argv[3]) : first;
+		const int baud = argc > 4 ? std::atoi(argv[4]) : 9600;
+		if (first < 1 || last > FRAME_ADDR_MAX || first > last)
+			return usage();
+
+		door::BusMaster bus(door::open_serial(argv[1], baud));
+		for (;;) {
+			for (int a = first; a <= last; a++) {
+				door::PollResult r = bus.poll(static_cast<uint8_t>(a), 100);
+				if (!r.answered)
+					continue;
+				if (r.lost)
+					std::printf("door %3d lost %u events\n", a, r.lost);
+				for (const auto &ev : r.events)
+					std::printf("door %3d t=%5us #%3u %-7s %u\n", a, ev.time, ev.seq,
+					            door::event_name(ev.type), ev.arg);
+			}
+			std::fflush(stdout);
+		}
+	} catch (const std::exception &e) {
+		std::fprintf(stderr, "doorbus_master: %s\n", e.what());
+		return 1;
+	}
+}
@@ -0,0 +1,199 @@
+// Fuzz target for the door logic (door.c) on the host HAL.
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include "door_fuzz.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "door.h"
+#include "hal.h"
+#include "lcdfb.h"
+#include "pin.h"
+#include "sim.h"
+#include "sound.h"
+#include "users.h"
+}
+
+namespace door {
+
+namespace {
+
+constexpr unsigned kSoundMax = SOUND_TICKS_MAX;  // Longest melody
+constexpr unsigned kIdleSeconds = 10;
+
+void start_door()
+{
+	static bool users = false;
+	if (!users) {
+		// Default users, both banks equal
+		sim_eeprom_erase();
+		users_init();
+		for (unsigned i = 0; i < USERS_MAX; i++)
+			users_task();
+		users = true;
+	}
+	hal_init(0);
+	door_init();
+}
+
+class Checker {
+public:
+	Checker() : rises_(sim_pin_rises(HAL_RELAY)) {}
+
+	// The checker does not know whether a * started an entry, so every
+	// * opens one. # ends them all after the check of its press, digits
+	// past PIN_MAX are dropped. The key pad tick of a key may still show
+	// the answer to what was typed before it, that counts for its check
+	void key(uint8_t k)
+	{
+		last_ = entries_;
+		if (ended_)
+			entries_.clear();
+		ended_ = k == '#';
+		if (k == '*') {
+			entries_.emplace_back();
+		} else if (k != '#') {
+			for (auto &e : entries_)
+				if (e.size() < PIN_MAX)
+					e += static_cast<char>(k);
+		}
+		sim_key(k);
+		keypad();
+	}
+
+	// The main loop runs after every key pad tick, the next one takes
+	// its answer
+	void keypad()
+	{
+		door_tick_keypad();
+		door_task();
+	}
+
+	void sound()
+	{
+		door_tick_sound();
+	}
+
+	// Checked after every operation
+	bool check(std::string *why)
+	{
+		if (sim_pin_rises(HAL_RELAY) != rises_) {
+			rises_ = sim_pin_rises(HAL_RELAY);
+			if (!typed_user(entries_) && !typed_user(last_)) {
+				*why = "relay on after " + (entries_.empty() ? "no entry" : entries_.back());
+				return false;
+			}
+		}
+		if (sim_pin(HAL_RELAY) && sim_pin(HAL_LED_RED)) {
+			*why = "relay and red led on";
+			return false;
+		}
+		last_.clear();
+		return true;
+	}
+
+	// Only the sound ticks run, no sequence can start
+	bool check_sound_ends(std::string *why)
+	{
+		for (unsigned i = 0; i <= kSoundMax; i++)
+			sound();
+		if (sim_pin(HAL_BUZZER) || sim_pin(HAL_BELL) || sim_chime()) {
+			*why = "sound still on after " + std::to_string(kSoundMax) + " sound ticks";
+			return false;
+		}
+		return true;
+	}
+
+	// No keys. Without a key the key pad tick only acts on what the
+	// second tick changed, a few of them per second are enough
+	bool check_standby(std::string *why)
+	{
+		for (unsigned s = 0; s < kIdleSeconds; s++) {
+			door_tick_second();
+			keypad();
+			keypad();
+			for (unsigned t = 0; t < 1000 / DOOR_SOUND_MS; t++)
+				sound();
+			if (!check(why))
+				return false;
+		}
+		lcdfb_flush();
+		if (sim_pin(HAL_RELAY) || sim_pin(HAL_LED_RED) || sim_pin(HAL_LED_GREEN) ||
+		    sim_pin(HAL_BUZZER) || sim_pin(HAL_BELL) || sim_chime() ||
+		    std::strstr(sim_display_line(0), "Dumbledoor wishes") == nullptr) {
+			*why = "not in standby after " + std::to_string(kIdleSeconds) + " s";
+			return false;
+		}
+		return true;
+	}
+
+private:
+	static bool typed_user(const std::vector<std::string> &entries)
+	{
+		for (const auto &e : entries)
+			if (e.size() >= PIN_MIN &&
+			    users_find(e.data(), static_cast<uint8_t>(e.size())) >= 0)
+				return true;
+		return false;
+	}
+
+	std::vector<std::string> entries_;
+	std::vector<std::string> last_;
+	bool ended_ = false;
+	uint64_t rises_;
+};
+
+} // namespace
+
+bool fuzz_door(const uint8_t *data, size_t size, std::string *why)
+{
+	start_door();
+	Checker c;
+
+	for (size_t i = 0; i < size; i++) {
+		const uint8_t op = data[i] & 0x0F;
+		const unsigned n = (data[i] >> 4) + 1;
+
+		if (op <= 9)
+			c.key(static_cast<uint8_t>('0' + op));
+		else if (op == 0xA)
+			c.key('*');
+		else if (op == 0xB)
+			c.key('#');
+		else if (op == 0xC)
+			for (unsigned k = 0; k < n; k++)
+				c.keypad();
+		else if (op == 0xD)
+			for (unsigned k = 0; k < n; k++)
+				door_tick_second();
+		else if (op == 0xE)
+			for (unsigned k = 0; k < n; k++)
+				c.sound();
+		else
+			lcdfb_flush();
+
+		if (!c.check(why))
+			return false;
+	}
+	return c.check_sound_ends(why) && c.check_standby(why);
+}
+
+} // namespace door
+
+// libFuzzer entry, a broken rule is a crash
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+	std::string why;
+	if (!door::fuzz_door(data, size, &why)) {
+		std::fprintf(stderr, "doorfuzz: %s\n", why.c_str());
+		std::abort();
+	}
+	return 0;
+}
@@ -0,0 +1,37 @@
+// Fuzz target for the door logic (door.c) on the host HAL.
+//
+// An input is a sequence of one byte operations. The low nibble selects
+// the operation, the high nibble repeats the ticks:
+//
+//     0x0..0x9  key pad tick with that digit pressed
+//     0xA       key pad tick with '*'
+//     0xB       key pad tick with '#'
+//     0xC       (n + 1) key pad ticks without a key
+//     0xD       (n + 1) second ticks
+//     0xE       (n + 1) sound ticks
+//     0xF       main loop: lcdfb_flush()
+//
+// On the AVR the tick handlers run in interrupts which do not nest, so
+// any order of whole ticks is one the door can see.
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace door {
+
+// Runs one input from a freshly started door and checks that
+//   - the relay only goes high when the last four digits typed are the
+//     pin of a user,
+//   - the relay and the red led are never on together,
+//   - every buzzer and bell sequence ends within 100 sound ticks,
+//   - the door is back in standby after 10 seconds without keys.
+// Returns false with the broken rule in why.
+bool fuzz_door(const uint8_t *data, size_t size, std::string *why);
+
+} // namespace door
@@ -0,0 +1,307 @@
+// Stand-alone driver for the door fuzz target, for compilers without
+// libFuzzer. With the door sources built with -fsanitize-coverage=trace-pc
+// it is coverage guided: a mutated input is kept when it reaches an edge,
+// or an edge count class, no earlier input reached.
+//
+// Usage: doorfuzz [-t seconds] [-o dir] [-x dict] [-s seed] corpus...
+//
+// Every input in the corpus files and directories is run first, a
+// broken rule there fails the run. With -t the inputs are mutated for
+// that long, new inputs are written to -o, a failing input to
+// crash-<hash> in the current directory. Built with AFL's compiler the
+// driver runs a single file: doorfuzz @@.
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include "door_fuzz.hpp"
+#include "serial.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+using Input = std::vector<uint8_t>;
+
+constexpr size_t kMapSize = 8192;
+constexpr size_t kMaxLen = 512;
+
+uint8_t cov[kMapSize];
+uintptr_t covPrev;
+
+} // namespace
+
+// Called by every instrumented edge of the door sources
+extern "C" void __sanitizer_cov_trace_pc(void)
+{
+	const uintptr_t pc = reinterpret_cast<uintptr_t>(__builtin_return_address(0));
+	cov[(pc ^ covPrev) % kMapSize]++;
+	covPrev = pc >> 1;
+}
+
+namespace {
+
+// Hit counts in classes, as AFL does: 1, 2, 3, 4-7, 8-15, 16-31, 32-127, 128+
+uint8_t count_class(uint8_t n)
+{
+	if (n <= 3)
+		return n ? static_cast<uint8_t>(1 << (n - 1)) : 0;
+	if (n < 8)
+		return 8;
+	if (n < 16)
+		return 16;
+	if (n < 32)
+		return 32;
+	return n < 128 ? 64 : 128;
+}
+
+class Fuzzer {
+public:
+	explicit Fuzzer(uint32_t seed) : rng_(seed) {}
+
+	// Runs an input, returns false when it breaks a rule
+	bool run(const Input &in, std::string *why, bool *fresh)
+	{
+		std::memset(cov, 0, sizeof cov);
+		covPrev = 0;
+		const bool ok = door::fuzz_door(in.data(), in.size(), why);
+		execs_++;
+
+		*fresh = false;
+		for (size_t i = 0; i < kMapSize; i++) {
+			if (!cov[i])
+				continue;
+			const uint8_t c = count_class(cov[i]);
+			if (!(seen_[i] & c)) {
+				if (!seen_[i])
+					edges_++;
+				seen_[i] |= c;
+				*fresh = true;
+			}
+		}
+		return ok;
+	}
+
+	void add(Input in) { corpus_.push_back(std::move(in)); }
+	void add_token(Input t) { dict_.push_back(std::move(t)); }
+
+	Input mutate()
+	{
+		Input in = corpus_.empty() ? Input{} : corpus_[rng_() % corpus_.size()];
+		const unsigned stack = 1 + rng_() % 8;
+
+		for (unsigned i = 0; i < stack; i++) {
+			const size_t pos = in.empty() ? 0 : rng_() % (in.size() + 1);
+			switch (rng_() % 7) {
+			case 0:     // Flip a bit
+				if (!in.empty())
+					in[rng_() % in.size()] ^= static_cast<uint8_t>(1 << (rng_() % 8));
+				break;
+			case 1:     // New operation
+				if (!in.empty())
+					in[rng_() % in.size()] = static_cast<uint8_t>(rng_());
+				break;
+			case 2:     // Insert an operation
+				in.insert(in.begin() + static_cast<long>(pos), static_cast<uint8_t>(rng_()));
+				break;
+			case 3:     // Delete a run
+				if (pos < in.size()) {
+					const size_t n = std::min<size_t>(1 + rng_() % 8, in.size() - pos);
+					in.erase(in.begin() + static_cast<long>(pos), in.begin() + static_cast<long>(pos + n));
+				}
+				break;
+			case 4:     // Repeat a run
+				if (pos < in.size()) {
+					const size_t n = std::min<size_t>(1 + rng_() % 8, in.size() - pos);
+					Input run(in.begin() + static_cast<long>(pos), in.begin() + static_cast<long>(pos + n));
+					in.insert(in.begin() + static_cast<long>(pos), run.begin(), run.end());
+				}
+				break;
+			case 5:     // Splice in part of another input
+				if (!corpus_.empty()) {
+					const Input &o = corpus_[rng_() % corpus_.size()];
+					if (!o.empty()) {
+						const size_t from = rng_() % o.size();
+						const size_t n = 1 + rng_() % (o.size() - from);
+						in.insert(in.begin() + static_cast<long>(pos), o.begin() + static_cast<long>(from),
+						          o.begin() + static_cast<long>(from + n));
+					}
+				}
+				break;
+			default:    // Dictionary token
+				if (!dict_.empty()) {
+					const Input &t = dict_[rng_() % dict_.size()];
+					in.insert(in.begin() + static_cast<long>(pos), t.begin(), t.end());
+				}
+				break;
+			}
+		}
+		if (in.size() > kMaxLen)
+			in.resize(kMaxLen);
+		return in;
+	}
+
+	uint64_t execs() const { return execs_; }
+	size_t edges() const { return edges_; }
+	size_t corpus_size() const { return corpus_.size(); }
+
+private:
+	std::mt19937 rng_;
+	std::vector<Input> corpus_;
+	std::vector<Input> dict_;
+	uint8_t seen_[kMapSize] = {};
+	uint64_t execs_ = 0;
+	size_t edges_ = 0;
+};
+
+Input read_file(const fs::path &p)
+{
+	std::ifstream f(p, std::ios::binary);
+	return Input(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+}
+
+std::string hash_name(const Input &in)
+{
+	uint64_t h = 1469598103934665603ULL;       // FNV-1a
+	for (uint8_t b : in)
+		h = (h ^ b) * 1099511628211ULL;
+	char name[20];
+	std::snprintf(name, sizeof name, "%016llx", static_cast<unsigned long long>(h));
+	return name;
+}
+
+void write_file(const fs::path &p, const Input &in)
+{
+	std::ofstream f(p, std::ios::binary);
+	f.write(reinterpret_cast<const char *>(in.data()), static_cast<std::streamsize>(in.size()));
+}
+
+// libFuzzer dictionary: one "..." token per line, \xNN escapes
+void read_dict(const char *path, Fuzzer &fz)
+{
+	std::ifstream f(path);
+	std::string line;
+	while (std::getline(f, line)) {
+		const size_t a = line.find('"');
+		const size_t b = line.rfind('"');
+		if (line.empty() || line[0] == '#' || a == std::string::npos || b <= a)
+			continue;
+		Input t;
+		for (size_t i = a + 1; i < b; i++) {
+			if (line[i] == '\\' && i + 3 < b && line[i + 1] == 'x') {
+				t.push_back(static_cast<uint8_t>(std::strtoul(line.substr(i + 2, 2).c_str(), nullptr, 16)));
+				i += 3;
+			} else {
+				t.push_back(static_cast<uint8_t>(line[i]));
+			}
+		}
+		if (!t.empty())
+			fz.add_token(std::move(t));
+	}
+}
+
+void usage()
+{
+	std::fprintf(stderr, "usage: doorfuzz [-t seconds] [-o dir] [-x dict] [-s seed] corpus...\n");
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	double seconds = 0;
+	const char *out = nullptr;
+	const char *dict = nullptr;
+	uint32_t seed = 1;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "t:o:x:s:")) != -1) {
+		switch (opt) {
+		case 't': seconds = std::atof(optarg); break;
+		case 'o': out = optarg; break;
+		case 'x': dict = optarg; break;
+		case 's': seed = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 0)); break;
+		default: usage(); return 2;
+		}
+	}
+	if (optind >= argc) {
+		usage();
+		return 2;
+	}
+
+	Fuzzer fz(seed);
+	if (dict)
+		read_dict(dict, fz);
+
+	// The corpus is the regression suite, every input must pass
+	std::string why;
+	bool fresh;
+	unsigned failed = 0;
+	for (int i = optind; i < argc; i++) {
+		std::vector<fs::path> files;
+		if (fs::is_directory(argv[i])) {
+			for (const auto &e : fs::directory_iterator(argv[i]))
+				if (e.is_regular_file())
+					files.push_back(e.path());
+		} else {
+			files.push_back(argv[i]);
+		}
+		for (const fs::path &p : files) {
+			Input in = read_file(p);
+			if (!fz.run(in, &why, &fresh)) {
+				std::fprintf(stderr, "doorfuzz: %s: %s\n", p.c_str(), why.c_str());
+				failed++;
+			}
+			fz.add(std::move(in));
+		}
+	}
+	std::printf("corpus      %zu inputs, %zu edges, %u failed\n", fz.corpus_size(), fz.edges(), failed);
+	if (failed || seconds <= 0)
+		return failed ? 1 : 0;
+
+	const uint64_t t0 = door::now_ns();
+	const uint64_t end = t0 + static_cast<uint64_t>(seconds * 1e9);
+	uint64_t report = t0 + 1000000000ULL;
+	const uint64_t execs0 = fz.execs();
+	for (;;) {
+		Input in = fz.mutate();
+		if (!fz.run(in, &why, &fresh)) {
+			const std::string name = "crash-" + hash_name(in);
+			write_file(name, in);
+			std::fprintf(stderr, "doorfuzz: %s, input written to %s\n", why.c_str(), name.c_str());
+			return 1;
+		}
+		if (fresh) {
+			if (out)
+				write_file(fs::path(out) / hash_name(in), in);
+			fz.add(std::move(in));
+		}
+
+		if ((fz.execs() & 255) == 0) {
+			const uint64_t now = door::now_ns();
+			if (now >= report || now >= end) {
+				const double s = static_cast<double>(now - t0) / 1e9;
+				std::printf("%6.0f s  %10llu execs  %8.0f exec/s  %5zu inputs  %5zu edges\n", s,
+				            static_cast<unsigned long long>(fz.execs() - execs0),
+				            static_cast<double>(fz.execs() - execs0) / s, fz.corpus_size(), fz.edges());
+				std::fflush(stdout);
+				report = now + 1000000000ULL;
+			}
+			if (now >= end)
+				break;
+		}
+	}
+	return 0;
+}
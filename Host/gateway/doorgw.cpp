@@ -0,0 +1,76 @@
+// Fleet gateway daemon.
+//
+//     doorgw [-b baud] [-l log] [-s socket] [-f] device...
+//
+// Reads the events of doors in stream mode (see bus.h), appends them to
+// the log and sends them to every client connected to the socket, one
+// text line per event. SIGINT/SIGTERM stop it and print statistics.
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include "gateway.hpp"
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <unistd.h>
+
+namespace {
+
+door::Gateway *running = nullptr;
+
+void on_signal(int)
+{
+	if (running)
+		running->stop();
+}
+
+int usage()
+{
+	std::fprintf(stderr, "usage: doorgw [-b baud] [-l log] [-s socket] [-f] device...\n");
+	return 2;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	door::GatewayConfig cfg;
+	int opt;
+	while ((opt = getopt(argc, argv, "b:l:s:f")) != -1) {
+		switch (opt) {
+		case 'b': cfg.baud = std::atoi(optarg); break;
+		case 'l': cfg.log_path = optarg; break;
+		case 's': cfg.socket_path = optarg; break;
+		case 'f': cfg.fsync_log = true; break;
+		default: return usage();
+		}
+	}
+	for (int i = optind; i < argc; i++)
+		cfg.devices.emplace_back(argv[i]);
+	if (cfg.devices.empty())
+		return usage();
+
+	try {
+		door::Gateway gw(cfg);
+		running = &gw;
+		std::signal(SIGINT, on_signal);
+		std::signal(SIGTERM, on_signal);
+		gw.run();
+		running = nullptr;
+
+		const auto &s = gw.stats();
+		std::fprintf(stderr, "frames %llu, events %llu, duplicates %llu, lost %llu, garbage %llu bytes\n",
+		             static_cast<unsigned long long>(s.frames.load()),
+		             static_cast<unsigned long long>(s.events.load()),
+		             static_cast<unsigned long long>(s.duplicates.load()),
+		             static_cast<unsigned long long>(s.lost.load()),
+		             static_cast<unsigned long long>(s.garbage.load()));
+	} catch (const std::exception &e) {
+		std::fprintf(stderr, "doorgw: %s\n", e.what());
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,336 @@
+// Load generator for the fleet gateway.
+//
+//     doorload [-n doors,doors,...] [-r events/s per door] [-t seconds] [-l log]
+//
+// Simulates doors in stream mode on pseudo-terminals, runs a gateway on
+// them and subscribes to it. Every event is timed from the moment the
+// door creates it to the moment the subscriber reads its line, so the
+// latency covers the door push, the PTY, parsing, the log write and the
+// socket fan out. Every door starts with EV_BOOT and halfway through
+// the first door resets, all the boots must reach the subscriber.
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include "frame.hpp"
+#include "gateway.hpp"
+#include "serial.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+extern "C" {
+#include "bus.h"
+}
+
+namespace {
+
+// Door in stream mode, behaves like bus.c without batches (bus_batch())
+struct SimDoor {
+	struct Event {
+		uint8_t seq, type, arg;
+		uint16_t time;
+	};
+
+	door::Pty pty;
+	uint8_t addr = 1;
+	frame_rx_t rx;
+	std::deque<Event> queue;
+	uint8_t epoch = 0;
+	uint8_t next_seq = 0;
+	uint8_t pushed = 0;
+	uint8_t lost = 0;
+	bool push_now = false;
+	uint64_t push_ns = 0;
+	uint64_t next_event_ns = 0;
+	std::array<std::atomic<uint64_t>, 256> emit_ns{};
+
+	void post(uint8_t type, uint8_t arg, uint64_t now, uint64_t start)
+	{
+		if (queue.size() == BUS_EVENTS_MAX) {
+			if (lost != 0xFF)
+				lost++;
+			return;
+		}
+		emit_ns[next_seq] = now;
+		queue.push_back({next_seq++, type, arg, static_cast<uint16_t>((now - start) / 1000000000ULL)});
+	}
+
+	// The queue is gone, the sequence numbers start over in a new epoch
+	void reset(uint64_t now, uint64_t start)
+	{
+		queue.clear();
+		epoch++;
+		next_seq = 0;
+		pushed = 0;
+		lost = 0;
+		post(EV_BOOT, 0, now, start);
+	}
+
+	// Same rule as bus_task(): new events at once, old ones after a while
+	void push(uint64_t now)
+	{
+		if (queue.empty() || !(push_now || pushed != next_seq || now - push_ns >= 1500000000ULL))
+			return;
+		uint8_t payload[2 + BUS_EVENTS_PER_FRAME * BUS_EVENT_LEN];
+		uint8_t n = 2;
+		payload[0] = epoch;
+		payload[1] = lost;
+		lost = 0;
+		for (size_t i = 0; i < queue.size() && i < BUS_EVENTS_PER_FRAME; i++) {
+			payload[n++] = queue[i].seq;
+			payload[n++] = queue[i].type;
+			payload[n++] = queue[i].arg;
+			payload[n++] = queue[i].time & 0xFF;
+			payload[n++] = queue[i].time >> 8;
+		}
+		std::vector<uint8_t> out;
+		door::append_frame(out, addr, FT_EVENTS, 0, payload, n);
+		door::write_all(pty.master, out.data(), out.size());
+		pushed = next_seq;
+		push_ns = now;
+		push_now = false;
+	}
+
+	void receive(uint8_t b)
+	{
+		if (!frame_rx_byte(&rx, b) || rx.addr != addr || rx.type != FT_EV_ACK || rx.len < 2 ||
+		    rx.payload[0] != epoch)
+			return;
+		while (!queue.empty() &&
+		       static_cast<uint8_t>(rx.payload[1] - queue.front().seq) <
+		           static_cast<uint8_t>(next_seq - queue.front().seq))
+			queue.pop_front();
+		push_now = true;
+	}
+};
+
+struct Result {
+	uint64_t generated = 0;
+	uint64_t delivered = 0;
+	uint64_t duplicates = 0;
+	uint64_t lost = 0;
+	uint64_t boots = 0;
+	uint64_t resets = 0;
+	double seconds = 0;
+	double cpu = 0;
+	door::LatencyStats latency;
+};
+
+void run_doors(std::vector<std::unique_ptr<SimDoor>> &doors, double rate, uint64_t end_ns,
+               std::atomic<bool> &running, std::atomic<uint64_t> &generated, uint64_t &resets)
+{
+	int ep = epoll_create1(EPOLL_CLOEXEC);
+	for (size_t i = 0; i < doors.size(); i++) {
+		epoll_event ev{};
+		ev.events = EPOLLIN;
+		ev.data.u64 = i;
+		epoll_ctl(ep, EPOLL_CTL_ADD, doors[i]->pty.master, &ev);
+	}
+
+	std::mt19937_64 rng(42);
+	std::exponential_distribution<double> gap(rate);
+	const uint64_t start = door::now_ns();
+	for (auto &d : doors) {
+		d->post(EV_BOOT, 0, start, start);
+		generated++;
+		d->next_event_ns = start + static_cast<uint64_t>(gap(rng) * 1e9);
+	}
+
+	epoll_event evs[64];
+	uint8_t buf[256];
+	bool reset = false;
+	while (running) {
+		int n = epoll_wait(ep, evs, 64, 1);
+		for (int k = 0; k < n; k++) {
+			SimDoor &d = *doors[evs[k].data.u64];
+			ssize_t r = ::read(d.pty.master, buf, sizeof buf);
+			for (ssize_t i = 0; i < r; i++)
+				d.receive(buf[i]);
+		}
+		const uint64_t now = door::now_ns();
+		if (!reset && now >= start + (end_ns - start) / 2) {
+			doors.front()->reset(now, start);
+			generated++;
+			resets++;
+			reset = true;
+		}
+		for (auto &d : doors) {
+			while (now < end_ns && d->next_event_ns <= now) {
+				static const uint8_t types[] = {EV_ENTRY, EV_DENIED, EV_BELL};
+				d->post(types[rng() % 3], static_cast<uint8_t>(rng() & 7), now, start);
+				generated++;
+				d->next_event_ns += static_cast<uint64_t>(gap(rng) * 1e9);
+			}
+			d->push(now);
+		}
+	}
+	::close(ep);
+}
+
+void run_subscriber(const std::string &path, const std::unordered_map<std::string, SimDoor *> &by_path,
+                    std::atomic<bool> &running, Result &res)
+{
+	int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	sockaddr_un sa{};
+	sa.sun_family = AF_UNIX;
+	std::strncpy(sa.sun_path, path.c_str(), sizeof sa.sun_path - 1);
+	if (connect(fd, reinterpret_cast<sockaddr *>(&sa), sizeof sa) < 0) {
+		std::perror("connect");
+		return;
+	}
+	timeval tv{0, 100000};
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof tv);
+
+	std::unordered_map<const SimDoor *, int> last;
+	std::string pending;
+	char buf[65536];
+	while (running) {
+		ssize_t n = ::recv(fd, buf, sizeof buf, 0);
+		if (n <= 0)
+			continue;
+		const uint64_t now = door::now_ns();
+		pending.append(buf, static_cast<size_t>(n));
+		size_t pos = 0, nl;
+		while ((nl = pending.find('\n', pos)) != std::string::npos) {
+			char dev[128], type[16];
+			unsigned long long ms;
+			unsigned addr, seq;
+			if (std::sscanf(pending.c_str() + pos, "%llu %127s %u %u %15s", &ms, dev, &addr, &seq, type) == 5) {
+				auto it = by_path.find(dev);
+				if (it != by_path.end()) {
+					// A reset starts the sequence numbers over
+					int &l = last.emplace(it->second, -1).first->second;
+					if (std::strcmp(type, "boot") == 0) {
+						res.boots++;
+						l = -1;
+					}
+					if (l == static_cast<int>(seq)) {
+						res.duplicates++;
+					} else {
+						l = static_cast<int>(seq);
+						res.delivered++;
+						res.latency.add(now - it->second->emit_ns[seq & 0xFF]);
+					}
+				}
+			}
+			pos = nl + 1;
+		}
+		pending.erase(0, pos);
+	}
+	::close(fd);
+}
+
+Result run(unsigned doors, double rate, double seconds, const std::string &log)
+{
+	std::vector<std::unique_ptr<SimDoor>> sims;
+	std::unordered_map<std::string, SimDoor *> by_path;
+	door::GatewayConfig cfg;
+	cfg.log_path = log;
+	cfg.socket_path = "/tmp/doorload." + std::to_string(getpid()) + ".sock";
+	for (unsigned i = 0; i < doors; i++) {
+		sims.push_back(std::make_unique<SimDoor>());
+		sims.back()->pty = door::open_pty();
+		sims.back()->addr = static_cast<uint8_t>(1 + i % FRAME_ADDR_MAX);
+		frame_rx_reset(&sims.back()->rx);
+		cfg.devices.push_back(sims.back()->pty.slave_path);
+		by_path[sims.back()->pty.slave_path] = sims.back().get();
+	}
+
+	Result res;
+	door::Gateway gw(cfg);
+	std::atomic<bool> subscribing{true}, simulating{true};
+	std::atomic<uint64_t> generated{0};
+	std::thread gw_thread([&] { gw.run(); });
+	std::thread sub_thread([&] { run_subscriber(cfg.socket_path, by_path, subscribing, res); });
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+	const uint64_t t0 = door::now_ns();
+	const uint64_t end = t0 + static_cast<uint64_t>(seconds * 1e9);
+	std::thread door_thread([&] { run_doors(sims, rate, end, simulating, generated, res.resets); });
+	while (door::now_ns() < end)
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	// Give retransmissions time to finish
+	std::this_thread::sleep_for(std::chrono::milliseconds(2000));
+	simulating = false;
+	door_thread.join();
+	subscribing = false;
+	sub_thread.join();
+	gw.stop();
+	gw_thread.join();
+
+	res.generated = generated;
+	res.lost = gw.stats().lost;
+	res.seconds = seconds;
+	res.cpu = gw.stats().cpu_ns / 1e9 / (seconds + 2.1);
+	for (auto &d : sims)
+		::close(d->pty.master);
+	return res;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	std::vector<unsigned> sizes{64, 128, 256, 512};
+	double rate = 2.0;
+	double seconds = 3.0;
+	std::string log = "/tmp/doorload." + std::to_string(getpid()) + ".log";
+	int opt;
+	while ((opt = getopt(argc, argv, "n:r:t:l:")) != -1) {
+		switch (opt) {
+		case 'n': {
+			sizes.clear();
+			std::stringstream ss(optarg);
+			std::string item;
+			while (std::getline(ss, item, ','))
+				sizes.push_back(static_cast<unsigned>(std::atoi(item.c_str())));
+			break;
+		}
+		case 'r': rate = std::atof(optarg); break;
+		case 't': seconds = std::atof(optarg); break;
+		case 'l': log = optarg; break;
+		default:
+			std::fprintf(stderr, "usage: doorload [-n doors,...] [-r events/s per door] [-t seconds] [-l log]\n");
+			return 2;
+		}
+	}
+
+	std::printf("%5s %10s %10s %6s %6s %6s %8s %8s %8s %8s %6s\n", "doors", "offered/s", "events/s",
+	            "lost", "dups", "boots", "p50", "p99", "p99.9", "max", "gw cpu");
+	unsigned wrong = 0;
+	try {
+		for (unsigned n : sizes) {
+			Result r = run(n, rate, seconds, log);
+			const bool missed = r.boots != n + r.resets;
+			std::printf("%5u %10.1f %10.1f %6llu %6llu %5llu%s %6.2fms %6.2fms %6.2fms %6.2fms %5.1f%%\n", n,
+			            r.generated / r.seconds, r.delivered / r.seconds,
+			            static_cast<unsigned long long>(r.lost),
+			            static_cast<unsigned long long>(r.duplicates),
+			            static_cast<unsigned long long>(r.boots), missed ? "!" : " ",
+			            r.latency.percentile(50) / 1e6, r.latency.percentile(99) / 1e6,
+			            r.latency.percentile(99.9) / 1e6, r.latency.max() / 1e6, r.cpu * 100);
+			std::fflush(stdout);
+			wrong += missed;
+		}
+	} catch (const std::exception &e) {
+		std::fprintf(stderr, "doorload: %s\n", e.what());
+		return 1;
+	}
+	::unlink(log.c_str());
+	return wrong ? 1 : 0;
+}
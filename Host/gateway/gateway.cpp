@@ -0,0 +1,369 @@
+// Fleet gateway: collects the events of many doors in stream mode, each
+// on its own serial link, and fans them out to an append-only log and
+// to subscribers on a UNIX socket.
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include "gateway.hpp"
+
+#include "frame.hpp"
+#include "serial.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
+#include <system_error>
+#include <unistd.h>
+
+extern "C" {
+#include "bus.h"
+}
+
+namespace door {
+
+namespace {
+
+// epoll data: kind in the upper half, slot index in the lower half
+enum Kind : uint64_t { K_LINK = 1, K_SUB, K_LISTEN, K_WAKE, K_TIMER };
+
+uint64_t tag(Kind k, size_t i = 0) { return (static_cast<uint64_t>(k) << 32) | i; }
+
+[[noreturn]] void fail(const std::string &what)
+{
+	throw std::system_error(errno, std::generic_category(), what);
+}
+
+uint64_t thread_cpu_ns()
+{
+	timespec ts;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+uint64_t unix_ms()
+{
+	timespec ts;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	return static_cast<uint64_t>(ts.tv_sec) * 1000ULL + static_cast<uint64_t>(ts.tv_nsec) / 1000000ULL;
+}
+
+} // namespace
+
+Gateway::Gateway(GatewayConfig cfg) : cfg_(std::move(cfg))
+{
+	epoll_ = epoll_create1(EPOLL_CLOEXEC);
+	wake_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	timer_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	if (epoll_ < 0 || wake_ < 0 || timer_ < 0)
+		fail("epoll/eventfd/timerfd");
+
+	epoll_event ev{};
+	ev.events = EPOLLIN;
+	ev.data.u64 = tag(K_WAKE);
+	epoll_ctl(epoll_, EPOLL_CTL_ADD, wake_, &ev);
+	ev.data.u64 = tag(K_TIMER);
+	epoll_ctl(epoll_, EPOLL_CTL_ADD, timer_, &ev);
+	itimerspec its{{1, 0}, {1, 0}};
+	timerfd_settime(timer_, 0, &its, nullptr);
+
+	if (!cfg_.log_path.empty()) {
+		log_ = ::open(cfg_.log_path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+		if (log_ < 0)
+			fail("open " + cfg_.log_path);
+	}
+
+	if (!cfg_.socket_path.empty()) {
+		sockaddr_un sa{};
+		sa.sun_family = AF_UNIX;
+		if (cfg_.socket_path.size() >= sizeof sa.sun_path)
+			throw std::invalid_argument("socket path too long");
+		std::strcpy(sa.sun_path, cfg_.socket_path.c_str());
+		::unlink(sa.sun_path);
+		listen_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+		if (listen_ < 0 || bind(listen_, reinterpret_cast<sockaddr *>(&sa), sizeof sa) < 0 ||
+		    listen(listen_, 16) < 0)
+			fail("listen " + cfg_.socket_path);
+		ev.data.u64 = tag(K_LISTEN);
+		epoll_ctl(epoll_, EPOLL_CTL_ADD, listen_, &ev);
+	}
+
+	for (const auto &path : cfg_.devices) {
+		links_.push_back(std::make_unique<Link>());
+		links_.back()->path = path;
+		open_link(links_.size() - 1);
+	}
+}
+
+Gateway::~Gateway()
+{
+	for (size_t i = 0; i < links_.size(); i++)
+		close_link(i);
+	for (auto &s : subs_)
+		if (s->fd >= 0)
+			::close(s->fd);
+	if (listen_ >= 0) {
+		::close(listen_);
+		::unlink(cfg_.socket_path.c_str());
+	}
+	for (int fd : {log_, timer_, wake_, epoll_})
+		if (fd >= 0)
+			::close(fd);
+}
+
+void Gateway::stop()
+{
+	running_ = false;
+	uint64_t one = 1;
+	if (::write(wake_, &one, sizeof one) < 0) {
+		// Already signalled
+	}
+}
+
+void Gateway::open_link(size_t i)
+{
+	Link &link = *links_[i];
+	try {
+		link.fd = open_serial(link.path, cfg_.baud, true);
+	} catch (const std::exception &) {
+		return;     // Retried by the timer
+	}
+	link.len = 0;
+	link.dedup.reset();
+	epoll_event ev{};
+	ev.events = EPOLLIN;
+	ev.data.u64 = tag(K_LINK, i);
+	epoll_ctl(epoll_, EPOLL_CTL_ADD, link.fd, &ev);
+}
+
+void Gateway::close_link(size_t i)
+{
+	Link &link = *links_[i];
+	if (link.fd < 0)
+		return;
+	epoll_ctl(epoll_, EPOLL_CTL_DEL, link.fd, nullptr);
+	::close(link.fd);
+	link.fd = -1;
+}
+
+void Gateway::read_link(size_t i)
+{
+	Link &link = *links_[i];
+	ssize_t n = ::read(link.fd, link.buf + link.len, sizeof link.buf - link.len);
+	if (n <= 0) {
+		if (n == 0 || (errno != EAGAIN && errno != EINTR))
+			close_link(i);
+		return;
+	}
+	stats_.bytes += static_cast<uint64_t>(n);
+	link.len += static_cast<size_t>(n);
+
+	// Frames are parsed in place, only the unfinished tail is moved
+	size_t pos = 0;
+	frame_view_t f;
+	size_t consumed;
+	while (frame_find(link.buf + pos, link.len - pos, &f, &consumed)) {
+		stats_.garbage += consumed - (f.len + FRAME_OVERHEAD);
+		handle_frame(link, f);
+		pos += consumed;
+	}
+	stats_.garbage += consumed;
+	pos += consumed;
+	link.len -= pos;
+	std::memmove(link.buf, link.buf + pos, link.len);
+}
+
+void Gateway::handle_frame(Link &link, const frame_view_t &f)
+{
+	// Events one after the other in FT_EVENTS, delta coded in FT_BATCH
+	std::vector<Event> events;
+	uint8_t epoch = 0, lost = 0;
+	if (f.type == FT_EVENTS) {
+		if (!decode_events(f.payload, f.len, epoch, lost, events))
+			return;
+	} else if (f.type != FT_BATCH || !decode_batch(f.payload, f.len, epoch, lost, events)) {
+		return;
+	}
+	stats_.frames++;
+	stats_.lost += lost;
+
+	const uint64_t ms = unix_ms();
+	for (const Event &e : events) {
+		if (!link.dedup.accept(epoch, e.seq)) {
+			stats_.duplicates++;
+			continue;
+		}
+		stats_.events++;
+		char line[256];
+		int n = std::snprintf(line, sizeof line, "%llu %s %u %u %s %u %u\n",
+		                      static_cast<unsigned long long>(ms), link.path.c_str(), f.addr,
+		                      e.seq, event_name(e.type), e.arg, e.time);
+		if (n > 0)
+			batch_.append(line, std::min(static_cast<size_t>(n), sizeof line - 1));
+	}
+
+	// Acknowledge retransmissions too, or the door keeps sending them
+	if (!events.empty()) {
+		const uint8_t ack[2] = {epoch, events.back().seq};
+		uint8_t out[FRAME_OVERHEAD + sizeof ack];
+		struct Buf { uint8_t *p; size_t n; } b{out, 0};
+		frame_write([](void *ctx, uint8_t c) {
+			auto *b = static_cast<Buf *>(ctx);
+			b->p[b->n++] = c;
+		}, &b, f.addr, FT_EV_ACK, 0, ack, sizeof ack);
+		if (::write(link.fd, out, b.n) < 0) {
+			// A full output buffer drops the ack, the door sends again
+		}
+	}
+}
+
+void Gateway::accept_subscribers()
+{
+	for (;;) {
+		int fd = accept4(listen_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (fd < 0)
+			return;
+		size_t i = 0;
+		while (i < subs_.size() && subs_[i]->fd >= 0)
+			i++;
+		if (i == subs_.size())
+			subs_.push_back(std::make_unique<Subscriber>());
+		*subs_[i] = Subscriber{};
+		subs_[i]->fd = fd;
+		epoll_event ev{};
+		ev.events = EPOLLIN;
+		ev.data.u64 = tag(K_SUB, i);
+		epoll_ctl(epoll_, EPOLL_CTL_ADD, fd, &ev);
+	}
+}
+
+void Gateway::flush_subscriber(size_t i)
+{
+	Subscriber &s = *subs_[i];
+	size_t done = 0;
+	while (done < s.out.size()) {
+		ssize_t n = ::send(s.fd, s.out.data() + done, s.out.size() - done, MSG_NOSIGNAL);
+		if (n > 0) {
+			done += static_cast<size_t>(n);
+			continue;
+		}
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n < 0 && errno == EAGAIN)
+			break;
+		s.out.clear();      // Gone, closed on its EPOLLHUP
+		return;
+	}
+	s.out.erase(0, done);
+
+	const bool want = !s.out.empty();
+	if (s.out.size() > cfg_.subscriber_limit) {
+		// Too slow, never let one reader hold the gateway back
+		stats_.dropped_subscribers++;
+		epoll_ctl(epoll_, EPOLL_CTL_DEL, s.fd, nullptr);
+		::close(s.fd);
+		s = Subscriber{};
+	} else if (want != s.want_out) {
+		epoll_event ev{};
+		ev.events = EPOLLIN | (want ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+		ev.data.u64 = tag(K_SUB, i);
+		epoll_ctl(epoll_, EPOLL_CTL_MOD, s.fd, &ev);
+		s.want_out = want;
+	}
+}
+
+void Gateway::flush()
+{
+	if (batch_.empty())
+		return;
+	if (log_ >= 0) {
+		write_all(log_, reinterpret_cast<const uint8_t *>(batch_.data()), batch_.size());
+		if (cfg_.fsync_log)
+			fdatasync(log_);
+	}
+	for (size_t i = 0; i < subs_.size(); i++) {
+		if (subs_[i]->fd < 0)
+			continue;
+		subs_[i]->out += batch_;
+		flush_subscriber(i);
+	}
+	batch_.clear();
+}
+
+void Gateway::run()
+{
+	running_ = true;
+	const uint64_t cpu0 = thread_cpu_ns();
+	epoll_event evs[64];
+
+	while (running_) {
+		int n = epoll_wait(epoll_, evs, 64, -1);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			fail("epoll_wait");
+		}
+		stats_.wakeups++;
+		for (int k = 0; k < n; k++) {
+			const uint64_t t = evs[k].data.u64;
+			const size_t i = t & 0xFFFFFFFFu;
+			switch (static_cast<Kind>(t >> 32)) {
+			case K_LINK:
+				if (links_[i]->fd < 0)
+					break;
+				if (evs[k].events & EPOLLIN)
+					read_link(i);
+				else if (evs[k].events & (EPOLLHUP | EPOLLERR))
+					close_link(i);
+				break;
+			case K_SUB: {
+				Subscriber &s = *subs_[i];
+				if (s.fd < 0)
+					break;
+				char sink[256];
+				if ((evs[k].events & (EPOLLHUP | EPOLLERR)) ||
+				    ((evs[k].events & EPOLLIN) && ::read(s.fd, sink, sizeof sink) == 0)) {
+					epoll_ctl(epoll_, EPOLL_CTL_DEL, s.fd, nullptr);
+					::close(s.fd);
+					s = Subscriber{};
+				} else if (evs[k].events & EPOLLOUT) {
+					flush_subscriber(i);
+				}
+				break;
+			}
+			case K_LISTEN:
+				accept_subscribers();
+				break;
+			case K_WAKE: {
+				uint64_t v;
+				if (::read(wake_, &v, sizeof v) < 0) {
+					// Nothing to drain
+				}
+				break;
+			}
+			case K_TIMER: {
+				uint64_t v;
+				if (::read(timer_, &v, sizeof v) < 0) {
+					// Spurious
+				}
+				for (size_t j = 0; j < links_.size(); j++)
+					if (links_[j]->fd < 0)
+						open_link(j);
+				stats_.cpu_ns = thread_cpu_ns() - cpu0;
+				break;
+			}
+			}
+		}
+		flush();
+	}
+	stats_.cpu_ns = thread_cpu_ns() - cpu0;
+}
+
+} // namespace door
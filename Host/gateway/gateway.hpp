@@ -0,0 +1,101 @@
+// Fleet gateway: collects the events of many doors in stream mode, each
+// on its own serial link, and fans them out to an append-only log and
+// to subscribers on a UNIX socket.
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#pragma once
+
+#include "events.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "frame.h"
+}
+
+namespace door {
+
+struct GatewayConfig {
+	std::vector<std::string> devices;
+	int baud = 9600;
+	std::string log_path;       // Empty: no log
+	std::string socket_path;    // Empty: no subscribers
+	bool fsync_log = false;     // fdatasync after every batch
+	size_t subscriber_limit = 1 << 20;  // Pending bytes before a slow
+	                                    // subscriber is dropped
+};
+
+struct GatewayStats {
+	std::atomic<uint64_t> frames{0};
+	std::atomic<uint64_t> events{0};
+	std::atomic<uint64_t> duplicates{0};
+	std::atomic<uint64_t> lost{0};          // Reported by the doors
+	std::atomic<uint64_t> bytes{0};
+	std::atomic<uint64_t> garbage{0};       // Bytes outside valid frames
+	std::atomic<uint64_t> wakeups{0};
+	std::atomic<uint64_t> dropped_subscribers{0};
+	std::atomic<uint64_t> cpu_ns{0};        // Thread CPU time in run()
+};
+
+// One thread, one epoll set. Every event becomes one text line
+//
+//     <unix ms> <device> <addr> <seq> <type> <arg> <door time>
+//
+// written to the log and to every subscriber. Lines are batched per
+// epoll wakeup, so the log costs one write() per batch, not per event.
+class Gateway {
+public:
+	explicit Gateway(GatewayConfig cfg);
+	~Gateway();
+
+	Gateway(const Gateway &) = delete;
+	Gateway &operator=(const Gateway &) = delete;
+
+	// Runs until stop() is called from another thread or a signal handler.
+	void run();
+	void stop();
+
+	const GatewayStats &stats() const { return stats_; }
+
+private:
+	struct Link {
+		std::string path;
+		int fd = -1;
+		size_t len = 0;             // Bytes in buf
+		uint8_t buf[4 * FRAME_LEN_MAX];
+		EventDedup dedup;
+	};
+	struct Subscriber {
+		int fd = -1;
+		std::string out;            // Not yet written
+		bool want_out = false;      // EPOLLOUT registered
+	};
+
+	void open_link(size_t i);
+	void close_link(size_t i);
+	void read_link(size_t i);
+	void handle_frame(Link &link, const frame_view_t &f);
+	void accept_subscribers();
+	void flush_subscriber(size_t i);
+	void flush();
+
+	GatewayConfig cfg_;
+	GatewayStats stats_;
+	int epoll_ = -1;
+	int wake_ = -1;             // eventfd, stop()
+	int timer_ = -1;            // timerfd, reopens closed links
+	int listen_ = -1;
+	int log_ = -1;
+	std::vector<std::unique_ptr<Link>> links_;
+	std::vector<std::unique_ptr<Subscriber>> subs_;
+	std::string batch_;         // Lines of the current wakeup
+	std::atomic<bool> running_{false};
+};
+
+} // namespace door
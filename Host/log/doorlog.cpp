@@ -0,0 +1,96 @@
+// Prints the event log of a door.
+//
+//     doorlog <EEPROM image>                 raw, as avrdude reads it
+//     doorlog --bus <device> <addr> [baud]
+//
+// Each block is decoded on its own as it comes, then the records are put
+// in order. The times count the seconds since the reset before them
+// until the door had the time of day, then they are dates in UTC.
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include "event_log.hpp"
+#include "serial.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <exception>
+#include <string>
+
+namespace {
+
+std::string when(uint32_t time)
+{
+	char s[32];
+	if (time < EVLOG_UNIX) {
+		std::snprintf(s, sizeof s, "%10u s", time);
+	} else {
+		const std::time_t t = time;
+		std::tm tm;
+		gmtime_r(&t, &tm);
+		std::strftime(s, sizeof s, "%Y-%m-%d %H:%M:%S", &tm);
+	}
+	return s;
+}
+
+int usage()
+{
+	std::fprintf(stderr,
+		"usage: doorlog <EEPROM image>\n"
+		"       doorlog --bus <device> <addr> [baud]\n");
+	return 2;
+}
+
+void print(const std::vector<door::LogImage> &images)
+{
+	door::LogReader reader;
+	for (const door::LogImage &image : images)
+		reader.add(image);
+
+	unsigned used = 0, records = 0;
+	for (const door::LogBlock &b : reader.blocks()) {
+		std::printf("block %u%s\n", b.seq, b.sealed ? "" : ", open");
+		for (const door::LogRecord &r : b.records)
+			std::printf("  %19s  %s\n", when(r.time).c_str(), door::describe(r).c_str());
+		used += b.used;
+		records += static_cast<unsigned>(b.records.size());
+	}
+	std::printf("%u records in %u bytes, %.2f bytes per record", records, used,
+	            records ? static_cast<double>(used) / records : 0.0);
+	if (reader.damaged())
+		std::printf(", %u blocks damaged", reader.damaged());
+	std::printf("\n");
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	try {
+		std::vector<door::LogImage> images;
+		if (argc >= 4 && std::strcmp(argv[1], "--bus") == 0) {
+			const int baud = argc > 4 ? std::atoi(argv[4]) : 9600;
+			const auto addr = static_cast<uint8_t>(std::atoi(argv[3]));
+			door::BusMaster bus(door::open_serial(argv[2], baud));
+			if (!door::read_log(bus, addr, images)) {
+				std::fprintf(stderr, "door %u did not answer\n", addr);
+				return 1;
+			}
+		} else if (argc == 2 && argv[1][0] != '-') {
+			if (!door::load_log(argv[1], images)) {
+				std::fprintf(stderr, "doorlog: %s is no EEPROM image\n", argv[1]);
+				return 1;
+			}
+		} else {
+			return usage();
+		}
+		print(images);
+	} catch (const std::exception &e) {
+		std::fprintf(stderr, "doorlog: %s\n", e.what());
+		return 1;
+	}
+	return 0;
+}
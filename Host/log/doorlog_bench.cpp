@@ -0,0 +1,251 @@
+// Runs the event log of the firmware (evlog.c) on the simulated EEPROM
+// and compares what it keeps with a log of fixed 8 byte records, which
+// keeps 56 events in the same 448 bytes.
+//
+// The door sees entries of eight users, wrong pins and bells with gaps
+// of a given mean, exponentially distributed. Every event is written as
+// it comes, then the blocks are read back with the decoder of doorlog
+// and compared with the events posted. A second run cuts the power in
+// the middle of the EEPROM writes now and then and resets the door: after
+// each reset the records written before must all be there, unchanged.
+// Then the master sets the time of day, and the records after it must
+// be in unix time. Last every gap from 31 s to a day goes through the
+// encoder and the decoder and must come back to the second.
+//
+// Usage: doorlog_bench [events per run] [seed]
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include "event_log.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <set>
+
+extern "C" {
+#include "eemap.h"
+#include "event.h"
+#include "hal.h"
+#include "rtc.h"
+#include "sim.h"
+}
+
+namespace {
+
+constexpr unsigned kNaive = EVLOG_BLOCKS * EVLOG_BLOCK_LEN / 8;
+constexpr uint32_t kUnix = 1609459200;  // 2021-01-01 00:00 UTC
+
+struct Posted {
+	uint8_t type;
+	uint8_t arg;
+	uint32_t time;
+};
+
+struct Result {
+	unsigned kept = 0;          // Records read back
+	double bytes = 0;           // Per record, headers and unused ends included
+	double writes = 0;          // EEPROM bytes programmed per event
+	unsigned wrong = 0;         // Records changed or lost, cuts excepted
+	unsigned lost = 0;          // Events lost at a cut
+	unsigned damaged = 0;
+	unsigned dated = 0;         // Records in unix time
+};
+
+class Door {
+public:
+	Door(double gap, unsigned seed) : rng_(seed), gap_(1.0 / gap)
+	{
+		sim_eeprom_erase();
+		hal_init(0);
+		boot(1);
+	}
+
+	// A reset: the log is found again, the clock starts over and the
+	// time of day is unknown
+	void boot(uint8_t mcusr)
+	{
+		evlog_init();
+		clock_ = 1;
+		unix_ = 0;
+		rtc_set(0);
+		post(EV_BOOT, mcusr);
+	}
+
+	// The master sets the time of day, the door counts on from it
+	void set_clock(uint32_t time)
+	{
+		unix_ = time - clock_;
+	}
+
+	void next()
+	{
+		clock_ += std::min(60000u, static_cast<unsigned>(gap_(rng_)) + 1);
+		const unsigned r = pick_(rng_) % 20;
+		if (r < 12)
+			post(EV_ENTRY, static_cast<uint8_t>(pick_(rng_) % 8));
+		else if (r < 17)
+			post(EV_DENIED, 0);
+		else
+			post(EV_BELL, 0);
+	}
+
+	void post(uint8_t type, uint8_t arg)
+	{
+		if (unix_)
+			rtc_set(unix_ + clock_);
+		posted.push_back({type, arg, unix_ + clock_});
+		evlog_post(type, arg, static_cast<uint16_t>(clock_));
+		evlog_task();
+	}
+
+	std::vector<Posted> posted;
+	std::set<size_t> cut;       // Posted while the power failed
+
+private:
+	std::mt19937 rng_;
+	std::exponential_distribution<double> gap_;
+	std::uniform_int_distribution<unsigned> pick_;
+	uint32_t clock_ = 0;
+	uint32_t unix_ = 0;         // Unix time at the reset, 0 while unknown
+};
+
+// The records read back must be the posted events from some point on,
+// in order and unchanged, to the second. Events may only be missing where
+// they were cut off, or in the oldest block, which the newest one was
+// overwriting.
+Result check(const Door &door)
+{
+	std::vector<door::LogImage> images;
+	door::log_images(sim_eeprom(), images);
+	door::LogReader reader;
+	for (const door::LogImage &image : images)
+		reader.add(image);
+	const std::vector<door::LogBlock> blocks = reader.blocks();
+	const std::vector<door::LogRecord> recs = reader.records();
+
+	Result r;
+	r.kept = static_cast<unsigned>(recs.size());
+	r.damaged = reader.damaged();
+	r.bytes = recs.empty() ? 0 : static_cast<double>(EVLOG_BLOCK_LEN) * blocks.size() / recs.size();
+	const size_t oldest = blocks.empty() ? 0 : blocks[0].records.size();
+
+	// From the newest back, the oldest records repeat often (boots)
+	size_t at = door.posted.size();
+	for (size_t i = recs.size(); i-- > 0;) {
+		const door::LogRecord &rec = recs[i];
+		size_t j = at;
+		while (j-- > 0 && (door.posted[j].type != rec.type || door.posted[j].arg != rec.arg ||
+		                   door.posted[j].time != rec.time))
+			;
+		if (j == SIZE_MAX) {
+			if (r.wrong++ < 5)
+				std::fprintf(stderr, "record %zu: %s at %u s was never posted\n", i,
+				             door::describe(rec).c_str(), rec.time);
+			continue;
+		}
+		for (size_t k = j + 1; k < at; k++) {
+			if (door.cut.count(k))
+				r.lost++;
+			else if (i + 1 > oldest && r.wrong++ < 5)
+				std::fprintf(stderr, "event %zu missing after record %zu\n", k, i);
+		}
+		at = j;
+		r.dated += rec.time >= EVLOG_UNIX;
+	}
+	r.writes = static_cast<double>(sim_eeprom_writes()) / door.posted.size();
+	return r;
+}
+
+// The event clock of a door wraps after 18 h, longer gaps only go
+// through the codec. Returns the records which came back wrong
+unsigned round_trip(unsigned &longest)
+{
+	unsigned wrong = 0;
+	longest = 0;
+	for (uint32_t gap = 31; gap <= 86400; gap++) {
+		for (uint8_t arg : {3, 40}) {
+			uint8_t rec[EVLOG_REC_MAX];
+			const uint8_t n = evlog_encode(rec, EV_ENTRY, arg, gap);
+			evlog_rec_t r = {0, 0, kUnix};
+			if (evlog_decode(rec, n, &r) != n || r.type != EV_ENTRY || r.arg != arg ||
+			    r.time != kUnix + gap) {
+				if (wrong++ < 5)
+					std::fprintf(stderr, "gap of %u s came back as %u s\n", gap, r.time - kUnix);
+			} else if (n == 2) {
+				longest = gap;
+			}
+		}
+	}
+	return wrong;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	const long events = argc > 1 ? std::atol(argv[1]) : 5000;
+	const unsigned seed = argc > 2 ? static_cast<unsigned>(std::atol(argv[2])) : 1;
+	if (events <= 0) {
+		std::fprintf(stderr, "usage: doorlog_bench [events per run] [seed]\n");
+		return 2;
+	}
+	unsigned wrong = 0;
+
+	std::printf("%-12s %5s %12s %9s %13s\n", "mean gap", "kept", "bytes/event", "x 8 byte",
+	            "writes/event");
+	for (double gap : {10.0, 30.0, 60.0, 120.0, 300.0, 900.0, 3600.0}) {
+		Door door(gap, seed);
+		for (long i = 0; i < events; i++)
+			door.next();
+		const Result r = check(door);
+		wrong += r.wrong;
+		std::printf("%9.0f s  %5u %12.2f %9.2f %13.2f\n", gap, r.kept, r.bytes,
+		            static_cast<double>(r.kept) / kNaive, r.writes);
+	}
+
+	// Power cuts within the next few bytes written, every 40 events or so
+	Door door(60.0, seed);
+	std::mt19937 rng(seed + 1);
+	unsigned cuts = 0, cutWrong = 0;
+	for (long i = 0; i < events; i++) {
+		if (rng() % 40 == 0) {
+			sim_eeprom_power(rng() % 6);
+			door.cut.insert(door.posted.size());
+			door.next();
+			sim_eeprom_power(-1);
+			door.boot(0x01);
+			cutWrong += check(door).wrong;
+			cuts++;
+		} else {
+			door.next();
+		}
+	}
+	const Result r = check(door);
+	wrong += cutWrong + r.wrong;
+	std::printf("power cuts   %u, %u events lost at them, %u blocks damaged, %u records wrong\n", cuts,
+	            r.lost, r.damaged, cutWrong + r.wrong);
+
+	// The time of day set 60 events before the end, the records from
+	// then on are unix time
+	Door timed(60.0, seed);
+	for (long i = 0; i < events; i++) {
+		if (i == std::max(0L, events - 60))
+			timed.set_clock(kUnix);
+		timed.next();
+	}
+	const Result rt = check(timed);
+	const auto expect = static_cast<unsigned>(std::min<long>(rt.kept, std::min(60L, events)));
+	wrong += rt.wrong + (rt.dated != expect);
+	std::printf("wall clock   %u of %u records in unix time, %u expected, %u records wrong\n", rt.dated, rt.kept,
+	            expect, rt.wrong);
+
+	unsigned longest;
+	const unsigned rw = round_trip(longest);
+	wrong += rw;
+	std::printf("round trip   gaps of 31 s to 1 day, 2 bytes up to %u s, %u wrong\n", longest, rw);
+	return wrong ? 1 : 0;
+}
@@ -0,0 +1,123 @@
+// Event log of the door, see event_log.hpp.
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include "event_log.hpp"
+#include "events.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+extern "C" {
+#include "eemap.h"
+}
+
+namespace door {
+
+bool decode_log_block(const LogImage &image, LogBlock &block)
+{
+	block = LogBlock();
+	block.seq = static_cast<uint16_t>(image[0] | image[1] << 8);
+	if (block.seq == EVLOG_SEQ_FREE)
+		return false;
+	block.time = static_cast<uint32_t>(image[2] | image[3] << 8 | image[4] << 16) |
+	             static_cast<uint32_t>(image[5]) << 24;
+	block.sealed = evlog_crc(image.data()) == static_cast<uint16_t>(image[6] | image[7] << 8);
+
+	evlog_rec_t rec;
+	rec.time = block.time;
+	unsigned at = EVLOG_HEADER_LEN;
+	while (at < EVLOG_BLOCK_LEN) {
+		const uint8_t n = evlog_decode(&image[at], static_cast<uint8_t>(EVLOG_BLOCK_LEN - at), &rec);
+		if (n == 0)
+			break;
+		block.records.push_back({rec.type, rec.arg, rec.time, static_cast<uint8_t>(at)});
+		at += n;
+	}
+	block.used = static_cast<uint8_t>(at);
+	return true;
+}
+
+void LogReader::add(const LogImage &image)
+{
+	LogBlock block;
+	if (decode_log_block(image, block))
+		blocks_.push_back(std::move(block));
+}
+
+std::vector<LogBlock> LogReader::blocks() const
+{
+	std::vector<LogBlock> out = blocks_;
+	std::sort(out.begin(), out.end(), [](const LogBlock &a, const LogBlock &b) { return a.seq < b.seq; });
+	return out;
+}
+
+std::vector<LogRecord> LogReader::records() const
+{
+	std::vector<LogRecord> out;
+	for (const LogBlock &b : blocks())
+		out.insert(out.end(), b.records.begin(), b.records.end());
+	return out;
+}
+
+unsigned LogReader::damaged() const
+{
+	const std::vector<LogBlock> b = blocks();
+	return b.empty() ? 0 : static_cast<unsigned>(std::count_if(b.begin(), b.end() - 1,
+	                                             [](const LogBlock &x) { return !x.sealed; }));
+}
+
+bool read_log(BusMaster &bus, uint8_t addr, std::vector<LogImage> &images)
+{
+	images.clear();
+	for (uint8_t block = 0;; block++) {
+		LogImage image;
+		for (uint8_t half = 0; half < 2; half++) {
+			const uint8_t req[2] = {block, half};
+			std::vector<uint8_t> r;
+			if (!bus.request(addr, FT_LOG_READ, req, 2, 200, r) || r.empty())
+				return false;
+			if (block >= r[0])
+				return true;
+			if (r.size() < 3u + EVLOG_HALF || r[1] != block || r[2] != half)
+				return false;
+			std::copy(r.begin() + 3, r.begin() + 3 + EVLOG_HALF, image.begin() + half * EVLOG_HALF);
+		}
+		images.push_back(image);
+	}
+}
+
+void log_images(const uint8_t *eeprom, std::vector<LogImage> &images)
+{
+	images.clear();
+	for (unsigned i = 0; i < EVLOG_BLOCKS; i++) {
+		LogImage image;
+		std::copy_n(eeprom + EE_LOG + i * EVLOG_BLOCK_LEN, EVLOG_BLOCK_LEN, image.begin());
+		images.push_back(image);
+	}
+}
+
+bool load_log(const std::string &path, std::vector<LogImage> &images)
+{
+	std::ifstream f(path, std::ios::binary);
+	const std::vector<uint8_t> ee((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+	if (ee.size() < EE_LOG_END)
+		return false;
+	log_images(ee.data(), images);
+	return true;
+}
+
+std::string describe(const LogRecord &rec)
+{
+	std::string s = event_name(rec.type);
+	switch (rec.type) {
+	case EV_BOOT: return s + ", MCUSR " + std::to_string(rec.arg);
+	case EV_ENTRY: return s + " user " + std::to_string(rec.arg);
+	case EV_STACK: return s + ", " + std::to_string(rec.arg) + " bytes stack free";
+	default: return rec.arg ? s + " " + std::to_string(rec.arg) : s;
+	}
+}
+
+} // namespace door
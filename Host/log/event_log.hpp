@@ -0,0 +1,69 @@
+// Event log of the door (see evlog.h in the firmware): reading the
+// blocks and decoding them with the decoder of the firmware.
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#pragma once
+
+#include "bus_master.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "evlog.h"
+}
+
+namespace door {
+
+using LogImage = std::array<uint8_t, EVLOG_BLOCK_LEN>;
+
+struct LogRecord {
+	uint8_t type;
+	uint8_t arg;
+	uint32_t time;      // Seconds since the reset before it, unix time from EVLOG_UNIX on
+	uint8_t offset;     // In the block
+};
+
+struct LogBlock {
+	uint16_t seq = EVLOG_SEQ_FREE;
+	uint32_t time = 0;  // Of the first record
+	bool sealed = false;    // The CRC matches
+	uint8_t used = 0;       // Bytes up to the end of the records
+	std::vector<LogRecord> records;
+};
+
+// Decodes one block on its own, a block needs nothing of the others.
+// Returns false for a block never opened.
+bool decode_log_block(const LogImage &image, LogBlock &block);
+
+// Collects the blocks as they come, in any order, and gives the records
+// oldest first. Only the newest block may be unsealed, an older one
+// without its CRC is counted as damaged and decoded as far as it goes.
+class LogReader {
+public:
+	void add(const LogImage &image);
+	std::vector<LogBlock> blocks() const;  // Oldest first
+	std::vector<LogRecord> records() const;
+	unsigned damaged() const;
+
+private:
+	std::vector<LogBlock> blocks_;
+};
+
+// Reads all blocks of a door with FT_LOG_READ
+bool read_log(BusMaster &bus, uint8_t addr, std::vector<LogImage> &images);
+
+// Blocks of an EEPROM image of at least EE_LOG_END bytes
+void log_images(const uint8_t *eeprom, std::vector<LogImage> &images);
+
+// Blocks of a raw EEPROM image, as avrdude -U eeprom:r:door.bin:r reads it
+bool load_log(const std::string &path, std::vector<LogImage> &images);
+
+// One line of text for a record, e.g. "entry user 3"
+std::string describe(const LogRecord &rec);
+
+} // namespace door
@@ -0,0 +1,62 @@
+// Brings the user table of a door up to date.
+//
+//     doorprov <device> <addr> <users.csv> [state file] [baud]
+//
+// users.csv has one "slot,pin,name[,unlock seconds[,chime[,schedule]]]" line per user. The state file keeps
+// what was committed last; with it only the changed users are sent,
+// without it the door is asked for its hashes first. The door and the
+// state file only get the keyed hash of each PIN (see pin.h), doorprov
+// must be built with the PIN_KEY of the door and refuses to run without
+// one. A pin of "totp:<base32>", a secret of 20 bytes, gives the user
+// one-time codes instead (see totp.h); the secret is sent after the
+// record and the state file keeps only its fingerprint. The schedule, 1 to 3, limits the user to the hours set
+// with doorbus_master --schedule.
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include "provisioner.hpp"
+#include "serial.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+
+int main(int argc, char **argv)
+{
+#ifdef PIN_KEY_BENCH
+	// No door is built with the key of the benches
+	std::fprintf(stderr, "doorprov: built without the door's key, configure with -DPIN_KEY=<key>\n");
+	return 2;
+#endif
+	if (argc < 4) {
+		std::fprintf(stderr, "usage: doorprov <device> <addr> <users.csv> [state file] [baud]\n");
+		return 2;
+	}
+	const std::string state_path = argc > 4 ? argv[4] : "";
+	const int baud = argc > 5 ? std::atoi(argv[5]) : 9600;
+
+	try {
+		door::BusMaster bus(door::open_serial(argv[1], baud));
+		door::Provisioner prov(bus, static_cast<uint8_t>(std::atoi(argv[2])));
+		const auto desired = door::UserTable::load_csv(argv[3]);
+		std::optional<door::DoorState> known;
+		if (!state_path.empty())
+			known = door::DoorState::load(state_path);
+
+		door::SyncStats st;
+		const auto state = prov.sync(desired, known, &st);
+		if (!state_path.empty())
+			state.save(state_path);
+
+		std::printf("version %u, %u records written, %u secrets, %u frames, %llu bytes "
+		            "(%.0f ms at %d baud)%s\n",
+		            state.version, st.records, st.secrets, st.frames,
+		            static_cast<unsigned long long>(st.tx_bytes + st.rx_bytes), st.wire_ms(baud), baud,
+		            st.by_hashes ? ", compared hashes" : "");
+	} catch (const std::exception &e) {
+		std::fprintf(stderr, "doorprov: %s\n", e.what());
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,166 @@
+// Measures the user table sync against a simulated door running the
+// firmware's users.c with a 512 slot table.
+//
+// For 1, 10 and 500 changed users it prints the bytes on the wire and
+// the EEPROM bytes programmed, and the time both take on a real door:
+// 9600 baud and 3.4 ms per EEPROM byte. The EEPROM bytes include the
+// copy to the other bank the door makes after the commit. A full table
+// upload is given for comparison. Last a user of one-time codes is
+// added, its secret must follow the record into the door's EEPROM.
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include "provisioner.hpp"
+#include "serial.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <poll.h>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+
+extern "C" {
+#include "bus.h"
+#include "eemap.h"
+#include "sim.h"
+}
+
+namespace {
+
+constexpr int kBaud = 9600;
+constexpr double kEepromMsPerByte = 3.4;
+
+class SimDoor {
+public:
+	SimDoor() : pty_(door::open_pty())
+	{
+		sim_eeprom_erase();
+		sim_eeprom()[EE_LINK_MODE] = BUS_MODE_POLLED;
+		sim_eeprom()[EE_NODE_ADDR] = 1;
+		sim_uart_attach(pty_.master);
+		bus_init();
+		users_init();
+		thread_ = std::thread([this] {
+			while (running_) {
+				pollfd p{pty_.master, POLLIN, 0};
+				::poll(&p, 1, 1);
+				bus_task();
+				users_task();
+			}
+		});
+	}
+	~SimDoor()
+	{
+		running_ = false;
+		thread_.join();
+		::close(pty_.master);
+	}
+	const std::string &device() const { return pty_.slave_path; }
+
+private:
+	door::Pty pty_;
+	std::atomic<bool> running_{true};
+	std::thread thread_;
+};
+
+// Waits for the door to finish the copy to its other bank
+uint64_t eeprom_writes_after(door::Provisioner &prov, uint64_t before)
+{
+	while (prov.busy())
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	return sim_eeprom_writes() - before;
+}
+
+void report(const char *what, size_t changed, const door::SyncStats &st, uint64_t ee_bytes)
+{
+	const double wire = st.wire_ms(kBaud);
+	const double ee = ee_bytes * kEepromMsPerByte;
+	std::printf("%-18s %7zu %7u %7u %8llu %9.0f %8llu %9.0f %9.1f\n", what, changed, st.records,
+	            st.frames, static_cast<unsigned long long>(st.tx_bytes + st.rx_bytes), wire,
+	            static_cast<unsigned long long>(ee_bytes), ee, (wire + ee) / 1000.0);
+}
+
+door::UserTable change(const door::UserTable &t, size_t count, std::mt19937 &rng, unsigned round)
+{
+	door::UserTable out = t;
+	std::vector<size_t> slots(t.size());
+	for (size_t i = 0; i < slots.size(); i++)
+		slots[i] = i;
+	std::shuffle(slots.begin(), slots.end(), rng);
+	for (size_t i = 0; i < count; i++) {
+		const size_t s = slots[i];
+		out.set(s, door::UserTable::make(std::to_string(1000 + (rng() % 9000)),
+		                                 "User " + std::to_string(s) + "." + std::to_string(round)));
+	}
+	return out;
+}
+
+} // namespace
+
+int main()
+{
+	try {
+		SimDoor sim;
+		door::BusMaster bus(door::open_serial(sim.device(), kBaud));
+		door::Provisioner prov(bus, 1);
+		std::mt19937 rng(7);
+
+		std::printf("%-18s %7s %7s %7s %8s %9s %8s %9s %9s\n", "sync", "changed", "written",
+		            "frames", "bytes", "wire ms", "ee bytes", "ee ms", "total s");
+
+		// First contact: version unknown, fill 500 of the slots
+		door::SyncStats st;
+		auto state = prov.sync(door::UserTable(), std::nullopt, &st);
+		const size_t slots = state.table.size();
+		door::UserTable table(slots);
+		table = change(table, 500, rng, 0);
+		eeprom_writes_after(prov, 0);
+		uint64_t ee0 = sim_eeprom_writes();
+		state = prov.sync(table, std::nullopt, &st);
+		report("initial, hashes", 500, st, eeprom_writes_after(prov, ee0));
+
+		unsigned round = 1;
+		for (size_t n : {1, 10, 500}) {
+			table = change(table, n, rng, round++);
+			ee0 = sim_eeprom_writes();
+			state = prov.sync(table, state, &st);
+			report("known version", n, st, eeprom_writes_after(prov, ee0));
+
+			table = change(table, n, rng, round++);
+			ee0 = sim_eeprom_writes();
+			state = prov.sync(table, std::nullopt, &st);
+			report("unknown, hashes", n, st, eeprom_writes_after(prov, ee0));
+		}
+
+		// A full upload: every slot in a write frame, every record byte
+		// programmed into both banks
+		door::SyncStats full;
+		full.frames = static_cast<unsigned>(slots + 3);
+		full.records = static_cast<unsigned>(slots);
+		full.tx_bytes = slots * (FRAME_OVERHEAD + 2 + USERS_RECORD_LEN) + 3 * (FRAME_OVERHEAD + 2);
+		full.rx_bytes = slots * (FRAME_OVERHEAD + 1) + 3 * (FRAME_OVERHEAD + 10);
+		report("full upload", slots, full, 2 * slots * USERS_RECORD_LEN);
+
+		// "Hello!" and 0xDEADBEEF twice, 20 bytes
+		std::istringstream csv("3,totp:JBSWY3DPEHPK3PXPJBSWY3DPEHPK3PXP,Ms Onetime\n");
+		table.read_csv(csv);
+		ee0 = sim_eeprom_writes();
+		state = prov.sync(table, state, &st);
+		report("one-time code user", 1, st, eeprom_writes_after(prov, ee0));
+		const uint8_t *entry = sim_eeprom() + EE_TOTP;
+		if (st.secrets != 1 || entry[0] != 3 || entry[1] != 0 ||
+		    !std::equal(table.secret(3)->begin(), table.secret(3)->end(), entry + 2))
+			throw std::runtime_error("secret of the one-time code user not kept");
+	} catch (const std::exception &e) {
+		std::fprintf(stderr, "doorsync_bench: %s\n", e.what());
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,182 @@
+// Delta sync of a door's user table (see users.h in the firmware).
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include "provisioner.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+namespace door {
+
+namespace {
+
+uint16_t le16(const std::vector<uint8_t> &v, size_t i)
+{
+	return static_cast<uint16_t>(v[i] | (v[i + 1] << 8));
+}
+
+std::vector<uint8_t> u16(unsigned v)
+{
+	return {static_cast<uint8_t>(v & 0xFF), static_cast<uint8_t>(v >> 8)};
+}
+
+} // namespace
+
+std::optional<DoorState> DoorState::load(const std::string &path)
+{
+	std::ifstream in(path);
+	std::string word;
+	DoorState s;
+	if (!(in >> word >> s.version) || word != "version")
+		return std::nullopt;
+	s.table.read_csv(in);
+	return s;
+}
+
+void DoorState::save(const std::string &path) const
+{
+	std::ofstream out(path);
+	if (!out)
+		throw std::runtime_error("cannot write " + path);
+	out << "version " << version << '\n';
+	table.write_csv(out);
+}
+
+std::vector<uint8_t> Provisioner::request(uint8_t type, const std::vector<uint8_t> &payload,
+                                          size_t min_len, SyncStats &stats)
+{
+	std::vector<uint8_t> reply;
+	const uint64_t tx = bus_.bytes_sent(), rx = bus_.bytes_received();
+	const bool ok = bus_.request(addr_, type, payload.data(), static_cast<uint8_t>(payload.size()),
+	                             timeout_ms_, reply);
+	stats.frames++;
+	stats.tx_bytes += bus_.bytes_sent() - tx;
+	stats.rx_bytes += bus_.bytes_received() - rx;
+	if (!ok)
+		throw std::runtime_error("door " + std::to_string(addr_) + " does not answer");
+	if (reply.size() < min_len)
+		throw std::runtime_error("short reply");
+	return reply;
+}
+
+std::vector<uint8_t> Provisioner::call(uint8_t type, const std::vector<uint8_t> &payload,
+                                       size_t min_len, SyncStats &stats)
+{
+	auto reply = request(type, payload, min_len, stats);
+	if (reply[0] == USR_BAD_VERSION)
+		throw std::runtime_error("table changed by someone else, version " +
+		                         std::to_string(le16(reply, 1)));
+	if (reply[0] == USR_BUSY)
+		return reply;
+	if (reply[0] != USR_OK)
+		throw std::runtime_error("door refused, status " + std::to_string(reply[0]));
+	return reply;
+}
+
+std::vector<size_t> Provisioner::changed_by_hashes(const UserTable &desired, size_t buckets,
+                                                   size_t bucket_size, SyncStats &stats)
+{
+	std::vector<size_t> changed;
+	std::vector<size_t> bad_buckets;
+	for (size_t first = 0; first < buckets;) {
+		auto r = call(FT_USR_BUCKETS, u16(first), 2, stats);
+		const size_t n = r[1];
+		if (n == 0 || r.size() < 2 + 2 * n)
+			throw std::runtime_error("bad bucket reply");
+		for (size_t i = 0; i < n; i++)
+			if (le16(r, 2 + 2 * i) != desired.bucket_hash(first + i, bucket_size))
+				bad_buckets.push_back(first + i);
+		first += n;
+	}
+	for (size_t b : bad_buckets) {
+		auto r = call(FT_USR_HASHES, u16(b), 2, stats);
+		const size_t n = r[1];
+		for (size_t i = 0; i < n && 2 + 2 * i + 1 < r.size(); i++)
+			if (le16(r, 2 + 2 * i) != desired.hash(b * bucket_size + i))
+				changed.push_back(b * bucket_size + i);
+	}
+	return changed;
+}
+
+bool Provisioner::busy()
+{
+	SyncStats stats;
+	return call(FT_USR_INFO, {}, 10, stats)[9] & USERS_INFO_COPYING;
+}
+
+DoorState Provisioner::sync(const UserTable &desired_in, const std::optional<DoorState> &known,
+                            SyncStats *stats_out)
+{
+	SyncStats stats;
+	auto info = call(FT_USR_INFO, {}, 10, stats);
+	const uint16_t version = le16(info, 1);
+	const size_t slots = le16(info, 4);
+	const size_t bucket_size = info[6];
+	const uint16_t root = le16(info, 7);
+	if (bucket_size == 0)
+		throw std::runtime_error("bad info reply");
+
+	UserTable desired = desired_in;
+	for (size_t s = slots; s < desired.size(); s++)
+		if (desired.at(s) != UserRecord{})
+			throw std::runtime_error("slot " + std::to_string(s) + " does not fit, the door has " +
+			                         std::to_string(slots));
+	desired.resize(slots);
+
+	std::vector<size_t> changed;
+	if (known && known->version == version && known->table.size() == slots &&
+	    known->table.root() == root) {
+		for (size_t s = 0; s < slots; s++)
+			if (known->table.at(s) != desired.at(s))
+				changed.push_back(s);
+	} else {
+		stats.by_hashes = true;
+		changed = changed_by_hashes(desired, (slots + bucket_size - 1) / bucket_size, bucket_size,
+		                            stats);
+	}
+
+	DoorState result{version, desired};
+	if (!changed.empty()) {
+		// The door may still be copying the last sync to its other bank,
+		// about 3.4 ms per changed EEPROM byte
+		const auto give_up = std::chrono::steady_clock::now() + std::chrono::minutes(2);
+		while (call(FT_USR_BEGIN, u16(version), 3, stats)[0] == USR_BUSY) {
+			if (std::chrono::steady_clock::now() > give_up)
+				throw std::runtime_error("door stays busy");
+			std::this_thread::sleep_for(std::chrono::milliseconds(200));
+		}
+		for (size_t s : changed) {
+			auto payload = u16(static_cast<unsigned>(s));
+			payload.insert(payload.end(), desired.at(s).begin(), desired.at(s).end());
+			call(FT_USR_WRITE, payload, 1, stats);
+			stats.records++;
+		}
+		result.version = static_cast<uint16_t>(version + 1);
+		auto r = call(FT_USR_COMMIT, u16(result.version), 3, stats);
+		if (le16(r, 1) != desired.root())
+			throw std::runtime_error("door root differs after commit");
+	}
+
+	for (size_t s = 0; s < slots; s++) {
+		const TotpSecret *secret = desired.secret(s);
+		if (!secret || !(desired.at(s)[0] & USER_F_TOTP))
+			continue;
+		auto payload = u16(static_cast<unsigned>(s));
+		payload.insert(payload.end(), secret->begin(), secret->end());
+		const auto r = request(FT_TOTP_SECRET, payload, 1, stats);
+		if (r[0] != TOTP_OK)
+			throw std::runtime_error("door refused the secret of slot " + std::to_string(s) +
+			                         ", status " + std::to_string(r[0]));
+		stats.secrets++;
+	}
+
+	if (stats_out)
+		*stats_out = stats;
+	return result;
+}
+
+} // namespace door
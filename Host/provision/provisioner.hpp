@@ -0,0 +1,68 @@
+// Delta sync of a door's user table (see users.h in the firmware).
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#pragma once
+
+#include "bus_master.hpp"
+#include "user_table.hpp"
+
+#include <optional>
+#include <string>
+
+namespace door {
+
+// What the tool last committed to a door.
+struct DoorState {
+	uint16_t version = 0;
+	UserTable table;
+
+	// "version N" followed by the table as CSV
+	static std::optional<DoorState> load(const std::string &path);
+	void save(const std::string &path) const;
+};
+
+struct SyncStats {
+	unsigned frames = 0;        // Requests, each has one reply
+	uint64_t tx_bytes = 0;
+	uint64_t rx_bytes = 0;
+	unsigned records = 0;       // Records written
+	unsigned secrets = 0;       // TOTP secrets sent
+	bool by_hashes = false;     // Version unknown, compared hashes
+
+	// Time on the wire at a baud rate, 10 bits per byte
+	double wire_ms(int baud) const { return (tx_bytes + rx_bytes) * 10000.0 / baud; }
+};
+
+class Provisioner {
+public:
+	Provisioner(BusMaster &bus, uint8_t addr, int timeout_ms = 500)
+		: bus_(bus), addr_(addr), timeout_ms_(timeout_ms) {}
+
+	// Makes the door's table equal to desired. With known matching the
+	// door's version and root, the changed slots come from comparing
+	// known and desired, otherwise from the door's hashes. Throws
+	// std::runtime_error when the door does not answer or disagrees.
+	// The TOTP secrets of desired follow the commit, all of them each
+	// time: the door keeps one it has with its last used step.
+	DoorState sync(const UserTable &desired, const std::optional<DoorState> &known,
+	               SyncStats *stats = nullptr);
+
+	// True while the door copies the last sync to its other bank.
+	bool busy();
+
+private:
+	std::vector<uint8_t> request(uint8_t type, const std::vector<uint8_t> &payload, size_t min_len,
+	                             SyncStats &stats);
+	std::vector<uint8_t> call(uint8_t type, const std::vector<uint8_t> &payload, size_t min_len,
+	                          SyncStats &stats);
+	std::vector<size_t> changed_by_hashes(const UserTable &desired, size_t buckets,
+	                                      size_t bucket_size, SyncStats &stats);
+
+	BusMaster &bus_;
+	uint8_t addr_;
+	int timeout_ms_;
+};
+
+} // namespace door
@@ -0,0 +1,235 @@
+// Host copy of a door's user table (see users.h in the firmware).
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include "user_table.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+extern "C" {
+#include "pin.h"
+#include "relay.h"
+#include "schedule.h"
+#include "sha1.h"
+#include "sound.h"
+}
+
+namespace door {
+
+namespace {
+
+const char kBase32[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+const std::string kTotpPrefix = "totp:";
+const std::string kTotpCred = "totp=";
+
+// RFC 4648 base32 as authenticator apps show their secrets, lower case
+// and the padding accepted
+bool base32_decode(const std::string &text, uint8_t *out, size_t len)
+{
+	uint32_t bits = 0;
+	unsigned n = 0;
+	size_t got = 0;
+	for (char c : text) {
+		if (c == '=')
+			break;
+		const char *p = std::strchr(kBase32, std::toupper(static_cast<unsigned char>(c)));
+		if (c == '\0' || !p)
+			return false;
+		bits = bits << 5 | static_cast<uint32_t>(p - kBase32);
+		n += 5;
+		if (n >= 8) {
+			n -= 8;
+			if (got == len)
+				return false;
+			out[got++] = static_cast<uint8_t>(bits >> n);
+		}
+	}
+	return got == len && (bits & ((1u << n) - 1)) == 0;
+}
+
+// "=" or "totp=" and the 16 hex digits of a credential
+bool hex_cred(const std::string &text, size_t from, uint8_t *cred)
+{
+	if (text.size() != from + 2 * USERS_CRED_LEN ||
+	    !std::all_of(text.begin() + from, text.end(), [](unsigned char c) { return std::isxdigit(c) != 0; }))
+		return false;
+	for (size_t i = 0; i < USERS_CRED_LEN; i++)
+		cred[i] = static_cast<uint8_t>(std::stoul(text.substr(from + 2 * i, 2), nullptr, 16));
+	return true;
+}
+
+// totp_fingerprint() of the firmware
+void fingerprint(const TotpSecret &secret, uint8_t *cred)
+{
+	uint8_t digest[SHA1_LEN];
+	sha1_t s;
+	sha1_init(&s);
+	sha1_update(&s, secret.data(), static_cast<uint8_t>(secret.size()));
+	sha1_final(&s, digest);
+	std::memcpy(cred, digest, USERS_CRED_LEN);
+}
+
+} // namespace
+
+TotpSecret UserTable::totp_secret(const std::string &pin)
+{
+	TotpSecret secret;
+	if (pin.compare(0, kTotpPrefix.size(), kTotpPrefix) != 0 ||
+	    !base32_decode(pin.substr(kTotpPrefix.size()), secret.data(), secret.size()))
+		throw std::invalid_argument("bad TOTP secret '" + pin + "', " +
+		                            std::to_string(TOTP_SECRET_LEN) + " bytes in base32 expected");
+	return secret;
+}
+
+const TotpSecret *UserTable::secret(size_t slot) const
+{
+	const auto it = secrets_.find(slot);
+	return it == secrets_.end() ? nullptr : &it->second;
+}
+
+UserRecord UserTable::make(const std::string &pin, const std::string &name, uint8_t unlock,
+                          uint8_t chime, uint8_t schedule)
+{
+	user_t u{};
+	u.flags = USER_F_ACTIVE;
+	if (pin.compare(0, kTotpPrefix.size(), kTotpPrefix) == 0) {
+		fingerprint(totp_secret(pin), u.cred);
+		u.flags |= USER_F_TOTP;
+	} else if (pin.compare(0, kTotpCred.size(), kTotpCred) == 0) {
+		if (!hex_cred(pin, kTotpCred.size(), u.cred))
+			throw std::invalid_argument("bad TOTP credential '" + pin + "'");
+		u.flags |= USER_F_TOTP;
+	} else if (pin.compare(0, 1, "=") != 0 || !hex_cred(pin, 1, u.cred)) {
+		if (pin.size() < PIN_MIN || pin.size() > PIN_MAX ||
+		    !std::all_of(pin.begin(), pin.end(), [](char c) { return c >= '0' && c <= '9'; }))
+			throw std::invalid_argument("bad PIN '" + pin + "'");
+		const uint64_t cred = pin_hash(pin.data(), static_cast<uint8_t>(pin.size()));
+		for (size_t i = 0; i < USERS_CRED_LEN; i++)
+			u.cred[i] = static_cast<uint8_t>(cred >> (8 * i));
+	}
+	u.flags |= static_cast<uint8_t>(schedule << USER_SCHED_SHIFT) & USER_F_SCHED;
+	std::memcpy(u.name, name.data(), std::min(name.size(), sizeof u.name - 1));
+	u.unlock = unlock;
+	u.chime = chime;
+
+	UserRecord rec;
+	std::memcpy(rec.data(), &u, rec.size());
+	return rec;
+}
+
+uint16_t UserTable::hash(size_t slot) const
+{
+	return users_record_hash(static_cast<uint16_t>(slot), records_.at(slot).data());
+}
+
+uint16_t UserTable::bucket_hash(size_t bucket, size_t bucket_size) const
+{
+	uint16_t h = 0;
+	for (size_t s = bucket * bucket_size; s < size() && s < (bucket + 1) * bucket_size; s++)
+		h ^= hash(s);
+	return h;
+}
+
+uint16_t UserTable::root() const
+{
+	uint16_t h = 0;
+	for (size_t s = 0; s < size(); s++)
+		h ^= hash(s);
+	return h;
+}
+
+void UserTable::read_csv(std::istream &in)
+{
+	std::string line;
+	unsigned lineno = 0;
+	while (std::getline(in, line)) {
+		lineno++;
+		if (line.empty() || line[0] == '#')
+			continue;
+		std::stringstream ss(line);
+		std::string slot, pin, name, unlock, chime, sched;
+		if (!std::getline(ss, slot, ',') || !std::getline(ss, pin, ',') || !std::getline(ss, name, ','))
+			throw std::runtime_error("line " + std::to_string(lineno) + ": expected slot,pin,name");
+		unsigned long seconds = 0;
+		if (std::getline(ss, unlock, ',')) {
+			seconds = std::stoul(unlock);
+			if (seconds > RELAY_UNLOCK_MAX_S)
+				throw std::runtime_error("line " + std::to_string(lineno) + ": unlock time over " +
+				                         std::to_string(RELAY_UNLOCK_MAX_S) + " s");
+		}
+		unsigned long melody = 0;
+		if (std::getline(ss, chime, ',')) {
+			melody = std::stoul(chime);
+			if (melody > MELODIES)
+				throw std::runtime_error("line " + std::to_string(lineno) + ": chime over " +
+				                         std::to_string(MELODIES));
+		}
+		unsigned long schedule = 0;
+		if (std::getline(ss, sched)) {
+			schedule = std::stoul(sched);
+			if (schedule > SCHEDULE_COUNT)
+				throw std::runtime_error("line " + std::to_string(lineno) + ": schedule over " +
+				                         std::to_string(SCHEDULE_COUNT));
+		}
+		const size_t s = std::stoul(slot);
+		if (s >= size())
+			resize(s + 1);
+		set(s, make(pin, name, static_cast<uint8_t>(seconds), static_cast<uint8_t>(melody),
+		            static_cast<uint8_t>(schedule)));
+		if (pin.compare(0, kTotpPrefix.size(), kTotpPrefix) == 0)
+			secrets_[s] = totp_secret(pin);
+		else
+			secrets_.erase(s);
+	}
+}
+
+void UserTable::write_csv(std::ostream &out) const
+{
+	for (size_t s = 0; s < size(); s++) {
+		user_t u;
+		std::memcpy(&u, records_[s].data(), sizeof u);
+		if (!(u.flags & USER_F_ACTIVE))
+			continue;
+		// The PIN or secret itself is not known, only its credential
+		char cred[2 * USERS_CRED_LEN + 1];
+		for (size_t i = 0; i < USERS_CRED_LEN; i++)
+			std::snprintf(cred + 2 * i, 3, "%02x", u.cred[i]);
+		out << s << ',' << (u.flags & USER_F_TOTP ? kTotpCred : "=") << cred;
+		out << ',' << std::string(u.name, strnlen(u.name, sizeof u.name));
+		const unsigned schedule = (u.flags & USER_F_SCHED) >> USER_SCHED_SHIFT;
+		if (u.unlock || u.chime || schedule)
+			out << ',' << static_cast<unsigned>(u.unlock);
+		if (u.chime || schedule)
+			out << ',' << static_cast<unsigned>(u.chime);
+		if (schedule)
+			out << ',' << schedule;
+		out << '\n';
+	}
+}
+
+UserTable UserTable::load_csv(const std::string &path)
+{
+	std::ifstream in(path);
+	if (!in)
+		throw std::runtime_error("cannot read " + path);
+	UserTable t;
+	t.read_csv(in);
+	return t;
+}
+
+void UserTable::save_csv(const std::string &path) const
+{
+	std::ofstream out(path);
+	if (!out)
+		throw std::runtime_error("cannot write " + path);
+	write_csv(out);
+}
+
+} // namespace door
@@ -0,0 +1,73 @@
+// Host copy of a door's user table (see users.h in the firmware).
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#pragma once
+
+#include <array>
+#include <iosfwd>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "totp.h"
+#include "users.h"
+}
+
+namespace door {
+
+using UserRecord = std::array<uint8_t, USERS_RECORD_LEN>;
+using TotpSecret = std::array<uint8_t, TOTP_SECRET_LEN>;
+
+class UserTable {
+public:
+	explicit UserTable(size_t slots = 0) : records_(slots, UserRecord{}) {}
+
+	size_t size() const { return records_.size(); }
+	void resize(size_t slots) { records_.resize(slots, UserRecord{}); }
+	const UserRecord &at(size_t slot) const { return records_.at(slot); }
+	void set(size_t slot, const UserRecord &rec) { records_.at(slot) = rec; }
+	void clear(size_t slot) { records_.at(slot) = UserRecord{}; }
+
+	// Active record, throws std::invalid_argument for a PIN with non
+	// digits, less than PIN_MIN or more than PIN_MAX digits. The record
+	// keeps pin_hash() of the PIN; "=" and the 16 hex digits of a record
+	// written by write_csv() take its credential as it is. "totp:" and a
+	// base32 secret of TOTP_SECRET_LEN bytes make a user of one-time
+	// codes (totp.h), std::invalid_argument for any other length; the
+	// record keeps the fingerprint of the secret, "totp=" and 16 hex
+	// digits take it as it is. unlock is
+	// the unlock time in seconds, 0 for the time of the door. chime is
+	// the melody of a correct PIN + 1, 0 for the melody of the door.
+	// schedule is the access schedule of schedule.h, 0 for any time
+	static UserRecord make(const std::string &pin, const std::string &name, uint8_t unlock = 0,
+	                       uint8_t chime = 0, uint8_t schedule = 0);
+
+	// Secret of a "totp:" user read by read_csv(), kept out of the
+	// record and sent to the door on its own. nullptr for any other
+	// user, and for the "totp=" users of write_csv()
+	static TotpSecret totp_secret(const std::string &pin);
+	const TotpSecret *secret(size_t slot) const;
+
+	uint16_t hash(size_t slot) const;
+	uint16_t bucket_hash(size_t bucket, size_t bucket_size) const;
+	uint16_t root() const;
+
+	// One "slot,pin,name[,unlock[,chime[,schedule]]]" line per user, #
+	// starts a comment
+	static UserTable load_csv(const std::string &path);
+	void save_csv(const std::string &path) const;
+	void write_csv(std::ostream &out) const;
+	void read_csv(std::istream &in);
+
+	bool operator==(const UserTable &o) const { return records_ == o.records_; }
+
+private:
+	std::vector<UserRecord> records_;
+	std::map<size_t, TotpSecret> secrets_;
+};
+
+} // namespace door
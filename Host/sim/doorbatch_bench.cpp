@@ -0,0 +1,253 @@
+// Runs the stream mode of the door bus (bus.c) against a 9600 baud
+// link in simulated time and compares an FT_EVENTS frame per event with
+// the FT_BATCH batches.
+//
+// Time advances in steps of 1.024 ms, 16 steps make a sound tick. The
+// events come in at a steady rate as busy visitors make them: five key
+// presses, then an entry. The link takes 0.98 bytes per step from the
+// transmit buffer of the door, whose room uart_tx_free() reports, and
+// the master side acknowledges every frame as soon as it has arrived.
+// Each rate runs in its own process, so the door starts afresh.
+//
+// Usage: doorbatch_bench [seconds per rate] [rate of the histograms]
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include "events.hpp"
+#include "frame.hpp"
+#include "serial.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+extern "C" {
+#include "bus.h"
+#include "eemap.h"
+#include "event.h"
+#include "hal.h"
+#include "sim.h"
+}
+
+namespace {
+
+constexpr double kStepSeconds = 1.024e-3;
+constexpr unsigned kStepsPerTick = 16;                 // EVENT_TICK_US
+constexpr double kBytesPerStep = 960.0 * kStepSeconds; // 9600 baud, 10 bits a byte
+constexpr int kTxRing = 127;                           // UART_TX_BUFFER_SIZE - 1
+
+struct Posted {
+	uint8_t arg;
+	uint64_t step;
+};
+
+struct Result {
+	double delivered = 0;       // Events per second
+	unsigned lost = 0;
+	double bytes = 0;           // Per delivered event
+	double p50 = 0, p99 = 0;    // Milliseconds
+};
+
+class Master {
+public:
+	explicit Master(int fd) : fd_(fd) { frame_rx_reset(&rx_); }
+
+	// A byte off the wire at step now
+	void byte(uint8_t b, uint64_t now, std::deque<Posted> &posted)
+	{
+		if (!frame_rx_byte(&rx_, b))
+			return;
+		if (rx_.type == (FT_BATCH_STATS | FT_REPLY)) {
+			stats.assign(rx_.payload, rx_.payload + rx_.len);
+			return;
+		}
+
+		std::vector<door::Event> events;
+		uint8_t epoch = 0, lost = 0;
+		if (rx_.type == FT_EVENTS) {
+			if (!door::decode_events(rx_.payload, rx_.len, epoch, lost, events))
+				return;
+		} else if (rx_.type != FT_BATCH || !door::decode_batch(rx_.payload, rx_.len, epoch, lost, events)) {
+			return;
+		}
+		this->lost += lost;
+		if (events.empty())
+			return;
+
+		for (const door::Event &e : events) {
+			if (!dedup_.accept(epoch, e.seq))
+				continue;
+			// In order, the lost ones never come
+			while (!posted.empty() && posted.front().arg != e.arg)
+				posted.pop_front();
+			if (!posted.empty()) {
+				latency.push_back((now - posted.front().step) * kStepSeconds * 1e3);
+				posted.pop_front();
+			}
+		}
+		const uint8_t ack[2] = {epoch, events.back().seq};
+		send(FT_EV_ACK, ack, sizeof ack);
+	}
+
+	void send(uint8_t type, const uint8_t *payload, uint8_t len)
+	{
+		std::vector<uint8_t> out;
+		door::append_frame(out, 1, type, 0, payload, len);
+		door::write_all(fd_, out.data(), out.size());
+	}
+
+	std::vector<double> latency;
+	std::vector<uint8_t> stats;
+	unsigned lost = 0;
+
+private:
+	int fd_;
+	frame_rx_t rx_;
+	door::EventDedup dedup_;
+};
+
+double percentile(std::vector<double> v, double p)
+{
+	if (v.empty())
+		return 0;
+	std::sort(v.begin(), v.end());
+	return v[std::min(v.size() - 1, static_cast<size_t>(p * v.size()))];
+}
+
+Result run(double rate, double seconds, bool batch, bool hist)
+{
+	int sv[2];
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) < 0) {
+		std::perror("socketpair");
+		std::exit(1);
+	}
+	fcntl(sv[0], F_SETFL, O_NONBLOCK);
+	fcntl(sv[1], F_SETFL, O_NONBLOCK);
+
+	sim_eeprom_erase();
+	sim_eeprom()[EE_LINK_MODE] = BUS_MODE_STREAM;
+	sim_eeprom()[EE_NODE_ADDR] = 1;
+	hal_init(0);
+	bus_init();
+	bus_batch(BUS_BATCH_WINDOW, batch ? BUS_BATCH_EVENTS : 0);
+	sim_uart_attach(sv[0]);
+
+	Master master(sv[1]);
+	std::deque<uint8_t> wire;
+	std::deque<Posted> posted;
+	double credit = 0, due = 0, second = 0;
+	uint64_t bytes = 0, n = 0;
+	const auto steps = static_cast<uint64_t>(seconds / kStepSeconds);
+
+	for (uint64_t t = 0; t < steps; t++) {
+		// Timer/Counter2 and Timer/Counter1 handlers
+		if (t % kStepsPerTick == 0)
+			event_tick_sound();
+		if ((second += kStepSeconds) >= 1.0) {
+			second -= 1.0;
+			event_tick();
+		}
+
+		for (due += rate * kStepSeconds; due >= 1.0; due -= 1.0, n++) {
+			const uint8_t arg = static_cast<uint8_t>(n);
+			posted.push_back({arg, t});
+			// Key presses are queued for batches only, the same load
+			// is entries without them
+			event_post(n % 6 == 5 || !batch ? EV_ENTRY : EV_KEY, arg);
+		}
+
+		// Main loop, the door sees the room the link has left
+		sim_uart_tx_room(std::max(0, kTxRing - static_cast<int>(wire.size())));
+		bus_task();
+		uint8_t buf[256];
+		ssize_t got;
+		while ((got = ::read(sv[1], buf, sizeof buf)) > 0) {
+			wire.insert(wire.end(), buf, buf + got);
+			bytes += static_cast<uint64_t>(got);
+		}
+
+		// The link
+		credit = std::min(credit + kBytesPerStep, wire.empty() ? 1.0 : 1e9);
+		while (credit >= 1.0 && !wire.empty()) {
+			master.byte(wire.front(), t, posted);
+			wire.pop_front();
+			credit -= 1.0;
+		}
+	}
+
+	Result r;
+	r.delivered = master.latency.size() / seconds;
+	r.lost = master.lost;
+	r.bytes = master.latency.empty() ? 0 : static_cast<double>(bytes) / master.latency.size();
+	r.p50 = percentile(master.latency, 0.5);
+	r.p99 = percentile(master.latency, 0.99);
+
+	if (hist) {
+		master.send(FT_BATCH_STATS, nullptr, 0);
+		uint8_t buf[256];
+		ssize_t got;
+		for (int i = 0; i < 100 && master.stats.empty(); i++) {
+			sim_uart_tx_room(kTxRing);
+			bus_task();
+			while ((got = ::read(sv[1], buf, sizeof buf)) > 0)
+				for (ssize_t j = 0; j < got; j++)
+					master.byte(buf[j], steps, posted);
+		}
+		if (master.stats.size() >= BATCH_STATS_LEN) {
+			const auto u16 = [&](unsigned i) { return master.stats[2 * i] | master.stats[2 * i + 1] << 8; };
+			static const char *const kSizes[BUS_HIST_SIZES] = {"1", "2-3", "4-7", "8+"};
+			std::printf("  batch size ");
+			for (unsigned i = 0; i < BUS_HIST_SIZES; i++)
+				std::printf(" %s:%u", kSizes[i], u16(i));
+			std::printf("\n  latency ms ");
+			for (unsigned i = 0; i < BUS_HIST_LATENCIES; i++) {
+				const unsigned lo = i ? 1u << (i - 1) : 0;
+				std::printf(" %s%.0f:%u", i == BUS_HIST_LATENCIES - 1 ? ">=" : "",
+				            lo * EVENT_TICK_US / 1e3, u16(BUS_HIST_SIZES + i));
+			}
+			std::printf("\n");
+		}
+	}
+	::close(sv[0]);
+	::close(sv[1]);
+	return r;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	const double seconds = argc > 1 ? std::atof(argv[1]) : 30;
+	const double histRate = argc > 2 ? std::atof(argv[2]) : 60;
+	if (seconds <= 0) {
+		std::fprintf(stderr, "usage: doorbatch_bench [seconds per rate] [rate of the histograms]\n");
+		return 2;
+	}
+
+	std::printf("%-7s %8s %10s %7s %11s %9s %9s\n", "frames", "offered", "delivered", "lost",
+	            "bytes/event", "p50 ms", "p99 ms");
+	for (double rate : {10.0, 20.0, 40.0, 60.0, 80.0, 120.0, 160.0, 240.0}) {
+		for (bool batch : {false, true}) {
+			std::fflush(stdout);
+			const pid_t pid = fork();
+			if (pid == 0) {
+				const bool hist = batch && rate == histRate;
+				const Result r = run(rate, seconds, batch, hist);
+				std::printf("%-7s %8.0f %10.1f %7u %11.2f %9.0f %9.0f\n", batch ? "batch" : "events",
+				            rate, r.delivered, r.lost, r.bytes, r.p50, r.p99);
+				std::fflush(stdout);
+				_exit(0);
+			}
+			int status;
+			waitpid(pid, &status, 0);
+		}
+	}
+	return 0;
+}
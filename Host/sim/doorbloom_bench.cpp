@@ -0,0 +1,178 @@
+// Measures the filter in front of the user table lookup (users.c) on a
+// simulated door with a 512 slot table. The table is filled with 8 to
+// 512 users of random PINs; every user must still be found, and of a
+// million wrong entries the share the filter lets past is compared with
+// the rate a Bloom filter of this size should have. For the entries it
+// turns away it prints what the lookup would have cost: the EEPROM reads
+// and the time of a wrong entry that got past it. Last a user is removed
+// and must no longer be found.
+//
+// Usage: doorbloom_bench [wrong entries]
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "hal.h"
+#include "pin.h"
+#include "sim.h"
+#include "users.h"
+}
+
+namespace {
+
+// Filter bits and bits per credential of users.c for USERS_MAX 512
+constexpr double kBloomBits = 8192;
+constexpr double kProbes = 4;
+
+unsigned wrong = 0;
+
+void check(bool ok, const char *what)
+{
+	if (!ok && wrong++ < 10)
+		std::fprintf(stderr, "doorbloom_bench: %s\n", what);
+}
+
+void begin()
+{
+	uint8_t req[2], reply[FRAME_PAYLOAD_MAX];
+	const uint16_t ver = users_version();
+	req[0] = ver & 0xFF;
+	req[1] = ver >> 8;
+	users_frame(FT_USR_BEGIN, req, 2, reply);
+	check(reply[0] == USR_OK, "sync not opened");
+}
+
+void write(uint16_t slot, const user_t &u)
+{
+	uint8_t req[2 + USERS_RECORD_LEN], reply[FRAME_PAYLOAD_MAX];
+	req[0] = slot & 0xFF;
+	req[1] = slot >> 8;
+	std::memcpy(req + 2, &u, USERS_RECORD_LEN);
+	users_frame(FT_USR_WRITE, req, sizeof req, reply);
+	check(reply[0] == USR_OK, "record not written");
+}
+
+void commit()
+{
+	uint8_t req[2], reply[FRAME_PAYLOAD_MAX];
+	const uint16_t ver = users_version() + 1;
+	req[0] = ver & 0xFF;
+	req[1] = ver >> 8;
+	users_frame(FT_USR_COMMIT, req, 2, reply);
+	check(reply[0] == USR_OK, "sync not committed");
+	for (unsigned i = 0; i < USERS_MAX; i++)
+		users_task();
+}
+
+user_t make_user(uint64_t cred)
+{
+	user_t u = {};
+	u.flags = USER_F_ACTIVE;
+	for (unsigned i = 0; i < USERS_CRED_LEN; i++)
+		u.cred[i] = static_cast<uint8_t>(cred >> (8 * i));
+	std::snprintf(u.name, sizeof u.name, "User");
+	return u;
+}
+
+template <class F> double seconds(F f)
+{
+	const auto t0 = std::chrono::steady_clock::now();
+	f();
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	const long entries = argc > 1 ? std::atol(argv[1]) : 1000000;
+	if (entries <= 0) {
+		std::fprintf(stderr, "usage: doorbloom_bench [wrong entries]\n");
+		return 2;
+	}
+
+	sim_eeprom_erase();
+	hal_init(0);
+	users_init();
+	for (unsigned i = 0; i < USERS_MAX; i++)
+		users_task();
+
+	// PINs of 4 to 10 digits, finished the way the key pad does
+	std::mt19937_64 rng(49);
+	std::vector<uint64_t> creds;
+	const auto random_pin = [&] {
+		std::string pin(PIN_MIN + rng() % (PIN_MAX - PIN_MIN + 1), '0');
+		for (char &c : pin)
+			c = static_cast<char>('0' + rng() % 10);
+		return pin_hash(pin.data(), static_cast<uint8_t>(pin.size()));
+	};
+
+	std::printf("users  past filter  expected  reads/past  ns/entry  ns/past  reads saved/entry\n");
+	uint16_t filled = 0;
+	for (unsigned users : {8u, 64u, 256u, 512u}) {
+		begin();
+		for (; filled < users; filled++) {
+			uint64_t cred;
+			do
+				cred = random_pin();
+			while (std::find(creds.begin(), creds.end(), cred) != creds.end());
+			creds.push_back(cred);
+			write(filled, make_user(creds.back()));
+		}
+		commit();
+		for (uint16_t s = 0; s < users; s++)
+			check(users_match(creds[s]) == s, "user not found");
+
+		// Wrong entries: keyed hashes of PINs nobody has, as good as random
+		std::vector<uint64_t> past;
+		uint64_t sink = 0;
+		std::vector<uint64_t> tries(static_cast<size_t>(entries));
+		for (uint64_t &c : tries)
+			c = rng();
+		const double all = seconds([&] {
+			for (uint64_t c : tries)
+				sink += static_cast<uint64_t>(users_match(c));
+		});
+		for (uint64_t c : tries)
+			if (users_maybe(c))
+				past.push_back(c);
+		check(sink == static_cast<uint64_t>(-entries), "wrong entry taken");
+
+		// The lookup the others are spared
+		const uint64_t reads0 = sim_eeprom_reads();
+		const double past_s = seconds([&] {
+			for (unsigned r = 0; r < 100; r++)
+				for (uint64_t c : past)
+					sink += static_cast<uint64_t>(users_match(c));
+		});
+		const double lookups = 100.0 * past.size();
+		const double reads = past.empty() ? 0 : (sim_eeprom_reads() - reads0) / lookups;
+
+		const double rate = static_cast<double>(past.size()) / entries;
+		const double expect = std::pow(1 - std::exp(-kProbes * users / kBloomBits), kProbes);
+		check(rate < 2 * expect + 1e-5, "filter lets past far more than it should");
+		std::printf("%5u  %9.4f %%  %6.4f %%  %10.2f  %8.1f  %7.1f  %17.2f\n", users, 100 * rate, 100 * expect,
+		            reads, all / entries * 1e9, past.empty() ? 0 : past_s / lookups * 1e9, (1 - rate) * reads);
+	}
+
+	// A removed user is gone from the filter and the index
+	begin();
+	write(7, user_t{});
+	commit();
+	check(users_match(creds[7]) == -1, "removed user still found");
+	check(users_match(creds[8]) == 8, "user lost with the removal of another");
+
+	std::printf("users  found, removed and %ld wrong entries a fill checked, %u wrong\n", entries, wrong);
+	return wrong ? 1 : 0;
+}
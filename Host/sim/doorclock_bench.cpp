@@ -0,0 +1,133 @@
+// Runs the door logic of the firmware (door.c) with its clock governor
+// (cpuclk.c) through hours of simulated time and prints how long the
+// CPU ran at each clock and the cycles per wall clock second this gives.
+//
+// Time advances in key pad ticks of 4.096 ms, the sound and second ticks
+// follow as the timers would call them. Visitors arrive at random and
+// type a correct or a wrong pin, or ring the door bell, with 0.4 s
+// between the keys. The governor is driven as main.c does: woken by the
+// key pad handler, called with door_idle() from the main loop.
+//
+// Usage: doorclock_bench [hours] [visitors per hour]
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <random>
+
+extern "C" {
+#include "bus.h"
+#include "cpuclk.h"
+#include "door.h"
+#include "event.h"
+#include "hal.h"
+#include "lcdfb.h"
+#include "sim.h"
+#include "users.h"
+}
+
+namespace {
+
+constexpr double kCpuHz = 16e6;
+constexpr double kTickSeconds = 256.0 * 256.0 / kCpuHz;    // Timer/Counter0 overflow
+constexpr unsigned kSoundTicks = 4;                        // 16.384 ms
+constexpr unsigned kTickSteps = 256;                       // Timer/Counter1 steps of 16 us
+constexpr unsigned kKeyGapTicks = 98;                      // 0.4 s
+
+// Keys of one visitor, pins of the default users written by users.c
+void visitor(std::mt19937 &rng, std::deque<char> &keys)
+{
+	static const char *const kPins[] = {"3467", "4324", "1962", "7034"};
+	const unsigned kind = rng() % 20;
+
+	if (kind < 3) {
+		keys.push_back('#');
+		return;
+	}
+	keys.push_back('*');
+	const char *pin = kind < 15 ? kPins[rng() % 4] : "0000";
+	for (int i = 0; i < 4; i++)
+		keys.push_back(pin[i]);
+	keys.push_back('#');
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	const double hours = argc > 1 ? std::atof(argv[1]) : 24;
+	const double rate = argc > 2 ? std::atof(argv[2]) : 6;
+	if (hours <= 0 || rate < 0) {
+		std::fprintf(stderr, "usage: doorclock_bench [hours] [visitors per hour]\n");
+		return 2;
+	}
+
+	sim_eeprom_erase();
+	hal_init(0);
+	door_init();
+	bus_init();
+	users_init();
+	cpuclk_init(0);
+
+	std::mt19937 rng(7);
+	std::exponential_distribution<double> arrival(rate / 3600.0 * kTickSeconds);
+	const auto total = static_cast<uint64_t>(hours * 3600.0 / kTickSeconds);
+	uint64_t inState[CPUCLK_STATES] = {};
+	uint64_t next = rate > 0 ? static_cast<uint64_t>(arrival(rng)) : total;
+	uint64_t gap = 0, visitors = 0;
+	unsigned steps = 0;                 // Timer/Counter1 count
+	std::deque<char> keys;
+
+	for (uint64_t t = 0; t < total; t++) {
+		if (t >= next) {
+			visitor(rng, keys);
+			visitors++;
+			next = t + 1 + static_cast<uint64_t>(arrival(rng));
+		}
+		if (!keys.empty() && gap == 0) {
+			sim_key(static_cast<uint8_t>(keys.front()));
+			keys.pop_front();
+			gap = kKeyGapTicks;
+		} else if (gap) {
+			gap--;
+		}
+
+		// Timer/Counter0, Timer/Counter2 and Timer/Counter1 handlers
+		door_tick_keypad();
+		if (!door_idle())
+			cpuclk_full();
+		if (t % kSoundTicks == 0)
+			door_tick_sound();
+		steps += kTickSteps;
+		if (steps >= HAL_SECOND_STEPS) {
+			steps -= HAL_SECOND_STEPS;
+			event_tick();
+			door_tick_second();
+		}
+
+		// Main loop
+		cpuclk_task(door_idle());
+		door_task();
+		lcdfb_flush();
+		inState[cpuclk_state()]++;
+	}
+
+	const double seconds = static_cast<double>(total) * kTickSeconds;
+	double cycles = 0;
+	std::printf("simulated   %.1f h, %llu visitors\n", seconds / 3600.0,
+	            static_cast<unsigned long long>(visitors));
+	std::printf("%-8s %12s %7s %12s\n", "clock", "time", "share", "cycles/s");
+	for (unsigned s = 0; s < CPUCLK_STATES; s++) {
+		const double hz = s == CPUCLK_SLOW ? kCpuHz / (1 << CPUCLK_SLOW_SHIFT) : kCpuHz;
+		const double t = static_cast<double>(inState[s]) * kTickSeconds;
+		cycles += t * hz;
+		std::printf("%-8s %10.1f s %6.2f %% %10.2f M\n", s == CPUCLK_SLOW ? "slow" : "full",
+		            t, 100.0 * t / seconds, hz / 1e6);
+	}
+	std::printf("%-8s %12s %7s %10.2f M  (%.1f %% of full speed)\n", "average", "", "",
+	            cycles / seconds / 1e6, 100.0 * cycles / seconds / kCpuHz);
+	return 0;
+}
@@ -0,0 +1,182 @@
+// Changes the settings of the firmware (config.c) on the simulated
+// EEPROM while the power fails and checks what the door loads after the
+// reset.
+//
+// Every change is cut off after 0, 1, 2, ... programmed bytes until one
+// goes through whole, and after each cut config_init() must load either
+// all the settings of before or all of after, nothing in between. Many
+// changes in a row let the generation counter wrap. Banks of an older
+// and of a newer schema and fields out of range are loaded as well.
+//
+// Usage: doorconfig_bench [changes] [seed]
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+extern "C" {
+#include "config.h"
+#include "eemap.h"
+#include "frame.h"
+#include "hal.h"
+#include "sim.h"
+}
+
+namespace {
+
+bool same(const config_t &a, const config_t &b)
+{
+	for (uint8_t i = 0; i < CONFIG_FIELDS; i++) {
+		config_t x = config;
+		config = a;
+		const uint16_t va = config_get(i);
+		config = b;
+		const uint16_t vb = config_get(i);
+		config = x;
+		if (va != vb)
+			return false;
+	}
+	return true;
+}
+
+// A value in the range of a field
+uint16_t pick(uint8_t field, std::mt19937 &rng)
+{
+	static const uint16_t bauds[] = {1200, 2400, 4800, 9600, 19200};
+	if (field == CONFIG_BAUD)
+		return bauds[rng() % 5];
+	const uint16_t max = field == CONFIG_HOLD_DUTY || field == CONFIG_BATCH_WINDOW ? 255 : 16;
+	return static_cast<uint16_t>(1 + rng() % max);
+}
+
+// Writes a bank by hand, as another firmware would have
+void write_bank(uint8_t bank, uint8_t gen, uint8_t schema, const uint8_t *data, uint8_t len)
+{
+	uint8_t *p = sim_eeprom() + EE_CONFIG + bank * CONFIG_BANK_LEN;
+	p[0] = 0xC7;
+	p[1] = gen;
+	p[2] = schema;
+	p[3] = len;
+	std::memcpy(p + CONFIG_HEADER_LEN, data, len);
+	uint16_t crc = 0xFFFF;
+	for (unsigned i = 0; i < 4; i++)
+		crc = frame_crc16(crc, p[i]);
+	for (unsigned i = 0; i < len; i++)
+		crc = frame_crc16(crc, data[i]);
+	p[4] = crc & 0xFF;
+	p[5] = crc >> 8;
+}
+
+unsigned schemas()
+{
+	unsigned wrong = 0;
+	const auto expect = [&](const char *what, uint8_t field, uint16_t want) {
+		if (config_get(field) != want) {
+			std::fprintf(stderr, "%s: %s is %u, expected %u\n", what, config_name(field),
+			             config_get(field), want);
+			wrong++;
+		}
+	};
+
+	// Older schema, only baud, entry and hold
+	sim_eeprom_erase();
+	const uint8_t old[4] = {0x00, 0x4B, 9, 7};  // 19200 Bd
+	write_bank(0, 4, 0, old, sizeof old);
+	config_init();
+	expect("older schema", CONFIG_BAUD, 19200);
+	expect("older schema", CONFIG_ENTRY, 9);
+	expect("older schema", CONFIG_HOLD, 7);
+	expect("older schema", CONFIG_UNLOCK, 3);
+	expect("older schema", CONFIG_BATCH_EVENTS, 8);
+	expect("older schema", CONFIG_TZ, CONFIG_TZ_UTC);
+
+	// Newer schema with fields this firmware does not know, and a
+	// value out of range, in the newer of two banks
+	uint8_t data[CONFIG_DATA_MAX];
+	std::memset(data, 0x55, sizeof data);
+	config = config_t{};
+	config.baud = 4800;
+	config.entry = 200;
+	config.unlock = 12;
+	std::memcpy(data, &config, sizeof config);
+	write_bank(1, 5, CONFIG_SCHEMA + 1, data, sizeof data);
+	config_init();
+	expect("newer schema", CONFIG_BAUD, 4800);
+	expect("newer schema", CONFIG_ENTRY, CONFIG_ENTRY_S);
+	expect("newer schema", CONFIG_UNLOCK, 12);
+
+	// Baud rates the quarter clock cannot keep
+	if (config_set(CONFIG_BAUD, 38400) != CONFIG_E_RANGE || config_set(CONFIG_BAUD, 14400) != CONFIG_E_RANGE) {
+		std::fprintf(stderr, "a baud rate off by more than 2 %% was taken\n");
+		wrong++;
+	}
+	return wrong;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	const long changes = argc > 1 ? std::atol(argv[1]) : 1000;
+	const unsigned seed = argc > 2 ? static_cast<unsigned>(std::atol(argv[2])) : 1;
+	if (changes <= 0) {
+		std::fprintf(stderr, "usage: doorconfig_bench [changes] [seed]\n");
+		return 2;
+	}
+	std::mt19937 rng(seed);
+
+	sim_eeprom_erase();
+	hal_init(0);
+	config_init();
+	unsigned wrong = 0, cuts = 0;
+	uint64_t bytes = 0;
+
+	for (long i = 0; i < changes; i++) {
+		const config_t before = config;
+		config_t after;
+		const uint8_t field = static_cast<uint8_t>(rng() % CONFIG_FIELDS);
+		const uint16_t value = pick(field, rng);
+		if (value == config_get(field))
+			continue;
+
+		// Cut after 0, 1, 2, ... bytes, the first change writes nothing
+		// and gives the settings of after
+		const uint64_t start = sim_eeprom_writes();
+		for (int64_t n = 0;; n++) {
+			sim_eeprom_power(n);
+			const uint8_t st = config_set(field, value);
+			sim_eeprom_power(-1);
+			if (n == 0) {
+				if (st != CONFIG_OK) {
+					std::fprintf(stderr, "%s %u refused\n", config_name(field), value);
+					wrong++;
+					break;
+				}
+				after = config;
+			}
+
+			config_init();
+			if (same(config, after))
+				break;
+			if (!same(config, before) || n > CONFIG_BANK_LEN) {
+				if (wrong++ < 5)
+					std::fprintf(stderr, "change %ld cut after %lld bytes: neither before nor after\n", i,
+					             static_cast<long long>(n));
+				break;
+			}
+			cuts++;
+		}
+		bytes += sim_eeprom_writes() - start;
+	}
+	wrong += schemas();
+
+	std::printf("changes      %ld, cut %u times before they went through\n", changes, cuts);
+	std::printf("loaded       all before or all after each time, %u wrong\n", wrong);
+	std::printf("programmed   %.1f bytes per change, cut ones included\n",
+	            static_cast<double>(bytes) / changes);
+	return wrong ? 1 : 0;
+}
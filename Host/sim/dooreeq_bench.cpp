@@ -0,0 +1,221 @@
+// Runs the EEPROM write queue of the firmware (eeq.c) on the simulated
+// EEPROM with the ready interrupt held back, so the writes stay queued
+// until the bench lets them through one byte at a time.
+//
+// Four slots of 8 bytes are committed the way the setting banks are:
+// the header byte zeroed, the data, then the header with the version.
+// While commits are queued eeq_read() must see them all. Then the power
+// fails after a random number of programmed bytes, and a slot with a
+// header must hold the data of exactly that version. The write cycles
+// the queue saved over the blocking writes are counted. Last the order
+// of eeq_done() calls and the flush before the reply of a user table
+// commit are checked.
+//
+// Usage: dooreeq_bench [rounds] [seed]
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+extern "C" {
+#include "eeq.h"
+#include "hal.h"
+#include "sim.h"
+#include "users.h"
+}
+
+namespace {
+
+constexpr unsigned kSlots = 4;
+constexpr unsigned kSlotLen = 8;
+constexpr uint16_t kBase = SIM_EE_SIZE - kSlots * kSlotLen;    // Past the door's map
+
+unsigned wrong = 0;
+
+void check(bool ok, const char *what)
+{
+	if (!ok && wrong++ < 10)
+		std::fprintf(stderr, "dooreeq_bench: %s\n", what);
+}
+
+uint8_t pattern(uint8_t version, unsigned i)
+{
+	return static_cast<uint8_t>(version * 37 + i * 11);
+}
+
+// Contents as the firmware sees them, and the bytes a blocking write
+// would have programmed
+uint8_t model[kSlots * kSlotLen];
+uint64_t blocking = 0;
+
+void model_write(uint16_t addr, const uint8_t *src, uint8_t len)
+{
+	for (uint8_t i = 0; i < len; i++) {
+		uint8_t &m = model[addr - kBase + i];
+		if (m != src[i])
+			blocking++;
+		m = src[i];
+	}
+	eeq_write(addr, src, len);
+}
+
+void commit(unsigned slot, uint8_t version)
+{
+	const uint16_t addr = kBase + slot * kSlotLen;
+	uint8_t data[kSlotLen];
+	const uint8_t zero = 0;
+
+	for (unsigned i = 1; i < kSlotLen; i++)
+		data[i] = pattern(version, i);
+	model_write(addr, &zero, 1);
+	model_write(addr + 1, data + 1, kSlotLen - 1);
+	model_write(addr, &version, 1);
+}
+
+// Order of the eeq_done() calls
+std::vector<int> calls;
+uint8_t seenAtCall;
+
+void done_first()
+{
+	calls.push_back(1);
+	seenAtCall = sim_eeprom()[kBase];
+}
+
+void done_second()
+{
+	calls.push_back(2);
+}
+
+uint8_t sync_frame(uint8_t type, const uint8_t *req, uint8_t len)
+{
+	uint8_t reply[FRAME_PAYLOAD_MAX];
+	users_frame(type, req, len, reply);
+	return reply[0];
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	const long rounds = argc > 1 ? std::atol(argv[1]) : 20000;
+	const unsigned seed = argc > 2 ? static_cast<unsigned>(std::atol(argv[2])) : 50;
+	if (rounds <= 0) {
+		std::fprintf(stderr, "usage: dooreeq_bench [rounds] [seed]\n");
+		return 2;
+	}
+
+	sim_eeprom_erase();
+	hal_init(0);
+	sim_eeprom_hold(1);
+	std::memset(model, 0xFF, sizeof model);
+
+	std::mt19937 rng(seed);
+	uint8_t version = 1;
+	uint64_t steps = 0, cuts_valid = 0, programmed = 0, written = 0;
+	for (long r = 0; r < rounds; r++) {
+		// Up to three commits while the queue is held
+		blocking = 0;
+		const unsigned n = 1 + rng() % 3;
+		for (unsigned c = 0; c < n; c++) {
+			commit(rng() % kSlots, version);
+			version = version == 255 ? 1 : version + 1;
+			uint8_t seen[sizeof model];
+			eeq_read(seen, kBase, sizeof seen);
+			check(std::memcmp(seen, model, sizeof seen) == 0, "eeq_read missed a queued byte");
+		}
+
+		// Some bytes get through, or all of them
+		const unsigned left = eeq_pending();
+		const int64_t through = (rng() % 4) ? rng() % (left + 1) : -1;
+		const uint64_t before = sim_eeprom_writes();
+		sim_eeprom_power(through);
+		while (eeq_pending()) {
+			hal_ee_poll();
+			steps++;
+		}
+		sim_eeprom_power(-1);
+		if (through < 0) {
+			programmed += sim_eeprom_writes() - before;
+			written += blocking;
+		}
+		check(through < 0 || sim_eeprom_writes() - before <= static_cast<uint64_t>(through),
+		      "more bytes programmed than the power allowed");
+
+		// A header stands for its data, cut or not
+		const uint8_t *ee = sim_eeprom() + kBase;
+		for (unsigned s = 0; s < kSlots; s++) {
+			const uint8_t *p = ee + s * kSlotLen;
+			if (p[0] == 0 || p[0] == 0xFF)
+				continue;
+			bool ok = true;
+			for (unsigned i = 1; i < kSlotLen; i++)
+				ok = ok && p[i] == pattern(p[0], i);
+			check(ok, "header ahead of its data");
+			if (through >= 0)
+				cuts_valid += ok;
+		}
+		if (through < 0)
+			check(std::memcmp(ee, model, sizeof model) == 0, "queue drained to other contents");
+		// After the reset the firmware sees what is in the EEPROM
+		std::memcpy(model, ee, sizeof model);
+	}
+
+	// Unchanged bytes take no write cycle
+	const uint64_t same0 = sim_eeprom_writes();
+	for (unsigned s = 0; s < kSlots; s++)
+		eeq_write(kBase + s * kSlotLen, model + s * kSlotLen, kSlotLen);
+	eeq_flush();
+	check(sim_eeprom_writes() == same0, "unchanged byte programmed");
+
+	// eeq_done() in queue order, after the bytes before it
+	const uint8_t mark = 0x5A;
+	eeq_write(kBase, &mark, 1);
+	eeq_done(done_first);
+	eeq_done(done_second);
+	check(calls.empty(), "eeq_done() called before its turn");
+	eeq_flush();
+	check(calls.size() == 2 && calls[0] == 1 && calls[1] == 2, "eeq_done() calls out of order");
+	check(seenAtCall == mark, "eeq_done() called before the write");
+
+	// The commit of a user table is in EEPROM when the door answers, a
+	// reset right after it keeps the new version
+	sim_eeprom_hold(0);
+	users_init();
+	for (unsigned i = 0; i < USERS_MAX; i++)
+		users_task();
+	sim_eeprom_hold(1);
+	const uint16_t ver = users_version();
+	uint8_t req[2 + USERS_RECORD_LEN] = {};
+	req[0] = ver & 0xFF;
+	req[1] = ver >> 8;
+	check(sync_frame(FT_USR_BEGIN, req, 2) == USR_OK, "sync not opened");
+	req[0] = 3;
+	req[1] = 0;
+	req[2] = USER_F_ACTIVE;
+	std::memcpy(req + 2 + 1 + USERS_CRED_LEN, "Queued", 7);
+	check(sync_frame(FT_USR_WRITE, req, sizeof req) == USR_OK, "record not written");
+	req[0] = (ver + 1) & 0xFF;
+	req[1] = (ver + 1) >> 8;
+	check(sync_frame(FT_USR_COMMIT, req, 2) == USR_OK, "sync not committed");
+	check(eeq_pending() == 0, "commit answered with writes queued");
+	users_task();
+	sim_eeprom_power(0);
+	eeq_flush();
+	sim_eeprom_power(-1);
+	users_init();
+	check(users_version() == static_cast<uint16_t>(ver + 1), "committed table lost at a reset");
+
+	std::printf("commits      %ld rounds of 1 to 3, %llu cut with a valid header, %llu ready interrupts\n", rounds,
+	            static_cast<unsigned long long>(cuts_valid), static_cast<unsigned long long>(steps));
+	std::printf("programmed   %llu bytes of the rounds not cut, %llu with blocking writes (%.1f %%)\n",
+	            static_cast<unsigned long long>(programmed), static_cast<unsigned long long>(written),
+	            written ? 100.0 * programmed / written : 0.0);
+	std::printf("queue        read-through, cuts, unchanged bytes, eeq_done() and flush checked, %u wrong\n", wrong);
+	return wrong ? 1 : 0;
+}
@@ -0,0 +1,106 @@
+// Checks the SipHash-2-4 of the firmware (siphash.c) against the test
+// vectors of the reference implementation, the word at a time functions
+// against siphash24() and the PIN accumulator (pin.c) against the hash
+// of its message, then measures the PIN checks per second.
+//
+// The AVR runs the rounds of siphash_avr.S instead, its vectors and
+// cycles are printed by the boot benchmarks (bench.c, with BENCH).
+//
+// Usage: doorhash_bench [pins]
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+
+extern "C" {
+#include "pin.h"
+#include "siphash.h"
+}
+
+namespace {
+
+// SipHash-2-4 of the messages 00 01 .. len-1 under the key 00 01 .. 0F,
+// len 0 to 63, from vectors.h of the reference implementation
+const uint64_t kVectors[64] = {
+	0x726fdb47dd0e0e31ULL, 0x74f839c593dc67fdULL, 0x0d6c8009d9a94f5aULL,
+	0x85676696d7fb7e2dULL, 0xcf2794e0277187b7ULL, 0x18765564cd99a68dULL,
+	0xcbc9466e58fee3ceULL, 0xab0200f58b01d137ULL, 0x93f5f5799a932462ULL,
+	0x9e0082df0ba9e4b0ULL, 0x7a5dbbc594ddb9f3ULL, 0xf4b32f46226bada7ULL,
+	0x751e8fbc860ee5fbULL, 0x14ea5627c0843d90ULL, 0xf723ca908e7af2eeULL,
+	0xa129ca6149be45e5ULL, 0x3f2acc7f57c29bdbULL, 0x699ae9f52cbe4794ULL,
+	0x4bc1b3f0968dd39cULL, 0xbb6dc91da77961bdULL, 0xbed65cf21aa2ee98ULL,
+	0xd0f2cbb02e3b67c7ULL, 0x93536795e3a33e88ULL, 0xa80c038ccd5ccec8ULL,
+	0xb8ad50c6f649af94ULL, 0xbce192de8a85b8eaULL, 0x17d835b85bbb15f3ULL,
+	0x2f2e6163076bcfadULL, 0xde4daaaca71dc9a5ULL, 0xa6a2506687956571ULL,
+	0xad87a3535c49ef28ULL, 0x32d892fad841c342ULL, 0x7127512f72f27cceULL,
+	0xa7f32346f95978e3ULL, 0x12e0b01abb051238ULL, 0x15e034d40fa197aeULL,
+	0x314dffbe0815a3b4ULL, 0x027990f029623981ULL, 0xcadcd4e59ef40c4dULL,
+	0x9abfd8766a33735cULL, 0x0e3ea96b5304a7d0ULL, 0xad0c42d6fc585992ULL,
+	0x187306c89bc215a9ULL, 0xd4a60abcf3792b95ULL, 0xf935451de4f21df2ULL,
+	0xa9538f0419755787ULL, 0xdb9acddff56ca510ULL, 0xd06c98cd5c0975ebULL,
+	0xe612a3cb9ecba951ULL, 0xc766e62cfcadaf96ULL, 0xee64435a9752fe72ULL,
+	0xa192d576b245165aULL, 0x0a8787bf8ecb74b2ULL, 0x81b3e73d20b49b6fULL,
+	0x7fa8220ba3b2eceaULL, 0x245731c13ca42499ULL, 0xb78dbfaf3a8d83bdULL,
+	0xea1ad565322a1a0bULL, 0x60e61c23a3795013ULL, 0x6606d7e446282b93ULL,
+	0x6ca4ecb15c5f91e1ULL, 0x9f626da15c9625f3ULL, 0xe51b38608ef25f57ULL,
+	0x958a324ceb064572ULL,
+};
+
+const uint8_t kPinKey[SIPHASH_KEY_LEN] = {PIN_KEY};
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	const long pins = argc > 1 ? std::atol(argv[1]) : 1000000;
+	unsigned wrong = 0;
+
+	uint8_t key[SIPHASH_KEY_LEN], msg[64];
+	for (unsigned i = 0; i < sizeof msg; i++)
+		msg[i] = static_cast<uint8_t>(i);
+	std::memcpy(key, msg, sizeof key);
+
+	for (uint8_t len = 0; len < 64; len++) {
+		if (siphash24(key, msg, len) != kVectors[len]) {
+			std::fprintf(stderr, "vector %u wrong\n", len);
+			wrong++;
+		}
+	}
+
+	// A PIN is the message of its digits, one 8 byte word each
+	std::mt19937 rng(1);
+	for (unsigned n = 0; n < 10000; n++) {
+		std::string pin;
+		for (unsigned i = rng() % (PIN_MAX - PIN_MIN + 1) + PIN_MIN; i > 0; i--)
+			pin += static_cast<char>('0' + rng() % 10);
+		uint8_t words[8 * PIN_MAX] = {};
+		for (size_t i = 0; i < pin.size(); i++)
+			words[8 * i] = static_cast<uint8_t>(pin[i]);
+		const uint64_t h = siphash24(kPinKey, words, static_cast<uint8_t>(8 * pin.size()));
+		if (pin_hash(pin.data(), static_cast<uint8_t>(pin.size())) != h) {
+			if (wrong++ < 5)
+				std::fprintf(stderr, "pin %s: accumulator differs from siphash24\n", pin.c_str());
+		}
+	}
+
+	const auto t0 = std::chrono::steady_clock::now();
+	uint64_t sink = 0;
+	char digits[PIN_MAX];
+	for (long n = 0; n < pins; n++) {
+		for (unsigned i = 0; i < PIN_MIN; i++)
+			digits[i] = static_cast<char>('0' + (n >> (4 * i) & 7));
+		sink += pin_hash(digits, PIN_MIN);
+	}
+	const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+	std::printf("vectors      64 and 10000 pins checked, %u wrong\n", wrong);
+	std::printf("pins         %ld of 4 digits in %.2f s, %.2f M/s (%llx)\n", pins, s, pins / s / 1e6,
+	            static_cast<unsigned long long>(sink & 0xFF));
+	return wrong ? 1 : 0;
+}
@@ -0,0 +1,210 @@
+// Runs the door logic of the firmware (door.c) natively through the
+// host HAL and measures how many key presses it handles per second.
+//
+// Every session is one visitor: a correct pin, a wrong pin, a pin entry
+// which times out, or the door bell. Between the key presses the tick
+// handlers run as the timers would call them and the main loop looks the
+// entries up, the waits before standby are skipped by calling the second
+// tick directly. After every session the outputs and the display are
+// checked, a mismatch ends the run.
+//
+// Usage: doorkeys_bench [sessions]
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include "serial.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+
+extern "C" {
+#include "bus.h"
+#include "door.h"
+#include "hal.h"
+#include "lcdfb.h"
+#include "pin.h"
+#include "sim.h"
+#include "users.h"
+}
+
+namespace {
+
+// The default users written by users.c to an erased EEPROM
+struct User {
+	const char *pin;
+	const char *name;
+};
+constexpr User kUsers[] = {
+	{"3467", "Mr Harrman"},
+	{"4324", "Mrs Leyla"},
+	{"1962", "Mr Baglamac"},
+	{"7034", "Mr Demiroren"},
+};
+
+class Door {
+public:
+	Door()
+	{
+		sim_eeprom_erase();
+		hal_init(0);
+		door_init();
+		bus_init();
+		users_init();
+		while (users_task_pending())
+			users_task();
+	}
+
+	// One key pad tick with a key pressed, the sound tick every fourth
+	void press(char key)
+	{
+		sim_key(static_cast<uint8_t>(key));
+		tick();
+		keys_++;
+	}
+
+	// The main loop runs between two key pad ticks
+	void tick()
+	{
+		door_tick_keypad();
+		door_task();
+		if (++ticks_ % (DOOR_SOUND_MS / DOOR_KEYPAD_MS) == 0)
+			door_tick_sound();
+	}
+
+	void seconds(unsigned n)
+	{
+		while (n--)
+			door_tick_second();
+	}
+
+	uint64_t keys() const { return keys_; }
+
+private:
+	static bool users_task_pending()
+	{
+		uint8_t reply[FRAME_PAYLOAD_MAX];
+		users_frame(FT_USR_INFO, nullptr, 0, reply);
+		return reply[9] & USERS_INFO_COPYING;
+	}
+
+	uint64_t keys_ = 0;
+	uint64_t ticks_ = 0;
+};
+
+bool line_has(uint8_t y, const char *text)
+{
+	return std::strstr(sim_display_line(y), text) != nullptr;
+}
+
+bool fail(uint64_t session, const char *what)
+{
+	std::fprintf(stderr, "doorkeys_bench: session %llu: %s\n",
+	             static_cast<unsigned long long>(session), what);
+	for (uint8_t y = 0; y < 4; y++)
+		std::fprintf(stderr, "  |%s|\n", sim_display_line(y));
+	return false;
+}
+
+bool is_user_pin(const std::string &pin)
+{
+	for (const User &u : kUsers)
+		if (pin == u.pin)
+			return true;
+	return false;
+}
+
+bool run_session(Door &door, std::mt19937 &rng, uint64_t session)
+{
+	const unsigned kind = rng() % 8;
+
+	if (kind == 0) {
+		// Door bell, back to standby after 3 seconds
+		door.press('#');
+		lcdfb_flush();
+		if (!line_has(2, "Door bell is"))
+			return fail(session, "no door bell screen");
+		door.seconds(4);
+		door.tick();
+		if (sim_pin(HAL_RELAY))
+			return fail(session, "door bell unlocked the door");
+	} else if (kind == 1) {
+		// Two digits, then the 5 second entry timer runs out
+		door.press('*');
+		door.press(static_cast<char>('0' + rng() % 10));
+		door.press(static_cast<char>('0' + rng() % 10));
+		door.seconds(6);
+		door.tick();
+		door.tick();
+		if (sim_pin(HAL_RELAY) || !sim_pin(HAL_LED_RED))
+			return fail(session, "timed out entry not denied");
+		door.seconds(4);
+		door.tick();
+	} else {
+		// A pin of a user, or 4 to 10 random digits
+		std::string pin;
+		const User *user = nullptr;
+		if (kind < 6) {
+			user = &kUsers[rng() % 4];
+			pin = user->pin;
+		} else {
+			do {
+				pin.clear();
+				for (unsigned i = rng() % (PIN_MAX - PIN_MIN + 1) + PIN_MIN; i > 0; i--)
+					pin += static_cast<char>('0' + rng() % 10);
+			} while (is_user_pin(pin));
+		}
+
+		door.press('*');
+		for (char c : pin)
+			door.press(c);
+		door.press('#');
+		door.tick();
+		lcdfb_flush();
+		if (user) {
+			if (!sim_pin(HAL_RELAY) || !sim_pin(HAL_LED_GREEN))
+				return fail(session, "correct pin did not unlock");
+			if (!line_has(3, user->name))
+				return fail(session, "wrong name shown");
+		} else {
+			if (sim_pin(HAL_RELAY) || !sim_pin(HAL_LED_RED))
+				return fail(session, "wrong pin not denied");
+		}
+		door.seconds(4);
+		door.tick();
+	}
+
+	// Standby: locked, leds off
+	lcdfb_flush();
+	if (sim_pin(HAL_RELAY) || sim_pin(HAL_LED_RED) || sim_pin(HAL_LED_GREEN) ||
+	    !line_has(0, "Dumbledoor wishes"))
+		return fail(session, "not back in standby");
+	return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	const uint64_t sessions = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+
+	Door door;
+	std::mt19937 rng(7);
+
+	const uint64_t t0 = door::now_ns();
+	for (uint64_t s = 0; s < sessions; s++)
+		if (!run_session(door, rng, s))
+			return 1;
+	const double secs = static_cast<double>(door::now_ns() - t0) / 1e9;
+
+	std::printf("sessions    %llu\n", static_cast<unsigned long long>(sessions));
+	std::printf("key presses %llu\n", static_cast<unsigned long long>(door.keys()));
+	std::printf("unlocks     %llu\n", static_cast<unsigned long long>(sim_pin_rises(HAL_RELAY)));
+	std::printf("denials     %llu\n", static_cast<unsigned long long>(sim_pin_rises(HAL_LED_RED)));
+	std::printf("time        %.2f s\n", secs);
+	std::printf("key presses %.2f M/s\n", static_cast<double>(door.keys()) / secs / 1e6);
+	return 0;
+}
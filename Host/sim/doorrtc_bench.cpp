@@ -0,0 +1,292 @@
+// Checks the clock of the firmware (rtc.c) and the access schedules
+// (schedule.c). The hour of the week must follow gmtime() in every time
+// zone, also while the tick counts over the turn of an hour and of the
+// week. The second tick comes every HAL_SECOND_STEPS counts of
+// Timer/Counter1, a good crystal must keep the time to a second a day
+// without trim. A crystal off by some ten ppm is synced by the master once an
+// hour with FT_TIME: the error before each sync must shrink once the
+// trim is learned, and a day without the master must drift less than
+// one without trim. The trim must survive a reset. The schedules left
+// from the older layout must be cleared once. Last a user with a
+// schedule types the PIN inside and outside of the hours, and
+// schedule_allowed() is measured per second.
+//
+// Usage: doorrtc_bench [checks]
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <random>
+#include <string>
+
+extern "C" {
+#include "config.h"
+#include "door.h"
+#include "eemap.h"
+#include "eeq.h"
+#include "hal.h"
+#include "lcdfb.h"
+#include "pin.h"
+#include "rtc.h"
+#include "schedule.h"
+#include "sim.h"
+#include "users.h"
+}
+
+namespace {
+
+const uint32_t kMonday = 1609718400;     // 2021-01-04 00:00 UTC, a Monday
+const double kStepHz = 16e6 / 256;       // Timer/Counter1, prescaler 256
+const uint16_t kSlot = 3;
+const char kPin[] = "2580";
+
+unsigned wrong = 0;
+std::string shown;      // Message line of the last entry
+
+void check(bool ok, const char *what)
+{
+	if (!ok && wrong++ < 10)
+		std::fprintf(stderr, "doorrtc_bench: %s\n", what);
+}
+
+// Hour of the week by the C library
+unsigned gm_hour(uint32_t t, uint8_t tz)
+{
+	const time_t local = static_cast<time_t>(t) + (static_cast<int>(tz) - CONFIG_TZ_UTC) * 900;
+	std::tm tm{};
+	gmtime_r(&local, &tm);
+	return (tm.tm_wday + 6) % 7 * 24 + tm.tm_hour;
+}
+
+void sync(uint32_t t)
+{
+	uint8_t req[4], reply[FRAME_PAYLOAD_MAX];
+	for (unsigned i = 0; i < 4; i++)
+		req[i] = static_cast<uint8_t>(t >> (8 * i));
+	rtc_frame(FT_TIME, req, sizeof req, reply);
+}
+
+// Second ticks of a crystal off by ppm, counted in Timer/Counter1 steps
+// over true seconds, synced every
+// interval seconds until stop. Returns the largest error of the last
+// day, in seconds
+struct Drift {
+	double last_sync_error = 0;     // Before the last sync
+	double day_error = 0;           // A day after the last sync
+};
+
+Drift run_drift(double ppm, uint32_t interval, uint32_t stop, bool learn)
+{
+	Drift d;
+	const uint32_t t0 = kMonday + 1234;
+	double phase = 0;
+
+	sync(0);
+	rtc_set(0);
+	if (learn)
+		sync(t0);
+	else
+		rtc_set(t0);
+	for (uint32_t s = 1; s <= stop + 86400; s++) {
+		phase += kStepHz * (1 + ppm * 1e-6);
+		while (phase >= HAL_SECOND_STEPS) {
+			phase -= HAL_SECOND_STEPS;
+			rtc_tick();
+		}
+		if (learn && s <= stop && s % interval == 0) {
+			d.last_sync_error = static_cast<double>(static_cast<int32_t>(rtc_now() - (t0 + s)));
+			sync(t0 + s);
+		}
+	}
+	d.day_error = static_cast<double>(static_cast<int32_t>(rtc_now() - (t0 + stop + 86400)));
+	return d;
+}
+
+void commit(uint16_t slot, const user_t &u)
+{
+	uint8_t req[2 + USERS_RECORD_LEN], reply[FRAME_PAYLOAD_MAX];
+	const uint16_t ver = users_version();
+
+	req[0] = ver & 0xFF;
+	req[1] = ver >> 8;
+	users_frame(FT_USR_BEGIN, req, 2, reply);
+	req[0] = slot & 0xFF;
+	req[1] = slot >> 8;
+	std::memcpy(req + 2, &u, USERS_RECORD_LEN);
+	users_frame(FT_USR_WRITE, req, sizeof req, reply);
+	req[0] = (ver + 1) & 0xFF;
+	req[1] = (ver + 1) >> 8;
+	users_frame(FT_USR_COMMIT, req, 2, reply);
+	check(reply[0] == USR_OK, "sync not committed");
+	for (unsigned i = 0; i < USERS_MAX; i++)
+		users_task();
+}
+
+// Types an entry and reports whether the door opened
+bool enter(const char *digits)
+{
+	const auto press = [](char key) {
+		sim_key(static_cast<uint8_t>(key));
+		door_tick_keypad();
+		door_task();
+	};
+	press('*');
+	for (const char *c = digits; *c; c++)
+		press(*c);
+	press('#');
+	door_tick_keypad();
+	const bool open = sim_pin(HAL_RELAY);
+	lcdfb_flush();
+	shown = sim_display_line(2);
+	for (unsigned i = 0; i < 4; i++)
+		door_tick_second();
+	door_tick_keypad();
+	return open;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	const long checks = argc > 1 ? std::atol(argv[1]) : 10000000;
+
+	sim_eeprom_erase();
+	hal_init(0);
+	door_init();
+	config_init();
+	rtc_init();
+	users_init();
+	for (unsigned i = 0; i < USERS_MAX; i++)
+		users_task();
+
+	// Hour of the week in every zone, set and counted over the turns
+	check(rtc_hour() == RTC_NO_HOUR, "hour known without a clock");
+	std::mt19937 rng(7);
+	for (unsigned i = 0; i < 2000; i++) {
+		const uint8_t tz = static_cast<uint8_t>(rng() % (CONFIG_TZ_MAX + 1));
+		const uint32_t t = kMonday + rng() % (4 * 365 * 86400U);
+		config_set(CONFIG_TZ, tz);
+		rtc_set(t);
+		check(rtc_hour() == gm_hour(t, tz), "hour of the week wrong after a setting");
+	}
+	config_set(CONFIG_TZ, CONFIG_TZ_UTC + 8);   // UTC+2
+	rtc_set(kMonday - 3 * 3600 - 5);
+	for (unsigned s = 0; s < 3 * 86400; s++) {
+		rtc_tick();
+		if (rtc_hour() != gm_hour(rtc_now(), CONFIG_TZ_UTC + 8)) {
+			check(false, "hour of the week wrong while counting");
+			break;
+		}
+	}
+	config_set(CONFIG_TZ, CONFIG_TZ_UTC);
+
+	// A crystal 80 ppm fast and one 60 ppm slow, synced hourly for three
+	// days, then a day alone
+	const Drift fast = run_drift(80, 3600, 3 * 86400, true);
+	const double fast_trim = rtc_trim() * 1e6 / RTC_TRIM_ONE;
+	const Drift slow = run_drift(-60, 3600, 3 * 86400, true);
+	const double slow_trim = rtc_trim() * 1e6 / RTC_TRIM_ONE;
+	check(std::fabs(fast_trim + 80) < 8, "trim of the fast crystal not learned");
+	check(std::fabs(slow_trim - 60) < 8, "trim of the slow crystal not learned");
+	check(std::fabs(fast.last_sync_error) <= 1, "fast crystal off by more than a second in an hour");
+	check(std::fabs(slow.last_sync_error) <= 1, "slow crystal off by more than a second in an hour");
+
+	// The trim is kept for the next reset
+	const int16_t kept = rtc_trim();
+	rtc_set(0);
+	rtc_init();
+	check(rtc_trim() == kept, "trim lost over a reset");
+
+	// The same crystals without the trim
+	uint8_t erased[3] = {0xFF, 0xFF, 0xFF};
+	eeq_write(EE_RTC_TRIM, erased, sizeof erased);
+	rtc_init();
+	check(rtc_trim() == 0, "erased trim not taken as none");
+	const Drift fast_raw = run_drift(80, 3600, 0, false);
+	const Drift slow_raw = run_drift(-60, 3600, 0, false);
+	const Drift exact = run_drift(0, 3600, 0, false);
+	check(std::fabs(exact.day_error) <= 1, "good crystal off by more than a second a day");
+	check(std::fabs(fast.day_error) * 4 < std::fabs(fast_raw.day_error), "trim did not help the fast crystal");
+	check(std::fabs(slow.day_error) * 4 < std::fabs(slow_raw.day_error), "trim did not help the slow crystal");
+
+	// A log block where the schedules are now is cleared once
+	for (unsigned a = EE_SCHEDULE; a < EE_SCHEDULE_END; a++)
+		sim_eeprom()[a] = static_cast<uint8_t>(a * 7);
+	schedule_init();
+	eeq_flush();
+	uint8_t hours[SCHEDULE_LEN];
+	bool cleared = sim_eeprom()[EE_SCHEDULE_SET] == SCHEDULE_MAGIC;
+	for (uint8_t n = 1; n <= SCHEDULE_COUNT; n++) {
+		schedule_read(n, hours);
+		for (uint8_t b : hours)
+			cleared = cleared && b == 0xFF;
+	}
+	check(cleared, "schedules of the older layout not cleared");
+
+	// Schedule 1: Monday to Friday 8:00 to 18:00
+	uint8_t req[1 + SCHEDULE_LEN] = {1}, reply[FRAME_PAYLOAD_MAX];
+	for (unsigned d = 0; d < 5; d++)
+		for (unsigned h = 8; h < 18; h++)
+			req[1 + (d * 24 + h) / 8] |= static_cast<uint8_t>(1u << ((d * 24 + h) % 8));
+	check(schedule_frame(FT_SCHEDULE, req, sizeof req, reply) == SCHEDULE_REPLY_LEN &&
+	      std::memcmp(reply + 2, req + 1, SCHEDULE_LEN) == 0, "schedule not written");
+	req[0] = SCHEDULE_COUNT + 1;
+	check(schedule_frame(FT_SCHEDULE, req, 1, reply) == 2 && reply[0] == SCHEDULE_E_NUM,
+	      "schedule out of range taken");
+	schedule_init();
+	schedule_read(1, hours);
+	check(std::memcmp(hours, req + 1, SCHEDULE_LEN) == 0, "schedule cleared again at a reset");
+
+	user_t u = {};
+	u.flags = USER_F_ACTIVE | 1 << USER_SCHED_SHIFT;
+	const uint64_t cred = pin_hash(kPin, 4);
+	for (unsigned i = 0; i < USERS_CRED_LEN; i++)
+		u.cred[i] = static_cast<uint8_t>(cred >> (8 * i));
+	std::strcpy(u.name, "Mr Daytime");
+	commit(kSlot, u);
+	check(users_schedule(kSlot) == 1, "schedule of the user lost");
+
+	rtc_set(0);
+	check(!enter(kPin), "scheduled user let in without a clock");
+	rtc_set(kMonday + 10 * 3600);
+	check(enter(kPin), "scheduled user denied on Monday 10:00");
+	rtc_set(kMonday + 7 * 3600 + 3599);
+	check(!enter(kPin), "scheduled user let in on Monday 7:59");
+	check(shown.find("Not at this hour.") != std::string::npos, "off hours not shown");
+	rtc_tick();
+	check(enter(kPin), "scheduled user denied at the tick to 8:00");
+	rtc_set(kMonday + 5 * 86400 + 10 * 3600);
+	check(!enter(kPin), "scheduled user let in on Saturday");
+	check(enter("3467"), "user without a schedule denied on Saturday");
+	rtc_set(kMonday + 7 * 3600 + 1800);
+	check(!enter(kPin), "scheduled user let in on Monday 7:30");
+	config_set(CONFIG_TZ, CONFIG_TZ_UTC + 8);   // 9:30 at UTC+2
+	check(enter(kPin), "zone not applied to the schedule");
+	config_set(CONFIG_TZ, CONFIG_TZ_UTC);
+
+	// Speed of the check on an entry
+	rtc_set(kMonday + 10 * 3600);
+	auto t0 = std::chrono::steady_clock::now();
+	unsigned sink = 0;
+	for (long n = 0; n < checks; n++)
+		sink += schedule_allowed(static_cast<uint8_t>(1 + (n & 1)));
+	const double sc = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+	std::printf("hours        set and counted in 2000 zones and times, entries checked, %u wrong\n", wrong);
+	std::printf("drift        +80 ppm: trim %+.1f ppm, %+.0f s before the last sync, %+.0f s a day later"
+	            " (%+.0f s without trim)\n", fast_trim, fast.last_sync_error, fast.day_error,
+	            fast_raw.day_error);
+	std::printf("             -60 ppm: trim %+.1f ppm, %+.0f s before the last sync, %+.0f s a day later"
+	            " (%+.0f s without trim)\n", slow_trim, slow.last_sync_error, slow.day_error,
+	            slow_raw.day_error);
+	std::printf("               0 ppm: %+.0f s a day, second tick every %u steps of 16 us\n",
+	            exact.day_error, HAL_SECOND_STEPS);
+	std::printf("schedule     %ld checks in %.2f s, %.1f M/s (%u)\n", checks, sc, checks / sc / 1e6, sink & 1);
+	return wrong ? 1 : 0;
+}
@@ -0,0 +1,138 @@
+// Floods the command shell of the firmware (shell.c) over a PTY and
+// checks that every line is answered, in order, while the main loop
+// keeps turning.
+//
+// A client thread writes the lines as fast as the PTY takes them, a
+// mix of valid commands, wrong arguments and unknown words, and reads
+// the result lines. The door side runs shell_task() in a loop like
+// main.c and records the longest single call. On the AVR the shell
+// prints the parse and run cycles of each command itself.
+//
+// Usage: doorshell_bench [lines]
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include "serial.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+extern "C" {
+#include "bus.h"
+#include "door.h"
+#include "hal.h"
+#include "shell.h"
+#include "sim.h"
+#include "sound.h"
+#include "users.h"
+}
+
+namespace {
+
+struct Line {
+	const char *text;
+	const char *result;     // Start of the expected result line
+};
+
+const Line kLines[] = {
+	{"stat\r\n", "ok "},
+	{"user 1\r\n", "ok "},
+	{"sound\r\n", "ok "},
+	{"help stat\r\n", "ok "},
+	{"help cfg\r\n", "ok "},
+	{"user 99\r\n", "error arguments"},
+	{"open sesame\r\n", "error unknown command"},
+	{"stack\r\n", "ok "},
+	{"help\r\n", "ok "},
+	{"cfg\r\n", "ok "},
+	{"cfg baud 38400\r\n", "error arguments"},
+	{"time\r\n", "ok "},
+	{"sched 1\r\n", "ok "},
+};
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	const long lines = argc > 1 ? std::atol(argv[1]) : 20000;
+	if (lines <= 0) {
+		std::fprintf(stderr, "usage: doorshell_bench [lines]\n");
+		return 2;
+	}
+
+	sim_eeprom_erase();
+	hal_init(0);
+	door_init();
+	bus_init();
+	users_init();
+	sound_init();
+	shell_init();
+
+	door::Pty pty = door::open_pty();
+	sim_uart_attach(pty.master);
+	const int client = door::open_serial(pty.slave_path, 9600, true);
+
+	std::atomic<bool> done{false}, stop{false};
+	long answered = 0, wrong = 0;
+	std::thread reader([&] {
+		std::string text;
+		char buf[256];
+		while (answered < lines && !stop) {
+			const ssize_t n = ::read(client, buf, sizeof buf);
+			if (n <= 0) {
+				usleep(100);
+				continue;
+			}
+			text.append(buf, static_cast<size_t>(n));
+			size_t eol;
+			while ((eol = text.find("\r\n")) != std::string::npos) {
+				const std::string l = text.substr(0, eol);
+				text.erase(0, eol + 2);
+				if (l.compare(0, 3, "ok ") != 0 && l.compare(0, 6, "error ") != 0)
+					continue;
+				const char *want = kLines[answered % (sizeof kLines / sizeof kLines[0])].result;
+				if (l.compare(0, std::strlen(want), want) != 0) {
+					if (wrong++ < 5)
+						std::fprintf(stderr, "line %ld: '%s', expected '%s'\n", answered, l.c_str(), want);
+				}
+				answered++;
+			}
+		}
+		done = true;
+	});
+	std::thread writer([&] {
+		for (long i = 0; i < lines && !stop; i++) {
+			const char *t = kLines[i % (sizeof kLines / sizeof kLines[0])].text;
+			door::write_all(client, reinterpret_cast<const uint8_t *>(t), std::strlen(t));
+		}
+	});
+
+	const uint64_t start = door::now_ns();
+	uint64_t longest = 0, calls = 0;
+	while (!done) {
+		const uint64_t t = door::now_ns();
+		shell_task();
+		longest = std::max(longest, door::now_ns() - t);
+		calls++;
+		if (door::now_ns() - start > 60ULL * 1000000000ULL)
+			break;
+	}
+	const double seconds = (door::now_ns() - start) / 1e9;
+	stop = true;
+	writer.join();
+	reader.join();
+	::close(client);
+
+	std::printf("lines        %ld answered, %ld wrong\n", answered, wrong);
+	std::printf("time         %.2f s, %.0f lines/s\n", seconds, answered / seconds);
+	std::printf("shell_task   %llu calls, longest %.1f us\n", static_cast<unsigned long long>(calls),
+	            longest / 1e3);
+	return answered == lines && wrong == 0 ? 0 : 1;
+}
@@ -0,0 +1,285 @@
+// Checks the one-time codes of the firmware (totp.c): HOTP against the
+// test vectors of RFC 4226 and RFC 6238, then a TOTP user on the
+// simulated door. The door must take only the secret its record names
+// with FT_TOTP_SECRET. The codes of the steps t - 1, t and t + 1 must
+// open the door, t - 2 and t + 2 must not, nor a code of the last used
+// step or one before it, also after a sync of the table and after a
+// reset. At the turn of a step totp_task() must compute one code per
+// user and no more. The entries of removed users must be taken again.
+// Last it measures HOTP and totp_match() per second.
+//
+// The time is set with rtc_set() instead of counting seconds, the door
+// logic only sees the entries.
+//
+// Usage: doortotp_bench [matches]
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+extern "C" {
+#include "door.h"
+#include "frame.h"
+#include "hal.h"
+#include "lcdfb.h"
+#include "pin.h"
+#include "rtc.h"
+#include "sim.h"
+#include "totp.h"
+#include "users.h"
+}
+
+namespace {
+
+// RFC 4226 appendix D, counters 0 to 9
+const uint32_t kHotp[10] = {755224, 287082, 359152, 969429, 338314,
+                            254676, 287922, 162583, 399871, 520489};
+
+// RFC 6238 appendix B, SHA1, the last six of the eight digits
+struct TotpVector {
+	uint32_t time;
+	uint32_t code;
+};
+const TotpVector kTotp[] = {
+	{59, 287082}, {1111111109, 81804}, {1111111111, 50471}, {1234567890, 5924}, {2000000000, 279037},
+};
+
+const uint8_t kRfcKey[] = "12345678901234567890";
+const uint8_t kSecret[TOTP_SECRET_LEN] = {0x3D, 0xC6, 0xCA, 0xA4, 0x82, 0x4A, 0x6D, 0x28, 0x5F, 0x11,
+                                          0x90, 0xE7, 0x2B, 0x64, 0xD3, 0x08, 0xA9, 0x7C, 0x45, 0xBE};
+const uint16_t kSlot = 5;
+const uint32_t kStart = 1609459200;     // 2021-01-01 00:00 UTC
+
+unsigned wrong = 0;
+std::string shown;      // Name line of the last entry
+
+void check(bool ok, const char *what)
+{
+	if (!ok && wrong++ < 10)
+		std::fprintf(stderr, "doortotp_bench: %s\n", what);
+}
+
+std::string code_at(uint32_t t, const uint8_t *secret = kSecret)
+{
+	char s[TOTP_DIGITS + 1];
+	std::snprintf(s, sizeof s, "%06u", static_cast<unsigned>(hotp(secret, TOTP_SECRET_LEN, t / TOTP_STEP)));
+	return s;
+}
+
+// Types an entry and reports whether the door opened
+bool enter(const std::string &digits)
+{
+	const auto press = [](char key) {
+		sim_key(static_cast<uint8_t>(key));
+		door_tick_keypad();
+		door_task();
+	};
+	press('*');
+	for (char c : digits)
+		press(c);
+	press('#');
+	door_tick_keypad();
+	const bool open = sim_pin(HAL_RELAY);
+	lcdfb_flush();
+	shown = sim_display_line(3);
+	for (unsigned i = 0; i < 4; i++)
+		door_tick_second();
+	door_tick_keypad();
+	return open;
+}
+
+// totp_task() calls until the cache is complete
+unsigned settle()
+{
+	unsigned calls = 0;
+	do {
+		totp_task();
+		calls++;
+	} while (!totp_ready() && calls < 100);
+	return calls;
+}
+
+void commit(uint16_t slot, const user_t &u)
+{
+	uint8_t req[2 + USERS_RECORD_LEN], reply[FRAME_PAYLOAD_MAX];
+	const uint16_t ver = users_version();
+
+	req[0] = ver & 0xFF;
+	req[1] = ver >> 8;
+	users_frame(FT_USR_BEGIN, req, 2, reply);
+	check(reply[0] == USR_OK, "sync not opened");
+	req[0] = slot & 0xFF;
+	req[1] = slot >> 8;
+	std::memcpy(req + 2, &u, USERS_RECORD_LEN);
+	users_frame(FT_USR_WRITE, req, sizeof req, reply);
+	req[0] = (ver + 1) & 0xFF;
+	req[1] = (ver + 1) >> 8;
+	users_frame(FT_USR_COMMIT, req, 2, reply);
+	check(reply[0] == USR_OK, "sync not committed");
+	for (unsigned i = 0; i < USERS_MAX; i++)
+		users_task();
+}
+
+// Record of a TOTP user, the fingerprint of its secret in cred
+user_t totp_user(const uint8_t *secret, const char *name)
+{
+	user_t u = {};
+	u.flags = USER_F_ACTIVE | USER_F_TOTP;
+	totp_fingerprint(secret, u.cred);
+	std::strcpy(u.name, name);
+	return u;
+}
+
+// FT_TOTP_SECRET, the status of the reply
+uint8_t send_secret(uint16_t slot, const uint8_t *secret, uint8_t len = TOTP_SECRET_LEN)
+{
+	uint8_t req[2 + TOTP_SECRET_LEN], reply[FRAME_PAYLOAD_MAX];
+	req[0] = slot & 0xFF;
+	req[1] = slot >> 8;
+	std::memcpy(req + 2, secret, len);
+	check(totp_frame(FT_TOTP_SECRET, req, static_cast<uint8_t>(2 + len), reply) == 1,
+	      "secret not answered with a status");
+	return reply[0];
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	const long matches = argc > 1 ? std::atol(argv[1]) : 1000000;
+
+	for (uint32_t c = 0; c < 10; c++)
+		check(hotp(kRfcKey, 20, c) == kHotp[c], "RFC 4226 vector wrong");
+	for (const TotpVector &v : kTotp)
+		check(hotp(kRfcKey, 20, v.time / TOTP_STEP) == v.code, "RFC 6238 vector wrong");
+
+	sim_eeprom_erase();
+	hal_init(0);
+	door_init();
+	users_init();
+	for (unsigned i = 0; i < USERS_MAX; i++)
+		users_task();
+
+	// The secret follows the record, only the one the record names
+	user_t u = totp_user(kSecret, "Ms Onetime");
+	check(send_secret(kSlot, kSecret) == TOTP_E_SLOT, "secret taken without its user");
+	commit(kSlot, u);
+	uint8_t wrongSecret[TOTP_SECRET_LEN];
+	std::memcpy(wrongSecret, kSecret, sizeof wrongSecret);
+	wrongSecret[TOTP_SECRET_LEN - 1] ^= 1;
+	check(send_secret(kSlot, wrongSecret) == TOTP_E_SECRET, "secret of another record taken");
+	check(send_secret(kSlot, kSecret, USERS_CRED_LEN) == TOTP_E_LEN, "short secret taken");
+	check(send_secret(kSlot, kSecret) == TOTP_OK, "secret of the record refused");
+
+	// No clock, no codes
+	settle();
+	check(!enter(code_at(kStart)), "code taken without a clock");
+
+	// A whole cache is three codes. A code used takes the ones of its
+	// step and before with it
+	rtc_set(kStart + 10);
+	check(settle() == TOTP_WINDOWS, "cache not built with one code per call");
+	const uint32_t t = kStart + 10;
+	check(enter(code_at(t - TOTP_STEP)), "code of step t - 1 denied");
+	check(enter(code_at(t)), "code of step t denied");
+	check(shown.find("Ms Onetime") != std::string::npos, "wrong name shown");
+	check(!enter(code_at(t)), "code of step t taken twice");
+	check(!enter(code_at(t - TOTP_STEP)), "code of step t - 1 taken after step t");
+	check(!enter(code_at(t - 2 * TOTP_STEP)), "code of step t - 2 taken");
+	check(!enter(code_at(t + 2 * TOTP_STEP)), "code of step t + 2 taken");
+	check(enter(code_at(t + TOTP_STEP)), "code of step t + 1 denied");
+
+	// The turn of a step computes the new t + 1 only, the used codes
+	// stay used
+	rtc_set(t + TOTP_STEP);
+	check(settle() == 1, "turn of a step computed more than the new code");
+	check(!enter(code_at(t + TOTP_STEP)), "used code taken again after the turn");
+	check(enter(code_at(t + 2 * TOTP_STEP)), "new code of step t + 1 denied");
+
+	// A jump of the clock builds the cache again
+	rtc_set(t + 3600);
+	check(settle() == TOTP_WINDOWS, "jump of the clock not handled");
+	check(enter(code_at(t + 3600)), "code after the jump denied");
+
+	// The last used step is kept over a reset
+	totp_init();
+	settle();
+	check(!enter(code_at(t + 3600)), "used code taken again after a reset");
+	check(enter(code_at(t + 3600 + TOTP_STEP)), "next code denied after a reset");
+
+	// A sync keeps the codes of a user whose secret stayed, used ones
+	// included, while a new user ahead of it in the table gets its own
+	rtc_set(t + 7200);
+	settle();
+	uint8_t otherSecret[TOTP_SECRET_LEN];
+	for (unsigned i = 0; i < TOTP_SECRET_LEN; i++)
+		otherSecret[i] = static_cast<uint8_t>(kSecret[i] ^ (0x21 * (i + 1)));
+	commit(kSlot - 3, totp_user(otherSecret, "Mr Twotime"));
+	check(send_secret(kSlot - 3, otherSecret) == TOTP_OK, "secret of a second user refused");
+	check(settle() == TOTP_WINDOWS, "sync computed the codes of an unchanged user again");
+	check(enter(code_at(t + 7200)), "code of an unchanged user denied after a sync");
+	check(enter(code_at(t + 7200, otherSecret)), "code of the new user denied");
+	check(shown.find("Mr Twotime") != std::string::npos, "wrong name shown for the new user");
+
+	// The same secret sent again keeps its last used step
+	check(send_secret(kSlot, kSecret) == TOTP_OK, "secret refused when sent again");
+	totp_init();
+	settle();
+	check(!enter(code_at(t + 7200)), "used code taken again after the secret was sent again");
+
+	// The entries hold TOTP_USERS secrets, the entry of a removed user
+	// is taken again
+	uint8_t more[TOTP_SECRET_LEN];
+	std::memcpy(more, kSecret, sizeof more);
+	for (uint16_t slot : {kSlot + 1, kSlot + 2}) {
+		more[0] = static_cast<uint8_t>(slot);
+		commit(slot, totp_user(more, "Mr Another"));
+		check(send_secret(slot, more) == TOTP_OK, "secret of a further user refused");
+	}
+	more[0] = 1;
+	commit(1, totp_user(more, "Mr Onetoomany"));
+	check(send_secret(1, more) == TOTP_E_FULL, "more secrets kept than entries");
+	user_t gone = totp_user(otherSecret, "Mr Twotime");
+	gone.flags = 0;
+	commit(kSlot - 3, gone);
+	check(send_secret(1, more) == TOTP_OK, "entry of a removed user not taken again");
+	settle();
+	check(!enter(code_at(t + 7200 + TOTP_STEP, otherSecret)), "code of a removed user taken");
+	check(enter(code_at(t + 7200, more)), "code of the user in the freed entry denied");
+
+	// The secret is no PIN, the PINs still work
+	check(enter("3467"), "PIN of a user denied next to the codes");
+	check(users_find("3467", 4) == 0, "PIN user lost");
+
+	// Without the flag the slot is gone from the cache
+	u.flags = 0;
+	commit(kSlot, u);
+	settle();
+	check(!enter(code_at(t + 7200 + TOTP_STEP)), "code of a removed user taken");
+
+	// Speed of a HOTP and of a lookup
+	auto t0 = std::chrono::steady_clock::now();
+	uint32_t sink = 0;
+	for (uint32_t c = 0; c < 100000; c++)
+		sink += hotp(kSecret, sizeof kSecret, c);
+	const double sh = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+	u.flags = USER_F_ACTIVE | USER_F_TOTP;
+	commit(kSlot, u);
+	settle();
+	t0 = std::chrono::steady_clock::now();
+	for (long n = 0; n < matches; n++)
+		sink += static_cast<uint32_t>(totp_match(static_cast<uint64_t>(n) << 8));
+	const double sm = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+	std::printf("vectors      RFC 4226 and RFC 6238 checked, door entries checked, %u wrong\n", wrong);
+	std::printf("hotp         100000 in %.2f s, %.1f k/s (%x)\n", sh, 100000 / sh / 1e3, sink & 0xFF);
+	std::printf("totp_match   %ld in %.2f s, %.1f M/s, %u cached codes each\n", matches, sm,
+	            matches / sm / 1e6, TOTP_USERS * TOTP_WINDOWS);
+	return wrong ? 1 : 0;
+}
@@ -0,0 +1,215 @@
+/*
+ * Simulated door: the HAL of the firmware (hal.h) with in-memory pins,
+ * key pad, display and EEPROM.
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "hal.h"
+#include "eeq.h"
+#include "lcd.h"
+
+static uint8_t simPins[HAL_PINS];
+static uint64_t simRises[HAL_PINS];
+static uint8_t simChime;
+static uint8_t simKey = HAL_NO_KEY;
+static char simDisplay[LCD_LINES][LCD_DISP_LENGTH + 1];
+static uint8_t simCurX, simCurY;
+static uint8_t simEeprom[SIM_EE_SIZE];
+static uint64_t simWrites;
+static uint64_t simReads;
+static int64_t simPowerLeft = -1;      /* Byte writes before the power fails */
+static uint8_t simEeReady;              /* EEPROM ready interrupt on */
+static uint8_t simEeHold;               /* The queue waits for hal_ee_poll() */
+static uint8_t simEeDraining;
+
+/* Pins and key pad --------------------------------------------------*/
+void hal_init(uint8_t warm)
+{
+	(void)warm;	/* The display has no power-on wait */
+	memset(simPins, 0, sizeof(simPins));
+	memset(simRises, 0, sizeof(simRises));
+	simChime = 0;
+	simKey = HAL_NO_KEY;
+	for (uint8_t y = 0; y < LCD_LINES; y++)
+	{
+		memset(simDisplay[y], ' ', LCD_DISP_LENGTH);
+		simDisplay[y][LCD_DISP_LENGTH] = '\0';
+	}
+	simCurX = simCurY = 0;
+}
+
+void hal_ticks_start(void)
+{
+	/* The caller runs the tick handlers */
+}
+
+void hal_pin_write(uint8_t pin, uint8_t high)
+{
+	high = high ? 1 : 0;
+	if (high && !simPins[pin])
+		simRises[pin]++;
+	simPins[pin] = high;
+}
+
+void hal_relay(uint8_t duty)
+{
+	/* The hold current is on as well */
+	hal_pin_write(HAL_RELAY, duty);
+}
+
+void hal_chime(uint8_t on)
+{
+	simChime = on ? 1 : 0;
+}
+
+void hal_chime_write(uint8_t level)
+{
+	(void)level;	/* No samples without the compare handler */
+}
+
+void hal_pin_toggle(uint8_t pin)
+{
+	hal_pin_write(pin, !simPins[pin]);
+}
+
+uint8_t hal_keypad_scan(void)
+{
+	uint8_t key = simKey;
+
+	simKey = HAL_NO_KEY;
+	return key;
+}
+
+uint8_t sim_pin(uint8_t pin)
+{
+	return simPins[pin];
+}
+
+uint8_t sim_chime(void)
+{
+	return simChime;
+}
+
+uint64_t sim_pin_rises(uint8_t pin)
+{
+	return simRises[pin];
+}
+
+void sim_key(uint8_t key)
+{
+	simKey = key;
+}
+
+/* Display -----------------------------------------------------------*/
+void hal_display_goto(uint8_t x, uint8_t y)
+{
+	simCurX = x;
+	simCurY = y;
+}
+
+void hal_display_putc(char c)
+{
+	if (simCurX < LCD_DISP_LENGTH && simCurY < LCD_LINES)
+		simDisplay[simCurY][simCurX++] = c;
+}
+
+const char *sim_display_line(uint8_t y)
+{
+	return simDisplay[y];
+}
+
+/* EEPROM ------------------------------------------------------------*/
+static size_t ee_index(uint16_t addr, size_t n)
+{
+	if (addr + n > SIM_EE_SIZE)
+	{
+		fprintf(stderr, "sim: EEPROM access 0x%x+%zu out of range\n", addr, n);
+		abort();
+	}
+	return addr;
+}
+
+void sim_eeprom_erase(void)
+{
+	memset(simEeprom, 0xFF, sizeof(simEeprom));
+	simWrites = 0;
+	simReads = 0;
+	simPowerLeft = -1;
+}
+
+void sim_eeprom_power(int64_t writes)
+{
+	simPowerLeft = writes;
+}
+
+uint64_t sim_eeprom_writes(void)
+{
+	return simWrites;
+}
+
+uint64_t sim_eeprom_reads(void)
+{
+	return simReads;
+}
+
+uint8_t *sim_eeprom(void)
+{
+	return simEeprom;
+}
+
+void hal_ee_read(void *dst, uint16_t addr, uint8_t len)
+{
+	memcpy(dst, simEeprom + ee_index(addr, len), len);
+	simReads++;
+}
+
+void hal_ee_update(uint16_t addr, uint8_t value)
+{
+	uint8_t *d = simEeprom + ee_index(addr, 1);
+
+	if (*d == value)
+		return;
+	if (simPowerLeft == 0)
+		return;
+	if (simPowerLeft > 0)
+		simPowerLeft--;
+	*d = value;
+	simWrites++;
+}
+
+/* The ready interrupt of the simulated EEPROM fires at once for every
+   byte, unless the queue is held */
+uint8_t hal_ee_ready(uint8_t on)
+{
+	uint8_t was = simEeReady;
+
+	simEeReady = on;
+	if (on && !simEeHold && !simEeDraining)
+	{
+		simEeDraining = 1;
+		while (simEeReady && !simEeHold)
+			if (!eeq_step())
+				simEeReady = 0;
+		simEeDraining = 0;
+	}
+	return was;
+}
+
+uint8_t hal_ee_poll(void)
+{
+	if (simEeReady && !eeq_step())
+		simEeReady = 0;
+	return 0;
+}
+
+void sim_eeprom_hold(uint8_t hold)
+{
+	simEeHold = hold;
+	if (!hold && simEeReady)
+		hal_ee_ready(1);
+}
@@ -0,0 +1,12 @@
+/*
+ * Host stand-in for <avr/io.h>, only what the portable firmware
+ * modules need to compile. Registers live in sim.c.
+ */
+#ifndef SIM_AVR_IO_H_
+#define SIM_AVR_IO_H_
+
+#include <stdint.h>
+
+#define RAMEND      0x08FF      /* ATmega328P */
+
+#endif
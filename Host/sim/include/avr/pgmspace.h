@@ -0,0 +1,21 @@
+/*
+ * Host stand-in for <avr/pgmspace.h>: flash is ordinary memory.
+ */
+#ifndef SIM_AVR_PGMSPACE_H_
+#define SIM_AVR_PGMSPACE_H_
+
+#include <string.h>
+#include <avr/io.h>
+
+#define PROGMEM
+#define PGM_P               const char *
+#define PSTR(s)             (s)
+#define pgm_read_byte(p)    (*(const uint8_t *)(p))
+#define pgm_read_word(p)    (*(const uint16_t *)(p))
+#define pgm_read_dword(p)   (*(const uint32_t *)(p))
+#define pgm_read_ptr(p)     (*(void * const *)(p))
+#define memcpy_P            memcpy
+#define strlen_P            strlen
+#define strcmp_P            strcmp
+
+#endif
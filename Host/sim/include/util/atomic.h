@@ -0,0 +1,12 @@
+/*
+ * Host stand-in for <util/atomic.h>. The simulated door runs the
+ * firmware on one thread, a block only has to run once.
+ */
+#ifndef SIM_UTIL_ATOMIC_H_
+#define SIM_UTIL_ATOMIC_H_
+
+#define ATOMIC_RESTORESTATE
+#define ATOMIC_FORCEON
+#define ATOMIC_BLOCK(type)  for (int sim_once_ = 1; sim_once_; sim_once_ = 0)
+
+#endif
@@ -0,0 +1,87 @@
+/*
+ * Simulated door: UART of the firmware on the host, the rest of the
+ * hardware is in hal_host.c.
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ */
+#include <unistd.h>
+#include "sim.h"
+#include "uart.h"
+
+static int simUartFd = -1;
+static int simTxRoom = -1;
+
+/* UART --------------------------------------------------------------*/
+void sim_uart_attach(int fd)
+{
+	simUartFd = fd;
+}
+
+void sim_uart_tx_room(int room)
+{
+	simTxRoom = room;
+}
+
+void uart_init(unsigned int baudrate)
+{
+	(void)baudrate;
+}
+
+unsigned int uart_getc(void)
+{
+	uint8_t c;
+
+	if (simUartFd < 0 || read(simUartFd, &c, 1) != 1)
+		return UART_NO_DATA;
+	return c;
+}
+
+void uart_putc(unsigned char data)
+{
+	while (simUartFd >= 0 && write(simUartFd, &data, 1) != 1)
+		usleep(100);
+}
+
+void uart_putc_low(unsigned char data)
+{
+	uart_putc(data);
+}
+
+unsigned int uart_tx_free(unsigned char lane)
+{
+	if (lane == UART_HIGH && simTxRoom >= 0)
+		return (unsigned int)simTxRoom;
+	/* The pty takes it */
+	return (lane == UART_LOW ? UART_TX_LOW_BUFFER_SIZE : UART_TX_BUFFER_SIZE) - 1;
+}
+
+unsigned char uart_tx_idle(void)
+{
+	return simTxRoom < 0 || simTxRoom >= UART_TX_BUFFER_SIZE - 1;
+}
+
+void uart_tx_stats(unsigned char lane, unsigned int *dropped, unsigned char *peak,
+                   unsigned char clear)
+{
+	(void)lane;
+	(void)clear;
+	*dropped = 0;
+	*peak = 0;
+}
+
+void uart_puts(const char *s)
+{
+	while (*s)
+		uart_putc(*s++);
+}
+
+void uart_puts_p(const char *s)
+{
+	uart_puts(s);
+}
+
+void uart_puts_low_p(const char *s)
+{
+	uart_puts(s);
+}
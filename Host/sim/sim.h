@@ -0,0 +1,57 @@
+/*
+ * Simulated door: the firmware without main.c built for the host, with
+ * the HAL (hal_host.c) and the UART (sim.c) replaced.
+ *
+ * Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+ * This work is licensed under the terms of the MIT license.
+ */
+#ifndef SIM_H_
+#define SIM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SIM_EE_SIZE     32768   /* Room for a large user table */
+
+/* Erases the EEPROM (all 0xFF) and clears the counters */
+void sim_eeprom_erase(void);
+/* Bytes the firmware programmed, unchanged updates are not counted */
+uint64_t sim_eeprom_writes(void);
+/* Calls of hal_ee_read() */
+uint64_t sim_eeprom_reads(void);
+uint8_t *sim_eeprom(void);
+/* Lets this many more bytes be programmed, then drops the writes as a
+   power failure would, -1 for no failure */
+void sim_eeprom_power(int64_t writes);
+/* 1: the queued EEPROM writes (eeq.h) wait, each hal_ee_poll() programs
+   one byte as a ready interrupt would. 0: they are programmed at once,
+   the default */
+void sim_eeprom_hold(uint8_t hold);
+
+/* Level of a HAL_... output and how often it went high */
+uint8_t sim_pin(uint8_t pin);
+uint64_t sim_pin_rises(uint8_t pin);
+
+/* 1 while the speaker PWM of the chime runs */
+uint8_t sim_chime(void);
+
+/* The next hal_keypad_scan() returns this key, once */
+void sim_key(uint8_t key);
+
+/* A display line as written by lcdfb_flush(), zero terminated */
+const char *sim_display_line(uint8_t y);
+
+/* The UART reads from and writes to this file descriptor */
+void sim_uart_attach(int fd);
+/* uart_tx_free() of the high priority lane returns room, -1: always empty */
+void sim_uart_tx_room(int room);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,88 @@
+// Prints the flight recorder of a door as a time line.
+//
+//     doortrace [terminal log]              rings printed in console mode
+//     doortrace --bus <device> <addr> [baud]
+//
+// Without a file the log is read from stdin. On the bus a held ring,
+// the one of the run before a watchdog or brown-out reset, is freed
+// after it has been read.
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include "trace_log.hpp"
+#include "serial.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+int usage()
+{
+	std::fprintf(stderr,
+		"usage: doortrace [terminal log]\n"
+		"       doortrace --bus <device> <addr> [baud]\n");
+	return 2;
+}
+
+void print(const std::vector<door::TraceRecord> &ring)
+{
+	for (const door::TraceEntry &e : door::trace_timeline(ring))
+		std::printf("%11.6f s  %s\n", e.seconds, door::describe(e.rec).c_str());
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	try {
+		if (argc >= 4 && std::strcmp(argv[1], "--bus") == 0) {
+			const int baud = argc > 4 ? std::atoi(argv[4]) : 9600;
+			const auto addr = static_cast<uint8_t>(std::atoi(argv[3]));
+			door::BusMaster bus(door::open_serial(argv[2], baud));
+			std::vector<door::TraceRecord> ring;
+			bool held = false;
+			if (!door::read_trace(bus, addr, ring, held)) {
+				std::fprintf(stderr, "door %u did not answer\n", addr);
+				return 1;
+			}
+			std::printf("door %u, %zu records%s\n", addr, ring.size(),
+			            held ? ", from before the reset" : "");
+			print(ring);
+			if (held && !door::clear_trace(bus, addr)) {
+				std::fprintf(stderr, "door %u did not free its trace\n", addr);
+				return 1;
+			}
+			return 0;
+		}
+		if (argc > 2 || (argc == 2 && argv[1][0] == '-'))
+			return usage();
+
+		std::ifstream file;
+		if (argc == 2) {
+			file.open(argv[1]);
+			if (!file) {
+				std::fprintf(stderr, "doortrace: cannot read %s\n", argv[1]);
+				return 1;
+			}
+		}
+		const auto dumps = door::parse_trace_dumps(argc == 2 ? file : std::cin);
+		for (size_t i = 0; i < dumps.size(); i++) {
+			std::printf("%strace %zu, %zu records\n", i ? "\n" : "", i + 1, dumps[i].size());
+			print(dumps[i]);
+		}
+		if (dumps.empty()) {
+			std::fprintf(stderr, "doortrace: no trace in the log\n");
+			return 1;
+		}
+	} catch (const std::exception &e) {
+		std::fprintf(stderr, "doortrace: %s\n", e.what());
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,163 @@
+// Flight recorder of the door, see trace_log.hpp.
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include "trace_log.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+extern "C" {
+#include "hal.h"
+#include "trace.h"
+#include "uart.h"
+}
+
+namespace door {
+
+namespace {
+
+constexpr double kCountSeconds = 256.0 / 16e6;     // Prescaler 256 at 16 MHz
+constexpr double kPeriodSeconds = HAL_SECOND_STEPS * kCountSeconds;
+
+std::string hex(unsigned v)
+{
+	char s[8];
+	std::snprintf(s, sizeof s, "0x%02x", v);
+	return s;
+}
+
+} // namespace
+
+std::vector<std::vector<TraceRecord>> parse_trace_dumps(std::istream &in)
+{
+	std::vector<std::vector<TraceRecord>> dumps;
+	std::string line;
+	bool open = false;
+
+	while (std::getline(in, line)) {
+		if (!line.empty() && line.back() == '\r')
+			line.pop_back();
+		const size_t at = line.find("trace ");
+		if (at == std::string::npos)
+			continue;
+		std::istringstream f(line.substr(at + 6));
+		std::vector<std::string> w;
+		for (std::string s; f >> s;)
+			w.push_back(s);
+
+		if (w.size() == 1 && w[0] == "end") {
+			open = false;
+		} else if (w.size() == 1) {
+			dumps.emplace_back();
+			open = true;
+		} else if (w.size() == 3 && open) {
+			TraceRecord r;
+			r.type = static_cast<uint8_t>(std::strtoul(w[0].c_str(), nullptr, 16));
+			r.arg = static_cast<uint8_t>(std::strtoul(w[1].c_str(), nullptr, 16));
+			r.time = static_cast<uint16_t>(std::strtoul(w[2].c_str(), nullptr, 16));
+			dumps.back().push_back(r);
+		}
+	}
+	return dumps;
+}
+
+bool read_trace(BusMaster &bus, uint8_t addr, std::vector<TraceRecord> &ring, bool &held)
+{
+	ring.clear();
+	for (;;) {
+		const auto first = static_cast<uint8_t>(ring.size());
+		std::vector<uint8_t> r;
+		if (!bus.request(addr, FT_TRACE_READ, &first, 1, 200, r) || r.size() < 2 ||
+		    r.size() < 2u + r[1] * TRACE_REC_LEN)
+			return false;
+		held = r[0] != 0;
+		for (unsigned i = 0; i < r[1]; i++) {
+			const uint8_t *p = &r[2 + i * TRACE_REC_LEN];
+			ring.push_back({p[0], p[1], static_cast<uint16_t>(p[2] | p[3] << 8)});
+		}
+		if (r[1] < TRACE_PER_FRAME)
+			return true;
+	}
+}
+
+bool clear_trace(BusMaster &bus, uint8_t addr)
+{
+	std::vector<uint8_t> r;
+	return bus.request(addr, FT_TRACE_CLEAR, nullptr, 0, 200, r);
+}
+
+std::vector<TraceEntry> trace_timeline(const std::vector<TraceRecord> &ring)
+{
+	std::vector<TraceEntry> out;
+	uint64_t period = 0;
+	bool pending = false;       // wrapped, its TR_ISR_SECOND not seen yet
+	double start = 0;
+
+	for (size_t i = 0; i < ring.size(); i++) {
+		const TraceRecord &r = ring[i];
+		if (i > 0 && r.time < ring[i - 1].time && !(r.type == TR_ISR_SECOND && !pending)) {
+			period++;
+			pending = r.type != TR_ISR_SECOND;
+		} else if (i > 0 && r.type == TR_ISR_SECOND) {
+			if (!pending)
+				period++;
+			pending = false;
+		}
+		const double t = static_cast<double>(period) * kPeriodSeconds + r.time * kCountSeconds;
+		if (i == 0)
+			start = t;
+		out.push_back({t - start, r});
+	}
+	return out;
+}
+
+std::string describe(const TraceRecord &rec)
+{
+	static const char *const scan[] = {"idle", "pin entry", "message"};
+	static const char *const timer[] = {"off", "5 s", "3 s"};
+	const unsigned a = rec.arg;
+
+	switch (rec.type) {
+	case TR_BOOT: {
+		std::string s = "boot, MCUSR " + hex(a);
+		if (a & 0x08)
+			s += " watchdog";
+		if (a & 0x04)
+			s += " brown-out";
+		if (a & 0x02)
+			s += " external";
+		if (a & 0x01)
+			s += " power-on";
+		return s;
+	}
+	case TR_ISR_KEYPAD: return "key pad tick";
+	case TR_ISR_SECOND: return "second tick, clock " + std::to_string(a);
+	case TR_ISR_SOUND: return "sound tick";
+	case TR_KEY: return std::string("key '") + static_cast<char>(a) + "'";
+	case TR_STATE: {
+		const unsigned s = a >> 4, t = a & 0x0F;
+		return std::string("state ") + (s < 3 ? scan[s] : "?") + ", timer " + (t < 3 ? timer[t] : "?");
+	}
+	case TR_CORRECT: return "correct pin, " + std::to_string(a) + " since reset";
+	case TR_WRONG: return "wrong pin, " + std::to_string(a) + " since reset";
+	case TR_UART_ERROR: {
+		std::string s = "uart";
+		if (a & (UART_FRAME_ERROR >> 8))
+			s += " framing";
+		if (a & (UART_OVERRUN_ERROR >> 8))
+			s += " overrun";
+		if (a & (UART_PARITY_ERROR >> 8))
+			s += " parity";
+		if (a & (UART_BUFFER_OVERFLOW >> 8))
+			s += " buffer overflow";
+		return s;
+	}
+	case TR_EV_LOST: return std::string("event lost: ") + event_name(rec.arg);
+	default: return "type " + hex(rec.type) + " arg " + hex(a);
+	}
+}
+
+} // namespace door
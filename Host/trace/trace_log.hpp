@@ -0,0 +1,45 @@
+// Flight recorder of the door (see trace.h in the firmware): reading the
+// ring and putting its records on a time line.
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#pragma once
+
+#include "bus_master.hpp"
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace door {
+
+struct TraceRecord {
+	uint8_t type;
+	uint8_t arg;
+	uint16_t time;      // Timer/Counter1 count, 16 us
+};
+
+struct TraceEntry {
+	double seconds;     // Since the oldest record
+	TraceRecord rec;
+};
+
+// Rings printed by trace_task() in console mode, found among the other
+// lines of a terminal log. A cut off ring is returned as far as it goes.
+std::vector<std::vector<TraceRecord>> parse_trace_dumps(std::istream &in);
+
+// Reads the ring of a door with FT_TRACE_READ. Sets held when it is the
+// ring of the run before a reset, which the door keeps until clear_trace().
+bool read_trace(BusMaster &bus, uint8_t addr, std::vector<TraceRecord> &ring, bool &held);
+bool clear_trace(BusMaster &bus, uint8_t addr);
+
+// Counts wrap with every second tick. A count going back without a
+// TR_ISR_SECOND record means the tick is pending and its record follows.
+std::vector<TraceEntry> trace_timeline(const std::vector<TraceRecord> &ring);
+
+// One line of text for a record, e.g. "key '5'"
+std::string describe(const TraceRecord &rec);
+
+} // namespace door
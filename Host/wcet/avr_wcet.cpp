@@ -0,0 +1,616 @@
+// Static worst case execution time of AVR code, see avr_wcet.hpp.
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include "avr_wcet.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <optional>
+#include <sstream>
+
+namespace door {
+
+namespace {
+
+constexpr uint32_t kExit = 0xFFFFFFFF;     // Return of the function
+
+std::vector<std::string> split(const std::string &s, char sep)
+{
+	std::vector<std::string> out;
+	std::string part;
+	std::istringstream in(s);
+	while (std::getline(in, part, sep))
+		out.push_back(part);
+	return out;
+}
+
+std::string trim(const std::string &s)
+{
+	const size_t a = s.find_first_not_of(" \t");
+	const size_t b = s.find_last_not_of(" \t");
+	return a == std::string::npos ? "" : s.substr(a, b - a + 1);
+}
+
+bool all_hex(const std::string &s)
+{
+	return !s.empty() && s.find_first_not_of("0123456789abcdef") == std::string::npos;
+}
+
+std::string hex(uint32_t v)
+{
+	std::ostringstream o;
+	o << "0x" << std::hex << v;
+	return o.str();
+}
+
+bool is_branch(const std::string &op) { return op.size() > 2 && op.compare(0, 2, "br") == 0 && op != "break"; }
+bool is_skip(const std::string &op)
+{
+	return op == "cpse" || op == "sbrc" || op == "sbrs" || op == "sbic" || op == "sbis";
+}
+bool is_jump(const std::string &op) { return op == "rjmp" || op == "jmp"; }
+bool is_call(const std::string &op) { return op == "rcall" || op == "call"; }
+bool is_ret(const std::string &op) { return op == "ret" || op == "reti"; }
+
+int reg(const std::string &arg)
+{
+	if (arg.size() < 2 || arg[0] != 'r')
+		return -1;
+	return std::atoi(arg.c_str() + 1);
+}
+
+// Registers an instruction may change
+std::set<int> writes(const AvrInsn &in)
+{
+	static const std::set<std::string> dest = {
+		"add", "adc", "sub", "subi", "sbc", "sbci", "and", "andi", "or", "ori", "eor",
+		"com", "neg", "inc", "dec", "clr", "ser", "mov", "ldi", "in", "lsl", "lsr", "rol",
+		"ror", "asr", "swap", "bld", "ld", "ldd", "lds", "pop", "cbr", "sbr", "lpm", "elpm",
+	};
+	std::set<int> w;
+
+	if (is_call(in.op) || in.op == "icall") {
+		// Registers a callee may clobber in the avr-gcc ABI
+		w = {0, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 30, 31};
+		return w;
+	}
+	if (in.op == "movw" || in.op == "adiw" || in.op == "sbiw") {
+		const int r = in.args.empty() ? -1 : reg(in.args[0]);
+		w = {r, r + 1};
+		return w;
+	}
+	if (in.op.compare(0, 3, "mul") == 0 || in.op.compare(0, 4, "fmul") == 0)
+		return {0, 1};
+	if (dest.count(in.op) && !in.args.empty())
+		w.insert(reg(in.args[0]));
+	if ((in.op == "lpm" || in.op == "elpm") && in.args.empty())
+		w.insert(0);
+
+	// Pointer post-increment and pre-decrement
+	for (const std::string &a : in.args) {
+		if (a.find('+') == std::string::npos && a.find('-') == std::string::npos)
+			continue;
+		if (a.find('X') != std::string::npos)
+			w.insert({26, 27});
+		if (a.find('Y') != std::string::npos)
+			w.insert({28, 29});
+		if (a.find('Z') != std::string::npos)
+			w.insert({30, 31});
+	}
+	return w;
+}
+
+struct Block {
+	uint32_t start = 0;
+	std::vector<const AvrInsn *> insns;
+	uint64_t cost = 0;
+	std::vector<std::pair<uint32_t, uint64_t>> succ;     // target, extra cycles
+};
+
+struct Loop {
+	uint32_t header = 0;
+	std::set<uint32_t> body;
+	std::vector<uint32_t> latches;      // sources of the back edges
+	uint64_t bound = 0;
+};
+
+} // namespace
+
+/*--------------------------------------------------------------------*/
+void AvrProgram::read_listing(std::istream &in)
+{
+	std::string line;
+	bool text = false;
+	AvrFunction *cur = nullptr;
+
+	while (std::getline(in, line)) {
+		if (!line.empty() && line.back() == '\r')
+			line.pop_back();
+		if (line.compare(0, 23, "Disassembly of section ") == 0) {
+			text = line.find(".text") != std::string::npos;
+			cur = nullptr;
+			continue;
+		}
+		if (!text)
+			continue;
+
+		// Label: "000002a6 <lcd_write>:"
+		if (line.size() > 12 && all_hex(line.substr(0, 8)) && line[8] == ' ' && line[9] == '<' &&
+		    line.compare(line.size() - 2, 2, ">:") == 0) {
+			const uint32_t addr = static_cast<uint32_t>(std::stoul(line.substr(0, 8), nullptr, 16));
+			AvrFunction &f = funcs_[addr];
+			f.name = line.substr(10, line.size() - 12);
+			f.addr = addr;
+			cur = &f;
+			continue;
+		}
+
+		// Instruction: " 2ce:\t0e 94 48 01 \tcall\t0x290\t; 0x290 <toggle_e>"
+		const std::vector<std::string> f = split(line, '\t');
+		if (!cur || f.size() < 3)
+			continue;
+		const std::string a = trim(f[0]);
+		const std::string bytes = trim(f[1]);
+		if (a.size() < 2 || a.back() != ':' || !all_hex(a.substr(0, a.size() - 1)))
+			continue;
+		if (bytes.size() != 5 && bytes.size() != 11)
+			continue;
+
+		AvrInsn insn;
+		insn.addr = static_cast<uint32_t>(std::stoul(a.substr(0, a.size() - 1), nullptr, 16));
+		insn.size = bytes.size() == 5 ? 2 : 4;
+		insn.op = trim(f[2]);
+		std::string operands = f.size() > 3 ? f[3] : "";
+		std::string comment = f.size() > 4 ? f[4] : "";
+		const size_t semi = operands.find(';');
+		if (semi != std::string::npos) {
+			comment = operands.substr(semi);
+			operands.erase(semi);
+		}
+		for (const std::string &arg : split(operands, ','))
+			if (!trim(arg).empty())
+				insn.args.push_back(trim(arg));
+
+		if (is_branch(insn.op) || is_jump(insn.op) || is_call(insn.op)) {
+			// objdump gives the absolute target in the comment
+			const size_t x = comment.find("0x");
+			const std::string &last = insn.args.empty() ? std::string() : insn.args.back();
+			if (x != std::string::npos)
+				insn.target = static_cast<int64_t>(std::stoul(comment.substr(x + 2), nullptr, 16));
+			else if (last.compare(0, 2, "0x") == 0)
+				insn.target = static_cast<int64_t>(std::stoul(last.substr(2), nullptr, 16));
+			else if (last.compare(0, 1, ".") == 0)
+				insn.target = insn.addr + 2 + std::stol(last.substr(1));
+		}
+		cur->insns.push_back(insn);
+	}
+}
+
+const AvrFunction *AvrProgram::find(const std::string &name) const
+{
+	for (const auto &kv : funcs_)
+		if (kv.second.name == name)
+			return &kv.second;
+	return nullptr;
+}
+
+const AvrFunction *AvrProgram::at(uint32_t addr) const
+{
+	auto it = funcs_.find(addr);
+	return it == funcs_.end() ? nullptr : &it->second;
+}
+
+/*--------------------------------------------------------------------*/
+unsigned avr_cycles(const AvrInsn &in)
+{
+	static const std::map<std::string, unsigned> table = {
+		// 1 cycle
+		{"add", 1}, {"adc", 1}, {"sub", 1}, {"subi", 1}, {"sbc", 1}, {"sbci", 1},
+		{"and", 1}, {"andi", 1}, {"or", 1}, {"ori", 1}, {"eor", 1}, {"com", 1},
+		{"neg", 1}, {"inc", 1}, {"dec", 1}, {"tst", 1}, {"clr", 1}, {"ser", 1},
+		{"cp", 1}, {"cpc", 1}, {"cpi", 1}, {"mov", 1}, {"movw", 1}, {"ldi", 1},
+		{"in", 1}, {"out", 1}, {"lsl", 1}, {"lsr", 1}, {"rol", 1}, {"ror", 1},
+		{"asr", 1}, {"swap", 1}, {"bset", 1}, {"bclr", 1}, {"bst", 1}, {"bld", 1},
+		{"sec", 1}, {"clc", 1}, {"sen", 1}, {"cln", 1}, {"sez", 1}, {"clz", 1},
+		{"sei", 1}, {"cli", 1}, {"ses", 1}, {"cls", 1}, {"sev", 1}, {"clv", 1},
+		{"set", 1}, {"clt", 1}, {"seh", 1}, {"clh", 1}, {"nop", 1}, {"sleep", 1},
+		{"wdr", 1}, {"cbr", 1}, {"sbr", 1},
+		// Not taken, see the edges for taken
+		{"cpse", 1}, {"sbrc", 1}, {"sbrs", 1}, {"sbic", 1}, {"sbis", 1},
+		// 2 cycles
+		{"adiw", 2}, {"sbiw", 2}, {"mul", 2}, {"muls", 2}, {"mulsu", 2},
+		{"fmul", 2}, {"fmuls", 2}, {"fmulsu", 2}, {"ld", 2}, {"ldd", 2}, {"st", 2},
+		{"std", 2}, {"lds", 2}, {"sts", 2}, {"push", 2}, {"pop", 2}, {"sbi", 2},
+		{"cbi", 2}, {"rjmp", 2}, {"ijmp", 2},
+		// 3 and 4 cycles, 16-bit program counter
+		{"jmp", 3}, {"rcall", 3}, {"icall", 3}, {"lpm", 3}, {"elpm", 3},
+		{"call", 4}, {"ret", 4}, {"reti", 4},
+	};
+	if (is_branch(in.op))
+		return 1;
+	auto it = table.find(in.op);
+	if (it == table.end())
+		throw WcetError("no cycle count for '" + in.op + "' at " + hex(in.addr));
+	return it->second;
+}
+
+/*--------------------------------------------------------------------*/
+const FunctionWcet &WcetAnalyzer::function(const std::string &name)
+{
+	auto it = done_.find(name);
+	if (it != done_.end())
+		return it->second;
+	const AvrFunction *f = prog_.find(name);
+	if (!f)
+		throw WcetError("no function " + name + " in the listing");
+	return analyze(*f);
+}
+
+const FunctionWcet &WcetAnalyzer::analyze(const AvrFunction &f)
+{
+	auto known = done_.find(f.name);
+	if (known != done_.end())
+		return known->second;
+	if (busy_.count(f.name))
+		throw WcetError("recursion through " + f.name);
+	if (f.insns.empty())
+		throw WcetError(f.name + " has no instructions");
+	busy_.insert(f.name);
+
+	FunctionWcet res;
+	const auto where = [&](uint32_t addr) { return f.name + "+" + hex(addr - f.addr); };
+
+	std::map<uint32_t, size_t> index;
+	for (size_t i = 0; i < f.insns.size(); i++)
+		index[f.insns[i].addr] = i;
+	const auto next_of = [&](size_t i) -> const AvrInsn * {
+		return i + 1 < f.insns.size() ? &f.insns[i + 1] : nullptr;
+	};
+	const auto callee = [&](int64_t target, const AvrInsn &in) -> uint64_t {
+		const AvrFunction *g = target >= 0 ? prog_.at(static_cast<uint32_t>(target)) : nullptr;
+		if (!g)
+			throw WcetError(in.op + " at " + where(in.addr) + " to " + hex(static_cast<uint32_t>(target)) +
+			                ", which is not a function");
+		res.callees.insert(g->name);
+		return analyze(*g).cycles;
+	};
+	const auto indirect = [&](const AvrInsn &in) -> uint64_t {
+		auto h = hints_.indirect.find(f.name);
+		if (h == hints_.indirect.end())
+			throw WcetError(in.op + " at " + where(in.addr) + " needs an indirect annotation");
+		uint64_t worst = 0;
+		for (const std::string &t : h->second) {
+			const AvrFunction *g = prog_.find(t);
+			if (!g)
+				throw WcetError("indirect target " + t + " of " + f.name + " not in the listing");
+			worst = std::max(worst, callee(g->addr, in));
+		}
+		return worst;
+	};
+
+	// Leaders of the basic blocks
+	std::set<uint32_t> leaders = {f.insns[0].addr};
+	for (size_t i = 0; i < f.insns.size(); i++) {
+		const AvrInsn &in = f.insns[i];
+		const AvrInsn *next = next_of(i);
+		if (is_branch(in.op) || is_jump(in.op)) {
+			if (index.count(static_cast<uint32_t>(in.target)))
+				leaders.insert(static_cast<uint32_t>(in.target));
+		} else if (is_skip(in.op)) {
+			if (next && next_of(i + 1))
+				leaders.insert(next_of(i + 1)->addr);
+		} else if (!is_ret(in.op) && in.op != "ijmp") {
+			continue;
+		}
+		if (next)
+			leaders.insert(next->addr);
+	}
+
+	// Blocks, their cost and their edges
+	std::map<uint32_t, Block> blocks;
+	for (auto l = leaders.begin(); l != leaders.end(); ++l) {
+		Block &b = blocks[*l];
+		b.start = *l;
+		const auto end = std::next(l);
+		size_t i = index.at(*l);
+		for (; i < f.insns.size() && (end == leaders.end() || f.insns[i].addr < *end); i++) {
+			const AvrInsn &in = f.insns[i];
+			b.insns.push_back(&in);
+			b.cost += avr_cycles(in);
+			// rcall .+0 only reserves two bytes of stack frame
+			if (is_call(in.op) && in.target != in.addr + in.size)
+				b.cost += callee(in.target, in);
+			else if (in.op == "icall")
+				b.cost += indirect(in);
+		}
+		const size_t last = i - 1;
+		const AvrInsn &t = f.insns[last];
+		const AvrInsn *next = next_of(last);
+		const auto jump_to = [&](int64_t target, uint64_t extra) {
+			if (index.count(static_cast<uint32_t>(target)))
+				b.succ.emplace_back(static_cast<uint32_t>(target), extra);
+			else
+				b.succ.emplace_back(kExit, extra + callee(target, t));   // tail call
+		};
+		const auto fall = [&]() {
+			if (next)
+				b.succ.emplace_back(next->addr, 0);
+			else
+				jump_to(t.addr + t.size, 0);    // into the next label
+		};
+
+		if (is_branch(t.op)) {
+			fall();
+			jump_to(t.target, 1);
+		} else if (is_skip(t.op)) {
+			if (!next)
+				throw WcetError(t.op + " at " + where(t.addr) + " skips out of the function");
+			b.succ.emplace_back(next->addr, 0);
+			jump_to(next->addr + next->size, next->size / 2);
+		} else if (is_jump(t.op)) {
+			jump_to(t.target, 0);
+		} else if (is_ret(t.op)) {
+			b.succ.emplace_back(kExit, 0);
+		} else if (t.op == "ijmp") {
+			b.succ.emplace_back(kExit, indirect(t));
+		} else {
+			fall();
+		}
+	}
+
+	// Reverse postorder of the reachable blocks
+	std::vector<uint32_t> order;
+	{
+		std::set<uint32_t> seen;
+		std::function<void(uint32_t)> dfs = [&](uint32_t n) {
+			seen.insert(n);
+			for (const auto &s : blocks.at(n).succ)
+				if (s.first != kExit && !seen.count(s.first))
+					dfs(s.first);
+			order.push_back(n);
+		};
+		dfs(f.insns[0].addr);
+		std::reverse(order.begin(), order.end());
+	}
+	std::map<uint32_t, size_t> rpo;
+	std::map<uint32_t, std::vector<uint32_t>> preds;
+	for (size_t i = 0; i < order.size(); i++)
+		rpo[order[i]] = i;
+	for (uint32_t n : order)
+		for (const auto &s : blocks.at(n).succ)
+			if (s.first != kExit)
+				preds[s.first].push_back(n);
+
+	// Immediate dominators (Cooper, Harvey, Kennedy)
+	std::vector<size_t> idom(order.size(), SIZE_MAX);
+	idom[0] = 0;
+	for (bool changed = true; changed;) {
+		changed = false;
+		for (size_t i = 1; i < order.size(); i++) {
+			size_t nd = SIZE_MAX;
+			for (uint32_t p : preds[order[i]]) {
+				size_t pi = rpo.at(p);
+				if (idom[pi] == SIZE_MAX)
+					continue;
+				if (nd == SIZE_MAX) {
+					nd = pi;
+					continue;
+				}
+				while (pi != nd) {
+					while (pi > nd)
+						pi = idom[pi];
+					while (nd > pi)
+						nd = idom[nd];
+				}
+			}
+			if (nd != idom[i]) {
+				idom[i] = nd;
+				changed = true;
+			}
+		}
+	}
+	const auto dominates = [&](uint32_t a, uint32_t b) {
+		size_t x = rpo.at(b);
+		const size_t ai = rpo.at(a);
+		for (;;) {
+			if (x == ai)
+				return true;
+			if (x == 0)
+				return false;
+			x = idom[x];
+		}
+	};
+
+	// Natural loops, one per header
+	std::map<uint32_t, Loop> loops;
+	for (uint32_t n : order) {
+		for (const auto &s : blocks.at(n).succ) {
+			if (s.first == kExit || !dominates(s.first, n))
+				continue;
+			Loop &l = loops[s.first];
+			l.header = s.first;
+			l.latches.push_back(n);
+			l.body.insert(s.first);
+			std::vector<uint32_t> work = {n};
+			while (!work.empty()) {
+				const uint32_t m = work.back();
+				work.pop_back();
+				if (!l.body.insert(m).second)
+					continue;
+				for (uint32_t p : preds[m])
+					work.push_back(p);
+			}
+		}
+	}
+
+	// Counted loop: ldi before the loop, one decrement and brne at the
+	// end of the only latch, nothing else in the loop writes the counter
+	const auto infer = [&](const Loop &l) -> std::optional<uint64_t> {
+		if (l.latches.size() != 1)
+			return std::nullopt;
+		const std::vector<const AvrInsn *> &li = blocks.at(l.latches[0]).insns;
+		if (li.empty() || li.back()->op != "brne" || li.back()->target != l.header)
+			return std::nullopt;
+
+		std::vector<int> regs;      // least significant first
+		std::set<const AvrInsn *> dec;
+		size_t k = li.size() - 1;
+		if (k >= 1 && li[k - 1]->op == "dec") {
+			regs = {reg(li[k - 1]->args[0])};
+			dec.insert(li[k - 1]);
+		} else if (k >= 1 && li[k - 1]->op == "sbiw" && li[k - 1]->args.size() == 2 &&
+		           std::strtol(li[k - 1]->args[1].c_str(), nullptr, 0) == 1) {
+			const int r = reg(li[k - 1]->args[0]);
+			regs = {r, r + 1};
+			dec.insert(li[k - 1]);
+		} else {
+			std::vector<int> high;
+			while (k >= 1 && li[k - 1]->op == "sbci" && std::strtol(li[k - 1]->args[1].c_str(), nullptr, 0) == 0) {
+				high.insert(high.begin(), reg(li[k - 1]->args[0]));
+				dec.insert(li[k - 1]);
+				k--;
+			}
+			if (k < 1 || li[k - 1]->op != "subi" || std::strtol(li[k - 1]->args[1].c_str(), nullptr, 0) != 1)
+				return std::nullopt;
+			dec.insert(li[k - 1]);
+			regs.push_back(reg(li[k - 1]->args[0]));
+			regs.insert(regs.end(), high.begin(), high.end());
+		}
+
+		for (uint32_t n : l.body)
+			for (const AvrInsn *in : blocks.at(n).insns)
+				if (!dec.count(in))
+					for (int r : writes(*in))
+						if (std::find(regs.begin(), regs.end(), r) != regs.end())
+							return std::nullopt;
+
+		std::vector<uint32_t> outside;
+		for (uint32_t p : preds[l.header])
+			if (!l.body.count(p))
+				outside.push_back(p);
+		if (outside.size() != 1)
+			return std::nullopt;
+		const std::vector<const AvrInsn *> &pi = blocks.at(outside[0]).insns;
+		uint64_t value = 0;
+		for (size_t b = 0; b < regs.size(); b++) {
+			bool found = false;
+			for (auto it = pi.rbegin(); it != pi.rend(); ++it) {
+				if (!writes(**it).count(regs[b]))
+					continue;
+				if ((*it)->op != "ldi")
+					return std::nullopt;
+				value |= (std::strtoull((*it)->args[1].c_str(), nullptr, 0) & 0xFF) << (8 * b);
+				found = true;
+				break;
+			}
+			if (!found)
+				return std::nullopt;
+		}
+		return value ? value : (1ULL << (8 * regs.size()));
+	};
+
+	std::vector<Loop *> inner_first;
+	for (auto &kv : loops) {
+		Loop &l = kv.second;
+		const std::string at = where(l.header);
+		auto exact = hints_.loops.find(at);
+		auto inferred = infer(l);
+		auto any = hints_.loops.find(f.name);
+		if (exact != hints_.loops.end()) {
+			l.bound = exact->second;
+			res.loops.push_back(at + ": " + std::to_string(l.bound) + " (annotated)");
+		} else if (inferred) {
+			l.bound = *inferred;
+			res.loops.push_back(at + ": " + std::to_string(l.bound) + " (inferred)");
+		} else if (any != hints_.loops.end()) {
+			l.bound = any->second;
+			res.loops.push_back(at + ": " + std::to_string(l.bound) + " (annotated)");
+		} else {
+			throw WcetError("loop at " + at + " has no bound, annotate it");
+		}
+		if (l.bound == 0)
+			throw WcetError("loop at " + at + " with bound 0");
+		inner_first.push_back(&l);
+	}
+	std::sort(inner_first.begin(), inner_first.end(),
+	          [](const Loop *a, const Loop *b) { return a->body.size() < b->body.size(); });
+
+	// Longest paths through a region, loops inside it already summarized
+	std::map<uint32_t, std::vector<std::pair<uint32_t, uint64_t>>> summary;
+	struct Region {
+		uint64_t iter = 0;
+		std::map<uint32_t, uint64_t> exits;
+	};
+	const auto longest = [&](uint32_t entry, const std::set<uint32_t> *body, uint32_t header) {
+		const auto in_region = [&](uint32_t n) { return n != kExit && (!body || body->count(n)); };
+		const auto node = [&](uint32_t n, uint64_t &cost) -> const std::vector<std::pair<uint32_t, uint64_t>> & {
+			auto s = summary.find(n);
+			if (n != header && s != summary.end()) {
+				cost = 0;
+				return s->second;
+			}
+			cost = blocks.at(n).cost;
+			return blocks.at(n).succ;
+		};
+
+		std::vector<uint32_t> topo;
+		std::map<uint32_t, int> state;
+		std::function<void(uint32_t)> visit = [&](uint32_t n) {
+			state[n] = 1;
+			uint64_t c;
+			for (const auto &s : node(n, c)) {
+				if (!in_region(s.first) || s.first == header)
+					continue;
+				if (state[s.first] == 1)
+					throw WcetError("irreducible loop at " + where(s.first));
+				if (state[s.first] == 0)
+					visit(s.first);
+			}
+			state[n] = 2;
+			topo.push_back(n);
+		};
+		visit(entry);
+		std::reverse(topo.begin(), topo.end());
+
+		Region r;
+		std::map<uint32_t, uint64_t> dist;
+		uint64_t c;
+		node(entry, c);
+		dist[entry] = c;
+		for (uint32_t n : topo) {
+			for (const auto &s : node(n, c)) {
+				const uint64_t v = dist[n] + s.second;
+				if (s.first == header && header != kExit) {
+					r.iter = std::max(r.iter, v);
+				} else if (!in_region(s.first)) {
+					r.exits[s.first] = std::max(r.exits[s.first], v);
+				} else {
+					uint64_t tc;
+					node(s.first, tc);
+					dist[s.first] = std::max(dist[s.first], v + tc);
+				}
+			}
+		}
+		return r;
+	};
+
+	for (Loop *l : inner_first) {
+		Region r = longest(l->header, &l->body, l->header);
+		std::vector<std::pair<uint32_t, uint64_t>> exits;
+		for (const auto &e : r.exits)
+			exits.emplace_back(e.first, (l->bound - 1) * r.iter + e.second);
+		summary[l->header] = exits;
+	}
+	Region top = longest(f.insns[0].addr, nullptr, kExit);
+	if (!top.exits.count(kExit))
+		throw WcetError(f.name + " never returns");
+	res.cycles = top.exits.at(kExit);
+
+	busy_.erase(f.name);
+	return done_[f.name] = res;
+}
+
+} // namespace door
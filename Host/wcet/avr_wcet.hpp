@@ -0,0 +1,98 @@
+// Static worst case execution time of AVR code, from the disassembly in
+// an avr-objdump listing (the .lss Atmel Studio writes next to the .elf).
+//
+// Every function is split into basic blocks. Loops are found as back
+// edges of the dominator tree and need a bound: counted loops like the
+// ones of _delay_us() (ldi, then dec/subi/sbiw down to zero) are bounded
+// from the listing, every other loop by an annotation. A loop body is
+// summarized innermost first and the function is the longest path over
+// the resulting acyclic graph. A call costs the call instruction plus
+// the callee's worst case.
+//
+// Cycle counts are those of the ATmega328P (AVRe+, 16-bit PC). A
+// conditional branch or skip is charged its taken cost only on the
+// taken edge, so the result is the worst path, not the sum of worst
+// instructions.
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace door {
+
+struct AvrInsn {
+	uint32_t addr = 0;
+	uint8_t size = 2;               // bytes, 2 or 4
+	std::string op;                 // mnemonic
+	std::vector<std::string> args;  // operands, comment removed
+	int64_t target = -1;            // branch, jump or call target
+};
+
+struct AvrFunction {
+	std::string name;
+	uint32_t addr = 0;
+	std::vector<AvrInsn> insns;
+};
+
+// Annotations the listing cannot give
+struct WcetHints {
+	// Header executions per entry: "func" for every loop of a function
+	// without an inferred bound, "func+0x1a" for one loop header
+	std::map<std::string, uint64_t> loops;
+	// Possible targets of icall/ijmp in a function
+	std::map<std::string, std::vector<std::string>> indirect;
+};
+
+class WcetError : public std::runtime_error {
+public:
+	using std::runtime_error::runtime_error;
+};
+
+class AvrProgram {
+public:
+	// Reads the disassembly of an avr-objdump -d/-S listing
+	void read_listing(std::istream &in);
+
+	const std::map<uint32_t, AvrFunction> &functions() const { return funcs_; }
+	const AvrFunction *find(const std::string &name) const;
+	const AvrFunction *at(uint32_t addr) const;
+
+private:
+	std::map<uint32_t, AvrFunction> funcs_;
+};
+
+// Cycles of one instruction, not counting a taken branch or skip
+unsigned avr_cycles(const AvrInsn &insn);
+
+struct FunctionWcet {
+	uint64_t cycles = 0;            // entry to return, callees included
+	std::set<std::string> callees;  // direct, indirect and tail calls
+	std::vector<std::string> loops; // "func+0x1a: 3000 (inferred)"
+};
+
+class WcetAnalyzer {
+public:
+	WcetAnalyzer(const AvrProgram &prog, WcetHints hints) : prog_(prog), hints_(std::move(hints)) {}
+
+	// Worst case of a function, throws WcetError when it has no bound
+	const FunctionWcet &function(const std::string &name);
+
+private:
+	const FunctionWcet &analyze(const AvrFunction &f);
+
+	const AvrProgram &prog_;
+	WcetHints hints_;
+	std::map<std::string, FunctionWcet> done_;
+	std::set<std::string> busy_;
+};
+
+} // namespace door
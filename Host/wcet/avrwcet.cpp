@@ -0,0 +1,224 @@
+// Worst case execution time of every interrupt handler of the firmware.
+//
+// Usage: avrwcet [-a annotations] [-f MHz] [-d objdump] Dumbledoor.lss|.elf
+//
+// The handlers are the __vector_N functions of the listing. Their worst
+// case includes the interrupt response and the jmp of the vector table,
+// 7 cycles. The annotation file has one statement per line, # comments:
+//
+//     loop    <func>[+0xOFF] <n>    loop header runs at most n times per entry
+//     indirect <func> <target>...  icall/ijmp targets of a function
+//     budget  <vector|*> <cycles>  e.g. TIMER0_OVF or __vector_16
+//
+// Exits with 1 when a handler is over its budget, 2 when one cannot be
+// bounded. An .elf is disassembled with avr-objdump -d first.
+//
+// Copyright (c) 2020-2021 Demirkan K. Baglamac and Rasit Demiroren
+// This work is licensed under the terms of the MIT license.
+
+#include "avr_wcet.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+constexpr unsigned kEntryCycles = 4 + 3;    // interrupt response, jmp in the vector table
+
+// ATmega328P vector names, datasheet table 12-6
+const char *const kVectors[] = {
+	"RESET", "INT0", "INT1", "PCINT0", "PCINT1", "PCINT2", "WDT", "TIMER2_COMPA",
+	"TIMER2_COMPB", "TIMER2_OVF", "TIMER1_CAPT", "TIMER1_COMPA", "TIMER1_COMPB",
+	"TIMER1_OVF", "TIMER0_COMPA", "TIMER0_COMPB", "TIMER0_OVF", "SPI_STC", "USART_RX",
+	"USART_UDRE", "USART_TX", "ADC", "EE_READY", "ANALOG_COMP", "TWI", "SPM_READY",
+};
+
+struct Config {
+	door::WcetHints hints;
+	std::map<std::string, uint64_t> budgets;
+};
+
+void read_annotations(const char *path, Config &cfg)
+{
+	std::ifstream f(path);
+	if (!f)
+		throw door::WcetError(std::string("cannot read ") + path);
+	std::string line;
+	unsigned no = 0;
+	while (std::getline(f, line)) {
+		no++;
+		const size_t hash = line.find('#');
+		if (hash != std::string::npos)
+			line.erase(hash);
+		std::istringstream in(line);
+		std::string kw, name;
+		if (!(in >> kw))
+			continue;
+		const std::string at = std::string(path) + ":" + std::to_string(no);
+		if (!(in >> name))
+			throw door::WcetError(at + ": " + kw + " without a name");
+		if (kw == "loop" || kw == "budget") {
+			uint64_t n;
+			if (!(in >> n))
+				throw door::WcetError(at + ": " + kw + " without a count");
+			(kw == "loop" ? cfg.hints.loops : cfg.budgets)[name] = n;
+		} else if (kw == "indirect") {
+			std::string t;
+			while (in >> t)
+				cfg.hints.indirect[name].push_back(t);
+		} else {
+			throw door::WcetError(at + ": unknown statement " + kw);
+		}
+	}
+}
+
+void read_program(const std::string &path, const char *objdump, door::AvrProgram &prog)
+{
+	if (path.size() > 4 && path.compare(path.size() - 4, 4, ".elf") == 0) {
+		const std::string cmd = std::string(objdump) + " -d '" + path + "'";
+		FILE *p = popen(cmd.c_str(), "r");
+		if (!p)
+			throw door::WcetError("cannot run " + cmd);
+		std::string text;
+		char buf[4096];
+		size_t n;
+		while ((n = std::fread(buf, 1, sizeof buf, p)) > 0)
+			text.append(buf, n);
+		if (pclose(p) != 0)
+			throw door::WcetError(cmd + " failed");
+		std::istringstream in(text);
+		prog.read_listing(in);
+	} else {
+		std::ifstream in(path);
+		if (!in)
+			throw door::WcetError("cannot read " + path);
+		prog.read_listing(in);
+	}
+}
+
+// Call tree with the worst case of every function on it, the callees of
+// a function only the first time it appears
+void print_calls(door::WcetAnalyzer &an, const std::string &name, unsigned depth, std::set<std::string> &shown)
+{
+	const door::FunctionWcet &w = an.function(name);
+	const bool first = shown.insert(name).second;
+	std::printf("    %*s%-*s %8llu%s\n", 2 * depth, "", 28 - 2 * static_cast<int>(depth), name.c_str(),
+	            static_cast<unsigned long long>(w.cycles), first || w.callees.empty() ? "" : "  ...");
+	if (first)
+		for (const std::string &c : w.callees)
+			print_calls(an, c, depth + 1, shown);
+}
+
+void print_loops(door::WcetAnalyzer &an, const std::string &name, std::set<std::string> &seen)
+{
+	if (!seen.insert(name).second)
+		return;
+	const door::FunctionWcet &w = an.function(name);
+	for (const std::string &l : w.loops)
+		std::printf("    %s\n", l.c_str());
+	for (const std::string &c : w.callees)
+		print_loops(an, c, seen);
+}
+
+void usage()
+{
+	std::fprintf(stderr, "usage: avrwcet [-a annotations] [-f MHz] [-d objdump] file.lss|file.elf\n");
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	const char *annotations = nullptr;
+	const char *objdump = "avr-objdump";
+	double mhz = 16;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "a:f:d:")) != -1) {
+		switch (opt) {
+		case 'a': annotations = optarg; break;
+		case 'f': mhz = std::atof(optarg); break;
+		case 'd': objdump = optarg; break;
+		default: usage(); return 2;
+		}
+	}
+	if (optind + 1 != argc || mhz <= 0) {
+		usage();
+		return 2;
+	}
+
+	Config cfg;
+	door::AvrProgram prog;
+	try {
+		if (annotations)
+			read_annotations(annotations, cfg);
+		read_program(argv[optind], objdump, prog);
+	} catch (const door::WcetError &e) {
+		std::fprintf(stderr, "avrwcet: %s\n", e.what());
+		return 2;
+	}
+
+	door::WcetAnalyzer an(prog, cfg.hints);
+	unsigned over = 0, failed = 0, isrs = 0;
+	std::set<std::string> seen;
+
+	std::printf("%-12s %-12s %8s %9s %8s\n", "handler", "vector", "cycles", "us", "budget");
+	for (const auto &kv : prog.functions()) {
+		const std::string &fn = kv.second.name;
+		if (fn.compare(0, 9, "__vector_") != 0)
+			continue;
+		const unsigned v = static_cast<unsigned>(std::atoi(fn.c_str() + 9));
+		const std::string vec = v < sizeof kVectors / sizeof kVectors[0] ? kVectors[v] : "?";
+		isrs++;
+
+		uint64_t budget = 0;
+		for (const std::string &key : {fn, vec, std::string("*")}) {
+			auto b = cfg.budgets.find(key);
+			if (b != cfg.budgets.end()) {
+				budget = b->second;
+				break;
+			}
+		}
+
+		try {
+			const uint64_t cycles = an.function(fn).cycles + kEntryCycles;
+			const bool ok = !budget || cycles <= budget;
+			over += !ok;
+			std::printf("%-12s %-12s %8llu %9.1f %8s %s\n", fn.c_str(), vec.c_str(),
+			            static_cast<unsigned long long>(cycles), static_cast<double>(cycles) / mhz,
+			            budget ? std::to_string(budget).c_str() : "-", ok ? "ok" : "OVER");
+			std::set<std::string> shown;
+			print_calls(an, fn, 0, shown);
+		} catch (const door::WcetError &e) {
+			failed++;
+			std::printf("%-12s %-12s %8s %9s %8s %s\n", fn.c_str(), vec.c_str(), "?", "?", "-", e.what());
+		}
+	}
+
+	std::printf("\nloop bounds\n");
+	for (const auto &kv : prog.functions())
+		if (kv.second.name.compare(0, 9, "__vector_") == 0) {
+			try {
+				print_loops(an, kv.second.name, seen);
+			} catch (const door::WcetError &) {
+				// reported above
+			}
+		}
+
+	if (!isrs) {
+		std::fprintf(stderr, "avrwcet: no interrupt handlers in %s\n", argv[optind]);
+		return 2;
+	}
+	std::fflush(stdout);
+	if (failed)
+		return 2;
+	if (over) {
+		std::fprintf(stderr, "avrwcet: %u handler(s) over budget\n", over);
+		return 1;
+	}
+	return 0;
+}